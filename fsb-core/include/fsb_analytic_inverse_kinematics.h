@@ -0,0 +1,190 @@
+
+#ifndef FSB_ANALYTIC_INVERSE_KINEMATICS_H
+#define FSB_ANALYTIC_INVERSE_KINEMATICS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "fsb_body_tree.h"
+#include "fsb_configuration.h"
+#include "fsb_inverse_kinematics.h"
+#include "fsb_joint.h"
+#include "fsb_kinematics.h"
+#include "fsb_motion.h"
+#include "fsb_types.h"
+
+namespace fsb
+{
+
+/**
+ * @defgroup AnalyticInverseKinematics Analytic Inverse Kinematics
+ * @brief Closed form inverse kinematics for six revolute joint arms
+ *
+ * The joint screw axes of the chain at zero configuration are inspected when the solver is
+ * initialized. Supported geometries are solved in closed form using rotations about the zero
+ * configuration axes. Other geometries fall back to the numeric inverse kinematics solver.
+ *
+ * @{
+ */
+
+/**
+ * @brief Number of revolute joints in chain with analytic solution
+ */
+constexpr size_t kAnalyticIkJoints = 6U;
+
+/**
+ * @brief Maximum number of analytic inverse kinematics solutions
+ */
+constexpr size_t kAnalyticIkMaxSolutions = 8U;
+
+/**
+ * @brief Arm geometry detected for analytic inverse kinematics
+ */
+enum class AnalyticGeometry : uint8_t
+{
+    /**
+     * @brief No closed form solution, numeric solver is used
+     */
+    UNSUPPORTED = 0,
+    /**
+     * @brief UR family arm
+     *
+     * Axes 2, 3 and 4 are parallel, axis 5 intersects axis 4 and axis 6 intersects axis 5.
+     */
+    OFFSET_WRIST = 1,
+    /**
+     * @brief Arm satisfying the Pieper condition with a spherical wrist
+     *
+     * Axes 2 and 3 are parallel and axes 4, 5 and 6 intersect at a common point.
+     */
+    SPHERICAL_WRIST = 2
+};
+
+/**
+ * @brief Joint screw axis at zero configuration
+ */
+struct AnalyticJointScrew
+{
+    /**
+     * @brief Unit rotation axis in base frame
+     */
+    Vec3 axis = {};
+    /**
+     * @brief Point on rotation axis in base frame
+     */
+    Vec3 point = {};
+    /**
+     * @brief Index of joint coordinate
+     */
+    size_t coord_index = 0U;
+};
+
+/**
+ * @brief All solutions of analytic inverse kinematics
+ */
+struct AnalyticInverseKinematicsSolutions
+{
+    /**
+     * @brief Joint positions of solutions, only coordinates of the chain are set
+     */
+    std::array<JointSpacePosition, kAnalyticIkMaxSolutions> joint_position = {};
+    /**
+     * @brief Number of valid solutions
+     */
+    size_t num_solutions = 0U;
+};
+
+/**
+ * @brief Analytic inverse kinematics solver with numeric fallback
+ */
+class AnalyticInverseKinematics
+{
+public:
+    AnalyticInverseKinematics() = default;
+
+    /**
+     * @brief Initialize solver and detect arm geometry
+     *
+     * @param body_tree Body tree with link definitions
+     * @param body_index Index of body to compute inverse kinematics for
+     * @param params Optimization parameters of numeric fallback
+     * @param base_pose Base pose (default is identity transform)
+     * @return @c SUCCESS or @c INVALID_INPUT if body has no degrees of freedom or tree is invalid
+     */
+    InverseKinematicsInfo initialize(
+        const BodyTree& body_tree, size_t body_index, const OptimParameters& params,
+        const Transform& base_pose = transform_identity());
+
+    /**
+     * @brief Get detected arm geometry
+     *
+     * @return Arm geometry, @c UNSUPPORTED if numeric solver is used
+     */
+    [[nodiscard]] AnalyticGeometry get_geometry() const
+    {
+        return m_geometry;
+    }
+
+    /**
+     * @brief Compute all closed form solutions for a target pose
+     *
+     * Each solution is verified with forward kinematics. Joint angles are in range [-pi, pi] and
+     * joint limits are not applied.
+     *
+     * @param target_pose Desired body target pose
+     * @param[out] solutions Joint positions of all solutions
+     * @return Number of solutions, zero if target is not reachable or geometry is unsupported
+     */
+    size_t solve_all(const Transform& target_pose, AnalyticInverseKinematicsSolutions& solutions) const;
+
+    /**
+     * @brief Solve inverse kinematics for the solution closest to a seed configuration
+     *
+     * With @c joint_limits enabled in the parameters, only closed form solutions with a turn of
+     * each joint angle within the position limits are selected. The numeric solver starting from
+     * the seed is used if geometry is unsupported or no selectable closed form solution is found.
+     *
+     * @param target_pose Desired body target pose
+     * @param seed Joint configuration used to select solution, also sets coordinates outside chain
+     * @return Result of inverse kinematics computation, valid until next call to solve
+     */
+    const InverseKinematicsResult& solve(const Transform& target_pose, const JointSpacePosition& seed);
+
+    /**
+     * @brief Solve inverse kinematics for the solution closest to the previous solution
+     *
+     * @param target_pose Desired body target pose
+     * @return Result of inverse kinematics computation, valid until next call to solve
+     */
+    const InverseKinematicsResult& solve(const Transform& target_pose);
+
+private:
+    void solve_offset_wrist(
+        const Transform& target_base, AnalyticInverseKinematicsSolutions& solutions) const;
+    void solve_spherical_wrist(
+        const Transform& target_base, AnalyticInverseKinematicsSolutions& solutions) const;
+    void add_solution(
+        const Transform& target_base, const std::array<Real, kAnalyticIkJoints>& angles,
+        AnalyticInverseKinematicsSolutions& solutions) const;
+
+    AnalyticGeometry                                 m_geometry = AnalyticGeometry::UNSUPPORTED;
+    std::array<AnalyticJointScrew, kAnalyticIkJoints> m_screw = {};
+    Transform                                        m_home_inverse = {};
+    Vec3                                             m_wrist_point = {};
+    Vec3                                             m_tool_point = {};
+    Transform                                        m_base_pose = {};
+    size_t                                           m_body_index = 0U;
+    KinematicProgram                                 m_program = {};
+    KinematicProgram                                 m_chain = {};
+    JointSpacePosition                               m_seed = {};
+    InverseKinematicsSolver                          m_numeric = {};
+    InverseKinematicsResult                          m_result = {};
+};
+
+/**
+ * @}
+ */
+
+} // namespace fsb
+
+#endif // FSB_ANALYTIC_INVERSE_KINEMATICS_H
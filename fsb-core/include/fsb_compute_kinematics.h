@@ -2,12 +2,15 @@
 #ifndef FSB_COMPUTE_KINEMATICS_H
 #define FSB_COMPUTE_KINEMATICS_H
 
+#include <array>
+#include <cstddef>
 #include "fsb_body.h"
 #include "fsb_body_tree.h"
 #include "fsb_joint.h"
 #include "fsb_kinematics.h"
 #include "fsb_jacobian.h"
 #include "fsb_motion.h"
+#include "fsb_configuration.h"
 
 namespace fsb
 {
@@ -46,6 +49,9 @@ public:
     /**
      * @brief Initialize the computation interface with a body tree
      *
+     * The body tree is compiled into a kinematic program that is used by all forward kinematics
+     * computations.
+     *
      * @param[in] tree Body tree
      * @return Error code
      */
@@ -82,6 +88,36 @@ public:
         ForwardKinematicsOption opt, const JointPva& joint, const CartesianPva& base,
         BodyCartesianPva& cartesian) const;
 
+    /**
+     * @brief Compute forward kinematics reusing cached results of bodies with unchanged joints
+     *
+     * Only subtrees below joints whose values differ from the previous call are recomputed.
+     *
+     * @param[in] opt Pose, velocity or acceleration selection
+     * @param[in] joint Joint position, velocity and acceleration
+     * @param[out] cartesian Output Cartesian pose, velocity and acceleration of all bodies
+     */
+    void compute_forward_kinematics_incremental(
+        ForwardKinematicsOption opt, const JointPva& joint, BodyCartesianPva& cartesian);
+
+    /**
+     * @brief Invalidate cached forward kinematics used for incremental computation
+     */
+    void reset_kinematics_state()
+    {
+        kinematics_state_reset(m_state);
+    }
+
+    /**
+     * @brief Get the number of bodies recomputed by the last incremental computation
+     *
+     * @return Number of recomputed bodies
+     */
+    [[nodiscard]] size_t get_num_updated_bodies() const
+    {
+        return m_state.num_updated;
+    }
+
     /**
      * @brief Compute Jacobian matrix for a single body in tree
      *
@@ -93,6 +129,51 @@ public:
     JacobianError compute_jacobian(
         size_t body_index, const BodyCartesianPva& cartesian, Jacobian& jacobian) const;
 
+    /**
+     * @brief Compute Jacobian matrices for several bodies in tree from shared joint axes
+     *
+     * @param[in] body_indices Body indices of Jacobians
+     * @param[in] num_jacobians Number of Jacobians to compute
+     * @param[in] cartesian Cartesian pose of all bodies from forward kinematics
+     * @param[out] jacobians Jacobian matrices in order of body indices
+     * @return Jacobian error code, @c BODY_NOT_IN_TREE if any body index is invalid
+     */
+    JacobianError compute_jacobians(
+        const std::array<size_t, MaxSize::kBodies>& body_indices, size_t num_jacobians,
+        const BodyCartesianPva& cartesian, std::array<Jacobian, MaxSize::kBodies>& jacobians) const;
+
+    /**
+     * @brief Compute forward kinematics and the Jacobian matrix of a single body in one pass
+     *
+     * @param[in] opt Pose, velocity or acceleration selection
+     * @param[in] joint Joint position, velocity and acceleration
+     * @param[in] body_index Body index of Jacobian
+     * @param[out] cartesian Output Cartesian pose, velocity and acceleration of all bodies
+     * @param[out] jacobian Jacobian matrix for body
+     * @return Jacobian error code
+     */
+    JacobianError compute_forward_kinematics_and_jacobians(
+        ForwardKinematicsOption opt, const JointPva& joint, size_t body_index,
+        BodyCartesianPva& cartesian, Jacobian& jacobian) const;
+
+    /**
+     * @brief Compute forward kinematics and Jacobian matrices of several bodies in one pass
+     *
+     * Joint axes are computed once during forward kinematics and shared by all Jacobians.
+     *
+     * @param[in] opt Pose, velocity or acceleration selection
+     * @param[in] joint Joint position, velocity and acceleration
+     * @param[in] body_indices Body indices of Jacobians
+     * @param[in] num_jacobians Number of Jacobians to compute
+     * @param[out] cartesian Output Cartesian pose, velocity and acceleration of all bodies
+     * @param[out] jacobians Jacobian matrices in order of body indices
+     * @return Jacobian error code, @c BODY_NOT_IN_TREE if any body index is invalid
+     */
+    JacobianError compute_forward_kinematics_and_jacobians(
+        ForwardKinematicsOption opt, const JointPva& joint,
+        const std::array<size_t, MaxSize::kBodies>& body_indices, size_t num_jacobians,
+        BodyCartesianPva& cartesian, std::array<Jacobian, MaxSize::kBodies>& jacobians) const;
+
     /**
      * @brief Get the number of bodies in the body tree
      *
@@ -114,13 +195,21 @@ public:
     }
 
 private:
-    BodyTree m_body_tree;
+    BodyTree         m_body_tree;
+    KinematicProgram m_program;
+    KinematicsState  m_state;
 };
 
 inline ComputeKinematicsError ComputeKinematics::initialize(const BodyTree& tree)
 {
+    auto result = ComputeKinematicsError::SUCCESS;
     m_body_tree = tree;
-    return ComputeKinematicsError::SUCCESS;
+    kinematics_state_reset(m_state);
+    if (!kinematic_program_compile(m_body_tree, m_program))
+    {
+        result = ComputeKinematicsError::INVALID_BODY_TREE;
+    }
+    return result;
 }
 
 inline void ComputeKinematics::compute_forward_kinematics_pose(
@@ -133,14 +222,21 @@ inline void ComputeKinematics::compute_forward_kinematics_pose(
 inline void ComputeKinematics::compute_forward_kinematics(
     const ForwardKinematicsOption opt, const JointPva& joint, BodyCartesianPva& cartesian) const
 {
-    forward_kinematics(m_body_tree, joint, {}, opt, cartesian);
+    forward_kinematics_program(m_program, joint, {}, opt, cartesian);
 }
 
 inline void ComputeKinematics::compute_forward_kinematics_with_base(
     const ForwardKinematicsOption opt, const JointPva& joint, const CartesianPva& base,
     BodyCartesianPva& cartesian) const
 {
-    forward_kinematics(m_body_tree, joint, base, opt, cartesian);
+    forward_kinematics_program(m_program, joint, base, opt, cartesian);
+}
+
+inline void ComputeKinematics::compute_forward_kinematics_incremental(
+    const ForwardKinematicsOption opt, const JointPva& joint, BodyCartesianPva& cartesian)
+{
+    forward_kinematics_incremental(m_program, joint, {}, opt, m_state);
+    cartesian = m_state.body_cartesian;
 }
 
 inline JacobianError ComputeKinematics::compute_jacobian(
@@ -149,6 +245,36 @@ inline JacobianError ComputeKinematics::compute_jacobian(
     return calculate_jacobian(body_index, m_body_tree, cartesian, jacobian);
 }
 
+inline JacobianError ComputeKinematics::compute_forward_kinematics_and_jacobians(
+    const ForwardKinematicsOption opt, const JointPva& joint, const size_t body_index,
+    BodyCartesianPva& cartesian, Jacobian& jacobian) const
+{
+    BodyJointAxes joint_axes = {};
+    forward_kinematics_program_axes(m_program, joint, {}, opt, cartesian, joint_axes);
+    return calculate_jacobian_from_axes(body_index, joint_axes, cartesian, jacobian);
+}
+
+inline JacobianError ComputeKinematics::compute_forward_kinematics_and_jacobians(
+    const ForwardKinematicsOption opt, const JointPva& joint,
+    const std::array<size_t, MaxSize::kBodies>& body_indices, const size_t num_jacobians,
+    BodyCartesianPva& cartesian, std::array<Jacobian, MaxSize::kBodies>& jacobians) const
+{
+    BodyJointAxes joint_axes = {};
+    forward_kinematics_program_axes(m_program, joint, {}, opt, cartesian, joint_axes);
+    return calculate_jacobians_from_axes(
+        body_indices, num_jacobians, joint_axes, cartesian, jacobians);
+}
+
+inline JacobianError ComputeKinematics::compute_jacobians(
+    const std::array<size_t, MaxSize::kBodies>& body_indices, const size_t num_jacobians,
+    const BodyCartesianPva& cartesian, std::array<Jacobian, MaxSize::kBodies>& jacobians) const
+{
+    BodyJointAxes joint_axes = {};
+    kinematic_program_joint_axes(m_program, cartesian, joint_axes);
+    return calculate_jacobians_from_axes(
+        body_indices, num_jacobians, joint_axes, cartesian, jacobians);
+}
+
 /**
  * @}
  */
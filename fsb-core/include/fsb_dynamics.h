@@ -2,11 +2,15 @@
 #define FSB_DYNAMICS_H
 
 #include <array>
+#include <cstdint>
 
 #include "fsb_body.h"
 #include "fsb_body_tree.h"
 #include "fsb_configuration.h"
+#include "fsb_jacobian.h"
 #include "fsb_joint.h"
+#include "fsb_kinematics.h"
+#include "fsb_motion.h"
 #include "fsb_types.h"
 
 namespace fsb
@@ -42,6 +46,9 @@ struct BodyForce
 /**
  * @brief Inverse dynamics to find joint torques based on external forces and motion of bodies.
  *
+ * Spherical and Cartesian joint torques are given in the joint frame, the frame of their joint
+ * velocities, so joint torque times joint velocity is the joint power.
+ *
  * @param body_tree Body tree
  * @param cartesian_motion Cartesian motion of bodies
  * @param external_force External forces applied to bodies
@@ -52,6 +59,241 @@ JointSpace inverse_dynamics(
     const BodyTree& body_tree, const BodyCartesianPva& cartesian_motion,
     const BodyForce& external_force, BodyForce& body_force);
 
+/**
+ * @brief Joint space mass matrix output options
+ */
+enum class MassMatrixOption : uint8_t
+{
+    /**
+     * @brief Full symmetric matrix
+     */
+    FULL = 0,
+    /**
+     * @brief Lower triangle, strict upper triangle is zero
+     */
+    LOWER = 1,
+    /**
+     * @brief Cholesky factor \f$ L \f$ of \f$ M = L L^T \f$ in lower triangle, strict upper
+     * triangle is zero
+     */
+    CHOLESKY = 2
+};
+
+/**
+ * @brief Body constants of a dynamics model
+ *
+ * Joint transform and mass properties of a body resolved once from the body tree so the dynamics
+ * recursions do not convert rotations or shift inertia on every call.
+ */
+struct DynamicsBody
+{
+    /**
+     * @brief Resolved kind of the parent joint
+     */
+    KinematicOpKind kind = KinematicOpKind::IDENTITY;
+    /**
+     * @brief Index of parent body
+     */
+    size_t parent_index = 0U;
+    /**
+     * @brief Index of first joint coordinate
+     */
+    size_t coord_index = 0U;
+    /**
+     * @brief Index of first joint degree of freedom
+     */
+    size_t dof_index = 0U;
+    /**
+     * @brief Number of joint degrees of freedom
+     */
+    size_t num_dofs = 0U;
+    /**
+     * @brief Index of joint axis for revolute and prismatic joints, 0 for x, 1 for y, 2 for z
+     */
+    size_t axis_index = 0U;
+    /**
+     * @brief Joint direction sign, -1 for reversed joints
+     */
+    Real sign = 1.0;
+    /**
+     * @brief Rotation of constant parent to joint transform
+     */
+    Mat3 parent_joint_rotation = {};
+    /**
+     * @brief Translation of constant parent to joint transform
+     */
+    Vec3 parent_joint_translation = {};
+    /**
+     * @brief Body mass
+     */
+    Real mass = 0.0;
+    /**
+     * @brief First mass moment, mass times center of mass in body coordinates
+     */
+    Vec3 mass_com = {};
+    /**
+     * @brief Inertia about body origin in body coordinates
+     */
+    Inertia inertia = {};
+};
+
+/**
+ * @brief Body tree constants for dynamics recursions
+ *
+ * The model is a copy of the body tree, it has to be compiled again after the body tree changes.
+ */
+struct DynamicsModel
+{
+    /**
+     * @brief Body constants, index 0 holds the mass properties of the base
+     */
+    std::array<DynamicsBody, MaxSize::kBodies> body = {};
+    /**
+     * @brief Number of bodies including base
+     */
+    size_t num_bodies = 0U;
+    /**
+     * @brief Number of joint degrees of freedom
+     */
+    size_t num_dofs = 0U;
+    /**
+     * @brief Gravity vector in world coordinates
+     */
+    Vec3 gravity = {};
+};
+
+/**
+ * @brief Compile body tree into a dynamics model
+ *
+ * @param[in] body_tree Body tree, parents must precede their children
+ * @param[out] model Dynamics model, empty on failure
+ * @return true on success, false if the body tree is not ordered from base to leaves
+ */
+bool dynamics_model_compile(const BodyTree& body_tree, DynamicsModel& model);
+
+/**
+ * @brief Recursive Newton-Euler inverse dynamics on a compiled model
+ *
+ * Velocities and accelerations are propagated in body coordinates with the parent to child
+ * transforms of the forward pass reused for the backward force pass. Gravity enters as an
+ * acceleration of the base. Forces and torques of a body act at the body origin.
+ *
+ * Joint torques are the same as for @c inverse_dynamics.
+ *
+ * @param[in] model Dynamics model
+ * @param[in] joint_pva Joint position, velocity and acceleration
+ * @param[in] base_pva Base pose, velocity and acceleration in world coordinates
+ * @param[in] external_force External forces applied to bodies in body coordinates
+ * @param[out] body_force Forces and torque acting at each joint in body coordinates
+ * @return Joint torque vector resulting from dynamics
+ */
+JointSpace inverse_dynamics_rnea(
+    const DynamicsModel& model, const JointPva& joint_pva, const CartesianPva& base_pva,
+    const BodyForce& external_force, BodyForce& body_force);
+
+/**
+ * @brief Gravity joint torques g(q)
+ *
+ * Joint torques that hold the bodies at rest against gravity. Only body orientations are
+ * propagated, velocity and acceleration terms of @c inverse_dynamics_rnea are skipped.
+ *
+ * @param[in] model Dynamics model
+ * @param[in] joint_position Joint position
+ * @param[in] base_pose Base pose in world coordinates
+ * @return Gravity joint torque vector
+ */
+JointSpace gravity_torques(
+    const DynamicsModel& model, const JointSpacePosition& joint_position, const Transform& base_pose);
+
+/**
+ * @brief Coriolis and centrifugal joint torques \f$ C(q, \dot{q}) \dot{q} \f$
+ *
+ * Joint torques of inverse dynamics with the base at rest, no gravity and zero joint acceleration.
+ *
+ * @param[in] model Dynamics model
+ * @param[in] joint_position Joint position
+ * @param[in] joint_velocity Joint velocity
+ * @return Coriolis and centrifugal joint torque vector
+ */
+JointSpace coriolis_torques(
+    const DynamicsModel& model, const JointSpacePosition& joint_position,
+    const JointSpace& joint_velocity);
+
+/**
+ * @brief Joint space mass matrix with the Composite Rigid Body Algorithm
+ *
+ * Composite inertias are accumulated from leaves to base in a single backward pass, each joint
+ * column is then projected onto the joints between its body and the base.
+ *
+ * @param[in] model Dynamics model
+ * @param[in] joint_position Joint position
+ * @param[in] opt Output option
+ * @param[out] mass_matrix Mass matrix (dofs x dofs) with @c joint_matrix_index layout
+ * @return false if the Cholesky factor was requested and the mass matrix is not positive definite
+ */
+bool mass_matrix_crba(
+    const DynamicsModel& model, const JointSpacePosition& joint_position, MassMatrixOption opt,
+    JointMatrix& mass_matrix);
+
+/**
+ * @brief Joint space mass matrix of a body tree with the Composite Rigid Body Algorithm
+ *
+ * Compiles a dynamics model on every call, use the overload with a compiled model in control loops.
+ *
+ * @param[in] body_tree Body tree
+ * @param[in] joint_position Joint position
+ * @param[in] opt Output option
+ * @param[out] mass_matrix Mass matrix (dofs x dofs) with @c joint_matrix_index layout
+ * @return false if the body tree cannot be compiled or the Cholesky factor was requested and the
+ * mass matrix is not positive definite
+ */
+bool mass_matrix_crba(
+    const BodyTree& body_tree, const JointSpacePosition& joint_position, MassMatrixOption opt,
+    JointMatrix& mass_matrix);
+
+/**
+ * @brief Forward dynamics with the Articulated Body Algorithm
+ *
+ * Joint accelerations are found in three passes over the tree: body velocities and bias
+ * accelerations toward the leaves, articulated body inertias toward the base and joint and body
+ * accelerations toward the leaves again. Base motion is prescribed, a Cartesian joint from the base
+ * gives a floating base. Joint torques follow the convention of @c inverse_dynamics_rnea.
+ *
+ * @param[in] model Dynamics model
+ * @param[in] joint_position Joint position
+ * @param[in] joint_velocity Joint velocity
+ * @param[in] joint_torque Joint torque
+ * @param[in] base_pva Base pose, velocity and acceleration in world coordinates
+ * @param[in] external_force External forces applied to bodies in body coordinates
+ * @param[out] joint_acceleration Joint acceleration
+ * @return false if the articulated inertia about a joint is not positive definite, for example if
+ * the joint moves only massless bodies
+ */
+bool forward_dynamics_aba(
+    const DynamicsModel& model, const JointSpacePosition& joint_position,
+    const JointSpace& joint_velocity, const JointSpace& joint_torque, const CartesianPva& base_pva,
+    const BodyForce& external_force, JointSpace& joint_acceleration);
+
+/**
+ * @brief Forward dynamics of a body tree with the Articulated Body Algorithm
+ *
+ * Compiles a dynamics model on every call, use the overload with a compiled model in control loops.
+ *
+ * @param[in] body_tree Body tree
+ * @param[in] joint_position Joint position
+ * @param[in] joint_velocity Joint velocity
+ * @param[in] joint_torque Joint torque
+ * @param[in] base_pva Base pose, velocity and acceleration in world coordinates
+ * @param[in] external_force External forces applied to bodies in body coordinates
+ * @param[out] joint_acceleration Joint acceleration
+ * @return false if the body tree cannot be compiled or the articulated inertia about a joint is not
+ * positive definite
+ */
+bool forward_dynamics_aba(
+    const BodyTree& body_tree, const JointSpacePosition& joint_position,
+    const JointSpace& joint_velocity, const JointSpace& joint_torque, const CartesianPva& base_pva,
+    const BodyForce& external_force, JointSpace& joint_acceleration);
+
 /**
  * @}
  */
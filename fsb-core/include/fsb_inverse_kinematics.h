@@ -5,19 +5,27 @@
 #ifndef FSB_INVERSE_KINEMATICS_H
 #define FSB_INVERSE_KINEMATICS_H
 
+#include <array>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <ctime>
 #include "fsb_body.h"
 #include "fsb_body_tree.h"
 #include "fsb_motion.h"
 #include "fsb_joint.h"
 #include "fsb_types.h"
 #include "fsb_jacobian.h"
+#include "fsb_kinematics.h"
 #include "fsb_linalg.h"
+#include "fsb_linalg_fixed.h"
+#include "fsb_work.h"
 
 namespace fsb
 {
 
+class InverseKinematicsSeedCache;
+
 /**
  * @defgroup InverseKinematics Inverse Kinematics
  * @brief Inverse kinematics
@@ -29,8 +37,10 @@ struct OptimParameters
 {
     size_t       max_iterations = 100U; ///< Maximum number of iterations
     Real         objective_tol = 1.0e-12; ///< Objective function error tolerance for convergence
-    Real         state_tol = 1.0e-12; ///< State vector error tolerance for convergence
-    Real         damping_factor = 0.001; ///< Damping factor for Levenberg-Marquardt algorithm
+    Real         state_tol = 1.0e-12; ///< Relative state vector change tolerance for convergence
+    Real         reduction_tol = 1.0e-12; ///< Relative objective function reduction tolerance for convergence
+    Real         damping_factor = 0.001; ///< Initial damping relative to largest diagonal of normal equations
+    bool         joint_limits = false; ///< Constrain joint positions to position limits of body tree
     MotionVector objective_weights = {
         {1.0, 1.0, 1.0},
         {1.0, 1.0, 1.0}
@@ -42,39 +52,359 @@ enum class InverseKinematicsInfo : uint8_t
     INVALID_INPUT = 0,
     SUCCESS = 1, ///< objective function converged
     WITHIN_FTOL = 2, ///< both actual and predicted relative reductions in the sum of squares are at
-                     ///< most ftol
-    WITHIN_XTOL = 3, ///< relative error between two consecutive iterates is at most xtol
+                     ///< most reduction_tol
+    WITHIN_XTOL = 3, ///< relative error between two consecutive iterates is at most state_tol
     WITHIN_FTOL_XTOL = 4, ///< conditions for WITHIN_FTOL and WITHIN_XTOL both hold
     MAXIMUM_EVALUATIONS_REACHED = 5, ///< number of calls to fcn with iflag = 1 has reached maxfev
-    SINGULAR_UPDATE_MATRIX = 6 ///< singular matrix encountered
+    SINGULAR_UPDATE_MATRIX = 6, ///< singular matrix encountered
+    CANCELLED = 7, ///< iterations stopped by cancel flag
+    DEADLINE_REACHED = 8 ///< deadline reached before convergence, best iterate is returned
 };
 
 struct InverseKinematicsResult
+{
+    InverseKinematicsInfo            info = InverseKinematicsInfo::INVALID_INPUT; ///< Convergence information
+    JointSpacePosition               joint_position = {}; ///< Joint position
+    BodyCartesianPva                 body_poses = {}; ///< Body poses
+    Jacobian                         jacobian = {}; ///< Jacobian matrix
+    Transform                        computed_pose = {}; ///< Computed end-effector pose
+    MotionVector                     error_pose = {}; ///< Error between computed and desired pose
+    size_t                           iterations = 0; ///< Number of iterations
+    std::array<bool, MaxSize::kDofs> active_limits = {}; ///< Degrees of freedom at a position limit
+    size_t                           num_active_limits = 0U; ///< Number of degrees of freedom at a position limit
+};
+
+/**
+ * @brief Check if inverse kinematics reached the objective tolerance
+ *
+ * Stops on small relative reduction or state change (@c WITHIN_FTOL, @c WITHIN_XTOL) also occur
+ * at stalled iterates of unreachable targets and do not count as converged.
+ *
+ * @param info Convergence information
+ * @return true for @c SUCCESS
+ */
+bool inverse_kinematics_converged(InverseKinematicsInfo info);
+
+/**
+ * @brief Joint position bounds of single degree of freedom joints in a chain
+ */
+struct InverseKinematicsBounds
+{
+    std::array<bool, MaxSize::kDofs>   set = {}; ///< Bounds enabled for degree of freedom
+    std::array<Real, MaxSize::kDofs>   lower = {}; ///< Minimum joint position
+    std::array<Real, MaxSize::kDofs>   upper = {}; ///< Maximum joint position
+    std::array<size_t, MaxSize::kDofs> coord_index = {}; ///< Joint coordinate of degree of freedom
+    size_t                             num_set = 0U; ///< Number of bounded degrees of freedom
+};
+
+/**
+ * @brief Initial configuration of each sample when solving a sequence of targets
+ */
+enum class InverseKinematicsSeedPrediction : uint8_t
+{
+    PREVIOUS_SOLUTION = 0, ///< previous converged solution
+    VELOCITY = 1 ///< previous converged solution moved by joint velocity mapped from target pose change
+};
+
+/**
+ * @brief Result of one sample of a target sequence
+ */
+struct InverseKinematicsSample
 {
     InverseKinematicsInfo info = InverseKinematicsInfo::INVALID_INPUT; ///< Convergence information
     JointSpacePosition    joint_position = {}; ///< Joint position
-    BodyCartesianPva      body_poses = {}; ///< Body poses
-    Jacobian              jacobian = {}; ///< Jacobian matrix
-    Transform             computed_pose = {}; ///< Computed end-effector pose
-    MotionVector          error_pose = {}; ///< Error between computed and desired pose
-    size_t                iterations = 0; ///< Number of iterations
+    size_t                iterations = 0U; ///< Number of iterations
+};
+
+/**
+ * @brief Summary of solving a sequence of targets
+ */
+struct InverseKinematicsSequenceSummary
+{
+    size_t num_samples = 0U; ///< Number of samples solved
+    size_t num_failures = 0U; ///< Number of samples that did not reach the objective tolerance
+    size_t total_iterations = 0U; ///< Sum of iterations of all samples
+    size_t max_iterations = 0U; ///< Largest number of iterations of a sample
+};
+
+/**
+ * @brief Length of LAPACK Cholesky work, only used for more degrees of freedom than the fixed size
+ * solver supports
+ */
+constexpr size_t kInverseKinematicsCholeskyWork
+    = (MaxSize::kDofs > kLinalgFixedMaxDim) ? (MaxSize::kDofs * MaxSize::kDofs) : 1U;
+
+/**
+ * @brief Scratch buffers for inverse kinematics iterations
+ */
+struct InverseKinematicsWorkspace
+{
+    JointPva                           joint_pva = {}; ///< Joint state of current iterate
+    CartesianPva                       base_pva = {}; ///< Base pose
+    BodyJointAxes                      joint_axes = {}; ///< World frame joint axes of current iterate
+    MotionVector                       weighted_error = {}; ///< Weighted pose error
+    JointSpace                         joint_gradient = {}; ///< Gradient of objective function
+    JointSpace                         joint_offset = {}; ///< Joint increment
+    JointMatrix                        increment_matrix = {}; ///< Damped normal equations matrix
+    JointSpacePosition                 previous_position = {}; ///< Joint position restored after rejected step
+    JointMatrix                        normal_matrix = {}; ///< Damped normal equations matrix kept for bounded step
+    std::array<int8_t, MaxSize::kDofs> active_bound = {}; ///< Active bound of step, -1 lower, 1 upper
+    std::array<Real, kInverseKinematicsCholeskyWork> cholesky_work = {}; ///< LAPACK Cholesky work
 };
 
 /**
  * @brief Compute inverse kinematics for a given end-effector pose
  *
+ * With @c joint_limits enabled in the parameters, each step is a box constrained least squares
+ * problem on the position limits of single degree of freedom joints and the initial
+ * configuration is projected onto the limits.
+ *
+ * With a seed cache, a successful solution is stored in the cache. The initial configuration is
+ * an explicit seed and is not replaced by a stored solution, use
+ * @c InverseKinematicsSeedCache::lookup to start from the nearest stored target.
+ *
  * @param body_tree Body tree with link definitions
  * @param params Optimization parameters
  * @param initial_config Initial joint configuration
  * @param body_index Index of body to compute inverse kinematics for
  * @param target_pose Desired body target pose
  * @param base_pose Base pose (default is identity transform)
+ * @param seed_cache Optional cache of solutions for the same body tree, body and base pose
  * @return Result of inverse kinematics computation
  */
 InverseKinematicsResult compute_inverse_kinematics(
     const BodyTree& body_tree, const OptimParameters& params,
     const JointSpacePosition& initial_config, size_t body_index, const Transform& target_pose,
-    const Transform& base_pose = transform_identity());
+    const Transform& base_pose = transform_identity(),
+    InverseKinematicsSeedCache* seed_cache = nullptr);
+
+/**
+ * @brief LAPACK plans of Jacobian linear systems indexed by number of degrees of freedom
+ *
+ * Plans hold the LAPACK workspace sizes of the fallback solvers, so overloads taking plans do
+ * not query LAPACK on each call.
+ */
+struct JacobianLinalgPlans
+{
+    std::array<FsbLinalgLeastSquaresPlan, MaxSize::kDofs + 1U>  leastsquares = {}; ///< Least squares plans of Jacobian linear system
+    std::array<FsbLinalgPseudoinversePlan, MaxSize::kDofs + 1U> pseudoinverse = {}; ///< Pseudoinverse plans of Jacobian
+};
+
+/**
+ * @brief Create LAPACK plans of Jacobian linear systems
+ *
+ * Runs the LAPACK workspace queries once, call at initialization outside of real-time loops.
+ *
+ * @param[out] plans Plans for one up to MaxSize::kDofs degrees of freedom
+ * @return Linear algebra error code, first failed query
+ */
+FsbLinalgErrorType jacobian_linalg_plans_create(JacobianLinalgPlans& plans);
+
+/**
+ * @brief Inverse kinematics solver for a single body with preallocated buffers
+ *
+ * The solver is initialized once for a body tree and target body. Each call to @c solve works in
+ * place on buffers owned by the solver. Without an explicit seed the previous converged solution
+ * is used as initial configuration, which suits streaming targets.
+ */
+class InverseKinematicsSolver
+{
+public:
+    InverseKinematicsSolver() = default;
+
+    /**
+     * @brief Initialize solver for a body in tree
+     *
+     * The warm start configuration is reset to the zero configuration of the joints.
+     *
+     * @param body_tree Body tree with link definitions
+     * @param body_index Index of body to compute inverse kinematics for
+     * @param params Optimization parameters
+     * @param base_pose Base pose (default is identity transform)
+     * @return @c SUCCESS or @c INVALID_INPUT if body has no degrees of freedom, tree is invalid or
+     * the LAPACK fallback workspace cannot be planned
+     */
+    InverseKinematicsInfo initialize(
+        const BodyTree& body_tree, size_t body_index, const OptimParameters& params,
+        const Transform& base_pose = transform_identity());
+
+    /**
+     * @brief Solve inverse kinematics starting from the previous converged solution
+     *
+     * @param target_pose Desired body target pose
+     * @return Result of inverse kinematics computation, valid until next call to solve
+     */
+    const InverseKinematicsResult& solve(const Transform& target_pose);
+
+    /**
+     * @brief Solve inverse kinematics starting from a seed configuration
+     *
+     * @param target_pose Desired body target pose
+     * @param seed Initial joint configuration
+     * @return Result of inverse kinematics computation, valid until next call to solve
+     */
+    const InverseKinematicsResult& solve(const Transform& target_pose, const JointSpacePosition& seed);
+
+    /**
+     * @brief Solve inverse kinematics from the warm start until an absolute deadline
+     *
+     * The monotonic clock is checked between iterations and at least one iteration is computed.
+     * When the deadline is reached the result info is @c DEADLINE_REACHED and the best iterate
+     * becomes the warm start, so the next call resumes from it.
+     *
+     * @param target_pose Desired body target pose
+     * @param deadline Absolute time of @c CLOCK_MONOTONIC
+     * @return Result of inverse kinematics computation, valid until next call to solve
+     */
+    const InverseKinematicsResult& solve_until(const Transform& target_pose, const timespec& deadline);
+
+    /**
+     * @brief Solve inverse kinematics from the warm start within a time budget
+     *
+     * @see solve_until
+     *
+     * @param target_pose Desired body target pose
+     * @param budget_ns Time budget in nanoseconds from now
+     * @return Result of inverse kinematics computation, valid until next call to solve
+     */
+    const InverseKinematicsResult& solve_within(const Transform& target_pose, int64_t budget_ns);
+
+    /**
+     * @brief Solve inverse kinematics for a sequence of targets with warm start
+     *
+     * The first sample starts from the warm start configuration and each following sample starts
+     * from the last converged solution. With @c VELOCITY prediction the initial configuration is
+     * moved by the joint offset that maps to the pose change between consecutive targets through
+     * the Jacobian of the previous solution. Failed samples do not update the warm start.
+     *
+     * @param target_poses Desired body target poses
+     * @param num_targets Number of target poses
+     * @param prediction Initial configuration of each sample
+     * @param[out] samples Result of each sample (num_targets)
+     * @return Iterations and failures of the sequence
+     */
+    InverseKinematicsSequenceSummary solve_sequence(
+        const Transform target_poses[], size_t num_targets,
+        InverseKinematicsSeedPrediction prediction, InverseKinematicsSample samples[]);
+
+    /**
+     * @brief Set optimization parameters
+     *
+     * @param params Optimization parameters
+     */
+    void set_parameters(const OptimParameters& params)
+    {
+        m_params = params;
+    }
+
+    /**
+     * @brief Set base pose
+     *
+     * @param base_pose Base pose
+     */
+    void set_base_pose(const Transform& base_pose)
+    {
+        m_work.base_pva.pose = base_pose;
+    }
+
+    /**
+     * @brief Set configuration used as initial guess by the next call to @c solve without seed
+     *
+     * @param seed Initial joint configuration
+     */
+    void set_warm_start(const JointSpacePosition& seed)
+    {
+        m_seed = seed;
+        m_keep_warm_start = true;
+    }
+
+    /**
+     * @brief Get configuration used as initial guess by the next call to @c solve without seed
+     *
+     * @return Initial joint configuration
+     */
+    [[nodiscard]] const JointSpacePosition& get_warm_start() const
+    {
+        return m_seed;
+    }
+
+    /**
+     * @brief Set flag checked before each iteration to stop the solver early
+     *
+     * The result info is @c CANCELLED when the flag is set during a call to @c solve.
+     *
+     * @param cancel Cancel flag owned by the caller, nullptr to disable
+     */
+    void set_cancel_flag(const std::atomic<bool>* cancel)
+    {
+        m_cancel = cancel;
+    }
+
+    /**
+     * @brief Set seed cache used by calls to @c solve
+     *
+     * The nearest stored solution replaces the warm start of calls without seed. Explicit seeds,
+     * including the seeds of @c solve_sequence, a warm start set with @c set_warm_start and the
+     * best iterate resumed after @c DEADLINE_REACHED are kept. Successful solutions of all calls
+     * are stored in the cache.
+     *
+     * @param seed_cache Seed cache owned by the caller, nullptr to disable
+     */
+    void set_seed_cache(InverseKinematicsSeedCache* seed_cache)
+    {
+        m_seed_cache = seed_cache;
+    }
+
+    /**
+     * @brief Get joint position bounds applied by the solver
+     *
+     * @return Bounds of chain degrees of freedom, none set if @c joint_limits is disabled in the
+     * parameters
+     */
+    [[nodiscard]] const InverseKinematicsBounds& get_bounds() const;
+
+    /**
+     * @brief Get result of the last call to @c solve
+     *
+     * @return Result of inverse kinematics computation
+     */
+    [[nodiscard]] const InverseKinematicsResult& get_result() const
+    {
+        return m_result;
+    }
+
+    /**
+     * @brief Get linear algebra work array used by the solver
+     *
+     * The high-water mark of the work array reports the largest work buffer used by solver calls.
+     *
+     * @return Solver work array
+     */
+    [[nodiscard]] const LinalgWork& get_linalg_work() const
+    {
+        return m_linalg_work;
+    }
+
+private:
+    const InverseKinematicsResult& solve_before(
+        const Transform& target_pose, const JointSpacePosition& seed, const timespec* deadline,
+        bool use_seed_cache);
+
+    KinematicProgram            m_program = {};
+    KinematicProgram            m_chain = {};
+    OptimParameters             m_params = {};
+    size_t                      m_body_index = 0U;
+    size_t                      m_dofs = 0U;
+    JointSpacePosition          m_seed = {};
+    bool                        m_keep_warm_start = false; ///< Warm start not replaced from seed cache
+    InverseKinematicsBounds     m_bounds = {};
+    InverseKinematicsWorkspace  m_work = {};
+    InverseKinematicsResult     m_result = {};
+    const std::atomic<bool>*    m_cancel = nullptr;
+    InverseKinematicsSeedCache* m_seed_cache = nullptr;
+    LinalgWork                  m_linalg_work = {};
+    JacobianLinalgPlans         m_linalg_plans = {};
+};
 
 /**
  * @brief Inverse velocity kinematics
@@ -82,6 +412,9 @@ InverseKinematicsResult compute_inverse_kinematics(
  * The equation for inverse velocity kinematics is given by:
  * \[ \dot{q} = J^{\dagger} \dot{x} \]
  *
+ * A rank deficient Jacobian falls back to LAPACK with a workspace query and a work array on the
+ * stack. Real-time callers use the overload with plans and work array.
+ *
  * @param jacobian Jacobian matrix
  * @param cart_velocity Cartesian velocity vector
  * @param dofs Number of degrees of freedom (dofs)
@@ -92,12 +425,30 @@ FsbLinalgErrorType inverse_velocity_kinematics(
     const Jacobian& jacobian, const MotionVector& cart_velocity, size_t dofs,
     JointSpace& joint_velocity);
 
+/**
+ * @brief Inverse velocity kinematics with caller provided plans and work array
+ *
+ * @param jacobian Jacobian matrix
+ * @param cart_velocity Cartesian velocity vector
+ * @param dofs Number of degrees of freedom (dofs)
+ * @param[out] joint_velocity Joint velocity vector
+ * @param plans LAPACK plans created by @c jacobian_linalg_plans_create
+ * @param[in,out] work Work array, allocations are released on return
+ * @return Linear algebra error code
+ */
+FsbLinalgErrorType inverse_velocity_kinematics(
+    const Jacobian& jacobian, const MotionVector& cart_velocity, size_t dofs,
+    JointSpace& joint_velocity, const JacobianLinalgPlans& plans, LinalgWork& work);
+
 /**
  * @brief Inverse acceleration kinematics
  *
  * The equation for inverse acceleration kinematics is given by:
  * \[ \ddot{q} = J^{\dagger} \left( \ddot{x} - \dot{J} \dot{q} \right) \]
  *
+ * A rank deficient Jacobian falls back to LAPACK with a workspace query and a work array on the
+ * stack. Real-time callers use the overload with plans and work array.
+ *
  * @param jacobian Jacobian matrix
  * @param jacobian_derivative Time derivative of Jacobian matrix
  * @param cart_acceleration Cartesian acceleration vector
@@ -111,6 +462,24 @@ FsbLinalgErrorType inverse_acceleration_kinematics(
     const MotionVector& cart_acceleration, const JointSpace& joint_velocity, size_t dofs,
     JointSpace& joint_acceleration);
 
+/**
+ * @brief Inverse acceleration kinematics with caller provided plans and work array
+ *
+ * @param jacobian Jacobian matrix
+ * @param jacobian_derivative Time derivative of Jacobian matrix
+ * @param cart_acceleration Cartesian acceleration vector
+ * @param joint_velocity Joint velocity vector
+ * @param dofs Number of degrees of freedom (dofs)
+ * @param[out] joint_acceleration Joint acceleration vector
+ * @param plans LAPACK plans created by @c jacobian_linalg_plans_create
+ * @param[in,out] work Work array, allocations are released on return
+ * @return Linear algebra error code
+ */
+FsbLinalgErrorType inverse_acceleration_kinematics(
+    const Jacobian& jacobian, const Jacobian& jacobian_derivative,
+    const MotionVector& cart_acceleration, const JointSpace& joint_velocity, size_t dofs,
+    JointSpace& joint_acceleration, const JacobianLinalgPlans& plans, LinalgWork& work);
+
 /**
  * @}
  */
@@ -0,0 +1,155 @@
+#ifndef FSB_INVERSE_KINEMATICS_CACHE_H
+#define FSB_INVERSE_KINEMATICS_CACHE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "fsb_configuration.h"
+#include "fsb_joint.h"
+#include "fsb_motion.h"
+#include "fsb_types.h"
+
+namespace fsb
+{
+
+/**
+ * @defgroup InverseKinematicsCache Inverse Kinematics Seed Cache
+ * @brief Converged inverse kinematics solutions indexed by target pose
+ *
+ * Target poses are quantized to cells of a grid in position and rotation vector. Each cell stores
+ * the target and the last converged joint position of a target in the cell, so repeated or nearby
+ * targets start from a configuration close to the solution. Cells are held in a fixed size set
+ * associative hash table and the least recently used cell of a set is replaced when the set is
+ * full.
+ *
+ * A lookup probes the cell of the target and the neighbouring cells on the nearer side in each
+ * coordinate, so every stored target within half a cell in each coordinate is found across cell
+ * boundaries. Rotations close to half a turn also probe the cells of the equivalent rotation vector
+ * on the opposite side. The stored target nearest to the requested target is returned.
+ *
+ * A cache is valid for one body tree, target body and base pose.
+ *
+ * @{
+ */
+
+/**
+ * @brief Number of hash sets of the seed cache
+ */
+constexpr size_t kSeedCacheSets = 64U;
+
+/**
+ * @brief Number of cells per hash set of the seed cache
+ */
+constexpr size_t kSeedCacheWays = 4U;
+
+/**
+ * @brief Quantization of target poses
+ */
+struct SeedCacheParameters
+{
+    Real position_resolution = 0.01; ///< Cell size of target position
+    Real orientation_resolution = 0.05; ///< Cell size of target rotation vector in radians
+};
+
+/**
+ * @brief Seed cache lookup counters
+ */
+struct SeedCacheStatistics
+{
+    size_t hits = 0U; ///< Lookups that found a seed
+    size_t misses = 0U; ///< Lookups without seed
+    size_t insertions = 0U; ///< Solutions stored
+    size_t evictions = 0U; ///< Cells replaced to store a solution of another cell
+};
+
+/**
+ * @brief Fixed size cache of inverse kinematics seeds
+ *
+ * The cache is not thread safe.
+ */
+class InverseKinematicsSeedCache
+{
+public:
+    /**
+     * @brief Set quantization parameters and remove all seeds
+     *
+     * The cache is disabled if a resolution is not positive and finite. Lookups of a disabled
+     * cache find no seed and insertions are ignored until the next successful initialization.
+     *
+     * @param params Quantization parameters
+     * @return true if parameters are valid and the cache is enabled
+     */
+    bool initialize(const SeedCacheParameters& params);
+
+    /**
+     * @brief Remove all seeds and reset counters
+     */
+    void clear();
+
+    /**
+     * @brief Find seed of the stored target nearest to the target pose
+     *
+     * @param[in] target_pose Target pose
+     * @param[out] seed Stored joint position, unchanged on miss
+     * @return true if a seed was found, false on miss or if the cache is disabled
+     */
+    bool lookup(const Transform& target_pose, JointSpacePosition& seed);
+
+    /**
+     * @brief Store converged joint position of a target pose, ignored if the cache is disabled
+     *
+     * @param target_pose Target pose
+     * @param joint_position Converged joint position
+     */
+    void insert(const Transform& target_pose, const JointSpacePosition& joint_position);
+
+    /**
+     * @brief Get lookup counters
+     * @return Counters since last @c clear
+     */
+    [[nodiscard]] const SeedCacheStatistics& get_statistics() const
+    {
+        return m_statistics;
+    }
+
+    /**
+     * @brief Get number of stored seeds
+     * @return Number of occupied cells
+     */
+    [[nodiscard]] size_t get_size() const;
+
+private:
+    using CellKey = std::array<int64_t, 6U>;
+    using CellCoordinates = std::array<Real, 6U>;
+
+    struct Entry
+    {
+        bool               valid = false;
+        CellKey            key = {};
+        uint64_t           stamp = 0U;
+        Transform          target_pose = {};
+        JointSpacePosition joint_position = {};
+    };
+
+    [[nodiscard]] CellCoordinates cell_coordinates(const Transform& target_pose, Real sign) const;
+
+    [[nodiscard]] Real target_distance(const Transform& target_pose, const Transform& stored_pose) const;
+
+    void probe_cells(
+        const CellCoordinates& coordinates, const Transform& target_pose, size_t& nearest_index,
+        Real& nearest_distance) const;
+
+    SeedCacheParameters                                m_params = {};
+    std::array<Entry, kSeedCacheSets * kSeedCacheWays> m_entries = {};
+    SeedCacheStatistics                                m_statistics = {};
+    uint64_t                                           m_stamp = 0U;
+    bool                                               m_enabled = true;
+};
+
+/**
+ * @}
+ */
+
+} // namespace fsb
+
+#endif // FSB_INVERSE_KINEMATICS_CACHE_H
@@ -9,6 +9,7 @@
 #include "fsb_body_tree.h"
 #include "fsb_configuration.h"
 #include "fsb_joint.h"
+#include "fsb_kinematics.h"
 #include "fsb_motion.h"
 #include "fsb_types.h"
 
@@ -37,7 +38,11 @@ enum class JacobianError : uint8_t
     /**
      * @brief Hessian fails since all proximal joints are not revolute or prismatic
      */
-    NOT_REVOLUTE_OR_PRISMATIC
+    NOT_REVOLUTE_OR_PRISMATIC,
+    /**
+     * @brief Body tree cannot be compiled to a kinematic program
+     */
+    TREE_NOT_COMPILED
 };
 
 /**
@@ -172,6 +177,77 @@ JacobianError calculate_jacobian(
     size_t body_index, const BodyTree& body_tree, const BodyCartesianPva& cartesian_pva,
     Jacobian& jacobian);
 
+/**
+ * @brief Determine Jacobian matrix for a single body from world frame joint axes
+ *
+ * Joint axes and Cartesian poses should be determined by @c forward_kinematics_program_axes
+ * prior to calling this function. The result is the same as @c calculate_jacobian without
+ * recomputing the joint frames.
+ *
+ * @param[in] body_index Body index of Jacobian
+ * @param[in] joint_axes World frame joint axes of all bodies
+ * @param[in] cartesian_pva Cartesian pose, velocity and acceleration data for all bodies
+ * @param[out] jacobian Jacobian matrix for body
+ * @return Jacobian error code
+ */
+JacobianError calculate_jacobian_from_axes(
+    size_t body_index, const BodyJointAxes& joint_axes, const BodyCartesianPva& cartesian_pva,
+    Jacobian& jacobian);
+
+/**
+ * @brief Determine Jacobian matrices of several bodies from shared joint axes
+ *
+ * @param[in] body_indices Body indices of Jacobians
+ * @param[in] num_jacobians Number of Jacobians to compute
+ * @param[in] joint_axes World frame joint axes of all bodies
+ * @param[in] cartesian_pva Cartesian pose, velocity and acceleration data for all bodies
+ * @param[out] jacobians Jacobian matrices in order of body indices
+ * @return Jacobian error code, @c BODY_NOT_IN_TREE if any body index is invalid
+ */
+JacobianError calculate_jacobians_from_axes(
+    const std::array<size_t, MaxSize::kBodies>& body_indices, size_t num_jacobians,
+    const BodyJointAxes& joint_axes, const BodyCartesianPva& cartesian_pva,
+    std::array<Jacobian, MaxSize::kBodies>& jacobians);
+
+/**
+ * @brief Determine Jacobian matrices of several bodies from a compiled kinematic program
+ *
+ * The world frame axis of each joint is computed once and shared by all Jacobians, e.g. for all
+ * leaves returned by @c BodyTree::get_leaves. Cartesian pose for all bodies should be determined
+ * by forward kinematics prior to calling this function.
+ *
+ * @param[in] body_indices Body indices of Jacobians
+ * @param[in] num_jacobians Number of Jacobians to compute
+ * @param[in] program Kinematic program compiled from the body tree
+ * @param[in] cartesian_pva Cartesian pose, velocity and acceleration data for all bodies
+ * @param[out] jacobians Jacobian matrices in order of body indices
+ * @return Jacobian error code, @c BODY_NOT_IN_TREE if any body index is invalid
+ */
+JacobianError calculate_jacobians(
+    const std::array<size_t, MaxSize::kBodies>& body_indices, size_t num_jacobians,
+    const KinematicProgram& program, const BodyCartesianPva& cartesian_pva,
+    std::array<Jacobian, MaxSize::kBodies>& jacobians);
+
+/**
+ * @brief Determine Jacobian matrices of several bodies in tree
+ *
+ * Same as the overload taking a kinematic program, but the body tree is compiled on every call.
+ * Callers computing Jacobians repeatedly, e.g. in a control loop, should compile the program once
+ * with @c kinematic_program_compile and use the program overload.
+ *
+ * @param[in] body_indices Body indices of Jacobians
+ * @param[in] num_jacobians Number of Jacobians to compute
+ * @param[in] body_tree Body tree with body and joint data
+ * @param[in] cartesian_pva Cartesian pose, velocity and acceleration data for all bodies
+ * @param[out] jacobians Jacobian matrices in order of body indices
+ * @return Jacobian error code, @c BODY_NOT_IN_TREE if any body index is invalid,
+ * @c TREE_NOT_COMPILED if the body tree cannot be compiled
+ */
+JacobianError calculate_jacobians(
+    const std::array<size_t, MaxSize::kBodies>& body_indices, size_t num_jacobians,
+    const BodyTree& body_tree, const BodyCartesianPva& cartesian_pva,
+    std::array<Jacobian, MaxSize::kBodies>& jacobians);
+
 JacobianError jacobian_derivative(
     size_t body_index, const BodyTree& body_tree, const Jacobian& jacobian,
     const JointSpace& joint_velocity, Jacobian& jacobian_deriv);
@@ -2,9 +2,17 @@
 #ifndef FSB_KINEMATICS_REDUNDANCY_H
 #define FSB_KINEMATICS_REDUNDANCY_H
 
+#include <array>
+#include <cstddef>
+#include "fsb_configuration.h"
+#include "fsb_inverse_kinematics.h"
 #include "fsb_joint.h"
 #include "fsb_linalg.h"
+#include "fsb_linalg_fixed.h"
 #include "fsb_jacobian.h"
+#include "fsb_motion.h"
+#include "fsb_types.h"
+#include "fsb_work.h"
 
 namespace fsb
 {
@@ -31,6 +39,9 @@ struct JointLimits;
  * \f]
  * where \f$ \mathbf{J} = \mathbf{U} \mathbf{\Sigma} \mathbf{V}^T \f$ is the SVD decomposition.
  *
+ * If the Jacobi decomposition does not converge, the LAPACK fallback queries its workspace and
+ * uses a work array on the stack. Real-time callers use the overload with plans and work array.
+ *
  * @param[in]  jacobian         Input Jacobian matrix \f$ \mathbf{J} \f$
  * @param[out] inverse_jacobian Output pseudoinverse of the Jacobian \f$ \mathbf{J}^{+} \f$
  * @param[in]  dofs             Number of degrees of freedom (columns in Jacobian)
@@ -39,6 +50,20 @@ struct JointLimits;
 FsbLinalgErrorType
 jacobian_pseudoinverse(const Jacobian& jacobian, Jacobian& inverse_jacobian, size_t dofs);
 
+/**
+ * @brief Computes the pseudoinverse of a Jacobian matrix with caller provided plans and work array
+ *
+ * @param[in]  jacobian         Input Jacobian matrix \f$ \mathbf{J} \f$
+ * @param[out] inverse_jacobian Output pseudoinverse of the Jacobian \f$ \mathbf{J}^{+} \f$
+ * @param[in]  dofs             Number of degrees of freedom (columns in Jacobian)
+ * @param[in]  plans            LAPACK plans created by @c jacobian_linalg_plans_create
+ * @param[in,out] work          Work array, allocations are released on return
+ * @return                      Linear algebra error code
+ */
+FsbLinalgErrorType jacobian_pseudoinverse(
+    const Jacobian& jacobian, Jacobian& inverse_jacobian, size_t dofs,
+    const JacobianLinalgPlans& plans, LinalgWork& work);
+
 /**
  * @brief Computes nullspace motion using the Jacobian and its pseudoinverse
  *
@@ -73,6 +98,9 @@ JointSpace compute_nullspace_motion(
  *
  * @brief Computes nullspace motion by least squares solution without explicit pseudoinverse
  *
+ * Uses @c inverse_velocity_kinematics, real-time callers use the overload with plans and work
+ * array.
+ *
  * @param[in] jacobian          Input Jacobian matrix \f$ \mathbf{J} \f$
  * @param[in] joint_motion      Input joint motion vector \f$ \dot{\mathbf{q}} \f$ to project into
  * nullspace
@@ -83,6 +111,22 @@ JointSpace compute_nullspace_motion(
 JointSpace
 compute_nullspace_motion(const Jacobian& jacobian, const JointSpace& joint_motion, size_t dofs);
 
+/**
+ * @brief Computes nullspace motion by least squares solution with caller provided plans and work array
+ *
+ * @param[in] jacobian          Input Jacobian matrix \f$ \mathbf{J} \f$
+ * @param[in] joint_motion      Input joint motion vector \f$ \dot{\mathbf{q}} \f$ to project into
+ * nullspace
+ * @param[in] dofs              Number of degrees of freedom (elements in joint velocity vector)
+ * @param[in] plans             LAPACK plans created by @c jacobian_linalg_plans_create
+ * @param[in,out] work          Work array, allocations are released on return
+ *
+ * @return                      Joint motion vector in the nullspace \f$ \dot{\mathbf{q}}_{null} \f$
+ */
+JointSpace compute_nullspace_motion(
+    const Jacobian& jacobian, const JointSpace& joint_motion, size_t dofs,
+    const JacobianLinalgPlans& plans, LinalgWork& work);
+
 /**
  * @brief Joint limit avoidance objective function
  *
@@ -109,6 +153,209 @@ JointSpace joint_limit_avoidance_objective(
     const JointSpacePosition& joint_positions, const JointLimits& joint_limits, size_t dofs,
     double gain = 0.1);
 
+/**
+ * @brief Singular value decomposition of a Jacobian warm-started across control cycles
+ *
+ * Uses the one-sided Jacobi decomposition @c linalg_fixed_svd. The right singular vectors of the
+ * last update are the initial rotation of the next update with the same number of degrees of
+ * freedom, so a slowly changing Jacobian converges in one or two sweeps.
+ */
+class JacobianSvd
+{
+public:
+    /**
+     * @brief Discard warm start, next update starts from identity rotation
+     */
+    void reset();
+
+    /**
+     * @brief Decompose Jacobian \f$ \mathbf{J} = \mathbf{U} \mathbf{\Sigma} \mathbf{V}^T \f$
+     *
+     * @param jacobian Jacobian matrix
+     * @param dofs Number of degrees of freedom (columns in Jacobian)
+     * @return @c EFSB_LAPACK_ERROR_CONVERGE if Jacobi iteration did not converge
+     */
+    FsbLinalgErrorType update(const Jacobian& jacobian, size_t dofs);
+
+    /**
+     * @brief Singular values only, for manipulability monitoring
+     *
+     * Singular vectors and warm start rotation are kept from the last call to @c update.
+     *
+     * @param jacobian Jacobian matrix
+     * @param dofs Number of degrees of freedom (columns in Jacobian)
+     * @return @c EFSB_LAPACK_ERROR_CONVERGE if Jacobi iteration did not converge
+     */
+    FsbLinalgErrorType update_singular_values(const Jacobian& jacobian, size_t dofs);
+
+    /**
+     * @brief Damped pseudoinverse from last @c update
+     *
+     * Singular values \f$ \sigma \f$ are inverted as \f$ \sigma / (\sigma^2 + \lambda) \f$. With zero
+     * damping this is the Moore-Penrose pseudoinverse where singular values below @p tolerance are
+     * treated as zero.
+     *
+     * @param[in] damping Damping \f$ \lambda \f$
+     * @param[in] tolerance Smallest singular value that is inverted
+     * @param[out] inverse_jacobian Pseudoinverse (dofs x 6)
+     */
+    void pseudoinverse(Real damping, Real tolerance, Jacobian& inverse_jacobian) const;
+
+    /**
+     * @brief Get singular values in descending order
+     * @return Singular values (dofs)
+     */
+    [[nodiscard]] const JointSpace& get_singular_values() const
+    {
+        return m_singular_values;
+    }
+
+    /**
+     * @brief Get manipulability, the product of the nonzero singular values
+     * @return Manipulability measure \f$ \sqrt{\det(\mathbf{J} \mathbf{J}^T)} \f$
+     */
+    [[nodiscard]] Real get_manipulability() const;
+
+    /**
+     * @brief Get number of Jacobi sweeps of last update
+     * @return Number of sweeps
+     */
+    [[nodiscard]] size_t get_sweeps() const
+    {
+        return m_sweeps;
+    }
+
+private:
+    size_t      m_dofs = 0U;
+    size_t      m_sweeps = 0U;
+    bool        m_warm = false;
+    JointSpace  m_singular_values = {};
+    Jacobian    m_left = {}; ///< Left singular vectors U (6 x dofs)
+    JointMatrix m_right = {}; ///< Right singular vectors V (dofs x dofs)
+};
+
+/**
+ * @brief Maximum number of prioritized tasks of the task priority controller
+ */
+constexpr size_t kTaskPriorityMaxTasks = 4U;
+
+/**
+ * @brief Maximum number of rows of a task, a Cartesian task or a joint task on all joints
+ */
+constexpr size_t kTaskPriorityMaxRows = (MaxSize::kDofs > FSB_CART_SIZE) ? MaxSize::kDofs : FSB_CART_SIZE;
+
+/**
+ * @brief Length of LAPACK Cholesky work of the task priority controller, only used for more task
+ * rows than the fixed size solver supports
+ */
+constexpr size_t kTaskPriorityCholeskyWork
+    = (kTaskPriorityMaxRows > kLinalgFixedMaxDim) ? (kTaskPriorityMaxRows * kTaskPriorityMaxRows) : 1U;
+
+/**
+ * @brief Prioritized differential inverse kinematics controller
+ *
+ * Stacks velocity tasks in order of priority and resolves them by recursive nullspace projection.
+ * For task \f$ k \f$ with matrix \f$ \mathbf{J}_k \f$ and desired velocity \f$ \dot{\mathbf{x}}_k \f$:
+ * \f[
+ *    \hat{\mathbf{J}}_k = \mathbf{J}_k \mathbf{N}_{k-1}, \quad
+ *    \dot{\mathbf{q}}_k = \dot{\mathbf{q}}_{k-1}
+ *    + \hat{\mathbf{J}}_k^{\#} (\dot{\mathbf{x}}_k - \mathbf{J}_k \dot{\mathbf{q}}_{k-1}), \quad
+ *    \mathbf{N}_k = \mathbf{N}_{k-1} - \hat{\mathbf{J}}_k^{\#} \hat{\mathbf{J}}_k
+ * \f]
+ * with \f$ \mathbf{N}_0 = \mathbf{I} \f$ and the damped pseudoinverse
+ * \f$ \hat{\mathbf{J}}^{\#} = \hat{\mathbf{J}}^T (\hat{\mathbf{J}} \hat{\mathbf{J}}^T + \lambda \mathbf{I})^{-1} \f$.
+ *
+ * Each task matrix is factored once per cycle and the factor gives both the task velocity and the
+ * nullspace update. All workspace is held by the controller, so a cycle does not allocate.
+ *
+ * Usage per control cycle: @c reset, add tasks from highest to lowest priority, @c solve.
+ */
+class TaskPriorityController
+{
+public:
+    /**
+     * @brief Remove all tasks
+     *
+     * @param[in] dofs Number of degrees of freedom
+     */
+    void reset(size_t dofs);
+
+    /**
+     * @brief Add Cartesian velocity task, such as end-effector pose tracking
+     *
+     * @param[in] jacobian Task Jacobian
+     * @param[in] cart_velocity Desired Cartesian velocity
+     * @param[in] damping Damping \f$ \lambda \f$ added to the task Gram matrix, may be zero for a
+     * task of full row rank
+     * @return false if the maximum number of tasks is reached
+     */
+    bool add_cartesian_task(const Jacobian& jacobian, const MotionVector& cart_velocity, Real damping = 1.0e-6);
+
+    /**
+     * @brief Add joint velocity task on all joints
+     *
+     * Used for posture tracking or joint limit avoidance from @c joint_limit_avoidance_objective,
+     * usually at lowest priority.
+     *
+     * @param[in] joint_velocity Desired joint velocity
+     * @param[in] damping Damping \f$ \lambda \f$ added to the task Gram matrix, must be positive
+     * if higher priority tasks constrain any joint motion
+     * @return false if the maximum number of tasks is reached
+     */
+    bool add_joint_task(const JointSpace& joint_velocity, Real damping = 1.0e-6);
+
+    /**
+     * @brief Compute joint velocity of prioritized tasks
+     *
+     * @param[out] joint_velocity Joint velocity, on error the velocity of the tasks solved before
+     * the failing task
+     * @return Linear algebra error code, @c EFSB_LAPACK_ERROR_INPUT for invalid number of degrees of
+     * freedom, @c EFSB_LAPACK_NOT_POSITIVE_DEFINITE if a task is singular without damping
+     */
+    FsbLinalgErrorType solve(JointSpace& joint_velocity);
+
+    /**
+     * @brief Get number of tasks
+     * @return Number of tasks
+     */
+    [[nodiscard]] size_t get_num_tasks() const
+    {
+        return m_num_tasks;
+    }
+
+    /**
+     * @brief Get nullspace projector of all tasks after @c solve
+     *
+     * @return Projector (dofs x dofs) onto joint motion that does not affect any task
+     */
+    [[nodiscard]] const JointMatrix& get_nullspace_projector() const
+    {
+        return m_nullspace;
+    }
+
+private:
+    /**
+     * @brief Velocity task with matrix (rows x dofs) in column-major order
+     */
+    struct Task
+    {
+        size_t                                                  rows = 0U;
+        std::array<Real, kTaskPriorityMaxRows * MaxSize::kDofs> matrix = {};
+        std::array<Real, kTaskPriorityMaxRows>                  velocity = {};
+        Real                                                    damping = 0.0;
+    };
+
+    std::array<Task, kTaskPriorityMaxTasks>                        m_tasks = {};
+    size_t                                                         m_num_tasks = 0U;
+    size_t                                                         m_dofs = 0U;
+    JointMatrix                                                    m_nullspace = {}; ///< Nullspace projector N (dofs x dofs)
+    std::array<Real, kTaskPriorityMaxRows * MaxSize::kDofs>        m_projected = {}; ///< Projected task matrix J N (rows x dofs)
+    std::array<Real, kTaskPriorityMaxRows * kTaskPriorityMaxRows>  m_gram = {}; ///< Damped Gram matrix (rows x rows)
+    std::array<Real, kTaskPriorityMaxRows * (MaxSize::kDofs + 1U)> m_rhs = {}; ///< Task residual and columns of J N (rows x (dofs + 1))
+    std::array<Real, kTaskPriorityMaxRows * (MaxSize::kDofs + 1U)> m_solution = {}; ///< Gram matrix solution of @c m_rhs
+    std::array<Real, kTaskPriorityCholeskyWork>                    m_cholesky_work = {};
+};
+
 /**
  * @}
  */
@@ -2,6 +2,8 @@
 #ifndef FSB_KINEMATICS_H
 #define FSB_KINEMATICS_H
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include "fsb_body.h"
 #include "fsb_body_tree.h"
@@ -38,6 +40,314 @@ enum class ForwardKinematicsOption : uint8_t
     POSE_VELOCITY_ACCELERATION = 2
 };
 
+/**
+ * @brief Joint kind resolved for a kinematic program operation
+ */
+enum class KinematicOpKind : uint8_t
+{
+    /**
+     * @brief Constant parent to child transform
+     */
+    FIXED = 0,
+    /**
+     * @brief Rotation about a single axis
+     */
+    REVOLUTE = 1,
+    /**
+     * @brief Translation along a single axis
+     */
+    PRISMATIC = 2,
+    /**
+     * @brief Rotation from a unit quaternion
+     */
+    SPHERICAL = 3,
+    /**
+     * @brief Rotation from a unit quaternion and translation
+     */
+    CARTESIAN = 4,
+    /**
+     * @brief Identity transform for joint types without kinematics
+     */
+    IDENTITY = 5
+};
+
+/**
+ * @brief Single body update in a compiled kinematic program
+ */
+struct KinematicOp
+{
+    /**
+     * @brief Resolved joint kind
+     */
+    KinematicOpKind kind = KinematicOpKind::IDENTITY;
+    /**
+     * @brief Index of parent body
+     */
+    size_t parent_index = 0U;
+    /**
+     * @brief Index of child body
+     */
+    size_t child_index = 0U;
+    /**
+     * @brief Index of first joint coordinate
+     */
+    size_t coord_index = 0U;
+    /**
+     * @brief Index of first joint degree of freedom
+     */
+    size_t dof_index = 0U;
+    /**
+     * @brief Number of joint coordinates affecting kinematics
+     */
+    size_t num_coordinates = 0U;
+    /**
+     * @brief Number of joint degrees of freedom affecting kinematics
+     */
+    size_t num_dofs = 0U;
+    /**
+     * @brief Joint direction sign, -1 for reversed joints
+     */
+    Real sign = 1.0;
+    /**
+     * @brief Unit joint axis in joint frame for revolute and prismatic joints
+     */
+    Vec3 axis = {};
+    /**
+     * @brief Signed angular motion per unit joint velocity in parent frame
+     */
+    Vec3 angular_axis = {};
+    /**
+     * @brief Signed linear motion per unit joint velocity in parent frame
+     */
+    Vec3 linear_axis = {};
+    /**
+     * @brief Constant parent to joint transform
+     */
+    Transform parent_joint_transform = {};
+};
+
+/**
+ * @brief Body tree compiled into a flat list of body updates in propagation order
+ */
+struct KinematicProgram
+{
+    /**
+     * @brief Program operations, one per non-base body
+     */
+    std::array<KinematicOp, MaxSize::kBodies> op;
+    /**
+     * @brief Number of operations in program
+     */
+    size_t num_ops = 0U;
+    /**
+     * @brief Number of bodies including base
+     */
+    size_t num_bodies = 0U;
+};
+
+/**
+ * @brief World frame motion axes and origin of a single joint
+ */
+struct JointAxes
+{
+    /**
+     * @brief Resolved joint kind
+     */
+    KinematicOpKind kind = KinematicOpKind::IDENTITY;
+    /**
+     * @brief Index of parent body
+     */
+    size_t parent_index = 0U;
+    /**
+     * @brief Index of first joint degree of freedom
+     */
+    size_t dof_index = 0U;
+    /**
+     * @brief Joint origin in world frame
+     */
+    Vec3 origin = {};
+    /**
+     * @brief Joint motion axes in world frame
+     *
+     * Revolute and prismatic joints use the first axis with the joint direction sign applied.
+     * Spherical and Cartesian joints use the three axes of the joint frame.
+     */
+    std::array<Vec3, 3U> axis = {};
+};
+
+/**
+ * @brief World frame joint axes of all bodies, indexed by child body
+ */
+struct BodyJointAxes
+{
+    /**
+     * @brief Joint axes of the parent joint of each body
+     */
+    std::array<JointAxes, MaxSize::kBodies> body;
+    /**
+     * @brief Number of bodies including base
+     */
+    size_t num_bodies = 0U;
+};
+
+/**
+ * @brief Cached forward kinematics state for incremental updates
+ */
+struct KinematicsState
+{
+    /**
+     * @brief Cached Cartesian pose, velocity and acceleration of all bodies
+     */
+    BodyCartesianPva body_cartesian = {};
+    /**
+     * @brief Joint values of cached result
+     */
+    JointPva joint_pva = {};
+    /**
+     * @brief Base pose, velocity and acceleration of cached result
+     */
+    CartesianPva base_pva = {};
+    /**
+     * @brief Compute option of cached result
+     */
+    ForwardKinematicsOption opt = ForwardKinematicsOption::POSE;
+    /**
+     * @brief Cached result is valid
+     */
+    bool valid = false;
+    /**
+     * @brief Number of bodies recomputed in the last update
+     */
+    size_t num_updated = 0U;
+};
+
+/**
+ * @brief Compile body tree into a kinematic program
+ *
+ * @param[in] body_tree Body tree with body and joint definitions
+ * @param[out] program Compiled kinematic program
+ * @return True on success, false if the body tree is inconsistent
+ */
+bool kinematic_program_compile(const BodyTree& body_tree, KinematicProgram& program);
+
+/**
+ * @brief Compile the path from the base to a single body into a kinematic program
+ *
+ * The program only updates the ancestors of the target body and the target body itself.
+ *
+ * @param[in] body_tree Body tree with body and joint definitions
+ * @param[in] target_body Index of last body in chain
+ * @param[out] program Compiled kinematic program of chain
+ * @return True on success, false if target body is not in tree or the body tree is inconsistent
+ */
+bool kinematic_program_compile_chain(
+    const BodyTree& body_tree, size_t target_body, KinematicProgram& program);
+
+/**
+ * @brief Compute parent to child transform of a single program operation
+ *
+ * @param[in] kin_op Program operation
+ * @param[in] joint_position Joint position
+ * @return Parent to child transform
+ */
+Transform kinematic_op_transform(const KinematicOp& kin_op, const JointSpacePosition& joint_position);
+
+/**
+ * @brief Compute parent to child motion of a single program operation
+ *
+ * @param[in] kin_op Program operation
+ * @param[in] joint_motion Joint velocity or acceleration
+ * @return Parent to child velocity or acceleration in parent frame
+ */
+MotionVector kinematic_op_motion(const KinematicOp& kin_op, const JointSpace& joint_motion);
+
+/**
+ * @brief Compute forward kinematics for all bodies from a compiled kinematic program
+ *
+ * Produces the same result as @c forward_kinematics for the body tree the program was compiled from.
+ *
+ * @param[in] program Compiled kinematic program
+ * @param[in] joint_pva Joint position, velocity and acceleration
+ * @param[in] base_pva Base pose, velocity and acceleration
+ * @param[in] opt Compute options
+ * @param[out] body_cartesian Output Cartesian pose, velocity and acceleration of all bodies
+ */
+void forward_kinematics_program(
+    const KinematicProgram& program, const JointPva& joint_pva, const CartesianPva& base_pva,
+    ForwardKinematicsOption opt, BodyCartesianPva& body_cartesian);
+
+/**
+ * @brief Compute forward kinematics and world frame joint axes from a compiled kinematic program
+ *
+ * The joint axes are a by-product of the forward pass and are used to assemble Jacobians without
+ * recomputing joint frames.
+ *
+ * @param[in] program Compiled kinematic program
+ * @param[in] joint_pva Joint position, velocity and acceleration
+ * @param[in] base_pva Base pose, velocity and acceleration
+ * @param[in] opt Compute options
+ * @param[out] body_cartesian Output Cartesian pose, velocity and acceleration of all bodies
+ * @param[out] joint_axes Output world frame joint axes of all bodies
+ */
+void forward_kinematics_program_axes(
+    const KinematicProgram& program, const JointPva& joint_pva, const CartesianPva& base_pva,
+    ForwardKinematicsOption opt, BodyCartesianPva& body_cartesian, BodyJointAxes& joint_axes);
+
+/**
+ * @brief Compute world frame joint axes from known body poses
+ *
+ * @param[in] program Compiled kinematic program
+ * @param[in] body_cartesian Cartesian pose of all bodies from forward kinematics
+ * @param[out] joint_axes Output world frame joint axes of all bodies
+ */
+void kinematic_program_joint_axes(
+    const KinematicProgram& program, const BodyCartesianPva& body_cartesian,
+    BodyJointAxes& joint_axes);
+
+/**
+ * @brief Compute forward kinematics only for bodies on the path from the base to a target body
+ *
+ * Bodies that are not ancestors of the target body are not modified. For repeated evaluation of
+ * the same chain, compile the chain once with @c kinematic_program_compile_chain and use
+ * @c forward_kinematics_program.
+ *
+ * @param[in] body_tree Body tree with body and joint definitions
+ * @param[in] joint_pva Joint position, velocity and acceleration
+ * @param[in] base_pva Base pose, velocity and acceleration
+ * @param[in] target_body Index of last body in chain
+ * @param[in] opt Compute options
+ * @param[out] body_cartesian Output Cartesian pose, velocity and acceleration of chain bodies
+ * @return True on success, false if target body is not in tree
+ */
+bool forward_kinematics_chain(
+    const BodyTree& body_tree, const JointPva& joint_pva, const CartesianPva& base_pva,
+    size_t target_body, ForwardKinematicsOption opt, BodyCartesianPva& body_cartesian);
+
+/**
+ * @brief Invalidate cached forward kinematics so the next update recomputes all bodies
+ *
+ * @param[in,out] state Cached forward kinematics state
+ */
+void kinematics_state_reset(KinematicsState& state);
+
+/**
+ * @brief Update cached forward kinematics for changed joints only
+ *
+ * Joint values are compared exactly with the values of the cached result. Only bodies in the
+ * subtrees below joints with changed values are recomputed, all other bodies keep their cached
+ * values. A change of base motion or a request for more data than the cached option recomputes
+ * all bodies.
+ *
+ * @param[in] program Compiled kinematic program
+ * @param[in] joint_pva Joint position, velocity and acceleration
+ * @param[in] base_pva Base pose, velocity and acceleration
+ * @param[in] opt Compute options
+ * @param[in,out] state Cached forward kinematics state with updated Cartesian data of all bodies
+ */
+void forward_kinematics_incremental(
+    const KinematicProgram& program, const JointPva& joint_pva, const CartesianPva& base_pva,
+    ForwardKinematicsOption opt, KinematicsState& state);
+
 /**
  * @brief Compute forward kinematics for all bodies in tree
  *
@@ -63,6 +373,20 @@ JointSpacePosition joint_add_offset(
     const BodyTree& body_tree, const JointSpacePosition& joint_position,
     const JointSpace& joint_offset);
 
+/**
+ * @brief Add offset to joint position in place for joints in a kinematic program
+ *
+ * Only coordinates of joints in the program are modified, e.g. the joints of a chain compiled by
+ * @c kinematic_program_compile_chain.
+ *
+ * @param[in] program Compiled kinematic program
+ * @param[in] joint_offset Joint offset
+ * @param[in,out] joint_position Joint position with offset added
+ */
+void kinematic_program_add_offset(
+    const KinematicProgram& program, const JointSpace& joint_offset,
+    JointSpacePosition& joint_position);
+
 /**
  * @brief Get difference between joint positions
  *
@@ -0,0 +1,180 @@
+#ifndef FSB_KINEMATICS_BATCH_H
+#define FSB_KINEMATICS_BATCH_H
+
+#include <array>
+#include <cstddef>
+#include "fsb_body_tree.h"
+#include "fsb_configuration.h"
+#include "fsb_joint.h"
+#include "fsb_kinematics.h"
+#include "fsb_motion.h"
+#include "fsb_types.h"
+
+namespace fsb
+{
+
+/**
+ * @defgroup KinematicsBatch Batched Forward Kinematics
+ * @brief Forward kinematics for many joint configurations at once
+ *
+ * Data is stored in structure-of-arrays layout where each scalar component holds one value per
+ * configuration (lane). The inner loops run over a fixed number of lanes so the compiler can
+ * vectorize them with the instruction set enabled for the target (e.g. SSE2, AVX2 or NEON). Joint
+ * angles are evaluated with polynomial sine and cosine, since the library functions are not
+ * vectorized.
+ *
+ * Any number of configurations can be computed with the overload taking an array of joint
+ * positions, which splits them into blocks of @c kKinematicsBatchSize lanes.
+ *
+ * @{
+ */
+
+/**
+ * @brief Number of joint configurations processed per batch
+ */
+constexpr size_t kKinematicsBatchSize = 8U;
+
+/**
+ * @brief One value per configuration in batch
+ */
+using BatchLanes = std::array<Real, kKinematicsBatchSize>;
+
+/**
+ * @brief Batch of 3D vectors in structure-of-arrays layout
+ */
+struct Vec3Batch
+{
+    /** @brief X components */
+    BatchLanes x;
+    /** @brief Y components */
+    BatchLanes y;
+    /** @brief Z components */
+    BatchLanes z;
+};
+
+/**
+ * @brief Batch of quaternions in structure-of-arrays layout
+ */
+struct QuaternionBatch
+{
+    /** @brief Scalar components */
+    BatchLanes qw;
+    /** @brief X components */
+    BatchLanes qx;
+    /** @brief Y components */
+    BatchLanes qy;
+    /** @brief Z components */
+    BatchLanes qz;
+};
+
+/**
+ * @brief Batch of rigid body transforms
+ */
+struct TransformBatch
+{
+    /** @brief Rotations */
+    QuaternionBatch rotation;
+    /** @brief Translations */
+    Vec3Batch translation;
+};
+
+/**
+ * @brief Batch of joint positions in generalized coordinates
+ */
+struct JointSpacePositionBatch
+{
+    /**
+     * @brief Joint position lanes for each generalized coordinate
+     */
+    std::array<BatchLanes, MaxSize::kCoordinates> q;
+};
+
+/**
+ * @brief Batch of Cartesian poses for all bodies in tree
+ */
+struct BodyTransformBatch
+{
+    /**
+     * @brief Pose lanes for each body
+     */
+    std::array<TransformBatch, MaxSize::kBodies> body;
+};
+
+/**
+ * @brief Compute forward kinematics pose for a batch of joint configurations
+ *
+ * All lanes are computed, unused lanes should be filled with any valid joint position.
+ *
+ * @param[in] program Kinematic program compiled from body tree
+ * @param[in] joint_position Joint positions, one configuration per lane
+ * @param[in] base_pose Base pose common to all configurations
+ * @param[out] body_pose Output Cartesian pose of bodies updated by program, one configuration per
+ * lane
+ */
+void forward_kinematics_batch(
+    const KinematicProgram& program, const JointSpacePositionBatch& joint_position,
+    const Transform& base_pose, BodyTransformBatch& body_pose);
+
+/**
+ * @brief Compute forward kinematics pose for a batch of joint configurations of a body tree
+ *
+ * Compiles a kinematic program on every call, use the overload with a compiled program in loops.
+ *
+ * @param[in] body_tree Body tree with body and joint definitions
+ * @param[in] joint_position Joint positions, one configuration per lane
+ * @param[in] base_pose Base pose common to all configurations
+ * @param[out] body_pose Output Cartesian pose of all bodies, one configuration per lane
+ */
+void forward_kinematics_batch(
+    const BodyTree& body_tree, const JointSpacePositionBatch& joint_position,
+    const Transform& base_pose, BodyTransformBatch& body_pose);
+
+/**
+ * @brief Compute forward kinematics pose of a body for any number of joint configurations
+ *
+ * Configurations are computed in blocks of @c kKinematicsBatchSize lanes, the last block is padded
+ * with the last configuration. A program from @c kinematic_program_compile_chain only computes the
+ * bodies between base and body.
+ *
+ * @param[in] program Kinematic program compiled from body tree
+ * @param[in] joint_position Joint positions (num_configurations)
+ * @param[in] num_configurations Number of joint configurations
+ * @param[in] base_pose Base pose common to all configurations
+ * @param[in] body_index Index of body in tree
+ * @param[out] body_pose Output Cartesian pose of body (num_configurations)
+ * @return false if body index is not in program
+ */
+bool forward_kinematics_batch(
+    const KinematicProgram& program, const JointSpacePosition joint_position[],
+    size_t num_configurations, const Transform& base_pose, size_t body_index,
+    Transform body_pose[]);
+
+/**
+ * @brief Set joint position of a single lane in batch
+ *
+ * @param[in] lane Lane index, must be less than @c kKinematicsBatchSize
+ * @param[in] joint_position Joint position of configuration
+ * @param[in,out] joint_position_batch Batch of joint positions
+ */
+void batch_set_joint_position(
+    size_t lane, const JointSpacePosition& joint_position,
+    JointSpacePositionBatch& joint_position_batch);
+
+/**
+ * @brief Get body pose of a single lane in batch
+ *
+ * @param[in] body_pose Batch of body poses
+ * @param[in] body_index Body index in tree
+ * @param[in] lane Lane index, must be less than @c kKinematicsBatchSize
+ * @return Body pose of configuration
+ */
+Transform
+batch_get_body_pose(const BodyTransformBatch& body_pose, size_t body_index, size_t lane);
+
+/**
+ * @}
+ */
+
+} // namespace fsb
+
+#endif
@@ -5,6 +5,7 @@
 
 #ifdef __cplusplus
 #include <array>
+#include "fsb_work.h"
 #endif
 
 #include "openblas/lapack.h"
@@ -65,6 +66,73 @@ typedef enum FsbLapackErrorType
     EFSB_LAPACK_ERROR_NOT_FULL_RANK = 7, ///< Matrix is not full rank
 } FsbLinalgErrorType;
 
+/**
+ * @brief Workspace plan for SVD of a fixed matrix shape
+ *
+ * Stores the optimal LAPACK workspace size so repeated decompositions of the same shape skip the
+ * workspace query.
+ */
+typedef struct FsbLinalgSvdPlan
+{
+    size_t rows; ///< Rows of A
+    size_t cols; ///< Columns of A
+    bool u_full; ///< Full U matrix
+    bool v_full; ///< Full V matrix
+    size_t lwork; ///< Optimal LAPACK workspace length
+    size_t work_len; ///< Work buffer length required by fsb_linalg_svd_execute
+} FsbLinalgSvdPlan;
+
+/**
+ * @brief Workspace plan for pseudoinverse of a fixed matrix shape
+ */
+typedef struct FsbLinalgPseudoinversePlan
+{
+    FsbLinalgSvdPlan svd; ///< Plan of the underlying SVD
+    size_t work_len; ///< Work buffer length required by fsb_linalg_pseudoinverse_execute
+} FsbLinalgPseudoinversePlan;
+
+/**
+ * @brief Workspace plan for least squares solve of a fixed problem shape
+ */
+typedef struct FsbLinalgLeastSquaresPlan
+{
+    size_t rows; ///< Rows of A
+    size_t columns; ///< Columns of A
+    size_t nrhs; ///< Number of right-hand side vectors
+    size_t lwork; ///< Optimal LAPACK workspace length
+    size_t work_len; ///< Work buffer length required by fsb_linalg_leastsquares_execute
+} FsbLinalgLeastSquaresPlan;
+
+/**
+ * @brief Create SVD plan by querying the optimal workspace once
+ *
+ * @param[in]  rows    rows of A
+ * @param[in]  cols    columns of A
+ * @param[in]  u_full  Boolean for full U matrix
+ * @param[in]  v_full  Boolean for full V matrix
+ * @param[out] plan    SVD plan
+ * @return Error code
+ */
+FsbLinalgErrorType fsb_linalg_svd_plan(size_t rows, size_t cols, bool u_full, bool v_full, FsbLinalgSvdPlan* plan);
+
+/**
+ * @brief SVD decomposition with precomputed workspace plan
+ *
+ * Output dimensions are as for fsb_linalg_svd.
+ *
+ * @param[in]  plan    SVD plan
+ * @param[in]  mat     matrix to perform SVD
+ * @param[in]  work_len    buffer length, at least plan->work_len
+ * @param[in,out]  work    buffer
+ * @param[out] unitary_u   Unitary matrix U
+ * @param[out] sing_val    Singular values array S
+ * @param[out] unitary_vt  Transpose of unitary matrix V
+ * @return Error code
+ */
+FsbLinalgErrorType fsb_linalg_svd_execute(
+    const FsbLinalgSvdPlan* plan, const double_t mat[], size_t work_len, double_t work[],
+    double_t unitary_u[], double_t sing_val[], double_t unitary_vt[]);
+
 /**
  * @brief SVD decomposition
  *
@@ -225,6 +293,55 @@ FsbLinalgErrorType fsb_linalg_leastsquares_solve(
     const double_t mat[], size_t rows, size_t columns, const double_t b_vec[], size_t nrhs,
     size_t work_len, double_t work[], double_t x_vec[]);
 
+/**
+ * @brief Create pseudoinverse plan by querying the optimal SVD workspace once
+ *
+ * @param[in]  rows     Number of rows in matrix
+ * @param[in]  columns  Number of columns in matrix
+ * @param[out] plan     Pseudoinverse plan
+ * @return Error code
+ */
+FsbLinalgErrorType fsb_linalg_pseudoinverse_plan(size_t rows, size_t columns, FsbLinalgPseudoinversePlan* plan);
+
+/**
+ * @brief Pseudoinverse with precomputed workspace plan
+ *
+ * @param plan Pseudoinverse plan
+ * @param mat Input matrix (rows x columns)
+ * @param work_len Length of work vector, at least plan->work_len
+ * @param work Work vector
+ * @param inv_mat Output inverse matrix (columns x rows)
+ * @return Error code
+ */
+FsbLinalgErrorType fsb_linalg_pseudoinverse_execute(
+    const FsbLinalgPseudoinversePlan* plan, const double_t mat[], size_t work_len, double_t work[], double_t inv_mat[]);
+
+/**
+ * @brief Create least squares plan by querying the optimal workspace once
+ *
+ * @param[in]  rows     Number of rows in A
+ * @param[in]  columns  Number of columns in A
+ * @param[in]  nrhs     Number of right-hand side vectors
+ * @param[out] plan     Least squares plan
+ * @return Error code
+ */
+FsbLinalgErrorType fsb_linalg_leastsquares_plan(size_t rows, size_t columns, size_t nrhs, FsbLinalgLeastSquaresPlan* plan);
+
+/**
+ * @brief Least squares solve with precomputed workspace plan
+ *
+ * @param plan Least squares plan
+ * @param mat Input matrix A (rows x columns)
+ * @param b_vec Right-hand side matrix B (rows x nrhs)
+ * @param work_len Length of work vector, at least plan->work_len
+ * @param work Work vector
+ * @param x_vec Output solution matrix X (columns x nrhs)
+ * @return Error code
+ */
+FsbLinalgErrorType fsb_linalg_leastsquares_execute(
+    const FsbLinalgLeastSquaresPlan* plan, const double_t mat[], const double_t b_vec[],
+    size_t work_len, double_t work[], double_t x_vec[]);
+
 /**
  * @brief Example demonstrating DGELS (least squares solver) usage
  */
@@ -358,4 +475,94 @@ inline FsbLinalgErrorType fsb_linalg_leastsquares_solve_array(
         x_vec.data());
 }
 
+template <size_t Capacity>
+inline FsbLinalgErrorType fsb_linalg_svd_execute_work(
+    const FsbLinalgSvdPlan& plan, const double_t mat[], fsb::WorkArray<double_t, Capacity>& work,
+    double_t unitary_u[], double_t sing_val[], double_t unitary_vt[])
+{
+    fsb::WorkFrame<double_t, Capacity> frame(work);
+    fsb::WorkBlock<double_t> block = {};
+    FsbLinalgErrorType retval = EFSB_LAPACK_ERROR_MEMORY;
+    if (frame.allocate(plan.work_len, block) == fsb::WorkArrayStatus::SUCCESS)
+    {
+        retval = fsb_linalg_svd_execute(&plan, mat, block.size, block.data, unitary_u, sing_val, unitary_vt);
+    }
+    return retval;
+}
+
+template <size_t Capacity>
+inline FsbLinalgErrorType fsb_linalg_pseudoinverse_execute_work(
+    const FsbLinalgPseudoinversePlan& plan, const double_t mat[], fsb::WorkArray<double_t, Capacity>& work,
+    double_t inv_mat[])
+{
+    fsb::WorkFrame<double_t, Capacity> frame(work);
+    fsb::WorkBlock<double_t> block = {};
+    FsbLinalgErrorType retval = EFSB_LAPACK_ERROR_MEMORY;
+    if (frame.allocate(plan.work_len, block) == fsb::WorkArrayStatus::SUCCESS)
+    {
+        retval = fsb_linalg_pseudoinverse_execute(&plan, mat, block.size, block.data, inv_mat);
+    }
+    return retval;
+}
+
+template <size_t Capacity>
+inline FsbLinalgErrorType fsb_linalg_leastsquares_execute_work(
+    const FsbLinalgLeastSquaresPlan& plan, const double_t mat[], const double_t b_vec[],
+    fsb::WorkArray<double_t, Capacity>& work, double_t x_vec[])
+{
+    fsb::WorkFrame<double_t, Capacity> frame(work);
+    fsb::WorkBlock<double_t> block = {};
+    FsbLinalgErrorType retval = EFSB_LAPACK_ERROR_MEMORY;
+    if (frame.allocate(plan.work_len, block) == fsb::WorkArrayStatus::SUCCESS)
+    {
+        retval = fsb_linalg_leastsquares_execute(&plan, mat, b_vec, block.size, block.data, x_vec);
+    }
+    return retval;
+}
+
+template <size_t Capacity>
+inline FsbLinalgErrorType fsb_linalg_matrix_eig_work(
+    const double_t mat[], const size_t dim, fsb::WorkArray<double_t, Capacity>& work,
+    double_t val_real[], double_t val_imag[], double_t vec_real[], double_t vec_imag[])
+{
+    // workspace length is only known after query, lend the remaining work array
+    fsb::WorkFrame<double_t, Capacity> frame(work);
+    fsb::WorkBlock<double_t> block = {};
+    FsbLinalgErrorType retval = EFSB_LAPACK_ERROR_MEMORY;
+    if (frame.allocate(work.get_remaining(), block) == fsb::WorkArrayStatus::SUCCESS)
+    {
+        retval = fsb_linalg_matrix_eig(mat, dim, block.size, block.data, val_real, val_imag, vec_real, vec_imag);
+    }
+    return retval;
+}
+
+template <size_t Capacity>
+inline FsbLinalgErrorType fsb_linalg_sym_lt_eig_work(
+    const double_t mat[], const size_t dim, fsb::WorkArray<double_t, Capacity>& work, double_t val[], double_t vec[])
+{
+    fsb::WorkFrame<double_t, Capacity> frame(work);
+    fsb::WorkBlock<double_t> block = {};
+    FsbLinalgErrorType retval = EFSB_LAPACK_ERROR_MEMORY;
+    if (frame.allocate(work.get_remaining(), block) == fsb::WorkArrayStatus::SUCCESS)
+    {
+        retval = fsb_linalg_sym_lt_eig(mat, dim, block.size, block.data, val, vec);
+    }
+    return retval;
+}
+
+template <size_t Capacity>
+inline FsbLinalgErrorType fsb_linalg_cholesky_solve_work(
+    const double_t mat[], const double_t b_vec[], const size_t nrhs, const size_t dim,
+    fsb::WorkArray<double_t, Capacity>& work, double_t x_vec[])
+{
+    fsb::WorkFrame<double_t, Capacity> frame(work);
+    fsb::WorkBlock<double_t> block = {};
+    FsbLinalgErrorType retval = EFSB_LAPACK_ERROR_MEMORY;
+    if (frame.allocate(FSB_MAX(dim * dim, 1U), block) == fsb::WorkArrayStatus::SUCCESS)
+    {
+        retval = fsb_linalg_cholesky_solve(mat, b_vec, nrhs, dim, block.size, block.data, x_vec);
+    }
+    return retval;
+}
+
 #endif
@@ -0,0 +1,487 @@
+#ifndef FSB_LINALG_BATCH_H
+#define FSB_LINALG_BATCH_H
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include "fsb_linalg.h"
+#include "fsb_linalg_fixed.h"
+#include "fsb_types.h"
+
+namespace fsb
+{
+
+/**
+ * @defgroup LinearAlgebraBatch Batched Linear Algebra for Small Matrices
+ * @brief Many independent small problems of the same shape solved together
+ *
+ * Lane kernels store each matrix element as one value per problem (lane), so the inner loops run
+ * over a fixed number of lanes and the compiler can vectorize them across the batch with the
+ * instruction set enabled for the target. Factorizations do not branch on data, a lane that fails
+ * is flagged in its status and computed with a neutral pivot so it cannot disturb other lanes.
+ *
+ * Batch drivers take any number of problems in interleaved layout, where element @c i of problem
+ * @c k is at index <tt>i * count + k</tt> and matrix elements are column-major. Problems are
+ * processed in groups of @c kLinalgBatchSize lanes.
+ *
+ * @{
+ */
+
+/**
+ * @brief Number of problems processed per lane group
+ */
+constexpr size_t kLinalgBatchSize = 8U;
+
+/**
+ * @brief One value per problem in lane group
+ */
+using LinalgBatchLanes = std::array<Real, kLinalgBatchSize>;
+
+/**
+ * @brief Error code per problem in lane group
+ */
+using LinalgBatchStatus = std::array<FsbLinalgErrorType, kLinalgBatchSize>;
+
+/**
+ * @brief Combined error code of lane group
+ *
+ * @param status Error code per lane
+ * @return First error of any lane, @c EFSB_LAPACK_ERROR_NONE if all lanes succeeded
+ */
+inline FsbLinalgErrorType linalg_batch_status(const LinalgBatchStatus& status)
+{
+    auto result = EFSB_LAPACK_ERROR_NONE;
+    for (const FsbLinalgErrorType lane_status : status)
+    {
+        if (result == EFSB_LAPACK_ERROR_NONE)
+        {
+            result = lane_status;
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Cholesky factorization of symmetric positive definite matrices for all lanes
+ *
+ * Same layout and result as @c linalg_fixed_cholesky_factor per lane.
+ *
+ * @tparam Dim Matrix dimension
+ * @param[in,out] mat Input matrices (Dim x Dim lanes), output Cholesky factors in lower triangle
+ * @param[out] status @c EFSB_LAPACK_NOT_POSITIVE_DEFINITE for lanes whose matrix is not positive
+ * definite
+ */
+template <size_t Dim>
+inline void linalg_batch_cholesky_factor(LinalgBatchLanes mat[], LinalgBatchStatus& status)
+{
+    static_assert((Dim > 0U) && (Dim <= kLinalgFixedMaxDim), "Unsupported matrix dimension");
+    status.fill(EFSB_LAPACK_ERROR_NONE);
+    for (size_t col = 0U; col < Dim; ++col)
+    {
+        LinalgBatchLanes diag = mat[Dim * col + col];
+        for (size_t ind = 0U; ind < col; ++ind)
+        {
+            for (size_t lane = 0U; lane < kLinalgBatchSize; ++lane)
+            {
+                diag[lane] -= mat[Dim * ind + col][lane] * mat[Dim * ind + col][lane];
+            }
+        }
+        LinalgBatchLanes diag_inv = {};
+        for (size_t lane = 0U; lane < kLinalgBatchSize; ++lane)
+        {
+            const bool posdef = diag[lane] > 0.0;
+            const Real diag_sqrt = std::sqrt(posdef ? diag[lane] : 1.0);
+            status[lane] = posdef ? status[lane] : EFSB_LAPACK_NOT_POSITIVE_DEFINITE;
+            mat[Dim * col + col][lane] = diag_sqrt;
+            diag_inv[lane] = 1.0 / diag_sqrt;
+        }
+        for (size_t row = col + 1U; row < Dim; ++row)
+        {
+            LinalgBatchLanes value = mat[Dim * col + row];
+            for (size_t ind = 0U; ind < col; ++ind)
+            {
+                for (size_t lane = 0U; lane < kLinalgBatchSize; ++lane)
+                {
+                    value[lane] -= mat[Dim * ind + row][lane] * mat[Dim * ind + col][lane];
+                }
+            }
+            for (size_t lane = 0U; lane < kLinalgBatchSize; ++lane)
+            {
+                mat[Dim * col + row][lane] = value[lane] * diag_inv[lane];
+            }
+        }
+    }
+}
+
+/**
+ * @brief Solve linear systems with Cholesky factors for all lanes
+ *
+ * @tparam Dim Matrix dimension
+ * @param[in] chol Cholesky factors in lower triangle (Dim x Dim lanes)
+ * @param[in,out] x_vec Input right-hand side vectors, output solution vectors (Dim lanes)
+ */
+template <size_t Dim>
+inline void linalg_batch_cholesky_solve(const LinalgBatchLanes chol[], LinalgBatchLanes x_vec[])
+{
+    static_assert((Dim > 0U) && (Dim <= kLinalgFixedMaxDim), "Unsupported matrix dimension");
+    // L y = b
+    for (size_t row = 0U; row < Dim; ++row)
+    {
+        for (size_t ind = 0U; ind < row; ++ind)
+        {
+            for (size_t lane = 0U; lane < kLinalgBatchSize; ++lane)
+            {
+                x_vec[row][lane] -= chol[Dim * ind + row][lane] * x_vec[ind][lane];
+            }
+        }
+        for (size_t lane = 0U; lane < kLinalgBatchSize; ++lane)
+        {
+            x_vec[row][lane] /= chol[Dim * row + row][lane];
+        }
+    }
+    // L^T x = y
+    for (size_t row = Dim; row > 0U; --row)
+    {
+        const size_t r_ind = row - 1U;
+        for (size_t ind = row; ind < Dim; ++ind)
+        {
+            for (size_t lane = 0U; lane < kLinalgBatchSize; ++lane)
+            {
+                x_vec[r_ind][lane] -= chol[Dim * r_ind + ind][lane] * x_vec[ind][lane];
+            }
+        }
+        for (size_t lane = 0U; lane < kLinalgBatchSize; ++lane)
+        {
+            x_vec[r_ind][lane] /= chol[Dim * r_ind + r_ind][lane];
+        }
+    }
+}
+
+/**
+ * @brief Householder QR factorization without pivoting for all lanes
+ *
+ * Column @c k of the output holds the Householder vector of reflector
+ * \f$ H_k = I - \tau_k v_k v_k^T \f$ from the diagonal down, the strict upper triangle holds R
+ * and @p r_diag the diagonal of R, so that \f$ A = H_0 \cdots H_{Cols-1} R \f$. Column pivoting
+ * would give each lane its own permutation, so rank is judged from the diagonal of R instead.
+ *
+ * @tparam Rows Number of rows, at least Cols
+ * @tparam Cols Number of columns
+ * @param[in,out] mat Input matrices (Rows x Cols lanes), output Householder vectors and R
+ * @param[out] tau Householder scalars (Cols lanes)
+ * @param[out] r_diag Diagonal of R (Cols lanes)
+ * @param[out] status @c EFSB_LAPACK_ERROR_NOT_FULL_RANK for lanes whose matrix is numerically
+ * rank deficient
+ */
+template <size_t Rows, size_t Cols>
+inline void linalg_batch_qr_factor(
+    LinalgBatchLanes mat[], LinalgBatchLanes tau[], LinalgBatchLanes r_diag[], LinalgBatchStatus& status)
+{
+    static_assert((Cols > 0U) && (Cols <= Rows) && (Rows <= kLinalgFixedMaxDim), "Unsupported matrix dimension");
+    LinalgBatchLanes frobenius_sq = {};
+    for (size_t ind = 0U; ind < (Rows * Cols); ++ind)
+    {
+        for (size_t lane = 0U; lane < kLinalgBatchSize; ++lane)
+        {
+            frobenius_sq[lane] += mat[ind][lane] * mat[ind][lane];
+        }
+    }
+    for (size_t col = 0U; col < Cols; ++col)
+    {
+        LinalgBatchLanes norm_sq = {};
+        for (size_t row = col; row < Rows; ++row)
+        {
+            for (size_t lane = 0U; lane < kLinalgBatchSize; ++lane)
+            {
+                norm_sq[lane] += mat[Rows * col + row][lane] * mat[Rows * col + row][lane];
+            }
+        }
+        for (size_t lane = 0U; lane < kLinalgBatchSize; ++lane)
+        {
+            const Real a_kk = mat[Rows * col + col][lane];
+            const Real norm = std::sqrt(norm_sq[lane]);
+            const Real alpha = (a_kk >= 0.0) ? -norm : norm;
+            // |v|^2 = 2 |a| (|a| + |a_kk|) with v = a - alpha e_k
+            const Real v_norm_sq = 2.0 * norm * (norm + std::fabs(a_kk));
+            tau[col][lane] = (v_norm_sq > 0.0) ? (2.0 / v_norm_sq) : 0.0;
+            mat[Rows * col + col][lane] = a_kk - alpha;
+            r_diag[col][lane] = alpha;
+        }
+        for (size_t other = col + 1U; other < Cols; ++other)
+        {
+            LinalgBatchLanes scale = {};
+            for (size_t row = col; row < Rows; ++row)
+            {
+                for (size_t lane = 0U; lane < kLinalgBatchSize; ++lane)
+                {
+                    scale[lane] += mat[Rows * col + row][lane] * mat[Rows * other + row][lane];
+                }
+            }
+            for (size_t row = col; row < Rows; ++row)
+            {
+                for (size_t lane = 0U; lane < kLinalgBatchSize; ++lane)
+                {
+                    mat[Rows * other + row][lane] -= tau[col][lane] * scale[lane] * mat[Rows * col + row][lane];
+                }
+            }
+        }
+    }
+    for (size_t lane = 0U; lane < kLinalgBatchSize; ++lane)
+    {
+        const Real rank_tol_sq = kLinalgFixedRankTol * kLinalgFixedRankTol * frobenius_sq[lane];
+        bool       full_rank = frobenius_sq[lane] > 0.0;
+        for (size_t col = 0U; col < Cols; ++col)
+        {
+            full_rank = full_rank && ((r_diag[col][lane] * r_diag[col][lane]) > rank_tol_sq);
+        }
+        status[lane] = full_rank ? EFSB_LAPACK_ERROR_NONE : EFSB_LAPACK_ERROR_NOT_FULL_RANK;
+    }
+}
+
+/**
+ * @brief Apply Householder reflectors of @c linalg_batch_qr_factor to vectors of all lanes
+ *
+ * @tparam Rows Number of rows
+ * @tparam Cols Number of columns
+ * @param[in] qr Householder vectors (Rows x Cols lanes)
+ * @param[in] tau Householder scalars (Cols lanes)
+ * @param[in] transpose Apply \f$ Q^T \f$ if true, otherwise \f$ Q \f$
+ * @param[in,out] x_vec Vectors (Rows lanes)
+ */
+template <size_t Rows, size_t Cols>
+inline void linalg_batch_qr_apply(
+    const LinalgBatchLanes qr[], const LinalgBatchLanes tau[], const bool transpose, LinalgBatchLanes x_vec[])
+{
+    for (size_t ind = 0U; ind < Cols; ++ind)
+    {
+        // Q^T = H_{n-1} ... H_0 applies H_0 first, Q applies H_{n-1} first
+        const size_t     col = transpose ? ind : (Cols - 1U - ind);
+        LinalgBatchLanes scale = {};
+        for (size_t row = col; row < Rows; ++row)
+        {
+            for (size_t lane = 0U; lane < kLinalgBatchSize; ++lane)
+            {
+                scale[lane] += qr[Rows * col + row][lane] * x_vec[row][lane];
+            }
+        }
+        for (size_t row = col; row < Rows; ++row)
+        {
+            for (size_t lane = 0U; lane < kLinalgBatchSize; ++lane)
+            {
+                x_vec[row][lane] -= tau[col][lane] * scale[lane] * qr[Rows * col + row][lane];
+            }
+        }
+    }
+}
+
+/**
+ * @brief Least squares or minimum norm solution of linear systems for all lanes
+ *
+ * For Rows >= Cols solves \f$ \min \| A x - b \| \f$ with the QR factorization of A, otherwise the
+ * minimum norm solution of \f$ A x = b \f$ with the QR factorization of \f$ A^T \f$. Lanes with
+ * rank deficient matrix are flagged and their solution is not meaningful.
+ *
+ * @tparam Rows Number of rows
+ * @tparam Cols Number of columns
+ * @param[in] mat Matrices (Rows x Cols lanes)
+ * @param[in] b_vec Right-hand side vectors (Rows lanes)
+ * @param[out] x_vec Solution vectors (Cols lanes)
+ * @param[out] status @c EFSB_LAPACK_ERROR_NOT_FULL_RANK for lanes with rank deficient matrix
+ */
+template <size_t Rows, size_t Cols>
+inline void linalg_batch_leastsquares_solve(
+    const LinalgBatchLanes mat[], const LinalgBatchLanes b_vec[], LinalgBatchLanes x_vec[],
+    LinalgBatchStatus& status)
+{
+    static_assert((Rows > 0U) && (Rows <= kLinalgFixedMaxDim), "Unsupported matrix dimension");
+    static_assert((Cols > 0U) && (Cols <= kLinalgFixedMaxDim), "Unsupported matrix dimension");
+    if constexpr (Rows >= Cols)
+    {
+        std::array<LinalgBatchLanes, Rows * Cols> qr = {};
+        std::array<LinalgBatchLanes, Cols>        tau = {};
+        std::array<LinalgBatchLanes, Cols>        r_diag = {};
+        std::array<LinalgBatchLanes, Rows>        rhs = {};
+        for (size_t ind = 0U; ind < (Rows * Cols); ++ind)
+        {
+            qr[ind] = mat[ind];
+        }
+        for (size_t row = 0U; row < Rows; ++row)
+        {
+            rhs[row] = b_vec[row];
+        }
+        linalg_batch_qr_factor<Rows, Cols>(qr.data(), tau.data(), r_diag.data(), status);
+        linalg_batch_qr_apply<Rows, Cols>(qr.data(), tau.data(), true, rhs.data());
+        // R x = Q^T b, neutral divisor for rank deficient lanes
+        for (size_t row = Cols; row > 0U; --row)
+        {
+            const size_t     r_ind = row - 1U;
+            LinalgBatchLanes value = rhs[r_ind];
+            for (size_t ind = row; ind < Cols; ++ind)
+            {
+                for (size_t lane = 0U; lane < kLinalgBatchSize; ++lane)
+                {
+                    value[lane] -= qr[Rows * ind + r_ind][lane] * x_vec[ind][lane];
+                }
+            }
+            for (size_t lane = 0U; lane < kLinalgBatchSize; ++lane)
+            {
+                const bool valid = status[lane] == EFSB_LAPACK_ERROR_NONE;
+                x_vec[r_ind][lane] = value[lane] / (valid ? r_diag[r_ind][lane] : 1.0);
+            }
+        }
+    }
+    else
+    {
+        // A^T = Q R, so A = R^T Q^T, solve R^T y = b and x = Q y
+        std::array<LinalgBatchLanes, Cols * Rows> qr = {};
+        std::array<LinalgBatchLanes, Rows>        tau = {};
+        std::array<LinalgBatchLanes, Rows>        r_diag = {};
+        std::array<LinalgBatchLanes, Cols>        sol = {};
+        for (size_t col = 0U; col < Cols; ++col)
+        {
+            for (size_t row = 0U; row < Rows; ++row)
+            {
+                qr[Cols * row + col] = mat[Rows * col + row];
+            }
+        }
+        linalg_batch_qr_factor<Cols, Rows>(qr.data(), tau.data(), r_diag.data(), status);
+        for (size_t row = 0U; row < Rows; ++row)
+        {
+            LinalgBatchLanes value = b_vec[row];
+            for (size_t ind = 0U; ind < row; ++ind)
+            {
+                for (size_t lane = 0U; lane < kLinalgBatchSize; ++lane)
+                {
+                    value[lane] -= qr[Cols * row + ind][lane] * sol[ind][lane];
+                }
+            }
+            for (size_t lane = 0U; lane < kLinalgBatchSize; ++lane)
+            {
+                const bool valid = status[lane] == EFSB_LAPACK_ERROR_NONE;
+                sol[row][lane] = value[lane] / (valid ? r_diag[row][lane] : 1.0);
+            }
+        }
+        linalg_batch_qr_apply<Cols, Rows>(qr.data(), tau.data(), false, sol.data());
+        for (size_t col = 0U; col < Cols; ++col)
+        {
+            x_vec[col] = sol[col];
+        }
+    }
+}
+
+/**
+ * @brief Copy lane group from interleaved layout, lanes past the last problem repeat problem
+ * @c first
+ */
+inline void linalg_batch_gather(
+    const Real data[], const size_t len, const size_t count, const size_t first, LinalgBatchLanes lanes[])
+{
+    for (size_t ind = 0U; ind < len; ++ind)
+    {
+        for (size_t lane = 0U; lane < kLinalgBatchSize; ++lane)
+        {
+            const size_t problem = ((first + lane) < count) ? (first + lane) : first;
+            lanes[ind][lane] = data[ind * count + problem];
+        }
+    }
+}
+
+/**
+ * @brief Copy lane group to interleaved layout, lanes past the last problem are dropped
+ */
+inline void linalg_batch_scatter(
+    const LinalgBatchLanes lanes[], const size_t len, const size_t count, const size_t first, Real data[])
+{
+    for (size_t ind = 0U; ind < len; ++ind)
+    {
+        for (size_t lane = 0U; (lane < kLinalgBatchSize) && ((first + lane) < count); ++lane)
+        {
+            data[ind * count + first + lane] = lanes[ind][lane];
+        }
+    }
+}
+
+/**
+ * @brief Solve symmetric positive definite systems in interleaved layout
+ *
+ * @tparam Dim Matrix dimension
+ * @param[in] count Number of problems
+ * @param[in] mat Matrices (Dim x Dim x count), only lower triangles are referenced
+ * @param[in] b_vec Right-hand side vectors (Dim x count)
+ * @param[out] x_vec Solution vectors (Dim x count)
+ * @param[out] status Error code per problem (count), nullptr if not needed
+ * @return First error of any problem, @c EFSB_LAPACK_ERROR_NONE if all problems were solved
+ */
+template <size_t Dim>
+inline FsbLinalgErrorType linalg_batch_posdef_solve(
+    const size_t count, const Real mat[], const Real b_vec[], Real x_vec[], FsbLinalgErrorType status[])
+{
+    auto result = EFSB_LAPACK_ERROR_NONE;
+    for (size_t first = 0U; first < count; first += kLinalgBatchSize)
+    {
+        std::array<LinalgBatchLanes, Dim * Dim> chol = {};
+        std::array<LinalgBatchLanes, Dim>       sol = {};
+        LinalgBatchStatus                       lane_status = {};
+        linalg_batch_gather(mat, Dim * Dim, count, first, chol.data());
+        linalg_batch_gather(b_vec, Dim, count, first, sol.data());
+        linalg_batch_cholesky_factor<Dim>(chol.data(), lane_status);
+        linalg_batch_cholesky_solve<Dim>(chol.data(), sol.data());
+        linalg_batch_scatter(sol.data(), Dim, count, first, x_vec);
+        for (size_t lane = 0U; (lane < kLinalgBatchSize) && ((first + lane) < count); ++lane)
+        {
+            result = (result == EFSB_LAPACK_ERROR_NONE) ? lane_status[lane] : result;
+            if (status != nullptr)
+            {
+                status[first + lane] = lane_status[lane];
+            }
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Least squares or minimum norm solutions in interleaved layout
+ *
+ * @tparam Rows Number of rows
+ * @tparam Cols Number of columns
+ * @param[in] count Number of problems
+ * @param[in] mat Matrices (Rows x Cols x count)
+ * @param[in] b_vec Right-hand side vectors (Rows x count)
+ * @param[out] x_vec Solution vectors (Cols x count)
+ * @param[out] status Error code per problem (count), nullptr if not needed
+ * @return First error of any problem, @c EFSB_LAPACK_ERROR_NONE if all problems were solved
+ */
+template <size_t Rows, size_t Cols>
+inline FsbLinalgErrorType linalg_batch_leastsquares_solve(
+    const size_t count, const Real mat[], const Real b_vec[], Real x_vec[], FsbLinalgErrorType status[])
+{
+    auto result = EFSB_LAPACK_ERROR_NONE;
+    for (size_t first = 0U; first < count; first += kLinalgBatchSize)
+    {
+        std::array<LinalgBatchLanes, Rows * Cols> lanes_mat = {};
+        std::array<LinalgBatchLanes, Rows>        lanes_b = {};
+        std::array<LinalgBatchLanes, Cols>        lanes_x = {};
+        LinalgBatchStatus                         lane_status = {};
+        linalg_batch_gather(mat, Rows * Cols, count, first, lanes_mat.data());
+        linalg_batch_gather(b_vec, Rows, count, first, lanes_b.data());
+        linalg_batch_leastsquares_solve<Rows, Cols>(lanes_mat.data(), lanes_b.data(), lanes_x.data(), lane_status);
+        linalg_batch_scatter(lanes_x.data(), Cols, count, first, x_vec);
+        for (size_t lane = 0U; (lane < kLinalgBatchSize) && ((first + lane) < count); ++lane)
+        {
+            result = (result == EFSB_LAPACK_ERROR_NONE) ? lane_status[lane] : result;
+            if (status != nullptr)
+            {
+                status[first + lane] = lane_status[lane];
+            }
+        }
+    }
+    return result;
+}
+
+/**
+ * @}
+ */
+
+} // namespace fsb
+
+#endif // FSB_LINALG_BATCH_H
@@ -0,0 +1,803 @@
+
+#ifndef FSB_LINALG_FIXED_H
+#define FSB_LINALG_FIXED_H
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include "fsb_configuration.h"
+#include "fsb_linalg.h"
+#include "fsb_types.h"
+
+namespace fsb
+{
+
+/**
+ * @defgroup LinearAlgebraFixed Linear Algebra for Fixed Size Matrices
+ * @brief Header-only linear algebra for small matrices with dimension known at compile time
+ *
+ * Loop bounds are compile-time constants so the compiler can unroll them completely. Matrices are
+ * column-major with leading dimension equal to the matrix dimension.
+ *
+ * @{
+ */
+
+/**
+ * @brief Largest matrix dimension supported by the runtime dispatch
+ */
+constexpr size_t kLinalgFixedMaxDim = 12U;
+
+/**
+ * @brief Relative tolerance of diagonal of triangular factor for numerical rank
+ */
+constexpr Real kLinalgFixedRankTol = 1.0e-12;
+
+/**
+ * @brief Maximum number of sweeps of Jacobi rotations
+ */
+constexpr size_t kLinalgFixedMaxSweeps = 30U;
+
+/**
+ * @brief Cholesky factorization of a symmetric positive definite matrix in place
+ *
+ * The lower triangle is replaced by the factor L where \f$ A = L L^T \f$. The strict upper
+ * triangle is not referenced.
+ *
+ * @tparam Dim Matrix dimension
+ * @param[in,out] mat Input matrix (Dim x Dim), output Cholesky factor in lower triangle
+ * @return @c EFSB_LAPACK_NOT_POSITIVE_DEFINITE if matrix is not positive definite
+ */
+template <size_t Dim>
+inline FsbLinalgErrorType linalg_fixed_cholesky_factor(Real mat[])
+{
+    static_assert((Dim > 0U) && (Dim <= kLinalgFixedMaxDim), "Unsupported matrix dimension");
+    auto result = EFSB_LAPACK_ERROR_NONE;
+    for (size_t col = 0U; (col < Dim) && (result == EFSB_LAPACK_ERROR_NONE); ++col)
+    {
+        Real diag = mat[Dim * col + col];
+        for (size_t ind = 0U; ind < col; ++ind)
+        {
+            diag -= mat[Dim * ind + col] * mat[Dim * ind + col];
+        }
+        if (diag > 0.0)
+        {
+            const Real diag_sqrt = std::sqrt(diag);
+            const Real diag_inv = 1.0 / diag_sqrt;
+            mat[Dim * col + col] = diag_sqrt;
+            for (size_t row = col + 1U; row < Dim; ++row)
+            {
+                Real value = mat[Dim * col + row];
+                for (size_t ind = 0U; ind < col; ++ind)
+                {
+                    value -= mat[Dim * ind + row] * mat[Dim * ind + col];
+                }
+                mat[Dim * col + row] = value * diag_inv;
+            }
+        }
+        else
+        {
+            result = EFSB_LAPACK_NOT_POSITIVE_DEFINITE;
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Solve linear system with Cholesky factor in place
+ *
+ * Solves \f$ L L^T x = b \f$ by forward and back substitution.
+ *
+ * @tparam Dim Matrix dimension
+ * @param[in] chol Cholesky factor in lower triangle (Dim x Dim)
+ * @param[in,out] x_vec Input right-hand side vector, output solution vector
+ */
+template <size_t Dim>
+inline void linalg_fixed_cholesky_solve(const Real chol[], Real x_vec[])
+{
+    static_assert((Dim > 0U) && (Dim <= kLinalgFixedMaxDim), "Unsupported matrix dimension");
+    // forward substitution L y = b
+    for (size_t row = 0U; row < Dim; ++row)
+    {
+        Real value = x_vec[row];
+        for (size_t ind = 0U; ind < row; ++ind)
+        {
+            value -= chol[Dim * ind + row] * x_vec[ind];
+        }
+        x_vec[row] = value / chol[Dim * row + row];
+    }
+    // back substitution L^T x = y
+    for (size_t count = 0U; count < Dim; ++count)
+    {
+        const size_t row = Dim - 1U - count;
+        Real         value = x_vec[row];
+        for (size_t ind = row + 1U; ind < Dim; ++ind)
+        {
+            value -= chol[Dim * row + ind] * x_vec[ind];
+        }
+        x_vec[row] = value / chol[Dim * row + row];
+    }
+}
+
+/**
+ * @brief Solve symmetric positive definite linear system in place
+ *
+ * @tparam Dim Matrix dimension
+ * @param[in,out] mat Input matrix (Dim x Dim), output Cholesky factor in lower triangle
+ * @param[in,out] x_vec Input right-hand side vector, output solution vector
+ * @return @c EFSB_LAPACK_NOT_POSITIVE_DEFINITE if matrix is not positive definite
+ */
+template <size_t Dim>
+inline FsbLinalgErrorType linalg_fixed_posdef_solve(Real mat[], Real x_vec[])
+{
+    const FsbLinalgErrorType result = linalg_fixed_cholesky_factor<Dim>(mat);
+    if (result == EFSB_LAPACK_ERROR_NONE)
+    {
+        linalg_fixed_cholesky_solve<Dim>(mat, x_vec);
+    }
+    return result;
+}
+
+/**
+ * @brief Solve symmetric positive definite linear system in place with runtime dimension
+ *
+ * Dispatches to the fixed size solver of matching dimension.
+ *
+ * @param[in] dim Matrix dimension, at most @c kLinalgFixedMaxDim
+ * @param[in,out] mat Input matrix (dim x dim), output Cholesky factor in lower triangle
+ * @param[in,out] x_vec Input right-hand side vector, output solution vector
+ * @return @c EFSB_LAPACK_ERROR_INPUT for unsupported dimension, @c EFSB_LAPACK_NOT_POSITIVE_DEFINITE
+ * if matrix is not positive definite
+ */
+inline FsbLinalgErrorType linalg_fixed_posdef_solve(const size_t dim, Real mat[], Real x_vec[])
+{
+    auto result = EFSB_LAPACK_ERROR_NONE;
+    switch (dim)
+    {
+        case 1U:
+            result = linalg_fixed_posdef_solve<1U>(mat, x_vec);
+            break;
+        case 2U:
+            result = linalg_fixed_posdef_solve<2U>(mat, x_vec);
+            break;
+        case 3U:
+            result = linalg_fixed_posdef_solve<3U>(mat, x_vec);
+            break;
+        case 4U:
+            result = linalg_fixed_posdef_solve<4U>(mat, x_vec);
+            break;
+        case 5U:
+            result = linalg_fixed_posdef_solve<5U>(mat, x_vec);
+            break;
+        case 6U:
+            result = linalg_fixed_posdef_solve<6U>(mat, x_vec);
+            break;
+        case 7U:
+            result = linalg_fixed_posdef_solve<7U>(mat, x_vec);
+            break;
+        case 8U:
+            result = linalg_fixed_posdef_solve<8U>(mat, x_vec);
+            break;
+        case 9U:
+            result = linalg_fixed_posdef_solve<9U>(mat, x_vec);
+            break;
+        case 10U:
+            result = linalg_fixed_posdef_solve<10U>(mat, x_vec);
+            break;
+        case 11U:
+            result = linalg_fixed_posdef_solve<11U>(mat, x_vec);
+            break;
+        case 12U:
+            result = linalg_fixed_posdef_solve<12U>(mat, x_vec);
+            break;
+        default:
+            result = EFSB_LAPACK_ERROR_INPUT;
+            break;
+    }
+    return result;
+}
+
+/**
+ * @brief Cholesky factorization in place with runtime dimension
+ *
+ * Dispatches to the fixed size factorization of matching dimension, so a factor can be reused for
+ * several right-hand sides with @c linalg_fixed_cholesky_solve.
+ *
+ * @param[in] dim Matrix dimension, at most @c kLinalgFixedMaxDim
+ * @param[in,out] mat Input matrix (dim x dim), output Cholesky factor in lower triangle
+ * @return @c EFSB_LAPACK_ERROR_INPUT for unsupported dimension, @c EFSB_LAPACK_NOT_POSITIVE_DEFINITE
+ * if matrix is not positive definite
+ */
+inline FsbLinalgErrorType linalg_fixed_cholesky_factor(const size_t dim, Real mat[])
+{
+    auto result = EFSB_LAPACK_ERROR_NONE;
+    switch (dim)
+    {
+        case 1U:
+            result = linalg_fixed_cholesky_factor<1U>(mat);
+            break;
+        case 2U:
+            result = linalg_fixed_cholesky_factor<2U>(mat);
+            break;
+        case 3U:
+            result = linalg_fixed_cholesky_factor<3U>(mat);
+            break;
+        case 4U:
+            result = linalg_fixed_cholesky_factor<4U>(mat);
+            break;
+        case 5U:
+            result = linalg_fixed_cholesky_factor<5U>(mat);
+            break;
+        case 6U:
+            result = linalg_fixed_cholesky_factor<6U>(mat);
+            break;
+        case 7U:
+            result = linalg_fixed_cholesky_factor<7U>(mat);
+            break;
+        case 8U:
+            result = linalg_fixed_cholesky_factor<8U>(mat);
+            break;
+        case 9U:
+            result = linalg_fixed_cholesky_factor<9U>(mat);
+            break;
+        case 10U:
+            result = linalg_fixed_cholesky_factor<10U>(mat);
+            break;
+        case 11U:
+            result = linalg_fixed_cholesky_factor<11U>(mat);
+            break;
+        case 12U:
+            result = linalg_fixed_cholesky_factor<12U>(mat);
+            break;
+        default:
+            result = EFSB_LAPACK_ERROR_INPUT;
+            break;
+    }
+    return result;
+}
+
+/**
+ * @brief Solve linear system with Cholesky factor in place with runtime dimension
+ *
+ * @param[in] dim Matrix dimension, at most @c kLinalgFixedMaxDim
+ * @param[in] chol Cholesky factor in lower triangle (dim x dim)
+ * @param[in,out] x_vec Input right-hand side vector, output solution vector
+ * @return @c EFSB_LAPACK_ERROR_INPUT for unsupported dimension
+ */
+inline FsbLinalgErrorType linalg_fixed_cholesky_solve(const size_t dim, const Real chol[], Real x_vec[])
+{
+    auto result = EFSB_LAPACK_ERROR_NONE;
+    switch (dim)
+    {
+        case 1U:
+            linalg_fixed_cholesky_solve<1U>(chol, x_vec);
+            break;
+        case 2U:
+            linalg_fixed_cholesky_solve<2U>(chol, x_vec);
+            break;
+        case 3U:
+            linalg_fixed_cholesky_solve<3U>(chol, x_vec);
+            break;
+        case 4U:
+            linalg_fixed_cholesky_solve<4U>(chol, x_vec);
+            break;
+        case 5U:
+            linalg_fixed_cholesky_solve<5U>(chol, x_vec);
+            break;
+        case 6U:
+            linalg_fixed_cholesky_solve<6U>(chol, x_vec);
+            break;
+        case 7U:
+            linalg_fixed_cholesky_solve<7U>(chol, x_vec);
+            break;
+        case 8U:
+            linalg_fixed_cholesky_solve<8U>(chol, x_vec);
+            break;
+        case 9U:
+            linalg_fixed_cholesky_solve<9U>(chol, x_vec);
+            break;
+        case 10U:
+            linalg_fixed_cholesky_solve<10U>(chol, x_vec);
+            break;
+        case 11U:
+            linalg_fixed_cholesky_solve<11U>(chol, x_vec);
+            break;
+        case 12U:
+            linalg_fixed_cholesky_solve<12U>(chol, x_vec);
+            break;
+        default:
+            result = EFSB_LAPACK_ERROR_INPUT;
+            break;
+    }
+    return result;
+}
+
+/**
+ * @brief Householder QR factorization with column pivoting in place
+ *
+ * Computes \f$ A P = Q R \f$ for Rows >= Cols. R is stored in the upper triangle and the
+ * Householder vectors below the diagonal with implicit unit first element, as in LAPACK @c dgeqp3.
+ * The pivot column of each step has the largest remaining norm, so the diagonal of R is
+ * non-increasing in magnitude and reveals the numerical rank.
+ *
+ * @tparam Rows Number of rows
+ * @tparam Cols Number of columns
+ * @param[in,out] mat Input matrix (Rows x Cols), output R and Householder vectors
+ * @param[out] tau Householder scalar factors (Cols)
+ * @param[out] perm Column permutation, column k of A P is column perm[k] of A (Cols)
+ * @return Numerical rank, number of diagonal elements of R above @c kLinalgFixedRankTol relative
+ * to the first
+ */
+template <size_t Rows, size_t Cols>
+inline size_t linalg_fixed_qr_pivot_factor(Real mat[], Real tau[], size_t perm[])
+{
+    static_assert((Cols > 0U) && (Rows >= Cols) && (Rows <= kLinalgFixedMaxDim), "Unsupported matrix dimension");
+    for (size_t col = 0U; col < Cols; ++col)
+    {
+        perm[col] = col;
+    }
+    for (size_t step = 0U; step < Cols; ++step)
+    {
+        // pivot on remaining column of largest norm
+        size_t pivot = step;
+        Real   pivot_norm = -1.0;
+        for (size_t col = step; col < Cols; ++col)
+        {
+            Real norm = 0.0;
+            for (size_t row = step; row < Rows; ++row)
+            {
+                norm += mat[Rows * col + row] * mat[Rows * col + row];
+            }
+            if (norm > pivot_norm)
+            {
+                pivot = col;
+                pivot_norm = norm;
+            }
+        }
+        if (pivot != step)
+        {
+            for (size_t row = 0U; row < Rows; ++row)
+            {
+                const Real value = mat[Rows * step + row];
+                mat[Rows * step + row] = mat[Rows * pivot + row];
+                mat[Rows * pivot + row] = value;
+            }
+            const size_t index = perm[step];
+            perm[step] = perm[pivot];
+            perm[pivot] = index;
+        }
+
+        // Householder reflection H = I - tau v v^T with beta = H x
+        const Real alpha = mat[Rows * step + step];
+        Real       tail_norm = 0.0;
+        for (size_t row = step + 1U; row < Rows; ++row)
+        {
+            tail_norm += mat[Rows * step + row] * mat[Rows * step + row];
+        }
+        tau[step] = 0.0;
+        if (tail_norm > 0.0)
+        {
+            const Real norm = std::sqrt(alpha * alpha + tail_norm);
+            const Real beta = (alpha > 0.0) ? -norm : norm;
+            const Real scale = 1.0 / (alpha - beta);
+            tau[step] = (beta - alpha) / beta;
+            for (size_t row = step + 1U; row < Rows; ++row)
+            {
+                mat[Rows * step + row] *= scale;
+            }
+            mat[Rows * step + step] = beta;
+            // apply reflection to remaining columns
+            for (size_t col = step + 1U; col < Cols; ++col)
+            {
+                Real value = mat[Rows * col + step];
+                for (size_t row = step + 1U; row < Rows; ++row)
+                {
+                    value += mat[Rows * step + row] * mat[Rows * col + row];
+                }
+                value *= tau[step];
+                mat[Rows * col + step] -= value;
+                for (size_t row = step + 1U; row < Rows; ++row)
+                {
+                    mat[Rows * col + row] -= value * mat[Rows * step + row];
+                }
+            }
+        }
+    }
+    size_t     rank = 0U;
+    const Real rank_tol = kLinalgFixedRankTol * std::fabs(mat[0U]);
+    for (size_t step = 0U; step < Cols; ++step)
+    {
+        if ((std::fabs(mat[Rows * step + step]) > rank_tol) && (rank == step))
+        {
+            rank += 1U;
+        }
+    }
+    return rank;
+}
+
+/**
+ * @brief Apply Householder reflections of QR factorization to a vector
+ *
+ * @tparam Rows Number of rows
+ * @tparam Cols Number of columns
+ * @param[in] qr Factorization from @c linalg_fixed_qr_pivot_factor (Rows x Cols)
+ * @param[in] tau Householder scalar factors (Cols)
+ * @param[in] transpose Apply \f$ Q^T \f$ if true, else \f$ Q \f$
+ * @param[in,out] x_vec Vector (Rows)
+ */
+template <size_t Rows, size_t Cols>
+inline void linalg_fixed_qr_apply(const Real qr[], const Real tau[], const bool transpose, Real x_vec[])
+{
+    for (size_t count = 0U; count < Cols; ++count)
+    {
+        const size_t step = transpose ? count : (Cols - 1U - count);
+        Real         value = x_vec[step];
+        for (size_t row = step + 1U; row < Rows; ++row)
+        {
+            value += qr[Rows * step + row] * x_vec[row];
+        }
+        value *= tau[step];
+        x_vec[step] -= value;
+        for (size_t row = step + 1U; row < Rows; ++row)
+        {
+            x_vec[row] -= value * qr[Rows * step + row];
+        }
+    }
+}
+
+/**
+ * @brief Least squares or minimum norm solution of a full rank linear system
+ *
+ * For Rows >= Cols the solution minimizes \f$ \| A x - b \| \f$, otherwise it is the minimum norm
+ * solution of \f$ A x = b \f$, the same as LAPACK @c dgels. Both use QR with column pivoting, of A
+ * or of \f$ A^T \f$ respectively.
+ *
+ * @tparam Rows Number of rows
+ * @tparam Cols Number of columns
+ * @param[in] mat Matrix (Rows x Cols)
+ * @param[in] b_vec Right-hand side vector (Rows)
+ * @param[out] x_vec Solution vector (Cols)
+ * @return @c EFSB_LAPACK_ERROR_NOT_FULL_RANK if matrix is rank deficient
+ */
+template <size_t Rows, size_t Cols>
+inline FsbLinalgErrorType linalg_fixed_leastsquares_solve(const Real mat[], const Real b_vec[], Real x_vec[])
+{
+    static_assert((Rows > 0U) && (Rows <= kLinalgFixedMaxDim), "Unsupported matrix dimension");
+    static_assert((Cols > 0U) && (Cols <= kLinalgFixedMaxDim), "Unsupported matrix dimension");
+    auto result = EFSB_LAPACK_ERROR_NONE;
+    if constexpr (Rows >= Cols)
+    {
+        // A P = Q R, solve R P^T x = Q^T b
+        std::array<Real, Rows * Cols> qr = {};
+        std::array<Real, Cols>        tau = {};
+        std::array<size_t, Cols>      perm = {};
+        std::array<Real, Rows>        rhs = {};
+        for (size_t ind = 0U; ind < Rows * Cols; ++ind)
+        {
+            qr[ind] = mat[ind];
+        }
+        for (size_t row = 0U; row < Rows; ++row)
+        {
+            rhs[row] = b_vec[row];
+        }
+        if (linalg_fixed_qr_pivot_factor<Rows, Cols>(qr.data(), tau.data(), perm.data()) < Cols)
+        {
+            result = EFSB_LAPACK_ERROR_NOT_FULL_RANK;
+        }
+        else
+        {
+            linalg_fixed_qr_apply<Rows, Cols>(qr.data(), tau.data(), true, rhs.data());
+            for (size_t count = 0U; count < Cols; ++count)
+            {
+                const size_t row = Cols - 1U - count;
+                Real         value = rhs[row];
+                for (size_t ind = row + 1U; ind < Cols; ++ind)
+                {
+                    value -= qr[Rows * ind + row] * rhs[ind];
+                }
+                rhs[row] = value / qr[Rows * row + row];
+            }
+            for (size_t col = 0U; col < Cols; ++col)
+            {
+                x_vec[perm[col]] = rhs[col];
+            }
+        }
+    }
+    else
+    {
+        // A^T P = Q R, so A = P R^T Q^T, solve R^T y = P^T b and x = Q y
+        std::array<Real, Cols * Rows> qr = {};
+        std::array<Real, Rows>        tau = {};
+        std::array<size_t, Rows>      perm = {};
+        std::array<Real, Cols>        sol = {};
+        for (size_t col = 0U; col < Cols; ++col)
+        {
+            for (size_t row = 0U; row < Rows; ++row)
+            {
+                qr[Cols * row + col] = mat[Rows * col + row];
+            }
+        }
+        if (linalg_fixed_qr_pivot_factor<Cols, Rows>(qr.data(), tau.data(), perm.data()) < Rows)
+        {
+            result = EFSB_LAPACK_ERROR_NOT_FULL_RANK;
+        }
+        else
+        {
+            for (size_t row = 0U; row < Rows; ++row)
+            {
+                Real value = b_vec[perm[row]];
+                for (size_t ind = 0U; ind < row; ++ind)
+                {
+                    value -= qr[Cols * row + ind] * sol[ind];
+                }
+                sol[row] = value / qr[Cols * row + row];
+            }
+            linalg_fixed_qr_apply<Cols, Rows>(qr.data(), tau.data(), false, sol.data());
+            for (size_t col = 0U; col < Cols; ++col)
+            {
+                x_vec[col] = sol[col];
+            }
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Singular value decomposition by one-sided Jacobi rotations
+ *
+ * Columns of \f$ W = A V \f$ are made mutually orthogonal by plane rotations accumulated in
+ * \f$ V \f$. Singular values are the column norms of \f$ W \f$ and left singular vectors the
+ * normalized columns. Pairs with a column of negligible norm relative to the matrix norm are
+ * skipped, so the nullspace of a rank deficient or wide matrix costs no rotations.
+ *
+ * Any orthogonal matrix can be given as initial rotation. For a slowly changing matrix, such as a
+ * Jacobian at control rate, the right singular vectors of the previous decomposition leave only
+ * small off-diagonal terms and the iteration converges in one or two sweeps.
+ *
+ * Singular values are sorted in descending order as with LAPACK @c dgesvd. For Rows < Cols the
+ * last Cols - Rows singular values are zero.
+ *
+ * @tparam Rows Number of rows
+ * @tparam Cols Number of columns
+ * @param[in] mat Matrix (Rows x Cols)
+ * @param[in] v_init Initial orthogonal rotation (Cols x Cols), nullptr to start from identity
+ * @param[out] sing_val Singular values (Cols)
+ * @param[out] vec_u Left singular vectors in columns (Rows x Cols), zero column for zero singular
+ * value, nullptr if not needed
+ * @param[out] vec_v Right singular vectors in columns (Cols x Cols), nullptr if not needed
+ * @param[out] sweeps Number of sweeps performed, nullptr if not needed
+ * @return @c EFSB_LAPACK_ERROR_CONVERGE if columns were not orthogonal within
+ * @c kLinalgFixedMaxSweeps sweeps
+ */
+template <size_t Rows, size_t Cols>
+inline FsbLinalgErrorType linalg_fixed_svd(
+    const Real mat[], const Real v_init[], Real sing_val[], Real vec_u[], Real vec_v[],
+    size_t* sweeps = nullptr)
+{
+    static_assert((Rows > 0U) && (Rows <= kLinalgFixedMaxDim), "Unsupported matrix dimension");
+    static_assert((Cols > 0U) && (Cols <= kLinalgFixedMaxDim), "Unsupported matrix dimension");
+    std::array<Real, Rows * Cols> work = {};
+    std::array<Real, Cols * Cols> rot = {};
+    for (size_t col = 0U; col < Cols; ++col)
+    {
+        for (size_t row = 0U; row < Cols; ++row)
+        {
+            rot[Cols * col + row] = (v_init != nullptr) ? v_init[Cols * col + row] : ((row == col) ? 1.0 : 0.0);
+        }
+    }
+    Real frobenius_sq = 0.0;
+    for (size_t col = 0U; col < Cols; ++col)
+    {
+        for (size_t row = 0U; row < Rows; ++row)
+        {
+            Real value = 0.0;
+            for (size_t ind = 0U; ind < Cols; ++ind)
+            {
+                value += mat[Rows * ind + row] * rot[Cols * col + ind];
+            }
+            work[Rows * col + row] = value;
+            frobenius_sq += mat[Rows * col + row] * mat[Rows * col + row];
+        }
+    }
+
+    // convergence is quadratic, a sweep with all cosines of column pairs below the square root of
+    // the orthogonality tolerance leaves them below the tolerance and no further sweep is needed
+    const Real ortho_tol = static_cast<Real>(Rows) * std::numeric_limits<Real>::epsilon();
+    const Real stop_tol = std::sqrt(ortho_tol);
+    const Real zero_tol = kLinalgFixedRankTol * kLinalgFixedRankTol * frobenius_sq;
+    bool       converged = false;
+    size_t     sweep = 0U;
+    while ((sweep < kLinalgFixedMaxSweeps) && !converged)
+    {
+        converged = true;
+        for (size_t p_ind = 0U; p_ind + 1U < Cols; ++p_ind)
+        {
+            for (size_t q_ind = p_ind + 1U; q_ind < Cols; ++q_ind)
+            {
+                Real alpha = 0.0;
+                Real beta = 0.0;
+                Real gamma = 0.0;
+                for (size_t row = 0U; row < Rows; ++row)
+                {
+                    const Real w_p = work[Rows * p_ind + row];
+                    const Real w_q = work[Rows * q_ind + row];
+                    alpha += w_p * w_p;
+                    beta += w_q * w_q;
+                    gamma += w_p * w_q;
+                }
+                const Real norm_pq = std::sqrt(alpha * beta);
+                if ((alpha > zero_tol) && (beta > zero_tol) && (std::fabs(gamma) > ortho_tol * norm_pq))
+                {
+                    // rotation that makes columns p and q orthogonal
+                    converged = converged && (std::fabs(gamma) <= stop_tol * norm_pq);
+                    const Real zeta = (beta - alpha) / (2.0 * gamma);
+                    const Real tan_phi = ((zeta >= 0.0) ? 1.0 : -1.0)
+                                         / (std::fabs(zeta) + std::sqrt(zeta * zeta + 1.0));
+                    const Real cos_phi = 1.0 / std::sqrt(tan_phi * tan_phi + 1.0);
+                    const Real sin_phi = tan_phi * cos_phi;
+                    for (size_t row = 0U; row < Rows; ++row)
+                    {
+                        const Real w_p = work[Rows * p_ind + row];
+                        const Real w_q = work[Rows * q_ind + row];
+                        work[Rows * p_ind + row] = cos_phi * w_p - sin_phi * w_q;
+                        work[Rows * q_ind + row] = sin_phi * w_p + cos_phi * w_q;
+                    }
+                    for (size_t row = 0U; row < Cols; ++row)
+                    {
+                        const Real v_p = rot[Cols * p_ind + row];
+                        const Real v_q = rot[Cols * q_ind + row];
+                        rot[Cols * p_ind + row] = cos_phi * v_p - sin_phi * v_q;
+                        rot[Cols * q_ind + row] = sin_phi * v_p + cos_phi * v_q;
+                    }
+                }
+            }
+        }
+        sweep += 1U;
+    }
+
+    // column norms sorted descending
+    std::array<size_t, Cols> order = {};
+    for (size_t col = 0U; col < Cols; ++col)
+    {
+        Real value = 0.0;
+        for (size_t row = 0U; row < Rows; ++row)
+        {
+            value += work[Rows * col + row] * work[Rows * col + row];
+        }
+        sing_val[col] = std::sqrt(value);
+        order[col] = col;
+    }
+    for (size_t ind = 0U; ind < Cols; ++ind)
+    {
+        size_t max_ind = ind;
+        for (size_t other = ind + 1U; other < Cols; ++other)
+        {
+            if (sing_val[other] > sing_val[max_ind])
+            {
+                max_ind = other;
+            }
+        }
+        const Real value = sing_val[ind];
+        sing_val[ind] = sing_val[max_ind];
+        sing_val[max_ind] = value;
+        const size_t col = order[ind];
+        order[ind] = order[max_ind];
+        order[max_ind] = col;
+    }
+    for (size_t ind = 0U; ind < Cols; ++ind)
+    {
+        const size_t col = order[ind];
+        if (vec_u != nullptr)
+        {
+            const bool is_zero = (sing_val[ind] * sing_val[ind]) <= zero_tol;
+            const Real scale = is_zero ? 0.0 : (1.0 / sing_val[ind]);
+            for (size_t row = 0U; row < Rows; ++row)
+            {
+                vec_u[Rows * ind + row] = work[Rows * col + row] * scale;
+            }
+        }
+        if (vec_v != nullptr)
+        {
+            for (size_t row = 0U; row < Cols; ++row)
+            {
+                vec_v[Cols * ind + row] = rot[Cols * col + row];
+            }
+        }
+    }
+    if (sweeps != nullptr)
+    {
+        *sweeps = sweep;
+    }
+    return converged ? EFSB_LAPACK_ERROR_NONE : EFSB_LAPACK_ERROR_CONVERGE;
+}
+
+/**
+ * @brief Least squares solve with number of columns known at runtime
+ *
+ * Recursive compile-time dispatch on the number of columns, see @c linalg_fixed_leastsquares_solve.
+ */
+template <size_t Rows, size_t Cols>
+inline FsbLinalgErrorType linalg_fixed_leastsquares_dispatch(
+    const size_t cols, const Real mat[], const Real b_vec[], Real x_vec[])
+{
+    auto result = EFSB_LAPACK_ERROR_INPUT;
+    if (cols == Cols)
+    {
+        result = linalg_fixed_leastsquares_solve<Rows, Cols>(mat, b_vec, x_vec);
+    }
+    else if constexpr (Cols < kLinalgFixedMaxDim)
+    {
+        result = linalg_fixed_leastsquares_dispatch<Rows, Cols + 1U>(cols, mat, b_vec, x_vec);
+    }
+    return result;
+}
+
+/**
+ * @brief Least squares or minimum norm solution with runtime number of columns
+ *
+ * @tparam Rows Number of rows
+ * @param[in] cols Number of columns, at most @c kLinalgFixedMaxDim
+ * @param[in] mat Matrix (Rows x cols)
+ * @param[in] b_vec Right-hand side vector (Rows)
+ * @param[out] x_vec Solution vector (cols)
+ * @return @c EFSB_LAPACK_ERROR_INPUT for unsupported dimension, @c EFSB_LAPACK_ERROR_NOT_FULL_RANK
+ * if matrix is rank deficient
+ */
+template <size_t Rows>
+inline FsbLinalgErrorType linalg_fixed_leastsquares_solve(
+    const size_t cols, const Real mat[], const Real b_vec[], Real x_vec[])
+{
+    return linalg_fixed_leastsquares_dispatch<Rows, 1U>(cols, mat, b_vec, x_vec);
+}
+
+/**
+ * @brief Singular value decomposition with number of columns known at runtime
+ *
+ * Recursive compile-time dispatch on the number of columns, see @c linalg_fixed_svd.
+ */
+template <size_t Rows, size_t Cols>
+inline FsbLinalgErrorType linalg_fixed_svd_dispatch(
+    const size_t cols, const Real mat[], const Real v_init[], Real sing_val[], Real vec_u[],
+    Real vec_v[], size_t* sweeps)
+{
+    auto result = EFSB_LAPACK_ERROR_INPUT;
+    if (cols == Cols)
+    {
+        result = linalg_fixed_svd<Rows, Cols>(mat, v_init, sing_val, vec_u, vec_v, sweeps);
+    }
+    else if constexpr (Cols < kLinalgFixedMaxDim)
+    {
+        result = linalg_fixed_svd_dispatch<Rows, Cols + 1U>(cols, mat, v_init, sing_val, vec_u, vec_v, sweeps);
+    }
+    return result;
+}
+
+/**
+ * @brief One-sided Jacobi singular value decomposition with runtime number of columns
+ *
+ * @tparam Rows Number of rows
+ * @param[in] cols Number of columns, at most @c kLinalgFixedMaxDim
+ * @param[in] mat Matrix (Rows x cols)
+ * @param[in] v_init Initial orthogonal rotation (cols x cols), nullptr to start from identity
+ * @param[out] sing_val Singular values in descending order (cols)
+ * @param[out] vec_u Left singular vectors (Rows x cols), nullptr if not needed
+ * @param[out] vec_v Right singular vectors (cols x cols), nullptr if not needed
+ * @param[out] sweeps Number of sweeps performed, nullptr if not needed
+ * @return @c EFSB_LAPACK_ERROR_INPUT for unsupported dimension, @c EFSB_LAPACK_ERROR_CONVERGE if
+ * iteration did not converge
+ */
+template <size_t Rows>
+inline FsbLinalgErrorType linalg_fixed_svd(
+    const size_t cols, const Real mat[], const Real v_init[], Real sing_val[], Real vec_u[],
+    Real vec_v[], size_t* sweeps = nullptr)
+{
+    return linalg_fixed_svd_dispatch<Rows, 1U>(cols, mat, v_init, sing_val, vec_u, vec_v, sweeps);
+}
+
+/**
+ * @}
+ */
+
+} // namespace fsb
+
+#endif // FSB_LINALG_FIXED_H
@@ -0,0 +1,250 @@
+
+#ifndef FSB_MULTISTART_INVERSE_KINEMATICS_H
+#define FSB_MULTISTART_INVERSE_KINEMATICS_H
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include "fsb_body_tree.h"
+#include "fsb_configuration.h"
+#include "fsb_inverse_kinematics.h"
+#include "fsb_joint.h"
+#include "fsb_motion.h"
+#include "fsb_types.h"
+
+namespace fsb
+{
+
+/**
+ * @defgroup MultiStartInverseKinematics Multi-Start Inverse Kinematics
+ * @brief Inverse kinematics from several initial configurations solved in parallel
+ *
+ * Seeds are distributed over a pool of worker threads. The threads are created once on
+ * initialization and wait on a condition variable between calls to solve, the calling thread
+ * takes part as the first worker. Each worker owns an inverse kinematics solver and takes the next
+ * unsolved seed until all seeds are solved or the search is cancelled. The best converged solution
+ * is selected with a user supplied cost function.
+ *
+ * @{
+ */
+
+/**
+ * @brief Maximum number of seeds for multi-start inverse kinematics
+ */
+constexpr size_t kMultiStartMaxSeeds = 32U;
+
+/**
+ * @brief Maximum number of worker threads for multi-start inverse kinematics
+ */
+constexpr size_t kMultiStartMaxWorkers = 8U;
+
+/**
+ * @brief Cost of a converged inverse kinematics solution, lower is better
+ *
+ * The function is called concurrently from worker threads and must not modify shared state.
+ *
+ * @param result Converged inverse kinematics result
+ * @param context User data passed to @c MultiStartInverseKinematics::solve
+ * @return Cost of solution
+ */
+using InverseKinematicsCost = Real (*)(const InverseKinematicsResult& result, const void* context);
+
+/**
+ * @brief Parameters of multi-start inverse kinematics
+ */
+struct MultiStartParameters
+{
+    size_t   num_workers = 4U; ///< Number of worker threads including the calling thread
+    bool     stop_on_success = true; ///< Cancel remaining seeds when one reaches objective tolerance
+    uint32_t random_seed = 1U; ///< Seed of random number generator for generated initial configurations
+};
+
+/**
+ * @brief Initial configurations for multi-start inverse kinematics
+ */
+struct MultiStartSeeds
+{
+    std::array<JointSpacePosition, kMultiStartMaxSeeds> seed = {}; ///< Initial joint configurations
+    size_t num_seeds = 0U; ///< Number of valid seeds
+};
+
+/**
+ * @brief Result of multi-start inverse kinematics
+ */
+struct MultiStartResult
+{
+    InverseKinematicsResult result = {}; ///< Best inverse kinematics result
+    size_t seed_index = 0U; ///< Index of seed of best result
+    Real   cost = 0.0; ///< Cost of best result, weighted squared pose error if not converged
+    size_t num_solved = 0U; ///< Number of seeds solved without cancellation
+    size_t num_converged = 0U; ///< Number of seeds that reached the objective tolerance
+};
+
+/**
+ * @brief Cost equal to the squared distance of joint coordinates to a reference configuration
+ *
+ * @param result Converged inverse kinematics result
+ * @param context Pointer to reference @c JointSpacePosition
+ * @return Squared distance of joint coordinates
+ */
+Real multistart_cost_joint_distance(const InverseKinematicsResult& result, const void* context);
+
+/**
+ * @brief Multi-start inverse kinematics solver with worker threads
+ *
+ * The solver holds @c kMultiStartMaxWorkers inverse kinematics solvers with their linear algebra
+ * work and takes a few hundred kilobytes. Create it in static storage or on the heap, not on the
+ * stack of a thread. The solver is not thread safe.
+ */
+class MultiStartInverseKinematics
+{
+public:
+    MultiStartInverseKinematics() = default;
+
+    /**
+     * @brief Stop and join worker threads
+     */
+    ~MultiStartInverseKinematics();
+
+    MultiStartInverseKinematics(const MultiStartInverseKinematics&) = delete;
+    MultiStartInverseKinematics& operator=(const MultiStartInverseKinematics&) = delete;
+    MultiStartInverseKinematics(MultiStartInverseKinematics&&) = delete;
+    MultiStartInverseKinematics& operator=(MultiStartInverseKinematics&&) = delete;
+
+    /**
+     * @brief Initialize solvers of all workers for a body in tree and start worker threads
+     *
+     * Worker threads of a previous initialization are stopped first. If a worker thread cannot be
+     * created the solver continues with the workers already started.
+     *
+     * Joint position limits of the tree bound the generated seeds. Revolute joints without
+     * limits are sampled in range [-pi, pi].
+     *
+     * @param body_tree Body tree with link definitions
+     * @param body_index Index of body to compute inverse kinematics for
+     * @param params Optimization parameters
+     * @param multistart_params Multi-start parameters
+     * @param base_pose Base pose (default is identity transform)
+     * @return @c SUCCESS or @c INVALID_INPUT if body has no degrees of freedom or tree is invalid
+     */
+    InverseKinematicsInfo initialize(
+        const BodyTree& body_tree, size_t body_index, const OptimParameters& params,
+        const MultiStartParameters& multistart_params,
+        const Transform& base_pose = transform_identity());
+
+    /**
+     * @brief Generate random seeds around an initial configuration
+     *
+     * The first seed is the initial configuration. Other seeds sample revolute and limited
+     * prismatic joints of the chain uniformly, remaining coordinates are copied from the initial
+     * configuration.
+     *
+     * @param initial_config Initial joint configuration
+     * @param num_seeds Number of seeds, at most @c kMultiStartMaxSeeds
+     * @param[out] seeds Generated seeds
+     */
+    void generate_seeds(
+        const JointSpacePosition& initial_config, size_t num_seeds, MultiStartSeeds& seeds);
+
+    /**
+     * @brief Solve inverse kinematics from all seeds and select the best solution
+     *
+     * Solutions that reach the objective tolerance are ranked by cost, ties are resolved by lowest
+     * seed index. If no seed converges the result with lowest weighted squared pose error is
+     * returned, stalled iterates of unreachable targets are never ranked by the cost function.
+     *
+     * @param target_pose Desired body target pose
+     * @param seeds Initial joint configurations
+     * @param cost Cost of converged solutions, nullptr ranks by weighted squared pose error
+     * @param context User data passed to cost function
+     * @return Best result, valid until next call to solve
+     */
+    const MultiStartResult& solve(
+        const Transform& target_pose, const MultiStartSeeds& seeds,
+        InverseKinematicsCost cost = nullptr, const void* context = nullptr);
+
+    /**
+     * @brief Get result of the last call to @c solve
+     *
+     * @return Best result
+     */
+    [[nodiscard]] const MultiStartResult& get_result() const
+    {
+        return m_result;
+    }
+
+    /**
+     * @brief Get number of workers including the calling thread
+     *
+     * @return Number of workers, zero if not initialized
+     */
+    [[nodiscard]] size_t get_num_workers() const
+    {
+        return m_num_workers;
+    }
+
+private:
+    struct Worker
+    {
+        InverseKinematicsSolver solver = {};
+        InverseKinematicsResult best = {};
+        bool                    best_converged = false;
+        Real                    best_cost = 0.0;
+        size_t                  best_seed_index = 0U;
+        size_t                  num_solved = 0U;
+        size_t                  num_converged = 0U;
+    };
+
+    struct Job
+    {
+        const Transform*       target_pose = nullptr;
+        const MultiStartSeeds* seeds = nullptr;
+        InverseKinematicsCost  cost = nullptr;
+        const void*            context = nullptr;
+        size_t                 num_workers = 0U;
+    };
+
+    void run_worker(
+        Worker& worker, const Transform& target_pose, const MultiStartSeeds& seeds,
+        InverseKinematicsCost cost, const void* context);
+
+    void run_thread(size_t worker_index);
+
+    void start_threads();
+
+    void stop_threads();
+
+    std::array<Worker, kMultiStartMaxWorkers>      m_worker = {};
+    std::array<std::thread, kMultiStartMaxWorkers> m_thread = {};
+    std::mutex                                     m_mutex;
+    std::condition_variable                        m_start_condition;
+    std::condition_variable                        m_done_condition;
+    Job                                            m_job = {};
+    uint64_t                                       m_generation = 0U;
+    size_t                                         m_num_threads = 0U;
+    size_t                                         m_num_running = 0U;
+    bool                                           m_shutdown = false;
+    size_t                                    m_num_workers = 0U;
+    MultiStartParameters                      m_multistart_params = {};
+    OptimParameters                           m_params = {};
+    KinematicProgram                          m_chain = {};
+    std::array<bool, MaxSize::kCoordinates>   m_sampled = {};
+    std::array<Real, MaxSize::kCoordinates>   m_lower = {};
+    std::array<Real, MaxSize::kCoordinates>   m_upper = {};
+    uint32_t                                  m_random_state = 1U;
+    std::atomic<size_t>                       m_next_seed = {0U};
+    std::atomic<bool>                         m_cancel = {false};
+    MultiStartResult                          m_result = {};
+};
+
+/**
+ * @}
+ */
+
+} // namespace fsb
+
+#endif // FSB_MULTISTART_INVERSE_KINEMATICS_H
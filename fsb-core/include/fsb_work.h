@@ -5,6 +5,7 @@
 #include <array>
 #include <cstddef>
 #include <cstdint>
+#include "fsb_configuration.h"
 
 namespace fsb
 {
@@ -77,6 +78,23 @@ public:
 		return Capacity - get_used();
 	}
 
+	/**
+	 * @brief Get high-water mark, the largest number of elements in use since construction or
+	 * last reset_peak().
+	 */
+	[[nodiscard]] size_t get_peak() const noexcept
+	{
+		return m_peak;
+	}
+
+	/**
+	 * @brief Restart high-water mark tracking from the current usage.
+	 */
+	void reset_peak() noexcept
+	{
+		m_peak = m_top;
+	}
+
 	[[nodiscard]] T* data() noexcept
 	{
 		return m_data.data();
@@ -88,7 +106,7 @@ public:
 	}
 
 	/**
-	 * @brief Reset allocator state (frees all allocations).
+	 * @brief Reset allocator state (frees all allocations), high-water mark is kept.
 	 */
 	void reset() noexcept
 	{
@@ -139,6 +157,10 @@ public:
 		out.data = &m_data[m_top];
 		out.size = len;
 		m_top += len;
+		if (m_top > m_peak)
+		{
+			m_peak = m_top;
+		}
 		return WorkArrayStatus::SUCCESS;
 	}
 
@@ -190,6 +212,7 @@ public:
 private:
 	std::array<T, Capacity> m_data = {};
 	size_t m_top = 0U;
+	size_t m_peak = 0U;
 };
 
 /**
@@ -232,6 +255,11 @@ private:
 	size_t m_marker;
 };
 
+/**
+ * @brief Work array for linear algebra routines of kinematic solvers
+ */
+using LinalgWork = WorkArray<double, MaxSize::kLinalgWork>;
+
 /**
  * @}
  */
@@ -0,0 +1,584 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include "fsb_analytic_inverse_kinematics.h"
+#include "fsb_body_tree.h"
+#include "fsb_configuration.h"
+#include "fsb_inverse_kinematics.h"
+#include "fsb_jacobian.h"
+#include "fsb_joint.h"
+#include "fsb_kinematics.h"
+#include "fsb_motion.h"
+#include "fsb_quaternion.h"
+#include "fsb_types.h"
+
+namespace fsb
+{
+
+/**
+ * Tolerance for parallel and intersecting joint axes
+ */
+static constexpr Real kGeometryTolerance = 1.0e-9;
+
+/**
+ * Tolerance of pose error for accepting a solution
+ */
+static constexpr Real kSolutionTolerance = 1.0e-6;
+
+static Vec3 axis_rotate(const Vec3& axis, const Real angle, const Vec3& vec)
+{
+    // Rodrigues rotation formula
+    const Real cos_angle = std::cos(angle);
+    const Real sin_angle = std::sin(angle);
+    const Vec3 axis_cross = vector_cross(axis, vec);
+    const Real axis_dot = vector_dot(axis, vec) * (1.0 - cos_angle);
+    return {
+        vec.x * cos_angle + axis_cross.x * sin_angle + axis.x * axis_dot,
+        vec.y * cos_angle + axis_cross.y * sin_angle + axis.y * axis_dot,
+        vec.z * cos_angle + axis_cross.z * sin_angle + axis.z * axis_dot};
+}
+
+static Quaternion axis_quaternion(const Vec3& axis, const Real angle)
+{
+    return quat_exp(vector_scale(0.5 * angle, axis));
+}
+
+static Vec3 screw_rotate_point(const AnalyticJointScrew& screw, const Real angle, const Vec3& point)
+{
+    return vector_add(
+        screw.point, axis_rotate(screw.axis, angle, vector_subtract(point, screw.point)));
+}
+
+/**
+ * Angle about axis that rotates vector "from" onto vector "to", only the components perpendicular
+ * to the axis are considered
+ */
+static Real rotation_angle(const Vec3& axis, const Vec3& from, const Vec3& to)
+{
+    const Vec3 from_proj = vector_subtract(from, vector_scale(vector_dot(axis, from), axis));
+    const Vec3 to_proj = vector_subtract(to, vector_scale(vector_dot(axis, to), axis));
+    return std::atan2(
+        vector_dot(axis, vector_cross(from_proj, to_proj)), vector_dot(from_proj, to_proj));
+}
+
+/**
+ * Solve dir . R(axis, angle) vec = value for angle
+ */
+static size_t solve_rotated_projection(
+    const Vec3& axis, const Vec3& vec, const Vec3& dir, const Real value,
+    std::array<Real, 2U>& angles)
+{
+    // a cos(angle) + b sin(angle) = c
+    const Real axis_vec = vector_dot(axis, vec);
+    const Real axis_dir = vector_dot(axis, dir);
+    const Real a_coef = vector_dot(dir, vec) - axis_vec * axis_dir;
+    const Real b_coef = vector_dot(dir, vector_cross(axis, vec));
+    const Real c_coef = value - axis_vec * axis_dir;
+    const Real radius = std::hypot(a_coef, b_coef);
+
+    size_t result = 0U;
+    if (radius > kGeometryTolerance)
+    {
+        const Real ratio = c_coef / radius;
+        if (std::fabs(ratio) <= (1.0 + kSolutionTolerance))
+        {
+            const Real phase = std::atan2(b_coef, a_coef);
+            const Real offset = std::acos(std::min(std::max(ratio, -1.0), 1.0));
+            angles = {phase + offset, phase - offset};
+            result = 2U;
+        }
+    }
+    return result;
+}
+
+/**
+ * Solve E_a(angle_a) E_b(angle_b) point = target for rotations about two parallel axes
+ */
+static size_t solve_parallel_pair(
+    const AnalyticJointScrew& screw_a, const AnalyticJointScrew& screw_b, const Vec3& point,
+    const Vec3& target, std::array<std::array<Real, 2U>, 2U>& angles)
+{
+    // distance from axis a to rotated point about axis b must reach the target
+    const Vec3 b_to_point = vector_subtract(point, screw_b.point);
+    const Vec3 a_to_b = vector_subtract(screw_b.point, screw_a.point);
+    const Vec3 a_to_target = vector_subtract(target, screw_a.point);
+    const Real value = 0.5
+                       * (vector_dot(a_to_target, a_to_target) - vector_dot(b_to_point, b_to_point)
+                          - vector_dot(a_to_b, a_to_b));
+    std::array<Real, 2U> angles_b = {};
+    const size_t         result
+        = solve_rotated_projection(screw_b.axis, b_to_point, a_to_b, value, angles_b);
+    for (size_t index = 0U; index < result; ++index)
+    {
+        const Vec3 rotated = screw_rotate_point(screw_b, angles_b[index], point);
+        angles[index] = {
+            rotation_angle(screw_a.axis, vector_subtract(rotated, screw_a.point), a_to_target),
+            angles_b[index]};
+    }
+    return result;
+}
+
+static bool axes_parallel(const Vec3& axis_a, const Vec3& axis_b)
+{
+    return vector_norm(vector_cross(axis_a, axis_b)) < kGeometryTolerance;
+}
+
+static bool axes_intersect(
+    const AnalyticJointScrew& screw_a, const AnalyticJointScrew& screw_b, Vec3& point)
+{
+    bool       result = false;
+    const Vec3 normal = vector_cross(screw_a.axis, screw_b.axis);
+    const Real normal_norm = vector_norm(normal);
+    if (normal_norm >= kGeometryTolerance)
+    {
+        const Vec3 a_to_b = vector_subtract(screw_b.point, screw_a.point);
+        const Real distance = std::fabs(vector_dot(a_to_b, normal)) / normal_norm;
+        if (distance < kGeometryTolerance)
+        {
+            // closest point on axis a
+            const Real offset = vector_dot(vector_cross(a_to_b, screw_b.axis), normal)
+                                / (normal_norm * normal_norm);
+            point = vector_add(screw_a.point, vector_scale(offset, screw_a.axis));
+            result = true;
+        }
+    }
+    return result;
+}
+
+static bool analytic_chain_screws(
+    const KinematicProgram& chain, const size_t body_index,
+    std::array<AnalyticJointScrew, kAnalyticIkJoints>& screws, Transform& home_pose)
+{
+    bool   result = true;
+    size_t num_revolute = 0U;
+    for (size_t op_index = 0U; result && (op_index < chain.num_ops); ++op_index)
+    {
+        const KinematicOp& kin_op = chain.op[op_index];
+        if (kin_op.kind == KinematicOpKind::REVOLUTE)
+        {
+            ++num_revolute;
+        }
+        else if (kin_op.num_dofs > 0U)
+        {
+            result = false;
+        }
+        else
+        {
+            // fixed joint
+        }
+    }
+    result = result && (num_revolute == kAnalyticIkJoints);
+    if (result)
+    {
+        // joint axes at zero configuration
+        const JointPva        joint_pva = {};
+        const CartesianPva    base_pva = {transform_identity(), {}, {}};
+        BodyCartesianPva      body_cartesian = {};
+        BodyJointAxes         joint_axes = {};
+        forward_kinematics_program_axes(
+            chain, joint_pva, base_pva, ForwardKinematicsOption::POSE, body_cartesian, joint_axes);
+        size_t joint = 0U;
+        for (size_t op_index = 0U; op_index < chain.num_ops; ++op_index)
+        {
+            const KinematicOp& kin_op = chain.op[op_index];
+            if (kin_op.kind == KinematicOpKind::REVOLUTE)
+            {
+                const JointAxes& axes = joint_axes.body[kin_op.child_index];
+                screws[joint] = {
+                    vector_scale(1.0 / vector_norm(axes.axis[0U]), axes.axis[0U]),
+                    axes.origin,
+                    kin_op.coord_index};
+                ++joint;
+            }
+        }
+        home_pose = body_cartesian.body[body_index].pose;
+    }
+    return result;
+}
+
+static AnalyticGeometry analytic_detect_geometry(
+    const std::array<AnalyticJointScrew, kAnalyticIkJoints>& screws, Vec3& wrist_point,
+    Vec3& tool_point)
+{
+    auto       result = AnalyticGeometry::UNSUPPORTED;
+    Vec3       point_45 = {};
+    Vec3       point_56 = {};
+    const bool wrist_intersect
+        = axes_intersect(screws[3U], screws[4U], point_45)
+          && axes_intersect(screws[4U], screws[5U], point_56);
+    const bool arm_parallel = axes_parallel(screws[1U].axis, screws[2U].axis)
+                              && !axes_parallel(screws[0U].axis, screws[1U].axis);
+    if (wrist_intersect && arm_parallel)
+    {
+        if (axes_parallel(screws[1U].axis, screws[3U].axis)
+            && !axes_parallel(screws[1U].axis, screws[4U].axis))
+        {
+            result = AnalyticGeometry::OFFSET_WRIST;
+            wrist_point = point_45;
+            tool_point = point_56;
+        }
+        else if (vector_norm(vector_subtract(point_45, point_56)) < kGeometryTolerance)
+        {
+            result = AnalyticGeometry::SPHERICAL_WRIST;
+            wrist_point = point_45;
+            tool_point = point_45;
+        }
+        else
+        {
+            // unsupported wrist
+        }
+    }
+    return result;
+}
+
+static Real angle_wrap(const Real angle)
+{
+    return std::remainder(angle, 2.0 * M_PI);
+}
+
+/**
+ * Joint position of a closed form solution nearest to the seed, false if a bounded joint has no
+ * turn of its angle within the position limits
+ */
+static bool analytic_bounded_position(
+    const InverseKinematicsBounds& bounds, const std::array<AnalyticJointScrew, kAnalyticIkJoints>& screw,
+    const JointSpacePosition& solution, const JointSpacePosition& seed, JointSpacePosition& position)
+{
+    bool within = true;
+    // keep coordinates outside chain and joint turns of seed
+    position = seed;
+    for (size_t joint = 0U; joint < kAnalyticIkJoints; ++joint)
+    {
+        const size_t coord = screw[joint].coord_index;
+        Real         angle = seed.q[coord] + angle_wrap(solution.q[coord] - seed.q[coord]);
+        for (size_t dof = 0U; dof < MaxSize::kDofs; ++dof)
+        {
+            if (bounds.set[dof] && (bounds.coord_index[dof] == coord))
+            {
+                // next turn towards limits
+                if (angle > bounds.upper[dof])
+                {
+                    angle -= 2.0 * M_PI;
+                }
+                else if (angle < bounds.lower[dof])
+                {
+                    angle += 2.0 * M_PI;
+                }
+                within = within && (angle >= bounds.lower[dof]) && (angle <= bounds.upper[dof]);
+            }
+        }
+        position.q[coord] = angle;
+    }
+    return within;
+}
+
+InverseKinematicsInfo AnalyticInverseKinematics::initialize(
+    const BodyTree& body_tree, const size_t body_index, const OptimParameters& params,
+    const Transform& base_pose)
+{
+    m_geometry = AnalyticGeometry::UNSUPPORTED;
+    m_body_index = body_index;
+    m_base_pose = base_pose;
+    m_result = {};
+    const InverseKinematicsInfo result
+        = m_numeric.initialize(body_tree, body_index, params, base_pose);
+    m_seed = m_numeric.get_warm_start();
+
+    Transform home_pose = {};
+    if ((result == InverseKinematicsInfo::SUCCESS)
+        && kinematic_program_compile(body_tree, m_program)
+        && kinematic_program_compile_chain(body_tree, body_index, m_chain)
+        && analytic_chain_screws(m_chain, body_index, m_screw, home_pose))
+    {
+        m_home_inverse = transform_inverse(home_pose);
+        m_geometry = analytic_detect_geometry(m_screw, m_wrist_point, m_tool_point);
+    }
+    return result;
+}
+
+void AnalyticInverseKinematics::add_solution(
+    const Transform& target_base, const std::array<Real, kAnalyticIkJoints>& angles,
+    AnalyticInverseKinematicsSolutions& solutions) const
+{
+    JointPva joint_pva = {};
+    for (size_t joint = 0U; joint < kAnalyticIkJoints; ++joint)
+    {
+        joint_pva.position.q[m_screw[joint].coord_index] = angle_wrap(angles[joint]);
+    }
+    // verify solution
+    const CartesianPva base_pva = {transform_identity(), {}, {}};
+    BodyCartesianPva   body_cartesian = {};
+    forward_kinematics_program(
+        m_chain, joint_pva, base_pva, ForwardKinematicsOption::POSE, body_cartesian);
+    const MotionVector error
+        = coord_transform_get_error(body_cartesian.body[m_body_index].pose, target_base);
+    bool accept = (vector_norm(error.angular) < kSolutionTolerance)
+                  && (vector_norm(error.linear) < kSolutionTolerance)
+                  && (solutions.num_solutions < kAnalyticIkMaxSolutions);
+    // skip duplicate solutions at singular configurations
+    for (size_t index = 0U; accept && (index < solutions.num_solutions); ++index)
+    {
+        Real max_diff = 0.0;
+        for (size_t joint = 0U; joint < kAnalyticIkJoints; ++joint)
+        {
+            const size_t coord = m_screw[joint].coord_index;
+            max_diff = std::max(
+                max_diff,
+                std::fabs(angle_wrap(
+                    joint_pva.position.q[coord] - solutions.joint_position[index].q[coord])));
+        }
+        accept = (max_diff > kSolutionTolerance);
+    }
+    if (accept)
+    {
+        solutions.joint_position[solutions.num_solutions] = joint_pva.position;
+        ++solutions.num_solutions;
+    }
+}
+
+void AnalyticInverseKinematics::solve_offset_wrist(
+    const Transform& target_base, AnalyticInverseKinematicsSolutions& solutions) const
+{
+    const AnalyticJointScrew& screw_1 = m_screw[0U];
+    const AnalyticJointScrew& screw_2 = m_screw[1U];
+    const AnalyticJointScrew& screw_3 = m_screw[2U];
+    const AnalyticJointScrew& screw_4 = m_screw[3U];
+    const AnalyticJointScrew& screw_5 = m_screw[4U];
+    const AnalyticJointScrew& screw_6 = m_screw[5U];
+    // product of joint transforms
+    const Transform tool_home = coord_transform(target_base, m_home_inverse);
+    // intersection of axes 5 and 6 is only moved by joints 1 to 4
+    const Vec3 tool_target = coord_transform_position(tool_home, m_tool_point);
+    // direction of axis 6 is only moved by joints 1 to 5
+    const Vec3 axis_6 = quat_rotate_vector(tool_home.rotation, screw_6.axis);
+    // joints 3 and 4 rotate about axis 2 or opposite direction
+    const Real sign_3 = vector_dot(screw_3.axis, screw_2.axis);
+    const Real sign_4 = vector_dot(screw_4.axis, screw_2.axis);
+
+    // joint 1: parallel joints do not change the component along axis 2
+    std::array<Real, 2U> angles_1 = {};
+    const size_t         num_1 = solve_rotated_projection(
+        screw_1.axis,
+        screw_2.axis,
+        vector_subtract(tool_target, screw_1.point),
+        vector_dot(screw_2.axis, vector_subtract(m_tool_point, screw_1.point)),
+        angles_1);
+    for (size_t index_1 = 0U; index_1 < num_1; ++index_1)
+    {
+        const Real angle_1 = angles_1[index_1];
+        // joint 5: component of axis 6 along axis 2
+        const Vec3           axis_6_arm = axis_rotate(screw_1.axis, -angle_1, axis_6);
+        std::array<Real, 2U> angles_5 = {};
+        const size_t         num_5 = solve_rotated_projection(
+            screw_5.axis, screw_6.axis, screw_2.axis, vector_dot(screw_2.axis, axis_6_arm), angles_5);
+        for (size_t index_5 = 0U; index_5 < num_5; ++index_5)
+        {
+            const Real angle_5 = angles_5[index_5];
+            // joint 6: axis 2 expressed at tool equals axis 2 rotated back through joint 5
+            const Vec3 axis_2_tool = quat_rotate_vector(
+                quat_conjugate(tool_home.rotation), axis_rotate(screw_1.axis, angle_1, screw_2.axis));
+            const Vec3 axis_2_wrist = axis_rotate(screw_5.axis, -angle_5, screw_2.axis);
+            const Real angle_6 = rotation_angle(screw_6.axis, axis_2_tool, axis_2_wrist);
+            // sum of parallel joint angles
+            const Quaternion rot_parallel = quat_multiply(
+                quat_multiply(
+                    quat_conjugate(axis_quaternion(screw_1.axis, angle_1)), tool_home.rotation),
+                quat_conjugate(quat_multiply(
+                    axis_quaternion(screw_5.axis, angle_5), axis_quaternion(screw_6.axis, angle_6))));
+            const Vec3 perp = vector_cross(screw_2.axis, screw_1.axis);
+            const Real angle_sum
+                = rotation_angle(screw_2.axis, perp, quat_rotate_vector(rot_parallel, perp));
+            // joints 2 and 3: intersection of axes 4 and 5 is only moved by joints 1 to 3
+            const Vec3 wrist_target = coord_transform_position(
+                tool_home, screw_rotate_point(screw_6, -angle_6, m_wrist_point));
+            std::array<std::array<Real, 2U>, 2U> angles_23 = {};
+            const size_t num_23 = solve_parallel_pair(
+                screw_2,
+                screw_3,
+                m_wrist_point,
+                screw_rotate_point(screw_1, -angle_1, wrist_target),
+                angles_23);
+            for (size_t index_23 = 0U; index_23 < num_23; ++index_23)
+            {
+                const Real angle_2 = angles_23[index_23][0U];
+                const Real angle_3 = angles_23[index_23][1U];
+                const Real angle_4 = sign_4 * (angle_sum - angle_2 - sign_3 * angle_3);
+                add_solution(
+                    target_base, {angle_1, angle_2, angle_3, angle_4, angle_5, angle_6}, solutions);
+            }
+        }
+    }
+}
+
+void AnalyticInverseKinematics::solve_spherical_wrist(
+    const Transform& target_base, AnalyticInverseKinematicsSolutions& solutions) const
+{
+    const AnalyticJointScrew& screw_1 = m_screw[0U];
+    const AnalyticJointScrew& screw_2 = m_screw[1U];
+    const AnalyticJointScrew& screw_3 = m_screw[2U];
+    const AnalyticJointScrew& screw_4 = m_screw[3U];
+    const AnalyticJointScrew& screw_5 = m_screw[4U];
+    const AnalyticJointScrew& screw_6 = m_screw[5U];
+    // product of joint transforms
+    const Transform tool_home = coord_transform(target_base, m_home_inverse);
+    // wrist center is only moved by joints 1 to 3
+    const Vec3 wrist_target = coord_transform_position(tool_home, m_wrist_point);
+
+    // joint 1: parallel joints do not change the component along axis 2
+    std::array<Real, 2U> angles_1 = {};
+    const size_t         num_1 = solve_rotated_projection(
+        screw_1.axis,
+        screw_2.axis,
+        vector_subtract(wrist_target, screw_1.point),
+        vector_dot(screw_2.axis, vector_subtract(m_wrist_point, screw_1.point)),
+        angles_1);
+    for (size_t index_1 = 0U; index_1 < num_1; ++index_1)
+    {
+        const Real angle_1 = angles_1[index_1];
+        // joints 2 and 3: position of wrist center
+        std::array<std::array<Real, 2U>, 2U> angles_23 = {};
+        const size_t num_23 = solve_parallel_pair(
+            screw_2,
+            screw_3,
+            m_wrist_point,
+            screw_rotate_point(screw_1, -angle_1, wrist_target),
+            angles_23);
+        for (size_t index_23 = 0U; index_23 < num_23; ++index_23)
+        {
+            const Real angle_2 = angles_23[index_23][0U];
+            const Real angle_3 = angles_23[index_23][1U];
+            // wrist orientation
+            const Quaternion rot_arm = quat_multiply(
+                quat_multiply(
+                    axis_quaternion(screw_1.axis, angle_1), axis_quaternion(screw_2.axis, angle_2)),
+                axis_quaternion(screw_3.axis, angle_3));
+            const Quaternion rot_wrist = quat_multiply(quat_conjugate(rot_arm), tool_home.rotation);
+            const Vec3       axis_6 = quat_rotate_vector(rot_wrist, screw_6.axis);
+            // joint 5: component of axis 6 along axis 4
+            std::array<Real, 2U> angles_5 = {};
+            const size_t         num_5 = solve_rotated_projection(
+                screw_5.axis, screw_6.axis, screw_4.axis, vector_dot(screw_4.axis, axis_6), angles_5);
+            for (size_t index_5 = 0U; index_5 < num_5; ++index_5)
+            {
+                const Real angle_5 = angles_5[index_5];
+                // joint 4: rotate axis 6 onto wrist orientation
+                const Real angle_4 = rotation_angle(
+                    screw_4.axis, axis_rotate(screw_5.axis, angle_5, screw_6.axis), axis_6);
+                // joint 6: remaining rotation
+                const Vec3 perp = vector_cross(screw_6.axis, screw_5.axis);
+                const Vec3 perp_target = axis_rotate(
+                    screw_5.axis,
+                    -angle_5,
+                    axis_rotate(screw_4.axis, -angle_4, quat_rotate_vector(rot_wrist, perp)));
+                const Real angle_6 = rotation_angle(screw_6.axis, perp, perp_target);
+                add_solution(
+                    target_base, {angle_1, angle_2, angle_3, angle_4, angle_5, angle_6}, solutions);
+            }
+        }
+    }
+}
+
+size_t AnalyticInverseKinematics::solve_all(
+    const Transform& target_pose, AnalyticInverseKinematicsSolutions& solutions) const
+{
+    solutions.num_solutions = 0U;
+    // target pose relative to base
+    const Transform target_base = coord_transform_inverse(m_base_pose, target_pose);
+    switch (m_geometry)
+    {
+        case AnalyticGeometry::OFFSET_WRIST:
+            solve_offset_wrist(target_base, solutions);
+            break;
+        case AnalyticGeometry::SPHERICAL_WRIST:
+            solve_spherical_wrist(target_base, solutions);
+            break;
+        case AnalyticGeometry::UNSUPPORTED:
+        default:
+            break;
+    }
+    return solutions.num_solutions;
+}
+
+const InverseKinematicsResult& AnalyticInverseKinematics::solve(const Transform& target_pose)
+{
+    return solve(target_pose, m_seed);
+}
+
+const InverseKinematicsResult&
+AnalyticInverseKinematics::solve(const Transform& target_pose, const JointSpacePosition& seed)
+{
+    m_result = {};
+    const InverseKinematicsBounds&     bounds = m_numeric.get_bounds();
+    AnalyticInverseKinematicsSolutions solutions = {};
+    const size_t num_solutions = solve_all(target_pose, solutions);
+    // solution closest to seed within joint limits
+    bool   found = false;
+    Real   best_distance = std::numeric_limits<Real>::max();
+    for (size_t index = 0U; index < num_solutions; ++index)
+    {
+        JointSpacePosition position = {};
+        if (analytic_bounded_position(bounds, m_screw, solutions.joint_position[index], seed, position))
+        {
+            Real distance = 0.0;
+            for (size_t joint = 0U; joint < kAnalyticIkJoints; ++joint)
+            {
+                const size_t coord = m_screw[joint].coord_index;
+                const Real   diff = position.q[coord] - seed.q[coord];
+                distance += diff * diff;
+            }
+            if (distance < best_distance)
+            {
+                best_distance = distance;
+                m_result.joint_position = position;
+                found = true;
+            }
+        }
+    }
+    if (!found)
+    {
+        // numeric fallback
+        m_result = m_numeric.solve(target_pose, seed);
+    }
+    else
+    {
+        const JointPva     joint_pva = {m_result.joint_position, {}, {}};
+        const CartesianPva base_pva = {m_base_pose, {}, {}};
+        BodyJointAxes      joint_axes = {};
+        forward_kinematics_program_axes(
+            m_program,
+            joint_pva,
+            base_pva,
+            ForwardKinematicsOption::POSE,
+            m_result.body_poses,
+            joint_axes);
+        const JacobianError error = calculate_jacobian_from_axes(
+            m_body_index, joint_axes, m_result.body_poses, m_result.jacobian);
+        m_result.computed_pose = m_result.body_poses.body[m_body_index].pose;
+        m_result.error_pose = coord_transform_get_error(m_result.computed_pose, target_pose);
+        m_result.iterations = 0U;
+        m_result.info = (error == JacobianError::SUCCESS) ? InverseKinematicsInfo::SUCCESS
+                                                          : InverseKinematicsInfo::INVALID_INPUT;
+        for (size_t dof = 0U; dof < MaxSize::kDofs; ++dof)
+        {
+            if (bounds.set[dof])
+            {
+                const Real coord = m_result.joint_position.q[bounds.coord_index[dof]];
+                m_result.active_limits[dof] = (coord <= bounds.lower[dof]) || (coord >= bounds.upper[dof]);
+                if (m_result.active_limits[dof])
+                {
+                    m_result.num_active_limits += 1U;
+                }
+            }
+        }
+    }
+    if (m_result.info == InverseKinematicsInfo::SUCCESS)
+    {
+        // warm start next solution
+        m_seed = m_result.joint_position;
+    }
+    return m_result;
+}
+
+} // namespace fsb
@@ -1,5 +1,12 @@
+#include <array>
+#include <cmath>
 #include <cstddef>
 #include "fsb_dynamics.h"
+#include "fsb_configuration.h"
+#include "fsb_jacobian.h"
+#include "fsb_kinematics.h"
+#include "fsb_linalg.h"
+#include "fsb_linalg_fixed.h"
 #include "fsb_motion.h"
 #include "fsb_body.h"
 #include "fsb_joint.h"
@@ -56,8 +63,13 @@ static BodyForce compute_body_com_force(
     return result;
 }
 
+/**
+ * Joint torque from force at child origin in child coordinates, spherical and Cartesian joint
+ * torques are rotated to the joint frame of their joint velocities
+ */
 static void joint_torque_from_force(
-    const Joint& joint, const ForceVector& joint_force, JointSpace& joint_torque)
+    const Joint& joint, const Quaternion& joint_rotation, const ForceVector& joint_force,
+    JointSpace& joint_torque)
 {
     const Real s_neg = joint.reversed ? -1.0 : 1.0;
     if (joint.type == JointType::REVOLUTE_X)
@@ -86,19 +98,22 @@ static void joint_torque_from_force(
     }
     else if (joint.type == JointType::SPHERICAL)
     {
-        joint_torque.qv[joint.dof_index] = joint_force.torque.x;
-        joint_torque.qv[joint.dof_index + 1U] = joint_force.torque.y;
-        joint_torque.qv[joint.dof_index + 2U] = joint_force.torque.z;
+        const Vec3 torque = quat_rotate_vector(joint_rotation, joint_force.torque);
+        joint_torque.qv[joint.dof_index] = torque.x;
+        joint_torque.qv[joint.dof_index + 1U] = torque.y;
+        joint_torque.qv[joint.dof_index + 2U] = torque.z;
     }
     else if (joint.type == JointType::CARTESIAN)
     {
-        joint_torque.qv[joint.dof_index] = joint_force.torque.x;
-        joint_torque.qv[joint.dof_index + 1U] = joint_force.torque.y;
-        joint_torque.qv[joint.dof_index + 2U] = joint_force.torque.z;
+        const Vec3 torque = quat_rotate_vector(joint_rotation, joint_force.torque);
+        const Vec3 force = quat_rotate_vector(joint_rotation, joint_force.force);
+        joint_torque.qv[joint.dof_index] = torque.x;
+        joint_torque.qv[joint.dof_index + 1U] = torque.y;
+        joint_torque.qv[joint.dof_index + 2U] = torque.z;
 
-        joint_torque.qv[joint.dof_index + 3U] = joint_force.force.x;
-        joint_torque.qv[joint.dof_index + 4U] = joint_force.force.y;
-        joint_torque.qv[joint.dof_index + 5U] = joint_force.force.z;
+        joint_torque.qv[joint.dof_index + 3U] = force.x;
+        joint_torque.qv[joint.dof_index + 4U] = force.y;
+        joint_torque.qv[joint.dof_index + 5U] = force.z;
     }
     else
     {
@@ -118,12 +133,14 @@ static JointSpace compute_body_joint_forces(
         const Body&  body = body_tree.get_body(index, err);
         const Joint& joint = body_tree.get_joint(body.joint_index, err);
         const size_t parent_body_index = joint.parent_body_index;
-        // get joint torque
-        joint_torque_from_force(joint, body_force.body[index], result);
         // Parent child transform
         const Transform& pose = cartesian_motion.body[index].pose;
         const Transform& parent_pose = cartesian_motion.body[parent_body_index].pose;
         const Transform  parent_child_transform = coord_transform_inverse(parent_pose, pose);
+        // get joint torque, joint rotation follows the constant parent to joint rotation
+        const Quaternion joint_rotation = quat_multiply(
+            quat_conjugate(joint.parent_joint_transform.rotation), parent_child_transform.rotation);
+        joint_torque_from_force(joint, joint_rotation, body_force.body[index], result);
         // body joint force
         const Vec3 force_child
             = quat_rotate_vector(parent_child_transform.rotation, body_force.body[index].force);
@@ -150,4 +167,1100 @@ JointSpace inverse_dynamics(
     return compute_body_joint_forces(body_tree, cartesian_motion, body_force);
 }
 
+/**
+ * Parent to child transform of a body with rotation matrices
+ */
+struct DynamicsJointTransform
+{
+    Mat3 rotation = {}; ///< Rotation of child coordinates to parent coordinates
+    Vec3 translation = {}; ///< Child origin in parent coordinates
+    Mat3 joint_rotation = {}; ///< Rotation of spherical and Cartesian joint coordinates
+};
+
+static Real vector_element(const Vec3& vec, const size_t index)
+{
+    Real result = vec.x;
+    if (index == 1U)
+    {
+        result = vec.y;
+    }
+    else if (index == 2U)
+    {
+        result = vec.z;
+    }
+    else
+    {
+        // x element
+    }
+    return result;
+}
+
+static Vec3 axis_vector(const size_t index, const Real value)
+{
+    Vec3 result = {};
+    if (index == 1U)
+    {
+        result.y = value;
+    }
+    else if (index == 2U)
+    {
+        result.z = value;
+    }
+    else
+    {
+        result.x = value;
+    }
+    return result;
+}
+
+static Mat3 mat3_multiply(const Mat3& mat_a, const Mat3& mat_b)
+{
+    const Vec3 col0 = rotate_mat3(mat_a, {mat_b.m00, mat_b.m10, mat_b.m20});
+    const Vec3 col1 = rotate_mat3(mat_a, {mat_b.m01, mat_b.m11, mat_b.m21});
+    const Vec3 col2 = rotate_mat3(mat_a, {mat_b.m02, mat_b.m12, mat_b.m22});
+    return {col0.x, col0.y, col0.z, col1.x, col1.y, col1.z, col2.x, col2.y, col2.z};
+}
+
+static Mat3 mat3_transpose(const Mat3& mat)
+{
+    return {mat.m00, mat.m01, mat.m02, mat.m10, mat.m11, mat.m12, mat.m20, mat.m21, mat.m22};
+}
+
+static Mat3 mat3_add(const Mat3& mat_a, const Mat3& mat_b)
+{
+    return {
+        mat_a.m00 + mat_b.m00,
+        mat_a.m10 + mat_b.m10,
+        mat_a.m20 + mat_b.m20,
+        mat_a.m01 + mat_b.m01,
+        mat_a.m11 + mat_b.m11,
+        mat_a.m21 + mat_b.m21,
+        mat_a.m02 + mat_b.m02,
+        mat_a.m12 + mat_b.m12,
+        mat_a.m22 + mat_b.m22};
+}
+
+/**
+ * Rotation matrix multiplied by rotation about a coordinate axis, only two columns change
+ */
+static Mat3 mat3_multiply_axis_rotation(
+    const Mat3& rot, const size_t axis_index, const Real cos_angle, const Real sin_angle)
+{
+    Mat3 result = rot;
+    if (axis_index == 0U)
+    {
+        result.m01 = cos_angle * rot.m01 + sin_angle * rot.m02;
+        result.m11 = cos_angle * rot.m11 + sin_angle * rot.m12;
+        result.m21 = cos_angle * rot.m21 + sin_angle * rot.m22;
+        result.m02 = cos_angle * rot.m02 - sin_angle * rot.m01;
+        result.m12 = cos_angle * rot.m12 - sin_angle * rot.m11;
+        result.m22 = cos_angle * rot.m22 - sin_angle * rot.m21;
+    }
+    else if (axis_index == 1U)
+    {
+        result.m00 = cos_angle * rot.m00 - sin_angle * rot.m02;
+        result.m10 = cos_angle * rot.m10 - sin_angle * rot.m12;
+        result.m20 = cos_angle * rot.m20 - sin_angle * rot.m22;
+        result.m02 = cos_angle * rot.m02 + sin_angle * rot.m00;
+        result.m12 = cos_angle * rot.m12 + sin_angle * rot.m10;
+        result.m22 = cos_angle * rot.m22 + sin_angle * rot.m20;
+    }
+    else
+    {
+        result.m00 = cos_angle * rot.m00 + sin_angle * rot.m01;
+        result.m10 = cos_angle * rot.m10 + sin_angle * rot.m11;
+        result.m20 = cos_angle * rot.m20 + sin_angle * rot.m21;
+        result.m01 = cos_angle * rot.m01 - sin_angle * rot.m00;
+        result.m11 = cos_angle * rot.m11 - sin_angle * rot.m10;
+        result.m21 = cos_angle * rot.m21 - sin_angle * rot.m20;
+    }
+    return result;
+}
+
+bool dynamics_model_compile(const BodyTree& body_tree, DynamicsModel& model)
+{
+    KinematicProgram program = {};
+    bool             result = kinematic_program_compile(body_tree, program);
+    model.num_bodies = 0U;
+    model.num_dofs = 0U;
+    if (result)
+    {
+        model.num_bodies = body_tree.get_num_bodies();
+        model.num_dofs = body_tree.get_num_dofs();
+        model.gravity = body_tree.get_gravity();
+        for (size_t index = 0U; index < model.num_bodies; ++index)
+        {
+            auto             err = BodyTreeError::SUCCESS;
+            const Body       body = body_tree.get_body(index, err);
+            const MassProps& mass_props = body.mass_props;
+            DynamicsBody&    dyn_body = model.body[index];
+            dyn_body = {};
+            dyn_body.parent_joint_rotation = rot_identity();
+            dyn_body.mass = mass_props.mass;
+            dyn_body.mass_com = vector_scale(mass_props.mass, mass_props.com);
+            dyn_body.inertia
+                = body_parallel_axis_inertia(mass_props.mass, mass_props.com, mass_props.inertia);
+        }
+        for (size_t op_index = 0U; op_index < program.num_ops; ++op_index)
+        {
+            const KinematicOp& kin_op = program.op[op_index];
+            DynamicsBody&      dyn_body = model.body[kin_op.child_index];
+            dyn_body.kind = kin_op.kind;
+            dyn_body.parent_index = kin_op.parent_index;
+            dyn_body.coord_index = kin_op.coord_index;
+            dyn_body.dof_index = kin_op.dof_index;
+            dyn_body.num_dofs = kin_op.num_dofs;
+            dyn_body.axis_index = (kin_op.axis.y > 0.5) ? 1U : ((kin_op.axis.z > 0.5) ? 2U : 0U);
+            dyn_body.sign = kin_op.sign;
+            if (kin_op.kind != KinematicOpKind::IDENTITY)
+            {
+                dyn_body.parent_joint_rotation = quat_to_rot(kin_op.parent_joint_transform.rotation);
+                dyn_body.parent_joint_translation = kin_op.parent_joint_transform.translation;
+            }
+        }
+    }
+    return result;
+}
+
+static DynamicsJointTransform
+dynamics_joint_transform(const DynamicsBody& body, const JointSpacePosition& position)
+{
+    const size_t           coord = body.coord_index;
+    DynamicsJointTransform result
+        = {body.parent_joint_rotation, body.parent_joint_translation, rot_identity()};
+    switch (body.kind)
+    {
+        case KinematicOpKind::REVOLUTE:
+        {
+            const Real angle = body.sign * position.q[coord];
+            result.rotation = mat3_multiply_axis_rotation(
+                body.parent_joint_rotation, body.axis_index, cos(angle), sin(angle));
+            break;
+        }
+        case KinematicOpKind::PRISMATIC:
+        {
+            result.translation = vector_add(
+                body.parent_joint_translation,
+                rotate_mat3(
+                    body.parent_joint_rotation,
+                    axis_vector(body.axis_index, body.sign * position.q[coord])));
+            break;
+        }
+        case KinematicOpKind::SPHERICAL:
+        {
+            result.joint_rotation = quat_to_rot(
+                {position.q[coord], position.q[coord + 1U], position.q[coord + 2U], position.q[coord + 3U]});
+            result.rotation = mat3_multiply(body.parent_joint_rotation, result.joint_rotation);
+            break;
+        }
+        case KinematicOpKind::CARTESIAN:
+        {
+            result.joint_rotation = quat_to_rot(
+                {position.q[coord], position.q[coord + 1U], position.q[coord + 2U], position.q[coord + 3U]});
+            result.rotation = mat3_multiply(body.parent_joint_rotation, result.joint_rotation);
+            result.translation = vector_add(
+                body.parent_joint_translation,
+                rotate_mat3(
+                    body.parent_joint_rotation,
+                    {position.q[coord + 4U], position.q[coord + 5U], position.q[coord + 6U]}));
+            break;
+        }
+        case KinematicOpKind::FIXED:
+        case KinematicOpKind::IDENTITY:
+        default:
+        {
+            // constant transform
+            break;
+        }
+    }
+    return result;
+}
+
+/**
+ * Joint velocity or acceleration of child relative to parent in child coordinates
+ */
+static MotionVector dynamics_joint_motion(
+    const DynamicsBody& body, const DynamicsJointTransform& transform, const JointSpace& motion)
+{
+    const size_t dof = body.dof_index;
+    MotionVector result = {};
+    switch (body.kind)
+    {
+        case KinematicOpKind::REVOLUTE:
+        {
+            result.angular = axis_vector(body.axis_index, body.sign * motion.qv[dof]);
+            break;
+        }
+        case KinematicOpKind::PRISMATIC:
+        {
+            result.linear = axis_vector(body.axis_index, body.sign * motion.qv[dof]);
+            break;
+        }
+        case KinematicOpKind::SPHERICAL:
+        {
+            result.angular = rotate_mat3_transpose(
+                transform.joint_rotation, {motion.qv[dof], motion.qv[dof + 1U], motion.qv[dof + 2U]});
+            break;
+        }
+        case KinematicOpKind::CARTESIAN:
+        {
+            result.angular = rotate_mat3_transpose(
+                transform.joint_rotation, {motion.qv[dof], motion.qv[dof + 1U], motion.qv[dof + 2U]});
+            result.linear = rotate_mat3_transpose(
+                transform.joint_rotation,
+                {motion.qv[dof + 3U], motion.qv[dof + 4U], motion.qv[dof + 5U]});
+            break;
+        }
+        case KinematicOpKind::FIXED:
+        case KinematicOpKind::IDENTITY:
+        default:
+        {
+            // no joint motion
+            break;
+        }
+    }
+    return result;
+}
+
+/**
+ * Joint torque from force at child origin in child coordinates
+ */
+static void dynamics_joint_torque(
+    const DynamicsBody& body, const DynamicsJointTransform& transform, const ForceVector& force,
+    JointSpace& joint_torque)
+{
+    const size_t dof = body.dof_index;
+    switch (body.kind)
+    {
+        case KinematicOpKind::REVOLUTE:
+        {
+            joint_torque.qv[dof] = body.sign * vector_element(force.torque, body.axis_index);
+            break;
+        }
+        case KinematicOpKind::PRISMATIC:
+        {
+            joint_torque.qv[dof] = body.sign * vector_element(force.force, body.axis_index);
+            break;
+        }
+        case KinematicOpKind::SPHERICAL:
+        {
+            const Vec3 torque = rotate_mat3(transform.joint_rotation, force.torque);
+            joint_torque.qv[dof] = torque.x;
+            joint_torque.qv[dof + 1U] = torque.y;
+            joint_torque.qv[dof + 2U] = torque.z;
+            break;
+        }
+        case KinematicOpKind::CARTESIAN:
+        {
+            const Vec3 torque = rotate_mat3(transform.joint_rotation, force.torque);
+            const Vec3 lin_force = rotate_mat3(transform.joint_rotation, force.force);
+            joint_torque.qv[dof] = torque.x;
+            joint_torque.qv[dof + 1U] = torque.y;
+            joint_torque.qv[dof + 2U] = torque.z;
+            joint_torque.qv[dof + 3U] = lin_force.x;
+            joint_torque.qv[dof + 4U] = lin_force.y;
+            joint_torque.qv[dof + 5U] = lin_force.z;
+            break;
+        }
+        case KinematicOpKind::FIXED:
+        case KinematicOpKind::IDENTITY:
+        default:
+        {
+            // no joint degrees of freedom
+            break;
+        }
+    }
+}
+
+/**
+ * Force at body origin from body motion in body coordinates
+ */
+static ForceVector dynamics_body_force(
+    const DynamicsBody& body, const Vec3& vel_angular, const MotionVector& acceleration,
+    const ForceVector& external_force)
+{
+    const Vec3 force_dyn = vector_add(
+        vector_scale(body.mass, acceleration.linear),
+        vector_add(
+            vector_cross(acceleration.angular, body.mass_com),
+            vector_cross(vel_angular, vector_cross(vel_angular, body.mass_com))));
+    const Vec3 torque_dyn = vector_add(
+        vector_add(
+            inertia_multiply_vector(body.inertia, acceleration.angular),
+            inertia_cross_multiply_vector(body.inertia, vel_angular)),
+        vector_cross(body.mass_com, acceleration.linear));
+    return {
+        vector_subtract(torque_dyn, external_force.torque),
+        vector_subtract(force_dyn, external_force.force)};
+}
+
+/**
+ * Force at child origin in child coordinates to force at parent origin in parent coordinates
+ */
+static ForceVector
+dynamics_force_to_parent(const DynamicsJointTransform& transform, const ForceVector& child_force)
+{
+    const Vec3 force = rotate_mat3(transform.rotation, child_force.force);
+    return {
+        vector_add(
+            rotate_mat3(transform.rotation, child_force.torque),
+            vector_cross(transform.translation, force)),
+        force};
+}
+
+/**
+ * Joint torques from body forces, forces of each body are added to its parent from leaves to base
+ */
+static JointSpace dynamics_backward_pass(
+    const DynamicsModel& model, const std::array<DynamicsJointTransform, MaxSize::kBodies>& transform,
+    BodyForce& body_force)
+{
+    JointSpace result = {};
+    for (size_t count = model.num_bodies; count > 1U; --count)
+    {
+        const size_t        index = count - 1U;
+        const DynamicsBody& body = model.body[index];
+        dynamics_joint_torque(body, transform[index], body_force.body[index], result);
+        const ForceVector force_child
+            = dynamics_force_to_parent(transform[index], body_force.body[index]);
+        ForceVector& parent_force = body_force.body[body.parent_index];
+        parent_force.force = vector_add(parent_force.force, force_child.force);
+        parent_force.torque = vector_add(parent_force.torque, force_child.torque);
+    }
+    return result;
+}
+
+/**
+ * Forward pass of body motion and body forces in body coordinates from base motion in base
+ * coordinates, joint acceleration terms are skipped without joint acceleration
+ */
+static void dynamics_forward_pass(
+    const DynamicsModel& model, const JointSpacePosition& joint_position,
+    const JointSpace& joint_velocity, const JointSpace* joint_acceleration,
+    const Vec3& base_vel_angular, const MotionVector& base_acceleration,
+    const BodyForce& external_force, std::array<DynamicsJointTransform, MaxSize::kBodies>& transform,
+    BodyForce& body_force)
+{
+    std::array<Vec3, MaxSize::kBodies>         vel_angular = {};
+    std::array<MotionVector, MaxSize::kBodies> acceleration = {};
+
+    constexpr size_t BaseIndex = 0U;
+    vel_angular[BaseIndex] = base_vel_angular;
+    acceleration[BaseIndex] = base_acceleration;
+    body_force.body[BaseIndex] = dynamics_body_force(
+        model.body[BaseIndex], vel_angular[BaseIndex], acceleration[BaseIndex],
+        external_force.body[BaseIndex]);
+
+    for (size_t index = 1U; index < model.num_bodies; ++index)
+    {
+        const DynamicsBody& body = model.body[index];
+        const size_t        parent = body.parent_index;
+        transform[index] = dynamics_joint_transform(body, joint_position);
+        const DynamicsJointTransform& tr_pc = transform[index];
+        const MotionVector joint_vel = dynamics_joint_motion(body, tr_pc, joint_velocity);
+        const MotionVector joint_acc = (joint_acceleration != nullptr)
+                                           ? dynamics_joint_motion(body, tr_pc, *joint_acceleration)
+                                           : MotionVector{};
+        // parent motion at child origin in parent coordinates
+        const Vec3&         vel_parent = vel_angular[parent];
+        const MotionVector& acc_parent = acceleration[parent];
+        const Vec3          acc_origin = vector_add(
+            acc_parent.linear,
+            vector_add(
+                vector_cross(acc_parent.angular, tr_pc.translation),
+                vector_cross(vel_parent, vector_cross(vel_parent, tr_pc.translation))));
+        // child motion in child coordinates
+        const Vec3 vel_parent_child = rotate_mat3_transpose(tr_pc.rotation, vel_parent);
+        vel_angular[index] = vector_add(vel_parent_child, joint_vel.angular);
+        acceleration[index].angular = vector_add(
+            rotate_mat3_transpose(tr_pc.rotation, acc_parent.angular),
+            vector_add(vector_cross(vel_parent_child, joint_vel.angular), joint_acc.angular));
+        acceleration[index].linear = vector_add(
+            rotate_mat3_transpose(tr_pc.rotation, acc_origin),
+            vector_add(
+                vector_scale(2.0, vector_cross(vel_parent_child, joint_vel.linear)),
+                joint_acc.linear));
+        body_force.body[index] = dynamics_body_force(
+            body, vel_angular[index], acceleration[index], external_force.body[index]);
+    }
+}
+
+JointSpace inverse_dynamics_rnea(
+    const DynamicsModel& model, const JointPva& joint_pva, const CartesianPva& base_pva,
+    const BodyForce& external_force, BodyForce& body_force)
+{
+    std::array<DynamicsJointTransform, MaxSize::kBodies> transform = {};
+
+    // base motion in base coordinates, gravity as upward acceleration of base
+    Quaternion base_rotation = base_pva.pose.rotation;
+    quat_normalize(base_rotation);
+    const Quaternion   base_inverse = quat_conjugate(base_rotation);
+    const MotionVector base_acceleration
+        = {quat_rotate_vector(base_inverse, base_pva.acceleration.angular),
+           quat_rotate_vector(
+               base_inverse, vector_subtract(base_pva.acceleration.linear, model.gravity))};
+    dynamics_forward_pass(
+        model, joint_pva.position, joint_pva.velocity, &joint_pva.acceleration,
+        quat_rotate_vector(base_inverse, base_pva.velocity.angular), base_acceleration,
+        external_force, transform, body_force);
+
+    return dynamics_backward_pass(model, transform, body_force);
+}
+
+JointSpace gravity_torques(
+    const DynamicsModel& model, const JointSpacePosition& joint_position, const Transform& base_pose)
+{
+    std::array<DynamicsJointTransform, MaxSize::kBodies> transform = {};
+    std::array<Vec3, MaxSize::kBodies>                   acceleration = {};
+    BodyForce                                            body_force = {};
+
+    // gravity as upward acceleration of base in base coordinates, bodies at rest
+    constexpr size_t BaseIndex = 0U;
+    Quaternion       base_rotation = base_pose.rotation;
+    quat_normalize(base_rotation);
+    acceleration[BaseIndex] = quat_rotate_vector(
+        quat_conjugate(base_rotation), vector_subtract(Vec3{}, model.gravity));
+    for (size_t index = 1U; index < model.num_bodies; ++index)
+    {
+        const DynamicsBody& body = model.body[index];
+        transform[index] = dynamics_joint_transform(body, joint_position);
+        acceleration[index]
+            = rotate_mat3_transpose(transform[index].rotation, acceleration[body.parent_index]);
+        body_force.body[index]
+            = {vector_cross(body.mass_com, acceleration[index]),
+               vector_scale(body.mass, acceleration[index])};
+    }
+    return dynamics_backward_pass(model, transform, body_force);
+}
+
+JointSpace coriolis_torques(
+    const DynamicsModel& model, const JointSpacePosition& joint_position,
+    const JointSpace& joint_velocity)
+{
+    std::array<DynamicsJointTransform, MaxSize::kBodies> transform = {};
+    const BodyForce                                      external_force = {};
+    BodyForce                                            body_force = {};
+
+    // base at rest, no gravity and no joint acceleration
+    dynamics_forward_pass(
+        model, joint_position, joint_velocity, nullptr, {}, {}, external_force, transform, body_force);
+    return dynamics_backward_pass(model, transform, body_force);
+}
+
+/**
+ * Rigid body inertia at body origin in body coordinates
+ */
+struct DynamicsInertia
+{
+    Real    mass = 0.0; ///< Mass
+    Vec3    mass_com = {}; ///< Mass times center of mass
+    Inertia inertia = {}; ///< Rotational inertia about origin
+};
+
+/**
+ * Child inertia in parent coordinates about parent origin
+ */
+static DynamicsInertia
+dynamics_inertia_to_parent(const DynamicsJointTransform& transform, const DynamicsInertia& child)
+{
+    // rotate inertia, R I R^T from rows of R
+    const Mat3& rot = transform.rotation;
+    const Vec3  rot_row_0 = {rot.m00, rot.m01, rot.m02};
+    const Vec3  rot_row_1 = {rot.m10, rot.m11, rot.m12};
+    const Vec3  rot_row_2 = {rot.m20, rot.m21, rot.m22};
+    const Vec3  inertia_row_0 = inertia_multiply_vector(child.inertia, rot_row_0);
+    const Vec3  inertia_row_1 = inertia_multiply_vector(child.inertia, rot_row_1);
+    const Vec3  inertia_row_2 = inertia_multiply_vector(child.inertia, rot_row_2);
+    // shift origin by r with first moment h, adds (r.(m r + 2 h)) 1 - (m r + h) r^T - r h^T
+    const Vec3& trans = transform.translation;
+    const Vec3  mass_com = rotate_mat3(rot, child.mass_com);
+    const Vec3  mass_com_shift = vector_add(mass_com, vector_scale(child.mass, trans));
+    const Real  shift_diag = vector_dot(trans, vector_add(mass_com_shift, mass_com));
+
+    DynamicsInertia result = {};
+    result.mass = child.mass;
+    result.mass_com = mass_com_shift;
+    result.inertia
+        = {vector_dot(rot_row_0, inertia_row_0) + shift_diag
+               - (mass_com_shift.x * trans.x + trans.x * mass_com.x),
+           vector_dot(rot_row_1, inertia_row_1) + shift_diag
+               - (mass_com_shift.y * trans.y + trans.y * mass_com.y),
+           vector_dot(rot_row_2, inertia_row_2) + shift_diag
+               - (mass_com_shift.z * trans.z + trans.z * mass_com.z),
+           vector_dot(rot_row_0, inertia_row_1) - (mass_com_shift.x * trans.y + trans.x * mass_com.y),
+           vector_dot(rot_row_0, inertia_row_2) - (mass_com_shift.x * trans.z + trans.x * mass_com.z),
+           vector_dot(rot_row_1, inertia_row_2) - (mass_com_shift.y * trans.z + trans.y * mass_com.z)};
+    return result;
+}
+
+/**
+ * Momentum of rigid body inertia with spatial motion at body origin
+ */
+static ForceVector dynamics_inertia_multiply(const DynamicsInertia& body, const MotionVector& motion)
+{
+    return {
+        vector_add(
+            inertia_multiply_vector(body.inertia, motion.angular),
+            vector_cross(body.mass_com, motion.linear)),
+        vector_subtract(
+            vector_scale(body.mass, motion.linear), vector_cross(body.mass_com, motion.angular))};
+}
+
+bool mass_matrix_crba(
+    const DynamicsModel& model, const JointSpacePosition& joint_position, const MassMatrixOption opt,
+    JointMatrix& mass_matrix)
+{
+    std::array<DynamicsJointTransform, MaxSize::kBodies> transform = {};
+    std::array<DynamicsInertia, MaxSize::kBodies>        composite = {};
+    for (size_t index = 0U; index < model.num_bodies; ++index)
+    {
+        const DynamicsBody& body = model.body[index];
+        transform[index] = dynamics_joint_transform(body, joint_position);
+        composite[index] = {body.mass, body.mass_com, body.inertia};
+    }
+
+    // composite inertias from leaves to base
+    for (size_t count = model.num_bodies; count > 1U; --count)
+    {
+        const size_t          index = count - 1U;
+        const DynamicsInertia child = dynamics_inertia_to_parent(transform[index], composite[index]);
+        DynamicsInertia&      parent = composite[model.body[index].parent_index];
+        parent.mass += child.mass;
+        parent.mass_com = vector_add(parent.mass_com, child.mass_com);
+        parent.inertia
+            = {parent.inertia.ixx + child.inertia.ixx,
+               parent.inertia.iyy + child.inertia.iyy,
+               parent.inertia.izz + child.inertia.izz,
+               parent.inertia.ixy + child.inertia.ixy,
+               parent.inertia.ixz + child.inertia.ixz,
+               parent.inertia.iyz + child.inertia.iyz};
+    }
+
+    // lower triangle, column of each joint degree of freedom projected on joints toward base
+    const size_t dofs = model.num_dofs;
+    mass_matrix = {};
+    for (size_t index = 1U; index < model.num_bodies; ++index)
+    {
+        const DynamicsBody& body = model.body[index];
+        for (size_t dof = 0U; dof < body.num_dofs; ++dof)
+        {
+            const size_t col = body.dof_index + dof;
+            JointSpace   unit_motion = {};
+            unit_motion.qv[col] = 1.0;
+            ForceVector force = dynamics_inertia_multiply(
+                composite[index], dynamics_joint_motion(body, transform[index], unit_motion));
+            JointSpace column = {};
+            for (size_t ancestor = index; ancestor != BodyTree::kBaseIndex;
+                 ancestor = model.body[ancestor].parent_index)
+            {
+                dynamics_joint_torque(model.body[ancestor], transform[ancestor], force, column);
+                force = dynamics_force_to_parent(transform[ancestor], force);
+            }
+            for (size_t row = 0U; row <= col; ++row)
+            {
+                mass_matrix.j[joint_matrix_index(col, row, dofs)] = column.qv[row];
+            }
+        }
+    }
+
+    bool result = true;
+    if (opt == MassMatrixOption::FULL)
+    {
+        for (size_t col = 1U; col < dofs; ++col)
+        {
+            for (size_t row = 0U; row < col; ++row)
+            {
+                mass_matrix.j[joint_matrix_index(row, col, dofs)]
+                    = mass_matrix.j[joint_matrix_index(col, row, dofs)];
+            }
+        }
+    }
+    else if ((opt == MassMatrixOption::CHOLESKY) && (dofs > kLinalgFixedMaxDim))
+    {
+        // LAPACK factor for more degrees of freedom than the fixed size factorization supports
+        const JointMatrix mass_lower = mass_matrix;
+        result = fsb_linalg_cholesky_decomposition(mass_lower.j.data(), dofs, mass_matrix.j.data())
+                 == EFSB_LAPACK_ERROR_NONE;
+    }
+    else if ((opt == MassMatrixOption::CHOLESKY) && (dofs > 0U))
+    {
+        result = linalg_fixed_cholesky_factor(dofs, mass_matrix.j.data()) == EFSB_LAPACK_ERROR_NONE;
+    }
+    else
+    {
+        // lower triangle
+    }
+    return result;
+}
+
+bool mass_matrix_crba(
+    const BodyTree& body_tree, const JointSpacePosition& joint_position, const MassMatrixOption opt,
+    JointMatrix& mass_matrix)
+{
+    DynamicsModel model = {};
+    bool          result = dynamics_model_compile(body_tree, model);
+    if (result)
+    {
+        result = mass_matrix_crba(model, joint_position, opt, mass_matrix);
+    }
+    return result;
+}
+
+/**
+ * Spatial vector of angular and linear parts, or torque and force parts
+ */
+using DynamicsSpatialVector = std::array<Real, FSB_CART_SIZE>;
+
+/**
+ * Spatial matrix (6 x 6), column major
+ */
+using DynamicsSpatialMatrix = std::array<Real, FSB_CART_SIZE * FSB_CART_SIZE>;
+
+static size_t spatial_index(const size_t row, const size_t col)
+{
+    return FSB_CART_SIZE * col + row;
+}
+
+static DynamicsSpatialVector spatial_from_motion(const MotionVector& motion)
+{
+    return {
+        motion.angular.x,
+        motion.angular.y,
+        motion.angular.z,
+        motion.linear.x,
+        motion.linear.y,
+        motion.linear.z};
+}
+
+static DynamicsSpatialVector spatial_from_force(const ForceVector& force)
+{
+    return {
+        force.torque.x, force.torque.y, force.torque.z, force.force.x, force.force.y, force.force.z};
+}
+
+static MotionVector spatial_to_motion(const DynamicsSpatialVector& vec)
+{
+    return {{vec[0U], vec[1U], vec[2U]}, {vec[3U], vec[4U], vec[5U]}};
+}
+
+static ForceVector spatial_to_force(const DynamicsSpatialVector& vec)
+{
+    return {{vec[0U], vec[1U], vec[2U]}, {vec[3U], vec[4U], vec[5U]}};
+}
+
+static Real spatial_dot(const DynamicsSpatialVector& vec_a, const DynamicsSpatialVector& vec_b)
+{
+    Real result = 0.0;
+    for (size_t index = 0U; index < FSB_CART_SIZE; ++index)
+    {
+        result += vec_a[index] * vec_b[index];
+    }
+    return result;
+}
+
+static DynamicsSpatialVector
+spatial_multiply(const DynamicsSpatialMatrix& mat, const DynamicsSpatialVector& vec)
+{
+    DynamicsSpatialVector result = {};
+    for (size_t col = 0U; col < FSB_CART_SIZE; ++col)
+    {
+        for (size_t row = 0U; row < FSB_CART_SIZE; ++row)
+        {
+            result[row] += mat[spatial_index(row, col)] * vec[col];
+        }
+    }
+    return result;
+}
+
+static Mat3 spatial_block(const DynamicsSpatialMatrix& mat, const size_t row, const size_t col)
+{
+    return {
+        mat[spatial_index(row, col)],
+        mat[spatial_index(row + 1U, col)],
+        mat[spatial_index(row + 2U, col)],
+        mat[spatial_index(row, col + 1U)],
+        mat[spatial_index(row + 1U, col + 1U)],
+        mat[spatial_index(row + 2U, col + 1U)],
+        mat[spatial_index(row, col + 2U)],
+        mat[spatial_index(row + 1U, col + 2U)],
+        mat[spatial_index(row + 2U, col + 2U)]};
+}
+
+static void
+spatial_set_block(const Mat3& block, const size_t row, const size_t col, DynamicsSpatialMatrix& mat)
+{
+    mat[spatial_index(row, col)] = block.m00;
+    mat[spatial_index(row + 1U, col)] = block.m10;
+    mat[spatial_index(row + 2U, col)] = block.m20;
+    mat[spatial_index(row, col + 1U)] = block.m01;
+    mat[spatial_index(row + 1U, col + 1U)] = block.m11;
+    mat[spatial_index(row + 2U, col + 1U)] = block.m21;
+    mat[spatial_index(row, col + 2U)] = block.m02;
+    mat[spatial_index(row + 1U, col + 2U)] = block.m12;
+    mat[spatial_index(row + 2U, col + 2U)] = block.m22;
+}
+
+/**
+ * Rigid body inertia [I, h x; -h x, m] maps acceleration at body origin to force
+ */
+static void spatial_rigid_inertia(const DynamicsBody& body, DynamicsSpatialMatrix& result)
+{
+    const Inertia& inertia = body.inertia;
+    const Mat3     skew = skew_symmetric(body.mass_com);
+    spatial_set_block(
+        {inertia.ixx,
+         inertia.ixy,
+         inertia.ixz,
+         inertia.ixy,
+         inertia.iyy,
+         inertia.iyz,
+         inertia.ixz,
+         inertia.iyz,
+         inertia.izz},
+        0U,
+        0U,
+        result);
+    spatial_set_block(skew, 0U, 3U, result);
+    spatial_set_block(mat3_transpose(skew), 3U, 0U, result);
+    spatial_set_block({body.mass, 0.0, 0.0, 0.0, body.mass, 0.0, 0.0, 0.0, body.mass}, 3U, 3U, result);
+}
+
+/**
+ * Child articulated inertia [A, B; B^T, C] in parent coordinates about parent origin, X^T I X with
+ * force transform X^T = [R, r x R; 0, R] of @c dynamics_force_to_parent
+ */
+static DynamicsSpatialMatrix spatial_inertia_to_parent(
+    const DynamicsJointTransform& transform, const DynamicsSpatialMatrix& child)
+{
+    const Mat3& rot = transform.rotation;
+    const Mat3  rot_t = mat3_transpose(rot);
+    const Mat3  shift_rot = mat3_multiply(skew_symmetric(transform.translation), rot);
+    const Mat3  block_a = spatial_block(child, 0U, 0U);
+    const Mat3  block_b = spatial_block(child, 0U, 3U);
+    const Mat3  block_c = spatial_block(child, 3U, 3U);
+    // X^T I = [R A + (r x R) B^T, R B + (r x R) C; R B^T, R C]
+    const Mat3 force_a
+        = mat3_add(mat3_multiply(rot, block_a), mat3_multiply(shift_rot, mat3_transpose(block_b)));
+    const Mat3 force_b = mat3_add(mat3_multiply(rot, block_b), mat3_multiply(shift_rot, block_c));
+    const Mat3 block_b_parent = mat3_multiply(force_b, rot_t);
+
+    DynamicsSpatialMatrix result = {};
+    spatial_set_block(
+        mat3_add(
+            mat3_multiply(force_a, rot_t), mat3_multiply(force_b, mat3_transpose(shift_rot))),
+        0U,
+        0U,
+        result);
+    spatial_set_block(block_b_parent, 0U, 3U, result);
+    spatial_set_block(mat3_transpose(block_b_parent), 3U, 0U, result);
+    spatial_set_block(mat3_multiply(mat3_multiply(rot, block_c), rot_t), 3U, 3U, result);
+    return result;
+}
+
+/**
+ * Articulated Body Algorithm quantities of a body
+ */
+struct DynamicsArticulatedBody
+{
+    DynamicsSpatialMatrix inertia = {}; ///< Articulated inertia
+    DynamicsSpatialVector bias_force = {}; ///< Articulated bias force
+    DynamicsSpatialVector bias_acceleration = {}; ///< Velocity product acceleration
+    DynamicsSpatialMatrix motion = {}; ///< Joint motion subspace, one column per joint dof
+    DynamicsSpatialMatrix inertia_motion = {}; ///< Articulated inertia times motion subspace
+    DynamicsSpatialMatrix joint_inertia = {}; ///< Joint inertia (dofs x dofs) factored by aba_joint_factor
+    DynamicsSpatialVector joint_force = {}; ///< Joint torque less bias force
+};
+
+/**
+ * Factor joint inertia D (dofs x dofs), single degree of freedom joints keep D
+ */
+static bool aba_joint_factor(const size_t dofs, DynamicsSpatialMatrix& joint_inertia)
+{
+    bool result = true;
+    if (dofs == 1U)
+    {
+        result = joint_inertia[0U] > 0.0;
+    }
+    else if (dofs > 1U)
+    {
+        result = linalg_fixed_cholesky_factor(dofs, joint_inertia.data()) == EFSB_LAPACK_ERROR_NONE;
+    }
+    else
+    {
+        // no joint degrees of freedom
+    }
+    return result;
+}
+
+/**
+ * Solve with factor of @c aba_joint_factor in place
+ */
+static void
+aba_joint_solve(const size_t dofs, const DynamicsSpatialMatrix& joint_inertia, Real x_vec[])
+{
+    if (dofs == 1U)
+    {
+        x_vec[0U] /= joint_inertia[0U];
+    }
+    else if (dofs > 1U)
+    {
+        (void)linalg_fixed_cholesky_solve(dofs, joint_inertia.data(), x_vec);
+    }
+    else
+    {
+        // no joint degrees of freedom
+    }
+}
+
+/**
+ * Velocities, bias accelerations and rigid body inertias from base to leaves
+ */
+static void aba_forward_velocity(
+    const DynamicsModel& model, const JointSpacePosition& joint_position,
+    const JointSpace& joint_velocity, const Vec3& base_vel_angular, const BodyForce& external_force,
+    std::array<DynamicsJointTransform, MaxSize::kBodies>&  transform,
+    std::array<DynamicsArticulatedBody, MaxSize::kBodies>& articulated)
+{
+    std::array<Vec3, MaxSize::kBodies> vel_angular = {};
+    vel_angular[0U] = base_vel_angular;
+    for (size_t index = 1U; index < model.num_bodies; ++index)
+    {
+        const DynamicsBody& body = model.body[index];
+        transform[index] = dynamics_joint_transform(body, joint_position);
+        const DynamicsJointTransform& tr_pc = transform[index];
+        DynamicsArticulatedBody&      art = articulated[index];
+
+        // joint motion subspace and velocity in child coordinates
+        for (size_t dof = 0U; dof < body.num_dofs; ++dof)
+        {
+            JointSpace unit_motion = {};
+            unit_motion.qv[body.dof_index + dof] = 1.0;
+            const DynamicsSpatialVector column
+                = spatial_from_motion(dynamics_joint_motion(body, tr_pc, unit_motion));
+            for (size_t row = 0U; row < FSB_CART_SIZE; ++row)
+            {
+                art.motion[spatial_index(row, dof)] = column[row];
+            }
+        }
+        const MotionVector joint_vel = dynamics_joint_motion(body, tr_pc, joint_velocity);
+        const Vec3&        vel_parent = vel_angular[body.parent_index];
+        const Vec3         vel_parent_child = rotate_mat3_transpose(tr_pc.rotation, vel_parent);
+        vel_angular[index] = vector_add(vel_parent_child, joint_vel.angular);
+
+        // acceleration terms of inverse_dynamics_rnea that do not depend on acceleration
+        const Vec3 acc_normal = rotate_mat3_transpose(
+            tr_pc.rotation, vector_cross(vel_parent, vector_cross(vel_parent, tr_pc.translation)));
+        art.bias_acceleration = spatial_from_motion(
+            {vector_cross(vel_parent_child, joint_vel.angular),
+             vector_add(
+                 acc_normal, vector_scale(2.0, vector_cross(vel_parent_child, joint_vel.linear)))});
+
+        // rigid body inertia and bias force
+        spatial_rigid_inertia(body, art.inertia);
+        art.bias_force = spatial_from_force(
+            dynamics_body_force(body, vel_angular[index], {}, external_force.body[index]));
+    }
+}
+
+/**
+ * Articulated body inertias and bias forces from leaves to base
+ */
+static bool aba_backward_inertia(
+    const DynamicsModel& model, const JointSpace& joint_torque,
+    const std::array<DynamicsJointTransform, MaxSize::kBodies>& transform,
+    std::array<DynamicsArticulatedBody, MaxSize::kBodies>&      articulated)
+{
+    bool result = true;
+    for (size_t count = model.num_bodies; result && (count > 1U); --count)
+    {
+        const size_t             index = count - 1U;
+        const DynamicsBody&      body = model.body[index];
+        const size_t             dofs = body.num_dofs;
+        DynamicsArticulatedBody& art = articulated[index];
+
+        // U = I S, D = S^T U, u = tau - S^T p
+        art.joint_inertia = {};
+        for (size_t dof = 0U; dof < dofs; ++dof)
+        {
+            DynamicsSpatialVector motion_col = {};
+            for (size_t row = 0U; row < FSB_CART_SIZE; ++row)
+            {
+                motion_col[row] = art.motion[spatial_index(row, dof)];
+            }
+            const DynamicsSpatialVector inertia_col = spatial_multiply(art.inertia, motion_col);
+            for (size_t row = 0U; row < FSB_CART_SIZE; ++row)
+            {
+                art.inertia_motion[spatial_index(row, dof)] = inertia_col[row];
+            }
+            for (size_t row = 0U; row < dofs; ++row)
+            {
+                Real value = 0.0;
+                for (size_t ind = 0U; ind < FSB_CART_SIZE; ++ind)
+                {
+                    value += art.motion[spatial_index(ind, row)] * inertia_col[ind];
+                }
+                art.joint_inertia[dofs * dof + row] = value;
+            }
+            art.joint_force[dof]
+                = joint_torque.qv[body.dof_index + dof] - spatial_dot(motion_col, art.bias_force);
+        }
+        result = aba_joint_factor(dofs, art.joint_inertia);
+
+        if (result && (body.parent_index != BodyTree::kBaseIndex))
+        {
+            // I_a = I - U D^-1 U^T, p_a = p + I_a c + U D^-1 u
+            DynamicsSpatialMatrix inertia_a = art.inertia;
+            for (size_t col = 0U; (dofs > 0U) && (col < FSB_CART_SIZE); ++col)
+            {
+                // column of D^-1 U^T from row of U
+                DynamicsSpatialVector solve = {};
+                for (size_t dof = 0U; dof < dofs; ++dof)
+                {
+                    solve[dof] = art.inertia_motion[spatial_index(col, dof)];
+                }
+                aba_joint_solve(dofs, art.joint_inertia, solve.data());
+                for (size_t row = 0U; row < FSB_CART_SIZE; ++row)
+                {
+                    for (size_t dof = 0U; dof < dofs; ++dof)
+                    {
+                        inertia_a[spatial_index(row, col)]
+                            -= art.inertia_motion[spatial_index(row, dof)] * solve[dof];
+                    }
+                }
+            }
+            DynamicsSpatialVector joint_solve = art.joint_force;
+            aba_joint_solve(dofs, art.joint_inertia, joint_solve.data());
+            DynamicsSpatialVector bias_a = spatial_multiply(inertia_a, art.bias_acceleration);
+            for (size_t row = 0U; row < FSB_CART_SIZE; ++row)
+            {
+                bias_a[row] += art.bias_force[row];
+                for (size_t dof = 0U; dof < dofs; ++dof)
+                {
+                    bias_a[row] += art.inertia_motion[spatial_index(row, dof)] * joint_solve[dof];
+                }
+            }
+
+            // accumulate on parent
+            DynamicsArticulatedBody&    parent = articulated[body.parent_index];
+            const DynamicsSpatialMatrix inertia_parent
+                = spatial_inertia_to_parent(transform[index], inertia_a);
+            const DynamicsSpatialVector bias_parent = spatial_from_force(
+                dynamics_force_to_parent(transform[index], spatial_to_force(bias_a)));
+            for (size_t elem = 0U; elem < inertia_parent.size(); ++elem)
+            {
+                parent.inertia[elem] += inertia_parent[elem];
+            }
+            for (size_t row = 0U; row < FSB_CART_SIZE; ++row)
+            {
+                parent.bias_force[row] += bias_parent[row];
+            }
+        }
+    }
+    return result;
+}
+
+/**
+ * Joint and body accelerations from base to leaves
+ */
+static void aba_forward_acceleration(
+    const DynamicsModel& model, const MotionVector& base_acceleration,
+    const std::array<DynamicsJointTransform, MaxSize::kBodies>&  transform,
+    const std::array<DynamicsArticulatedBody, MaxSize::kBodies>& articulated,
+    JointSpace&                                                  joint_acceleration)
+{
+    std::array<MotionVector, MaxSize::kBodies> acceleration = {};
+    acceleration[0U] = base_acceleration;
+    for (size_t index = 1U; index < model.num_bodies; ++index)
+    {
+        const DynamicsBody&            body = model.body[index];
+        const DynamicsJointTransform&  tr_pc = transform[index];
+        const DynamicsArticulatedBody& art = articulated[index];
+        const size_t                   dofs = body.num_dofs;
+
+        // parent acceleration in child coordinates with bias
+        const MotionVector& acc_parent = acceleration[body.parent_index];
+        const Vec3          acc_origin
+            = vector_add(acc_parent.linear, vector_cross(acc_parent.angular, tr_pc.translation));
+        DynamicsSpatialVector acc = spatial_from_motion(
+            {rotate_mat3_transpose(tr_pc.rotation, acc_parent.angular),
+             rotate_mat3_transpose(tr_pc.rotation, acc_origin)});
+        for (size_t row = 0U; row < FSB_CART_SIZE; ++row)
+        {
+            acc[row] += art.bias_acceleration[row];
+        }
+
+        // qdd = D^-1 (u - U^T a)
+        DynamicsSpatialVector joint_acc = {};
+        for (size_t dof = 0U; dof < dofs; ++dof)
+        {
+            Real value = art.joint_force[dof];
+            for (size_t row = 0U; row < FSB_CART_SIZE; ++row)
+            {
+                value -= art.inertia_motion[spatial_index(row, dof)] * acc[row];
+            }
+            joint_acc[dof] = value;
+        }
+        aba_joint_solve(dofs, art.joint_inertia, joint_acc.data());
+        for (size_t dof = 0U; dof < dofs; ++dof)
+        {
+            joint_acceleration.qv[body.dof_index + dof] = joint_acc[dof];
+            for (size_t row = 0U; row < FSB_CART_SIZE; ++row)
+            {
+                acc[row] += art.motion[spatial_index(row, dof)] * joint_acc[dof];
+            }
+        }
+        acceleration[index] = spatial_to_motion(acc);
+    }
+}
+
+bool forward_dynamics_aba(
+    const DynamicsModel& model, const JointSpacePosition& joint_position,
+    const JointSpace& joint_velocity, const JointSpace& joint_torque, const CartesianPva& base_pva,
+    const BodyForce& external_force, JointSpace& joint_acceleration)
+{
+    std::array<DynamicsJointTransform, MaxSize::kBodies>  transform = {};
+    std::array<DynamicsArticulatedBody, MaxSize::kBodies> articulated = {};
+
+    // base motion in base coordinates, gravity as upward acceleration of base
+    Quaternion base_rotation = base_pva.pose.rotation;
+    quat_normalize(base_rotation);
+    const Quaternion   base_inverse = quat_conjugate(base_rotation);
+    const MotionVector base_acceleration
+        = {quat_rotate_vector(base_inverse, base_pva.acceleration.angular),
+           quat_rotate_vector(
+               base_inverse, vector_subtract(base_pva.acceleration.linear, model.gravity))};
+
+    aba_forward_velocity(
+        model,
+        joint_position,
+        joint_velocity,
+        quat_rotate_vector(base_inverse, base_pva.velocity.angular),
+        external_force,
+        transform,
+        articulated);
+    joint_acceleration = {};
+    const bool result = aba_backward_inertia(model, joint_torque, transform, articulated);
+    if (result)
+    {
+        aba_forward_acceleration(model, base_acceleration, transform, articulated, joint_acceleration);
+    }
+    return result;
+}
+
+bool forward_dynamics_aba(
+    const BodyTree& body_tree, const JointSpacePosition& joint_position,
+    const JointSpace& joint_velocity, const JointSpace& joint_torque, const CartesianPva& base_pva,
+    const BodyForce& external_force, JointSpace& joint_acceleration)
+{
+    DynamicsModel model = {};
+    bool          result = dynamics_model_compile(body_tree, model);
+    if (result)
+    {
+        result = forward_dynamics_aba(
+            model, joint_position, joint_velocity, joint_torque, base_pva, external_force,
+            joint_acceleration);
+    }
+    return result;
+}
+
 } // namespace fsb
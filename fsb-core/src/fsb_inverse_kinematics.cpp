@@ -1,8 +1,12 @@
 #include <array>
+#include <atomic>
 #include <cmath>
 #include <algorithm>
 #include <cstddef>
+#include <ctime>
+#include <limits>
 #include "fsb_inverse_kinematics.h"
+#include "fsb_inverse_kinematics_cache.h"
 #include "fsb_body.h"
 #include "fsb_body_tree.h"
 #include "fsb_configuration.h"
@@ -12,29 +16,54 @@
 #include "fsb_motion.h"
 #include "fsb_types.h"
 #include "fsb_linalg.h"
+#include "fsb_linalg_fixed.h"
+#include "fsb_work.h"
 
 namespace fsb
 {
 
-static BodyCartesianPva optim_forward_kinematics(
-    const BodyTree& body_tree, const Transform& base_pose, const JointSpacePosition& joint_position)
+/**
+ * Conditions stopping iterations before convergence
+ */
+struct OptimTermination
 {
-    BodyCartesianPva body_poses = {};
-    // FK
-    const JointPva     joint_pva = {joint_position, {}, {}};
-    const CartesianPva base_pva = {base_pose, {}, {}};
-    forward_kinematics(body_tree, joint_pva, base_pva, ForwardKinematicsOption::POSE, body_poses);
-    return body_poses;
+    const std::atomic<bool>* cancel = nullptr; ///< Cancel flag, nullptr if not used
+    const timespec*          deadline = nullptr; ///< Absolute monotonic clock deadline, nullptr if not used
+};
+
+/**
+ * Bounds of unconstrained problem
+ */
+static const InverseKinematicsBounds kNoBounds = {};
+
+static bool optim_deadline_reached(const timespec& deadline)
+{
+    timespec now = {};
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec > deadline.tv_sec)
+           || ((now.tv_sec == deadline.tv_sec) && (now.tv_nsec >= deadline.tv_nsec));
 }
 
-static Jacobian optim_jacobian(
-    const BodyTree& body_tree, const size_t body_index, const BodyCartesianPva& body_poses)
+static void optim_evaluate(
+    const KinematicProgram& chain, const size_t body_index,
+    const Transform& target_pose, InverseKinematicsWorkspace& work,
+    InverseKinematicsResult& result)
 {
-    Jacobian jac = {};
+    // FK of bodies from base to target body with world frame joint axes
+    forward_kinematics_program_axes(
+        chain,
+        work.joint_pva,
+        work.base_pva,
+        ForwardKinematicsOption::POSE,
+        result.body_poses,
+        work.joint_axes);
     // Jacobian
-    const JacobianError error = calculate_jacobian(body_index, body_tree, body_poses, jac);
+    const JacobianError error
+        = calculate_jacobian_from_axes(body_index, work.joint_axes, result.body_poses, result.jacobian);
     (void)error;
-    return jac;
+    // Compute pose error
+    result.computed_pose = result.body_poses.body[body_index].pose;
+    result.error_pose = coord_transform_get_error(result.computed_pose, target_pose);
 }
 
 static Real optim_pose_error(
@@ -51,129 +80,523 @@ static Real optim_pose_error(
            + squared_error.linear.x + squared_error.linear.y + squared_error.linear.z;
 }
 
+static void optim_normal_equations(
+    const Jacobian& jacobian, const MotionVector& cartesian_weights,
+    const MotionVector& weighted_error, const Real joint_weight, const size_t dofs,
+    InverseKinematicsWorkspace& work)
+{
+    const std::array<Real, 6U> weights
+        = {cartesian_weights.angular.x,
+           cartesian_weights.angular.y,
+           cartesian_weights.angular.z,
+           cartesian_weights.linear.x,
+           cartesian_weights.linear.y,
+           cartesian_weights.linear.z};
+    const std::array<Real, 6U> error
+        = {weighted_error.angular.x,
+           weighted_error.angular.y,
+           weighted_error.angular.z,
+           weighted_error.linear.x,
+           weighted_error.linear.y,
+           weighted_error.linear.z};
+    for (size_t col = 0U; col < dofs; ++col)
+    {
+        // Gradient vector g = J.transpose() * We * e
+        Real gradient = 0.0;
+        for (size_t row = 0U; row < 6U; ++row)
+        {
+            gradient += jacobian.j[jacobian_index(row, col)] * error[row];
+        }
+        work.joint_gradient.qv[col] = gradient;
+        // Joint increment matrix Mj = (J.transpose() * We * J + Wn), symmetric
+        for (size_t row = col; row < dofs; ++row)
+        {
+            Real value = 0.0;
+            for (size_t cart = 0U; cart < 6U; ++cart)
+            {
+                value += jacobian.j[jacobian_index(cart, row)] * weights[cart]
+                         * jacobian.j[jacobian_index(cart, col)];
+            }
+            work.increment_matrix.j[joint_matrix_index(row, col, dofs)] = value;
+            work.increment_matrix.j[joint_matrix_index(col, row, dofs)] = value;
+        }
+        work.increment_matrix.j[joint_matrix_index(col, col, dofs)] += joint_weight;
+    }
+}
+
+/**
+ * Solve symmetric positive definite system in place, with LAPACK Cholesky for more degrees of
+ * freedom than the fixed size solver supports. The matrix may be overwritten.
+ */
+static FsbLinalgErrorType optim_posdef_solve(
+    const size_t dim, Real mat[], JointSpace& x_vec, InverseKinematicsWorkspace& work)
+{
+    auto result = EFSB_LAPACK_ERROR_NONE;
+    if (dim <= kLinalgFixedMaxDim)
+    {
+        result = linalg_fixed_posdef_solve(dim, mat, x_vec.qv.data());
+    }
+    else
+    {
+        const JointSpace b_vec = x_vec;
+        const size_t     nrhs = 1U;
+        result = fsb_linalg_cholesky_solve(
+            mat, b_vec.qv.data(), nrhs, dim, work.cholesky_work.size(), work.cholesky_work.data(),
+            x_vec.qv.data());
+    }
+    return result;
+}
+
 static FsbLinalgErrorType optim_solve_joint_matrix(
-    const JointMatrix& joint_mat, const JointSpace& joint_vec, const size_t dofs, JointSpace& result)
-{
-    // Create lapack input, work, and output variables
-    const size_t                   nrhs = 1U;
-    const size_t                   dim = dofs;
-    constexpr size_t               WorkLen = MaxSize::kDofs * MaxSize::kDofs;
-    std::array<double_t, WorkLen>  work = {};
-    const size_t                   iwork_len = MaxSize::kDofs;
-    std::array<lapack_int, MaxSize::kDofs> iwork = {};
-    // solve for x_vec
-    return fsb_linalg_matrix_sqr_solve(
-        joint_mat.j.data(),
-        joint_vec.qv.data(),
-        nrhs,
-        dim,
-        WorkLen,
-        iwork_len,
-        work.data(),
-        iwork.data(),
-        result.qv.data());
-}
-
-static InverseKinematicsResult optim_levenberg_marquardt(
-    const BodyTree& body_tree, const OptimParameters& params,
-    const JointSpacePosition& initial_config, const size_t body_index, const Transform& target_pose,
-    const Transform& base_pose, const size_t dofs)
+    const size_t dofs, InverseKinematicsWorkspace& work)
 {
-    // initialize result
-    InverseKinematicsResult result = {};
-    result.info = InverseKinematicsInfo::SUCCESS;
+    // solve symmetric positive definite system for joint offset
+    work.joint_offset = work.joint_gradient;
+    return optim_posdef_solve(dofs, work.increment_matrix.j.data(), work.joint_offset, work);
+}
 
-    // Initialize satte vector
-    JointSpace joint_offset = {};
+static void optim_joint_bounds(
+    const BodyTree& body_tree, const KinematicProgram& chain, const bool enable,
+    InverseKinematicsBounds& bounds)
+{
+    bounds = {};
+    for (size_t op_index = 0U; enable && (op_index < chain.num_ops); ++op_index)
+    {
+        const KinematicOp& kin_op = chain.op[op_index];
+        switch (kin_op.kind)
+        {
+            case KinematicOpKind::REVOLUTE:
+            case KinematicOpKind::PRISMATIC:
+            {
+                auto       err = BodyTreeError::SUCCESS;
+                const Body body = body_tree.get_body(kin_op.child_index, err);
+                bool       is_set = false;
+                Real       lower = 0.0;
+                Real       upper = 0.0;
+                if (err == BodyTreeError::SUCCESS)
+                {
+                    err = body_tree.get_joint_position_limit(body.joint_index, is_set, lower, upper);
+                }
+                if ((err == BodyTreeError::SUCCESS) && is_set && (lower <= upper))
+                {
+                    bounds.set[kin_op.dof_index] = true;
+                    bounds.lower[kin_op.dof_index] = lower;
+                    bounds.upper[kin_op.dof_index] = upper;
+                    bounds.coord_index[kin_op.dof_index] = kin_op.coord_index;
+                    bounds.num_set += 1U;
+                }
+                break;
+            }
+            case KinematicOpKind::FIXED:
+            case KinematicOpKind::SPHERICAL:
+            case KinematicOpKind::CARTESIAN:
+            case KinematicOpKind::IDENTITY:
+            default:
+                break;
+        }
+    }
+}
 
-    // First iteration
-    // ===============
+static void optim_project_bounds(const InverseKinematicsBounds& bounds, JointSpacePosition& position)
+{
+    for (size_t dof = 0U; dof < MaxSize::kDofs; ++dof)
+    {
+        if (bounds.set[dof])
+        {
+            Real& coord = position.q[bounds.coord_index[dof]];
+            coord = std::min(std::max(coord, bounds.lower[dof]), bounds.upper[dof]);
+        }
+    }
+}
 
-    // Update state: joint posiiton
-    result.joint_position = initial_config;
-    // Forward kinematics
-    result.body_poses = optim_forward_kinematics(body_tree, base_pose, result.joint_position);
-    // Jacobian
-    result.jacobian = optim_jacobian(body_tree, body_index, result.body_poses);
-    // Compute pose error
-    result.computed_pose = result.body_poses.body[body_index].pose;
-    result.error_pose = coord_transform_get_error(result.computed_pose, target_pose);
-    // Weighted squared error
-    MotionVector weighted_error = {};
-    Real obj_err = optim_pose_error(params.objective_weights, result.error_pose, weighted_error);
+static void optim_active_limits(const InverseKinematicsBounds& bounds, InverseKinematicsResult& result)
+{
+    result.active_limits = {};
+    result.num_active_limits = 0U;
+    for (size_t dof = 0U; dof < MaxSize::kDofs; ++dof)
+    {
+        if (bounds.set[dof])
+        {
+            const Real coord = result.joint_position.q[bounds.coord_index[dof]];
+            result.active_limits[dof] = (coord <= bounds.lower[dof]) || (coord >= bounds.upper[dof]);
+            if (result.active_limits[dof])
+            {
+                result.num_active_limits += 1U;
+            }
+        }
+    }
+}
 
-    // Start iterations
-    // ================
-    size_t iter = 1U;
-    while ((result.info == InverseKinematicsInfo::SUCCESS) && (obj_err > params.objective_tol)
-           && (iter < params.max_iterations))
+/**
+ * Box constrained joint offset by primal active set method. Minimizes
+ * 0.5 dq^T Mj dq - g^T dq with joint position bounds, starting from the feasible zero offset.
+ * Free offsets move towards the solution of the reduced system until a bound blocks. Bounds with
+ * multipliers of wrong sign are released.
+ */
+static FsbLinalgErrorType optim_solve_bounded(
+    const size_t dofs, const InverseKinematicsBounds& bounds, InverseKinematicsWorkspace& work)
+{
+    constexpr Real inf = std::numeric_limits<Real>::infinity();
+    auto           result = EFSB_LAPACK_ERROR_NONE;
+    work.normal_matrix = work.increment_matrix;
+    work.active_bound = {};
+    work.joint_offset = {};
+
+    // offset bounds at current position
+    JointSpace step_lower = {};
+    JointSpace step_upper = {};
+    for (size_t dof = 0U; dof < dofs; ++dof)
     {
-        // Compute Solution Increment
-        // ==========================
+        const Real coord = work.joint_pva.position.q[bounds.coord_index[dof]];
+        step_lower.qv[dof] = bounds.set[dof] ? std::min(bounds.lower[dof] - coord, 0.0) : -inf;
+        step_upper.qv[dof] = bounds.set[dof] ? std::max(bounds.upper[dof] - coord, 0.0) : inf;
+    }
 
-        // Weighting matrix Wn = *E * EyeN + lambda * EyeN;
-        JointSpace joint_weights = {};
-        for (size_t index = 0U; index < dofs; ++index)
+    bool done = false;
+    const size_t max_iterations = (3U * dofs) + 1U;
+    for (size_t iter = 0U; (iter < max_iterations) && !done && (result == EFSB_LAPACK_ERROR_NONE); ++iter)
+    {
+        // reduced system of free offsets with active offsets fixed
+        std::array<size_t, MaxSize::kDofs> free_dof = {};
+        size_t     num_free = 0U;
+        JointSpace reduced = {};
+        for (size_t dof = 0U; dof < dofs; ++dof)
         {
-            joint_weights.qv[index] = obj_err + params.damping_factor;
+            if (work.active_bound[dof] == 0)
+            {
+                free_dof[num_free] = dof;
+                num_free += 1U;
+            }
         }
-        // Gradient vector g = J.transpose() * We * e;
-        const JointSpace joint_gradient
-            = jacobian_transpose_multiply(result.jacobian, weighted_error, dofs);
-        // Joint increment matrix Mj = (J.transpose() * We * J + Wn)
-        JointMatrix increment_matrix
-            = jacobian_transpose_multiply_jacobian(result.jacobian, params.objective_weights, dofs);
-        for (size_t index = 0U; index < dofs; ++index)
+        for (size_t row = 0U; row < num_free; ++row)
         {
-            increment_matrix.j[joint_matrix_index(index, index, dofs)] += joint_weights.qv[index];
+            Real rhs = work.joint_gradient.qv[free_dof[row]];
+            for (size_t dof = 0U; dof < dofs; ++dof)
+            {
+                if (work.active_bound[dof] != 0)
+                {
+                    rhs -= work.normal_matrix.j[joint_matrix_index(free_dof[row], dof, dofs)]
+                           * work.joint_offset.qv[dof];
+                }
+            }
+            reduced.qv[row] = rhs;
+            for (size_t col = 0U; col < num_free; ++col)
+            {
+                work.increment_matrix.j[joint_matrix_index(row, col, num_free)]
+                    = work.normal_matrix.j[joint_matrix_index(free_dof[row], free_dof[col], dofs)];
+            }
         }
-        // Solve for increment dq = - Mj.inverse() * g
-        const FsbLinalgErrorType solve_result
-            = optim_solve_joint_matrix(increment_matrix, joint_gradient, dofs, joint_offset);
-        if (solve_result != EFSB_LAPACK_ERROR_NONE)
+        if (num_free > 0U)
         {
-            // error
-            result.info = InverseKinematicsInfo::SINGULAR_UPDATE_MATRIX;
+            result = optim_posdef_solve(num_free, work.increment_matrix.j.data(), reduced, work);
+        }
+        if (result == EFSB_LAPACK_ERROR_NONE)
+        {
+            // largest feasible fraction of move towards reduced solution
+            Real    alpha = 1.0;
+            size_t  blocking = dofs;
+            int8_t  blocking_bound = 0;
+            for (size_t row = 0U; row < num_free; ++row)
+            {
+                const size_t dof = free_dof[row];
+                const Real   offset = work.joint_offset.qv[dof];
+                const Real   delta = reduced.qv[row] - offset;
+                if ((delta < 0.0) && ((offset + delta) < step_lower.qv[dof]))
+                {
+                    const Real fraction = (step_lower.qv[dof] - offset) / delta;
+                    if (fraction < alpha)
+                    {
+                        alpha = fraction;
+                        blocking = dof;
+                        blocking_bound = -1;
+                    }
+                }
+                else if ((delta > 0.0) && ((offset + delta) > step_upper.qv[dof]))
+                {
+                    const Real fraction = (step_upper.qv[dof] - offset) / delta;
+                    if (fraction < alpha)
+                    {
+                        alpha = fraction;
+                        blocking = dof;
+                        blocking_bound = 1;
+                    }
+                }
+            }
+            for (size_t row = 0U; row < num_free; ++row)
+            {
+                const size_t dof = free_dof[row];
+                work.joint_offset.qv[dof] += alpha * (reduced.qv[row] - work.joint_offset.qv[dof]);
+            }
+
+            if (blocking < dofs)
+            {
+                // activate blocking bound
+                work.active_bound[blocking] = blocking_bound;
+                work.joint_offset.qv[blocking]
+                    = (blocking_bound < 0) ? step_lower.qv[blocking] : step_upper.qv[blocking];
+            }
+            else
+            {
+                // release active bound with most violating multiplier, gradient Mj dq - g
+                Real   violation = 0.0;
+                size_t release = dofs;
+                for (size_t dof = 0U; dof < dofs; ++dof)
+                {
+                    if (work.active_bound[dof] != 0)
+                    {
+                        Real gradient = -work.joint_gradient.qv[dof];
+                        for (size_t col = 0U; col < dofs; ++col)
+                        {
+                            gradient += work.normal_matrix.j[joint_matrix_index(dof, col, dofs)]
+                                        * work.joint_offset.qv[col];
+                        }
+                        const Real dof_violation = (work.active_bound[dof] < 0) ? -gradient : gradient;
+                        if (dof_violation > violation)
+                        {
+                            violation = dof_violation;
+                            release = dof;
+                        }
+                    }
+                }
+                if (release < dofs)
+                {
+                    work.active_bound[release] = 0;
+                }
+                else
+                {
+                    done = true;
+                }
+            }
+        }
+    }
+    return result;
+}
+
+/**
+ * Predicted reduction of weighted squared error for linear model, 2 dq^T g - |sqrt(We) J dq|^2
+ */
+static Real optim_predicted_reduction(
+    const Jacobian& jacobian, const MotionVector& cartesian_weights, const size_t dofs,
+    const InverseKinematicsWorkspace& work)
+{
+    const std::array<Real, 6U> weights
+        = {cartesian_weights.angular.x,
+           cartesian_weights.angular.y,
+           cartesian_weights.angular.z,
+           cartesian_weights.linear.x,
+           cartesian_weights.linear.y,
+           cartesian_weights.linear.z};
+    Real result = 0.0;
+    for (size_t dof = 0U; dof < dofs; ++dof)
+    {
+        result += 2.0 * work.joint_offset.qv[dof] * work.joint_gradient.qv[dof];
+    }
+    for (size_t row = 0U; row < 6U; ++row)
+    {
+        Real motion = 0.0;
+        for (size_t dof = 0U; dof < dofs; ++dof)
+        {
+            motion += jacobian.j[jacobian_index(row, dof)] * work.joint_offset.qv[dof];
+        }
+        result -= weights[row] * motion * motion;
+    }
+    return result;
+}
+
+/**
+ * Iteration state of Levenberg-Marquardt algorithm
+ */
+struct OptimIterate
+{
+    Real   obj_err = 0.0; ///< Weighted squared error of current iterate
+    Real   damping = 0.0; ///< Damping added to diagonal of normal equations
+    Real   damping_growth = 2.0; ///< Damping growth factor after rejected step
+    size_t iter = 0U; ///< Number of objective function evaluations
+};
+
+static Real optim_max_diagonal(
+    const Jacobian& jacobian, const MotionVector& cartesian_weights, const size_t dofs)
+{
+    const std::array<Real, 6U> weights
+        = {cartesian_weights.angular.x,
+           cartesian_weights.angular.y,
+           cartesian_weights.angular.z,
+           cartesian_weights.linear.x,
+           cartesian_weights.linear.y,
+           cartesian_weights.linear.z};
+    Real result = 0.0;
+    for (size_t col = 0U; col < dofs; ++col)
+    {
+        Real value = 0.0;
+        for (size_t row = 0U; row < 6U; ++row)
+        {
+            const Real jac = jacobian.j[jacobian_index(row, col)];
+            value += jac * weights[row] * jac;
+        }
+        result = std::max(result, value);
+    }
+    return result;
+}
+
+static Real optim_norm(const Real vec[], const size_t len)
+{
+    Real result = 0.0;
+    for (size_t index = 0U; index < len; ++index)
+    {
+        result += vec[index] * vec[index];
+    }
+    return std::sqrt(result);
+}
+
+/**
+ * Single Levenberg-Marquardt step with gain ratio damping update. Rejected steps restore the
+ * previous iterate and increase damping.
+ */
+static void optim_iteration(
+    const KinematicProgram& chain, const OptimParameters& params, const size_t body_index,
+    const Transform& target_pose, const size_t dofs, const InverseKinematicsBounds& bounds,
+    InverseKinematicsWorkspace& work, InverseKinematicsResult& result, OptimIterate& state)
+{
+    // Compute Solution Increment
+    // ==========================
+
+    // Damped normal equations (J^T We J + mu I) dq = J^T We e
+    optim_normal_equations(
+        result.jacobian,
+        params.objective_weights,
+        work.weighted_error,
+        state.damping,
+        dofs,
+        work);
+    const FsbLinalgErrorType solve_result = (bounds.num_set > 0U)
+                                                ? optim_solve_bounded(dofs, bounds, work)
+                                                : optim_solve_joint_matrix(dofs, work);
+
+    const Real predicted
+        = optim_predicted_reduction(result.jacobian, params.objective_weights, dofs, work);
+    const Real predicted_relative = predicted / state.obj_err;
+    // relative change of state vector
+    const Real step_norm = optim_norm(work.joint_offset.qv.data(), dofs);
+    const Real state_norm = optim_norm(work.joint_pva.position.q.data(), MaxSize::kCoordinates);
+
+    if (solve_result != EFSB_LAPACK_ERROR_NONE)
+    {
+        // error
+        result.info = InverseKinematicsInfo::SINGULAR_UPDATE_MATRIX;
+    }
+    else if (step_norm <= (params.state_tol * (state_norm + params.state_tol)))
+    {
+        result.info = (predicted_relative <= params.reduction_tol)
+                          ? InverseKinematicsInfo::WITHIN_FTOL_XTOL
+                          : InverseKinematicsInfo::WITHIN_XTOL;
+    }
+    else
+    {
+        // Iteration Result
+        // ================
+
+        // Update state: joint position
+        work.previous_position = work.joint_pva.position;
+        kinematic_program_add_offset(chain, work.joint_offset, work.joint_pva.position);
+        optim_project_bounds(bounds, work.joint_pva.position);
+        optim_evaluate(chain, body_index, target_pose, work, result);
+        state.iter += 1U;
+        // Weighted squared error
+        const Real obj_err
+            = optim_pose_error(params.objective_weights, result.error_pose, work.weighted_error);
+
+        // gain ratio of actual and predicted reduction
+        const Real actual = state.obj_err - obj_err;
+        const Real gain_ratio = actual / predicted;
+        if (gain_ratio > 0.0)
+        {
+            // accept step and decrease damping
+            const Real actual_relative = actual / state.obj_err;
+            const Real ratio_term = (2.0 * gain_ratio) - 1.0;
+            state.obj_err = obj_err;
+            state.damping *= std::max(1.0 / 3.0, 1.0 - (ratio_term * ratio_term * ratio_term));
+            state.damping_growth = 2.0;
+            if ((obj_err > params.objective_tol) && (actual_relative <= params.reduction_tol)
+                && (predicted_relative <= params.reduction_tol))
+            {
+                result.info = InverseKinematicsInfo::WITHIN_FTOL;
+            }
         }
         else
         {
-            // Iteration Result
-            // ================
+            // reject step and increase damping
+            work.joint_pva.position = work.previous_position;
+            optim_evaluate(chain, body_index, target_pose, work, result);
+            (void)optim_pose_error(params.objective_weights, result.error_pose, work.weighted_error);
+            state.damping *= state.damping_growth;
+            state.damping_growth *= 2.0;
+        }
+    }
+}
 
-            // Update state: joint posiiton
-            result.joint_position
-                = joint_add_offset(body_tree, result.joint_position, joint_offset);
-            // Forward kinematics
-            result.body_poses
-                = optim_forward_kinematics(body_tree, base_pose, result.joint_position);
-            // Jacobian
-            result.jacobian = optim_jacobian(body_tree, body_index, result.body_poses);
-            // Compute pose error
-            result.computed_pose = result.body_poses.body[body_index].pose;
-            result.error_pose = coord_transform_get_error(result.computed_pose, target_pose);
-            // Weighted squared error
-            obj_err = optim_pose_error(params.objective_weights, result.error_pose, weighted_error);
-            // ================
+/**
+ * Levenberg-Marquardt iterations in place. Initial configuration is read from the joint position
+ * of the workspace. Iterations stop early when the cancel flag is set, or after at least one
+ * iteration when the deadline is reached. Rejected steps are reverted so the current iterate is
+ * always the best one. The initial configuration is projected onto the joint position bounds.
+ */
+static void optim_levenberg_marquardt(
+    const KinematicProgram& chain, const OptimParameters& params, const size_t body_index,
+    const Transform& target_pose, const size_t dofs, const InverseKinematicsBounds& bounds,
+    const OptimTermination& termination, InverseKinematicsWorkspace& work,
+    InverseKinematicsResult& result)
+{
+    // initialize result
+    result.info = InverseKinematicsInfo::SUCCESS;
 
-            // TODO: check relative changes in state vector and objective function
+    // First iteration
+    // ===============
+
+    optim_project_bounds(bounds, work.joint_pva.position);
+    optim_evaluate(chain, body_index, target_pose, work, result);
+    OptimIterate state = {};
+    state.iter = 1U;
+    // Weighted squared error
+    state.obj_err = optim_pose_error(params.objective_weights, result.error_pose, work.weighted_error);
+    // initial damping relative to normal equations diagonal
+    state.damping = params.damping_factor
+                    * std::max(optim_max_diagonal(result.jacobian, params.objective_weights, dofs), 1.0);
 
-            // advance iteration
-            iter += 1;
+    // Start iterations
+    // ================
+    while ((result.info == InverseKinematicsInfo::SUCCESS) && (state.obj_err > params.objective_tol)
+           && (state.iter < params.max_iterations))
+    {
+        if ((termination.cancel != nullptr) && termination.cancel->load(std::memory_order_relaxed))
+        {
+            // stopped by caller
+            result.info = InverseKinematicsInfo::CANCELLED;
+        }
+        else if ((termination.deadline != nullptr) && (state.iter > 1U)
+                 && optim_deadline_reached(*termination.deadline))
+        {
+            result.info = InverseKinematicsInfo::DEADLINE_REACHED;
+        }
+        else
+        {
+            optim_iteration(
+                chain, params, body_index, target_pose, dofs, bounds, work, result, state);
         }
     }
 
-    if (iter == params.max_iterations)
+    if ((result.info == InverseKinematicsInfo::SUCCESS) && (state.obj_err > params.objective_tol))
     {
         result.info = InverseKinematicsInfo::MAXIMUM_EVALUATIONS_REACHED;
     }
-    result.iterations = iter;
-    return result;
+    result.iterations = state.iter;
+    result.joint_position = work.joint_pva.position;
+    optim_active_limits(bounds, result);
 }
 
 InverseKinematicsResult compute_inverse_kinematics(
     const BodyTree& body_tree, const OptimParameters& params,
     const JointSpacePosition& initial_config, const size_t body_index, const Transform& target_pose,
-    const Transform& base_pose)
+    const Transform& base_pose, InverseKinematicsSeedCache* seed_cache)
 {
     // initialize result
     InverseKinematicsResult result = {};
@@ -181,23 +604,285 @@ InverseKinematicsResult compute_inverse_kinematics(
     // number of dofs for selected body
     auto err = BodyTreeError::SUCCESS;
     const size_t  dofs = body_tree.get_body_dofs(body_index, err);
+    // bodies from base to target body
+    KinematicProgram chain = {};
     if (dofs == 0U || err != BodyTreeError::SUCCESS)
     {
         result.info = InverseKinematicsInfo::INVALID_INPUT;
     }
+    else if (!kinematic_program_compile_chain(body_tree, body_index, chain))
+    {
+        result.info = InverseKinematicsInfo::INVALID_INPUT;
+    }
     else
     {
-        result = optim_levenberg_marquardt(
-            body_tree, params, initial_config, body_index, target_pose, base_pose, dofs);
+        InverseKinematicsBounds bounds = {};
+        optim_joint_bounds(body_tree, chain, params.joint_limits, bounds);
+        InverseKinematicsWorkspace work = {};
+        work.joint_pva.position = initial_config;
+        work.base_pva.pose = base_pose;
+        optim_levenberg_marquardt(
+            chain, params, body_index, target_pose, dofs, bounds, {}, work, result);
+        if ((seed_cache != nullptr) && (result.info == InverseKinematicsInfo::SUCCESS))
+        {
+            seed_cache->insert(target_pose, result.joint_position);
+        }
+        // poses of bodies outside the chain at the final joint position
+        forward_kinematics(
+            body_tree, work.joint_pva, work.base_pva, ForwardKinematicsOption::POSE, result.body_poses);
     }
     return result;
 }
 
-FsbLinalgErrorType inverse_velocity_kinematics(const Jacobian& jacobian, const MotionVector& cart_velocity, size_t dofs, JointSpace& joint_velocity)
+bool inverse_kinematics_converged(const InverseKinematicsInfo info)
 {
-    dofs = std::min(dofs, MaxSize::kDofs);
+    return info == InverseKinematicsInfo::SUCCESS;
+}
 
-    const size_t nrhs = 1U; // number of right-hand sides
+static void kinematic_program_zero_position(
+    const KinematicProgram& program, JointSpacePosition& joint_position)
+{
+    joint_position = {};
+    for (size_t op_index = 0U; op_index < program.num_ops; ++op_index)
+    {
+        const KinematicOp& kin_op = program.op[op_index];
+        switch (kin_op.kind)
+        {
+            case KinematicOpKind::SPHERICAL:
+            case KinematicOpKind::CARTESIAN:
+                // identity quaternion
+                joint_position.q[kin_op.coord_index] = 1.0;
+                break;
+            case KinematicOpKind::FIXED:
+            case KinematicOpKind::REVOLUTE:
+            case KinematicOpKind::PRISMATIC:
+            case KinematicOpKind::IDENTITY:
+            default:
+                break;
+        }
+    }
+}
+
+InverseKinematicsInfo InverseKinematicsSolver::initialize(
+    const BodyTree& body_tree, const size_t body_index, const OptimParameters& params,
+    const Transform& base_pose)
+{
+    auto result = InverseKinematicsInfo::SUCCESS;
+    m_params = params;
+    m_body_index = body_index;
+    m_work = {};
+    m_work.base_pva.pose = base_pose;
+    m_result = {};
+
+    auto err = BodyTreeError::SUCCESS;
+    m_dofs = body_tree.get_body_dofs(body_index, err);
+    if ((m_dofs == 0U) || (err != BodyTreeError::SUCCESS))
+    {
+        result = InverseKinematicsInfo::INVALID_INPUT;
+    }
+    else if (!kinematic_program_compile(body_tree, m_program)
+             || !kinematic_program_compile_chain(body_tree, body_index, m_chain))
+    {
+        result = InverseKinematicsInfo::INVALID_INPUT;
+    }
+    else if (jacobian_linalg_plans_create(m_linalg_plans) != EFSB_LAPACK_ERROR_NONE)
+    {
+        // LAPACK fallback cannot be planned
+        result = InverseKinematicsInfo::INVALID_INPUT;
+    }
+    else
+    {
+        optim_joint_bounds(body_tree, m_chain, true, m_bounds);
+        kinematic_program_zero_position(m_program, m_seed);
+        m_keep_warm_start = false;
+    }
+    if (result != InverseKinematicsInfo::SUCCESS)
+    {
+        m_dofs = 0U;
+    }
+    return result;
+}
+
+const InverseKinematicsBounds& InverseKinematicsSolver::get_bounds() const
+{
+    return m_params.joint_limits ? m_bounds : kNoBounds;
+}
+
+const InverseKinematicsResult& InverseKinematicsSolver::solve(const Transform& target_pose)
+{
+    return solve_before(target_pose, m_seed, nullptr, !m_keep_warm_start);
+}
+
+const InverseKinematicsResult&
+InverseKinematicsSolver::solve(const Transform& target_pose, const JointSpacePosition& seed)
+{
+    return solve_before(target_pose, seed, nullptr, false);
+}
+
+const InverseKinematicsResult&
+InverseKinematicsSolver::solve_until(const Transform& target_pose, const timespec& deadline)
+{
+    return solve_before(target_pose, m_seed, &deadline, !m_keep_warm_start);
+}
+
+const InverseKinematicsResult&
+InverseKinematicsSolver::solve_within(const Transform& target_pose, const int64_t budget_ns)
+{
+    constexpr int64_t ns_per_second = 1000000000;
+    timespec deadline = {};
+    (void)clock_gettime(CLOCK_MONOTONIC, &deadline);
+    // clamp budget so the sum with the nanoseconds of current time does not overflow
+    const int64_t budget_max = std::numeric_limits<int64_t>::max() - ns_per_second;
+    const int64_t nsec = static_cast<int64_t>(deadline.tv_nsec)
+                         + std::min(std::max(budget_ns, int64_t{0}), budget_max);
+    deadline.tv_sec += static_cast<time_t>(nsec / ns_per_second);
+    deadline.tv_nsec = static_cast<long>(nsec % ns_per_second);
+    return solve_before(target_pose, m_seed, &deadline, !m_keep_warm_start);
+}
+
+const InverseKinematicsResult& InverseKinematicsSolver::solve_before(
+    const Transform& target_pose, const JointSpacePosition& seed, const timespec* deadline,
+    const bool use_seed_cache)
+{
+    if (m_dofs == 0U)
+    {
+        m_result.info = InverseKinematicsInfo::INVALID_INPUT;
+    }
+    else
+    {
+        m_work.joint_pva.position = seed;
+        if (use_seed_cache && (m_seed_cache != nullptr))
+        {
+            (void)m_seed_cache->lookup(target_pose, m_work.joint_pva.position);
+        }
+        const OptimTermination termination = {m_cancel, deadline};
+        optim_levenberg_marquardt(
+            m_chain,
+            m_params,
+            m_body_index,
+            target_pose,
+            m_dofs,
+            m_params.joint_limits ? m_bounds : kNoBounds,
+            termination,
+            m_work,
+            m_result);
+        // poses of bodies outside the chain at the final joint position
+        forward_kinematics_program(
+            m_program,
+            m_work.joint_pva,
+            m_work.base_pva,
+            ForwardKinematicsOption::POSE,
+            m_result.body_poses);
+        if ((m_seed_cache != nullptr) && (m_result.info == InverseKinematicsInfo::SUCCESS))
+        {
+            m_seed_cache->insert(target_pose, m_result.joint_position);
+        }
+        if (inverse_kinematics_converged(m_result.info)
+            || (m_result.info == InverseKinematicsInfo::DEADLINE_REACHED))
+        {
+            // warm start next solution, or resume from best iterate
+            m_seed = m_result.joint_position;
+        }
+        m_keep_warm_start = m_result.info == InverseKinematicsInfo::DEADLINE_REACHED;
+    }
+    return m_result;
+}
+
+InverseKinematicsSequenceSummary InverseKinematicsSolver::solve_sequence(
+    const Transform target_poses[], const size_t num_targets,
+    const InverseKinematicsSeedPrediction prediction, InverseKinematicsSample samples[])
+{
+    InverseKinematicsSequenceSummary summary = {};
+    bool previous_converged = false;
+    for (size_t index = 0U; index < num_targets; ++index)
+    {
+        JointSpacePosition seed = m_seed;
+        if ((prediction == InverseKinematicsSeedPrediction::VELOCITY) && previous_converged)
+        {
+            // first order prediction from target pose change
+            const MotionVector target_delta
+                = coord_transform_get_error(target_poses[index - 1U], target_poses[index]);
+            JointSpace joint_delta = {};
+            if (inverse_velocity_kinematics(
+                    m_result.jacobian, target_delta, m_dofs, joint_delta, m_linalg_plans, m_linalg_work)
+                == EFSB_LAPACK_ERROR_NONE)
+            {
+                kinematic_program_add_offset(m_chain, joint_delta, seed);
+            }
+        }
+        const InverseKinematicsResult& result = solve(target_poses[index], seed);
+        previous_converged = inverse_kinematics_converged(result.info);
+
+        InverseKinematicsSample& sample = samples[index];
+        sample.info = result.info;
+        sample.joint_position = result.joint_position;
+        sample.iterations = result.iterations;
+        summary.num_samples += 1U;
+        summary.total_iterations += result.iterations;
+        summary.max_iterations = std::max(summary.max_iterations, result.iterations);
+        if (!previous_converged)
+        {
+            summary.num_failures += 1U;
+        }
+    }
+    return summary;
+}
+
+FsbLinalgErrorType jacobian_linalg_plans_create(JacobianLinalgPlans& plans)
+{
+    FsbLinalgErrorType result = EFSB_LAPACK_ERROR_NONE;
+    plans = {};
+    for (size_t dofs = 1U; dofs <= MaxSize::kDofs; ++dofs)
+    {
+        const FsbLinalgErrorType leastsquares_result
+            = fsb_linalg_leastsquares_plan(FSB_CART_SIZE, dofs, 1U, &plans.leastsquares[dofs]);
+        const FsbLinalgErrorType pseudoinverse_result
+            = fsb_linalg_pseudoinverse_plan(FSB_CART_SIZE, dofs, &plans.pseudoinverse[dofs]);
+        if (result == EFSB_LAPACK_ERROR_NONE)
+        {
+            result = (leastsquares_result != EFSB_LAPACK_ERROR_NONE) ? leastsquares_result
+                                                                     : pseudoinverse_result;
+        }
+    }
+    return result;
+}
+
+/**
+ * Least squares solution of Jacobian linear system, fixed size kernel with LAPACK fallback for
+ * rank deficient Jacobian, the fallback is planned on each call without plans
+ */
+template <size_t Capacity>
+static FsbLinalgErrorType jacobian_leastsquares_solve(
+    const Jacobian& jacobian, const double_t bvec[], const size_t dofs, JointSpace& joint_motion,
+    const JacobianLinalgPlans* plans, WorkArray<double_t, Capacity>& work)
+{
+    FsbLinalgErrorType result = linalg_fixed_leastsquares_solve<FSB_CART_SIZE>(
+        dofs, jacobian.j.data(), bvec, joint_motion.qv.data());
+    if (result != EFSB_LAPACK_ERROR_NONE)
+    {
+        FsbLinalgLeastSquaresPlan plan = {};
+        if (plans != nullptr)
+        {
+            plan = plans->leastsquares[std::min(dofs, MaxSize::kDofs)];
+        }
+        else
+        {
+            (void)fsb_linalg_leastsquares_plan(FSB_CART_SIZE, dofs, 1U, &plan);
+        }
+        result = fsb_linalg_leastsquares_execute_work(
+            plan, jacobian.j.data(), bvec, work, joint_motion.qv.data());
+    }
+    return result;
+}
+
+/**
+ * Inverse velocity kinematics as least squares solution of Jacobian linear system
+ */
+template <size_t Capacity>
+static FsbLinalgErrorType inverse_velocity_solve(
+    const Jacobian& jacobian, const MotionVector& cart_velocity, const size_t dofs,
+    JointSpace& joint_velocity, const JacobianLinalgPlans* plans, WorkArray<double_t, Capacity>& work)
+{
     // Solve the least squares problem J * qv = velocity
     // where J is the Jacobian and qv is the joint velocity vector.
     const double_t bvec[FSB_CART_SIZE]
@@ -207,23 +892,19 @@ FsbLinalgErrorType inverse_velocity_kinematics(const Jacobian& jacobian, const M
            cart_velocity.linear.x,
            cart_velocity.linear.y,
            cart_velocity.linear.z};
-    double_t work[512U] = {}; // workspace for least squares solve
-    const size_t work_len = 512U; // length of workspace
-    return fsb_linalg_leastsquares_solve(
-        jacobian.j.data(),
-        FSB_CART_SIZE,
-        dofs,
-        bvec,
-        nrhs,
-        work_len,
-        work,
-        joint_velocity.qv.data());
+    return jacobian_leastsquares_solve(
+        jacobian, bvec, std::min(dofs, MaxSize::kDofs), joint_velocity, plans, work);
 }
 
-FsbLinalgErrorType inverse_acceleration_kinematics(
+/**
+ * Inverse acceleration kinematics as least squares solution of Jacobian linear system
+ */
+template <size_t Capacity>
+static FsbLinalgErrorType inverse_acceleration_solve(
     const Jacobian& jacobian, const Jacobian& jacobian_derivative,
     const MotionVector& cart_acceleration, const JointSpace& joint_velocity, const size_t dofs,
-    JointSpace& joint_acceleration)
+    JointSpace& joint_acceleration, const JacobianLinalgPlans* plans,
+    WorkArray<double_t, Capacity>& work)
 {
     const MotionVector cart_acc = jacobian_multiply(jacobian_derivative, joint_velocity, dofs);
     const MotionVector cart_motion
@@ -237,18 +918,43 @@ FsbLinalgErrorType inverse_acceleration_kinematics(
            cart_motion.linear.x,
            cart_motion.linear.y,
            cart_motion.linear.z};
-    const size_t nrhs = 1U;
-    double_t     work[512U] = {}; // workspace for least squares solve
-    const size_t work_len = 512U; // length of workspace
-    return fsb_linalg_leastsquares_solve(
-        jacobian.j.data(),
-        FSB_CART_SIZE,
-        dofs,
-        bvec,
-        nrhs,
-        work_len,
-        work,
-        joint_acceleration.qv.data());
+    return jacobian_leastsquares_solve(jacobian, bvec, dofs, joint_acceleration, plans, work);
+}
+
+FsbLinalgErrorType inverse_velocity_kinematics(
+    const Jacobian& jacobian, const MotionVector& cart_velocity, const size_t dofs,
+    JointSpace& joint_velocity)
+{
+    WorkArray<double_t, 512U> work; // workspace for least squares fallback
+    return inverse_velocity_solve(jacobian, cart_velocity, dofs, joint_velocity, nullptr, work);
+}
+
+FsbLinalgErrorType inverse_velocity_kinematics(
+    const Jacobian& jacobian, const MotionVector& cart_velocity, const size_t dofs,
+    JointSpace& joint_velocity, const JacobianLinalgPlans& plans, LinalgWork& work)
+{
+    return inverse_velocity_solve(jacobian, cart_velocity, dofs, joint_velocity, &plans, work);
+}
+
+FsbLinalgErrorType inverse_acceleration_kinematics(
+    const Jacobian& jacobian, const Jacobian& jacobian_derivative,
+    const MotionVector& cart_acceleration, const JointSpace& joint_velocity, const size_t dofs,
+    JointSpace& joint_acceleration)
+{
+    WorkArray<double_t, 512U> work; // workspace for least squares fallback
+    return inverse_acceleration_solve(
+        jacobian, jacobian_derivative, cart_acceleration, joint_velocity, dofs, joint_acceleration,
+        nullptr, work);
+}
+
+FsbLinalgErrorType inverse_acceleration_kinematics(
+    const Jacobian& jacobian, const Jacobian& jacobian_derivative,
+    const MotionVector& cart_acceleration, const JointSpace& joint_velocity, const size_t dofs,
+    JointSpace& joint_acceleration, const JacobianLinalgPlans& plans, LinalgWork& work)
+{
+    return inverse_acceleration_solve(
+        jacobian, jacobian_derivative, cart_acceleration, joint_velocity, dofs, joint_acceleration,
+        &plans, work);
 }
 
 } // namespace fsb
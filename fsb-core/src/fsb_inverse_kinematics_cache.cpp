@@ -0,0 +1,235 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include "fsb_inverse_kinematics_cache.h"
+#include "fsb_configuration.h"
+#include "fsb_joint.h"
+#include "fsb_motion.h"
+#include "fsb_quaternion.h"
+#include "fsb_types.h"
+
+namespace fsb
+{
+
+/**
+ * Cell index of value in cell units, non-finite values map to cell zero
+ */
+static int64_t cache_cell(const Real value)
+{
+    const Real cell = std::floor(value);
+    int64_t    result = 0;
+    if (std::isfinite(cell) && (std::fabs(cell) < 1.0e15))
+    {
+        result = static_cast<int64_t>(cell);
+    }
+    return result;
+}
+
+/**
+ * FNV-1a hash of cell key
+ */
+static size_t cache_set_index(const std::array<int64_t, 6U>& key)
+{
+    uint64_t hash = 14695981039346656037U;
+    for (const int64_t value : key)
+    {
+        hash ^= static_cast<uint64_t>(value);
+        hash *= 1099511628211U;
+    }
+    return static_cast<size_t>(hash % kSeedCacheSets);
+}
+
+bool InverseKinematicsSeedCache::initialize(const SeedCacheParameters& params)
+{
+    // resolutions divide target coordinates
+    m_enabled = std::isfinite(params.position_resolution)
+                && (params.position_resolution > 0.0)
+                && std::isfinite(params.orientation_resolution)
+                && (params.orientation_resolution > 0.0);
+    if (m_enabled)
+    {
+        m_params = params;
+    }
+    clear();
+    return m_enabled;
+}
+
+void InverseKinematicsSeedCache::clear()
+{
+    m_entries = {};
+    m_statistics = {};
+    m_stamp = 0U;
+}
+
+InverseKinematicsSeedCache::CellCoordinates
+InverseKinematicsSeedCache::cell_coordinates(const Transform& target_pose, const Real sign) const
+{
+    // rotation vector of quaternion with given sign, norm above pi for negative scalar part
+    const Quaternion rotation = {
+        sign * target_pose.rotation.qw, sign * target_pose.rotation.qx,
+        sign * target_pose.rotation.qy, sign * target_pose.rotation.qz};
+    const Vec3 rotation_vector = vector_scale(2.0, quat_log(rotation));
+    return {
+        target_pose.translation.x / m_params.position_resolution,
+        target_pose.translation.y / m_params.position_resolution,
+        target_pose.translation.z / m_params.position_resolution,
+        rotation_vector.x / m_params.orientation_resolution,
+        rotation_vector.y / m_params.orientation_resolution,
+        rotation_vector.z / m_params.orientation_resolution};
+}
+
+Real InverseKinematicsSeedCache::target_distance(const Transform& target_pose, const Transform& stored_pose) const
+{
+    // squared distance in cell units of position and rotation angle
+    const Vec3 position_error = vector_scale(
+        1.0 / m_params.position_resolution, vector_subtract(target_pose.translation, stored_pose.translation));
+    const Real quat_dot = std::fabs(
+        (target_pose.rotation.qw * stored_pose.rotation.qw) + (target_pose.rotation.qx * stored_pose.rotation.qx)
+        + (target_pose.rotation.qy * stored_pose.rotation.qy) + (target_pose.rotation.qz * stored_pose.rotation.qz));
+    const Real angle = 2.0 * std::acos(std::min(quat_dot, 1.0)) / m_params.orientation_resolution;
+    return vector_dot(position_error, position_error) + (angle * angle);
+}
+
+void InverseKinematicsSeedCache::probe_cells(
+    const CellCoordinates& coordinates, const Transform& target_pose, size_t& nearest_index,
+    Real& nearest_distance) const
+{
+    // cell of coordinates and neighbour on the nearer side in each coordinate
+    constexpr size_t num_dims = 6U;
+    CellKey          base_key = {};
+    CellKey          step = {};
+    for (size_t dim = 0U; dim < num_dims; ++dim)
+    {
+        base_key[dim] = cache_cell(coordinates[dim]);
+        step[dim] = ((coordinates[dim] - std::floor(coordinates[dim])) < 0.5) ? -1 : 1;
+    }
+    for (size_t mask = 0U; mask < (size_t{1U} << num_dims); ++mask)
+    {
+        CellKey key = base_key;
+        for (size_t dim = 0U; dim < num_dims; ++dim)
+        {
+            if (((mask >> dim) & 1U) != 0U)
+            {
+                key[dim] += step[dim];
+            }
+        }
+        const size_t set_begin = cache_set_index(key) * kSeedCacheWays;
+        for (size_t index = set_begin; index < set_begin + kSeedCacheWays; ++index)
+        {
+            const Entry& entry = m_entries[index];
+            if (entry.valid && (entry.key == key))
+            {
+                const Real distance = target_distance(target_pose, entry.target_pose);
+                if (distance < nearest_distance)
+                {
+                    nearest_index = index;
+                    nearest_distance = distance;
+                }
+            }
+        }
+    }
+}
+
+bool InverseKinematicsSeedCache::lookup(const Transform& target_pose, JointSpacePosition& seed)
+{
+    size_t nearest_index = m_entries.size();
+    if (m_enabled)
+    {
+        Real       nearest_distance = std::numeric_limits<Real>::infinity();
+        const Real sign = (target_pose.rotation.qw < 0.0) ? -1.0 : 1.0;
+        probe_cells(
+            cell_coordinates(target_pose, sign), target_pose, nearest_index, nearest_distance);
+
+        // rotation close to half a turn, cells of equivalent rotation vector on the opposite side
+        const Real vector_norm = std::sqrt(
+            (target_pose.rotation.qx * target_pose.rotation.qx)
+            + (target_pose.rotation.qy * target_pose.rotation.qy)
+            + (target_pose.rotation.qz * target_pose.rotation.qz));
+        const Real angle = 2.0 * std::atan2(vector_norm, std::fabs(target_pose.rotation.qw));
+        if ((M_PI - angle) < m_params.orientation_resolution)
+        {
+            probe_cells(
+                cell_coordinates(target_pose, -sign), target_pose, nearest_index, nearest_distance);
+        }
+    }
+
+    const bool result = nearest_index < m_entries.size();
+    if (result)
+    {
+        Entry& entry = m_entries[nearest_index];
+        m_stamp += 1U;
+        entry.stamp = m_stamp;
+        seed = entry.joint_position;
+        m_statistics.hits += 1U;
+    }
+    else
+    {
+        m_statistics.misses += 1U;
+    }
+    return result;
+}
+
+void InverseKinematicsSeedCache::insert(const Transform& target_pose, const JointSpacePosition& joint_position)
+{
+    if (m_enabled)
+    {
+        const Real            sign = (target_pose.rotation.qw < 0.0) ? -1.0 : 1.0;
+        const CellCoordinates coordinates = cell_coordinates(target_pose, sign);
+        CellKey               key = {};
+        for (size_t dim = 0U; dim < key.size(); ++dim)
+        {
+            key[dim] = cache_cell(coordinates[dim]);
+        }
+        const size_t set_begin = cache_set_index(key) * kSeedCacheWays;
+
+        // same cell, else empty cell, else least recently used cell of set
+        size_t match_index = m_entries.size();
+        size_t replace_index = set_begin;
+        for (size_t index = set_begin; index < set_begin + kSeedCacheWays; ++index)
+        {
+            const Entry& entry = m_entries[index];
+            if (entry.valid && (entry.key == key))
+            {
+                match_index = index;
+            }
+            else if (
+                m_entries[replace_index].valid
+                && (!entry.valid || (entry.stamp < m_entries[replace_index].stamp)))
+            {
+                replace_index = index;
+            }
+        }
+
+        const bool found = match_index < m_entries.size();
+        Entry&     entry = m_entries[found ? match_index : replace_index];
+        if (!found && entry.valid)
+        {
+            m_statistics.evictions += 1U;
+        }
+        m_stamp += 1U;
+        entry.valid = true;
+        entry.key = key;
+        entry.stamp = m_stamp;
+        entry.target_pose = target_pose;
+        entry.joint_position = joint_position;
+        m_statistics.insertions += 1U;
+    }
+}
+
+size_t InverseKinematicsSeedCache::get_size() const
+{
+    size_t result = 0U;
+    for (const Entry& entry : m_entries)
+    {
+        if (entry.valid)
+        {
+            result += 1U;
+        }
+    }
+    return result;
+}
+
+} // namespace fsb
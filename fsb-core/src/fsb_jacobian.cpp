@@ -10,6 +10,7 @@
 #include "fsb_body_tree.h"
 #include "fsb_joint.h"
 #include "fsb_jacobian.h"
+#include "fsb_kinematics.h"
 #include "fsb_rotation.h"
 #include "fsb_linalg3.h"
 
@@ -296,6 +297,154 @@ JacobianError calculate_jacobian(
     return result;
 }
 
+static void set_jacobian_column(
+    const size_t jac_col, const Vec3& angular, const Vec3& linear, Jacobian& jacobian)
+{
+    jacobian.j[jacobian_index(0U, jac_col)] = angular.x;
+    jacobian.j[jacobian_index(1U, jac_col)] = angular.y;
+    jacobian.j[jacobian_index(2U, jac_col)] = angular.z;
+    jacobian.j[jacobian_index(3U, jac_col)] = linear.x;
+    jacobian.j[jacobian_index(4U, jac_col)] = linear.y;
+    jacobian.j[jacobian_index(5U, jac_col)] = linear.z;
+}
+
+static void calculate_jacobian_axes_columns(
+    const JointAxes& joint_axes, const Vec3& target_position, Jacobian& jacobian)
+{
+    const Vec3   pos = vector_subtract(joint_axes.origin, target_position);
+    const size_t jac_col = joint_axes.dof_index;
+    switch (joint_axes.kind)
+    {
+        case KinematicOpKind::REVOLUTE:
+        {
+            set_jacobian_column(
+                jac_col,
+                joint_axes.axis[0U],
+                vector_cross(pos, joint_axes.axis[0U]),
+                jacobian);
+            break;
+        }
+        case KinematicOpKind::PRISMATIC:
+        {
+            set_jacobian_column(jac_col, {}, joint_axes.axis[0U], jacobian);
+            break;
+        }
+        case KinematicOpKind::SPHERICAL:
+        {
+            for (size_t index = 0U; index < 3U; ++index)
+            {
+                set_jacobian_column(
+                    jac_col + index,
+                    joint_axes.axis[index],
+                    vector_cross(pos, joint_axes.axis[index]),
+                    jacobian);
+            }
+            break;
+        }
+        case KinematicOpKind::CARTESIAN:
+        {
+            for (size_t index = 0U; index < 3U; ++index)
+            {
+                set_jacobian_column(
+                    jac_col + index,
+                    joint_axes.axis[index],
+                    vector_cross(pos, joint_axes.axis[index]),
+                    jacobian);
+                set_jacobian_column(jac_col + 3U + index, {}, joint_axes.axis[index], jacobian);
+            }
+            break;
+        }
+        case KinematicOpKind::FIXED:
+        case KinematicOpKind::IDENTITY:
+        default:
+        {
+            // nothing to do, leave jacobian columns at zero
+            break;
+        }
+    }
+}
+
+JacobianError calculate_jacobian_from_axes(
+    size_t body_index, const BodyJointAxes& joint_axes, const BodyCartesianPva& cartesian_pva,
+    Jacobian& jacobian)
+{
+    // initialize
+    jacobian = {};
+    auto result = JacobianError::SUCCESS;
+
+    if (body_index >= joint_axes.num_bodies)
+    {
+        result = JacobianError::BODY_NOT_IN_TREE;
+    }
+    else
+    {
+        const Vec3& target_position = cartesian_pva.body[body_index].pose.translation;
+        // propagate through parent bodies
+        while (body_index > 0U)
+        {
+            const JointAxes& axes = joint_axes.body[body_index];
+            calculate_jacobian_axes_columns(axes, target_position, jacobian);
+            body_index = axes.parent_index;
+        }
+    }
+    return result;
+}
+
+JacobianError calculate_jacobians_from_axes(
+    const std::array<size_t, MaxSize::kBodies>& body_indices, const size_t num_jacobians,
+    const BodyJointAxes& joint_axes, const BodyCartesianPva& cartesian_pva,
+    std::array<Jacobian, MaxSize::kBodies>& jacobians)
+{
+    auto result = JacobianError::SUCCESS;
+    if (num_jacobians > MaxSize::kBodies)
+    {
+        result = JacobianError::BODY_NOT_IN_TREE;
+    }
+    else
+    {
+        for (size_t index = 0U; index < num_jacobians; ++index)
+        {
+            const JacobianError err = calculate_jacobian_from_axes(
+                body_indices[index], joint_axes, cartesian_pva, jacobians[index]);
+            if (err != JacobianError::SUCCESS)
+            {
+                result = err;
+            }
+        }
+    }
+    return result;
+}
+
+JacobianError calculate_jacobians(
+    const std::array<size_t, MaxSize::kBodies>& body_indices, const size_t num_jacobians,
+    const KinematicProgram& program, const BodyCartesianPva& cartesian_pva,
+    std::array<Jacobian, MaxSize::kBodies>& jacobians)
+{
+    // world frame joint axes shared by all jacobians
+    BodyJointAxes joint_axes = {};
+    kinematic_program_joint_axes(program, cartesian_pva, joint_axes);
+    return calculate_jacobians_from_axes(
+        body_indices, num_jacobians, joint_axes, cartesian_pva, jacobians);
+}
+
+JacobianError calculate_jacobians(
+    const std::array<size_t, MaxSize::kBodies>& body_indices, const size_t num_jacobians,
+    const BodyTree& body_tree, const BodyCartesianPva& cartesian_pva,
+    std::array<Jacobian, MaxSize::kBodies>& jacobians)
+{
+    auto             result = JacobianError::SUCCESS;
+    KinematicProgram program = {};
+    if (!kinematic_program_compile(body_tree, program))
+    {
+        result = JacobianError::TREE_NOT_COMPILED;
+    }
+    else
+    {
+        result = calculate_jacobians(body_indices, num_jacobians, program, cartesian_pva, jacobians);
+    }
+    return result;
+}
+
 static bool is_revolute(const JointType jt)
 {
     return (jt == JointType::REVOLUTE_X) || (jt == JointType::REVOLUTE_Y)
@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <cstddef>
 
@@ -10,67 +11,198 @@
 #include "fsb_kinematic_redundancy.h"
 #include "fsb_linalg.h"
 #include "fsb_jacobian.h"
+#include "fsb_linalg_fixed.h"
+#include "fsb_inverse_kinematics.h"
+#include "fsb_work.h"
 
 namespace fsb
 {
 
-FsbLinalgErrorType
-jacobian_pseudoinverse(const Jacobian& jacobian, Jacobian& inverse_jacobian, const size_t dofs)
+/**
+ * Pseudoinverse of Jacobian by one-sided Jacobi decomposition with LAPACK fallback if it does not
+ * converge or exceeds the fixed size, the fallback is planned on each call without plans
+ */
+template <size_t Capacity>
+static FsbLinalgErrorType pseudoinverse_solve(
+    const Jacobian& jacobian, Jacobian& inverse_jacobian, const size_t dofs,
+    const JacobianLinalgPlans* plans, WorkArray<double_t, Capacity>& work)
 {
-    // lapack pseudoinverse c array inputs
-    constexpr size_t WorkLen = MaxSize::kLinalgWork;
-    double_t         work[WorkLen] = {};
-    // run pseudoinverse
-    return fsb_linalg_pseudoinverse(
-        jacobian.j.data(), FSB_CART_SIZE, dofs, WorkLen, work, inverse_jacobian.j.data());
+    JacobianSvd        svd = {};
+    FsbLinalgErrorType result = svd.update(jacobian, dofs);
+    if (result == EFSB_LAPACK_ERROR_NONE)
+    {
+        svd.pseudoinverse(0.0, 1.0e-12, inverse_jacobian);
+    }
+    else if ((result == EFSB_LAPACK_ERROR_CONVERGE) || (dofs > kLinalgFixedMaxDim))
+    {
+        FsbLinalgPseudoinversePlan plan = {};
+        if (plans != nullptr)
+        {
+            plan = plans->pseudoinverse[std::min(dofs, MaxSize::kDofs)];
+        }
+        else
+        {
+            (void)fsb_linalg_pseudoinverse_plan(FSB_CART_SIZE, dofs, &plan);
+        }
+        result = fsb_linalg_pseudoinverse_execute_work(plan, jacobian.j.data(), work, inverse_jacobian.j.data());
+    }
+    else
+    {
+        // invalid number of degrees of freedom
+    }
+    return result;
 }
 
-JointSpace compute_nullspace_motion(
-    const Jacobian& jacobian, const JointSpace& joint_motion, const size_t dofs)
+/**
+ * Solve damped Gram system for several right-hand sides from one factorization, with LAPACK
+ * Cholesky for more rows than the fixed size solver supports. The Gram matrix may be overwritten.
+ */
+static FsbLinalgErrorType task_gram_solve(
+    const size_t rows, const size_t nrhs, Real gram[], const Real rhs[], Real solution[],
+    const size_t work_len, Real work[])
 {
-    JointSpace result = {};
-    // Calculate J+ * J * qd
-    // First, compute J * qd (cartesian motion)
-    MotionVector cart_motion = {};
-    for (size_t col = 0; col < dofs; ++col)
+    auto result = EFSB_LAPACK_ERROR_NONE;
+    if (rows <= kLinalgFixedMaxDim)
     {
-        cart_motion.angular.x += jacobian.j[jacobian_index(0U, col)] * joint_motion.qv[col];
-        cart_motion.angular.y += jacobian.j[jacobian_index(1U, col)] * joint_motion.qv[col];
-        cart_motion.angular.z += jacobian.j[jacobian_index(2U, col)] * joint_motion.qv[col];
-        cart_motion.linear.x += jacobian.j[jacobian_index(3U, col)] * joint_motion.qv[col];
-        cart_motion.linear.y += jacobian.j[jacobian_index(4U, col)] * joint_motion.qv[col];
-        cart_motion.linear.z += jacobian.j[jacobian_index(5U, col)] * joint_motion.qv[col];
+        result = linalg_fixed_cholesky_factor(rows, gram);
+        for (size_t index = 0U; (index < nrhs) && (result == EFSB_LAPACK_ERROR_NONE); ++index)
+        {
+            Real* const x_vec = &solution[rows * index];
+            std::copy_n(&rhs[rows * index], rows, x_vec);
+            result = linalg_fixed_cholesky_solve(rows, gram, x_vec);
+        }
     }
+    else
+    {
+        result = fsb_linalg_cholesky_solve(gram, rhs, nrhs, rows, work_len, work, solution);
+    }
+    return result;
+}
 
-    // Then, compute qn = J+ * (J * qd) = J+ * cart_motion
-    // lapack pseudoinverse c array inputs
-    double_t motion_vec[FSB_CART_SIZE] = {};
-    double_t joint_null[MaxSize::kDofs] = {};
-    constexpr size_t NRHS = 1U;
-    constexpr size_t WorkLen = 512U;
-    double_t         work[WorkLen] = {};
-    // copy data to c array
-    motion_vec[0] = cart_motion.angular.x;
-    motion_vec[1] = cart_motion.angular.y;
-    motion_vec[2] = cart_motion.angular.z;
-    motion_vec[3] = cart_motion.linear.x;
-    motion_vec[4] = cart_motion.linear.y;
-    motion_vec[5] = cart_motion.linear.z;
-    // run least squares solve
-    FsbLinalgErrorType const linalg_err = fsb_linalg_leastsquares_solve(
-        jacobian.j.data(), FSB_CART_SIZE, dofs, motion_vec, NRHS, WorkLen, work, joint_null);
-
+/**
+ * Nullspace motion from least squares projection of joint motion, zero if the solve failed
+ */
+static JointSpace nullspace_motion_residual(
+    const JointSpace& joint_motion, const JointSpace& joint_null, const size_t dofs,
+    const FsbLinalgErrorType linalg_err)
+{
+    JointSpace result = {};
     // Compute nullspace motion: (I - J+ * J) * qd = qd - J+ * J * qd
     if (linalg_err == FsbLinalgErrorType::EFSB_LAPACK_ERROR_NONE)
     {
         for (size_t ind = 0U; ind < dofs; ++ind)
         {
-            result.qv[ind] = joint_motion.qv[ind] - joint_null[ind];
+            result.qv[ind] = joint_motion.qv[ind] - joint_null.qv[ind];
+        }
+    }
+    return result;
+}
+
+FsbLinalgErrorType
+jacobian_pseudoinverse(const Jacobian& jacobian, Jacobian& inverse_jacobian, const size_t dofs)
+{
+    LinalgWork work; // workspace for LAPACK fallback
+    return pseudoinverse_solve(jacobian, inverse_jacobian, dofs, nullptr, work);
+}
+
+FsbLinalgErrorType jacobian_pseudoinverse(
+    const Jacobian& jacobian, Jacobian& inverse_jacobian, const size_t dofs,
+    const JacobianLinalgPlans& plans, LinalgWork& work)
+{
+    return pseudoinverse_solve(jacobian, inverse_jacobian, dofs, &plans, work);
+}
+
+void JacobianSvd::reset()
+{
+    m_warm = false;
+}
+
+FsbLinalgErrorType JacobianSvd::update(const Jacobian& jacobian, const size_t dofs)
+{
+    const bool warm = m_warm && (dofs == m_dofs);
+    // previous right singular vectors are the initial rotation, copy since output aliases
+    const JointMatrix  v_init = m_right;
+    FsbLinalgErrorType result = linalg_fixed_svd<FSB_CART_SIZE>(
+        dofs,
+        jacobian.j.data(),
+        warm ? v_init.j.data() : nullptr,
+        m_singular_values.qv.data(),
+        m_left.j.data(),
+        m_right.j.data(),
+        &m_sweeps);
+    m_dofs = (result == EFSB_LAPACK_ERROR_INPUT) ? 0U : dofs;
+    m_warm = (result == EFSB_LAPACK_ERROR_NONE);
+    return result;
+}
+
+FsbLinalgErrorType JacobianSvd::update_singular_values(const Jacobian& jacobian, const size_t dofs)
+{
+    const bool warm = m_warm && (dofs == m_dofs);
+    return linalg_fixed_svd<FSB_CART_SIZE>(
+        dofs,
+        jacobian.j.data(),
+        warm ? m_right.j.data() : nullptr,
+        m_singular_values.qv.data(),
+        nullptr,
+        nullptr,
+        &m_sweeps);
+}
+
+void JacobianSvd::pseudoinverse(const Real damping, const Real tolerance, Jacobian& inverse_jacobian) const
+{
+    inverse_jacobian = {};
+    for (size_t ind = 0U; ind < m_dofs; ++ind)
+    {
+        const Real sing_val = m_singular_values.qv[ind];
+        const Real denominator = sing_val * sing_val + damping;
+        if ((sing_val > tolerance) && (denominator > 0.0))
+        {
+            const Real inv_sing_val = sing_val / denominator;
+            for (size_t col = 0U; col < FSB_CART_SIZE; ++col)
+            {
+                const Real scale = inv_sing_val * m_left.j[jacobian_index(col, ind)];
+                for (size_t row = 0U; row < m_dofs; ++row)
+                {
+                    inverse_jacobian.j[joint_matrix_index(row, col, m_dofs)]
+                        += m_right.j[joint_matrix_index(row, ind, m_dofs)] * scale;
+                }
+            }
         }
     }
+}
+
+Real JacobianSvd::get_manipulability() const
+{
+    Real         result = (m_dofs > 0U) ? 1.0 : 0.0;
+    const size_t rank = std::min(m_dofs, static_cast<size_t>(FSB_CART_SIZE));
+    for (size_t ind = 0U; ind < rank; ++ind)
+    {
+        result *= m_singular_values.qv[ind];
+    }
     return result;
 }
 
+JointSpace compute_nullspace_motion(
+    const Jacobian& jacobian, const JointSpace& joint_motion, const size_t dofs)
+{
+    // qn = J+ * (J * qd)
+    JointSpace               joint_null = {};
+    const FsbLinalgErrorType linalg_err = inverse_velocity_kinematics(
+        jacobian, jacobian_multiply(jacobian, joint_motion, dofs), dofs, joint_null);
+    return nullspace_motion_residual(joint_motion, joint_null, dofs, linalg_err);
+}
+
+JointSpace compute_nullspace_motion(
+    const Jacobian& jacobian, const JointSpace& joint_motion, const size_t dofs,
+    const JacobianLinalgPlans& plans, LinalgWork& work)
+{
+    // qn = J+ * (J * qd)
+    JointSpace               joint_null = {};
+    const FsbLinalgErrorType linalg_err = inverse_velocity_kinematics(
+        jacobian, jacobian_multiply(jacobian, joint_motion, dofs), dofs, joint_null, plans, work);
+    return nullspace_motion_residual(joint_motion, joint_null, dofs, linalg_err);
+}
+
 JointSpace compute_nullspace_motion(
     const Jacobian& jacobian, const Jacobian& inverse_jacobian, const JointSpace& joint_motion,
     const size_t dofs)
@@ -174,4 +306,146 @@ JointSpace joint_limit_avoidance_objective(
     return result;
 }
 
+void TaskPriorityController::reset(const size_t dofs)
+{
+    m_num_tasks = 0U;
+    m_dofs = dofs;
+}
+
+bool TaskPriorityController::add_cartesian_task(
+    const Jacobian& jacobian, const MotionVector& cart_velocity, const Real damping)
+{
+    bool result = false;
+    if ((m_num_tasks < kTaskPriorityMaxTasks) && (m_dofs <= MaxSize::kDofs))
+    {
+        Task& task = m_tasks[m_num_tasks];
+        task.rows = FSB_CART_SIZE;
+        for (size_t ind = 0U; ind < FSB_CART_SIZE * m_dofs; ++ind)
+        {
+            task.matrix[ind] = jacobian.j[ind];
+        }
+        task.velocity[0] = cart_velocity.angular.x;
+        task.velocity[1] = cart_velocity.angular.y;
+        task.velocity[2] = cart_velocity.angular.z;
+        task.velocity[3] = cart_velocity.linear.x;
+        task.velocity[4] = cart_velocity.linear.y;
+        task.velocity[5] = cart_velocity.linear.z;
+        task.damping = damping;
+        m_num_tasks += 1U;
+        result = true;
+    }
+    return result;
+}
+
+bool TaskPriorityController::add_joint_task(const JointSpace& joint_velocity, const Real damping)
+{
+    bool result = false;
+    if ((m_num_tasks < kTaskPriorityMaxTasks) && (m_dofs <= MaxSize::kDofs))
+    {
+        Task& task = m_tasks[m_num_tasks];
+        task.rows = m_dofs;
+        task.matrix = {};
+        for (size_t ind = 0U; ind < m_dofs; ++ind)
+        {
+            task.matrix[joint_matrix_index(ind, ind, m_dofs)] = 1.0;
+            task.velocity[ind] = joint_velocity.qv[ind];
+        }
+        task.damping = damping;
+        m_num_tasks += 1U;
+        result = true;
+    }
+    return result;
+}
+
+FsbLinalgErrorType TaskPriorityController::solve(JointSpace& joint_velocity)
+{
+    auto         result = EFSB_LAPACK_ERROR_NONE;
+    const size_t dofs = m_dofs;
+    joint_velocity = {};
+    m_nullspace = {};
+    if ((dofs == 0U) || (dofs > MaxSize::kDofs))
+    {
+        result = EFSB_LAPACK_ERROR_INPUT;
+    }
+    else
+    {
+        for (size_t ind = 0U; ind < dofs; ++ind)
+        {
+            m_nullspace.j[joint_matrix_index(ind, ind, dofs)] = 1.0;
+        }
+    }
+
+    for (size_t task_index = 0U; (task_index < m_num_tasks) && (result == EFSB_LAPACK_ERROR_NONE); ++task_index)
+    {
+        const Task&  task = m_tasks[task_index];
+        const size_t rows = task.rows;
+
+        // projected task matrix J N and task residual xd - J qd, the columns of J N follow the
+        // residual as right-hand sides of the nullspace update
+        for (size_t row = 0U; row < rows; ++row)
+        {
+            Real residual = task.velocity[row];
+            for (size_t col = 0U; col < dofs; ++col)
+            {
+                residual -= task.matrix[joint_matrix_index(row, col, rows)] * joint_velocity.qv[col];
+                Real value = 0.0;
+                for (size_t ind = 0U; ind < dofs; ++ind)
+                {
+                    value += task.matrix[joint_matrix_index(row, ind, rows)]
+                             * m_nullspace.j[joint_matrix_index(ind, col, dofs)];
+                }
+                m_projected[joint_matrix_index(row, col, rows)] = value;
+                m_rhs[joint_matrix_index(row, col + 1U, rows)] = value;
+            }
+            m_rhs[row] = residual;
+        }
+
+        // damped Gram matrix J N (J N)^T + damping I, lower triangle
+        for (size_t col = 0U; col < rows; ++col)
+        {
+            for (size_t row = col; row < rows; ++row)
+            {
+                Real value = (row == col) ? task.damping : 0.0;
+                for (size_t ind = 0U; ind < dofs; ++ind)
+                {
+                    value += m_projected[joint_matrix_index(row, ind, rows)]
+                             * m_projected[joint_matrix_index(col, ind, rows)];
+                }
+                m_gram[joint_matrix_index(row, col, rows)] = value;
+            }
+        }
+        result = task_gram_solve(
+            rows, dofs + 1U, m_gram.data(), m_rhs.data(), m_solution.data(), m_cholesky_work.size(),
+            m_cholesky_work.data());
+
+        if (result == EFSB_LAPACK_ERROR_NONE)
+        {
+            // task velocity qd += (J N)^# (xd - J qd)
+            for (size_t col = 0U; col < dofs; ++col)
+            {
+                for (size_t row = 0U; row < rows; ++row)
+                {
+                    joint_velocity.qv[col] += m_projected[joint_matrix_index(row, col, rows)] * m_solution[row];
+                }
+            }
+
+            // nullspace update N -= (J N)^# (J N)
+            for (size_t col = 0U; col < dofs; ++col)
+            {
+                for (size_t row = 0U; row < dofs; ++row)
+                {
+                    Real value = 0.0;
+                    for (size_t ind = 0U; ind < rows; ++ind)
+                    {
+                        value += m_projected[joint_matrix_index(ind, row, rows)]
+                                 * m_solution[joint_matrix_index(ind, col + 1U, rows)];
+                    }
+                    m_nullspace.j[joint_matrix_index(row, col, dofs)] -= value;
+                }
+            }
+        }
+    }
+    return result;
+}
+
 } // namespace fsb
@@ -1,4 +1,7 @@
+#include <array>
+#include <cmath>
 #include <cstddef>
+#include <cstdint>
 
 #include "fsb_types.h"
 #include "fsb_kinematics.h"
@@ -7,6 +10,7 @@
 #include "fsb_quaternion.h"
 #include "fsb_motion.h"
 #include "fsb_joint.h"
+#include "fsb_rotation.h"
 
 namespace fsb
 {
@@ -66,6 +70,574 @@ void forward_kinematics(
     }
 }
 
+static Vec3 joint_type_axis(const JointType joint_type)
+{
+    Vec3 axis = {};
+    switch (joint_type)
+    {
+        case JointType::REVOLUTE_X:
+        case JointType::PRISMATIC_X:
+            axis.x = 1.0;
+            break;
+        case JointType::REVOLUTE_Y:
+        case JointType::PRISMATIC_Y:
+            axis.y = 1.0;
+            break;
+        case JointType::REVOLUTE_Z:
+        case JointType::PRISMATIC_Z:
+            axis.z = 1.0;
+            break;
+        case JointType::FIXED:
+        case JointType::SPHERICAL:
+        case JointType::CARTESIAN:
+        case JointType::PLANAR:
+        default:
+            // no single joint axis
+            break;
+    }
+    return axis;
+}
+
+static KinematicOpKind joint_type_op_kind(const JointType joint_type)
+{
+    KinematicOpKind kind = KinematicOpKind::IDENTITY;
+    switch (joint_type)
+    {
+        case JointType::FIXED:
+            kind = KinematicOpKind::FIXED;
+            break;
+        case JointType::REVOLUTE_X:
+        case JointType::REVOLUTE_Y:
+        case JointType::REVOLUTE_Z:
+            kind = KinematicOpKind::REVOLUTE;
+            break;
+        case JointType::PRISMATIC_X:
+        case JointType::PRISMATIC_Y:
+        case JointType::PRISMATIC_Z:
+            kind = KinematicOpKind::PRISMATIC;
+            break;
+        case JointType::SPHERICAL:
+            kind = KinematicOpKind::SPHERICAL;
+            break;
+        case JointType::CARTESIAN:
+            kind = KinematicOpKind::CARTESIAN;
+            break;
+        case JointType::PLANAR:
+        default:
+            // identity transform, consistent with joint_parent_child_transform
+            break;
+    }
+    return kind;
+}
+
+static void kinematic_op_size(
+    const KinematicOpKind kind, size_t& num_coordinates, size_t& num_dofs)
+{
+    switch (kind)
+    {
+        case KinematicOpKind::REVOLUTE:
+        case KinematicOpKind::PRISMATIC:
+            num_coordinates = 1U;
+            num_dofs = 1U;
+            break;
+        case KinematicOpKind::SPHERICAL:
+            num_coordinates = 4U;
+            num_dofs = 3U;
+            break;
+        case KinematicOpKind::CARTESIAN:
+            num_coordinates = 7U;
+            num_dofs = 6U;
+            break;
+        case KinematicOpKind::FIXED:
+        case KinematicOpKind::IDENTITY:
+        default:
+            // joint values do not affect kinematics
+            num_coordinates = 0U;
+            num_dofs = 0U;
+            break;
+    }
+}
+
+static void kinematic_op_compile(const Joint& joint, KinematicOp& kin_op)
+{
+    kin_op.kind = joint_type_op_kind(joint.type);
+    kin_op.parent_index = joint.parent_body_index;
+    kin_op.child_index = joint.child_body_index;
+    kin_op.coord_index = joint.coord_index;
+    kin_op.dof_index = joint.dof_index;
+    kin_op.sign = joint.reversed ? -1.0 : 1.0;
+    kin_op.axis = joint_type_axis(joint.type);
+    kinematic_op_size(kin_op.kind, kin_op.num_coordinates, kin_op.num_dofs);
+    kin_op.parent_joint_transform = joint.parent_joint_transform;
+
+    // joint axis in parent frame with direction sign applied
+    const Vec3 parent_axis = quat_rotate_vector(
+        joint.parent_joint_transform.rotation, vector_scale(kin_op.sign, kin_op.axis));
+    kin_op.angular_axis = {};
+    kin_op.linear_axis = {};
+    if (kin_op.kind == KinematicOpKind::REVOLUTE)
+    {
+        kin_op.angular_axis = parent_axis;
+    }
+    else if (kin_op.kind == KinematicOpKind::PRISMATIC)
+    {
+        kin_op.linear_axis = parent_axis;
+    }
+    else
+    {
+        // motion is not along a single axis
+    }
+}
+
+bool kinematic_program_compile(const BodyTree& body_tree, KinematicProgram& program)
+{
+    bool result = true;
+    program.num_ops = 0U;
+    program.num_bodies = body_tree.get_num_bodies();
+    for (size_t body_index = 1U; body_index < program.num_bodies; ++body_index)
+    {
+        auto        err = BodyTreeError::SUCCESS;
+        const Body  body = body_tree.get_body(body_index, err);
+        const Joint joint = body_tree.get_joint(body.joint_index, err);
+        if ((err != BodyTreeError::SUCCESS) || (joint.parent_body_index >= body_index))
+        {
+            // parent must precede child for a single forward pass
+            result = false;
+            break;
+        }
+        kinematic_op_compile(joint, program.op[program.num_ops]);
+        ++program.num_ops;
+    }
+    if (!result)
+    {
+        program.num_ops = 0U;
+        program.num_bodies = 0U;
+    }
+    return result;
+}
+
+bool kinematic_program_compile_chain(
+    const BodyTree& body_tree, const size_t target_body, KinematicProgram& program)
+{
+    bool result = true;
+    program.num_ops = 0U;
+    program.num_bodies = body_tree.get_num_bodies();
+    if (target_body >= program.num_bodies)
+    {
+        result = false;
+    }
+    else
+    {
+        // collect joints from target body back to base
+        std::array<Joint, MaxSize::kBodies> chain = {};
+        size_t                              num_chain = 0U;
+        size_t                              body_index = target_body;
+        while (result && (body_index != BodyTree::kBaseIndex))
+        {
+            auto       err = BodyTreeError::SUCCESS;
+            const Body body = body_tree.get_body(body_index, err);
+            chain[num_chain] = body_tree.get_joint(body.joint_index, err);
+            if ((err != BodyTreeError::SUCCESS) || (chain[num_chain].parent_body_index >= body_index))
+            {
+                result = false;
+            }
+            else
+            {
+                body_index = chain[num_chain].parent_body_index;
+                ++num_chain;
+            }
+        }
+        // program runs from base to target body
+        for (size_t index = 0U; result && (index < num_chain); ++index)
+        {
+            kinematic_op_compile(chain[num_chain - 1U - index], program.op[index]);
+            ++program.num_ops;
+        }
+    }
+    if (!result)
+    {
+        program.num_ops = 0U;
+        program.num_bodies = 0U;
+    }
+    return result;
+}
+
+Transform kinematic_op_transform(const KinematicOp& kin_op, const JointSpacePosition& joint_position)
+{
+    const Transform& tr_pj = kin_op.parent_joint_transform;
+    const size_t     coord = kin_op.coord_index;
+    Transform        result = transform_identity();
+    switch (kin_op.kind)
+    {
+        case KinematicOpKind::FIXED:
+        {
+            result = tr_pj;
+            break;
+        }
+        case KinematicOpKind::REVOLUTE:
+        {
+            const Real half_angle = 0.5 * kin_op.sign * joint_position.q[coord];
+            const Real sin_half = sin(half_angle);
+            const Quaternion quat_joint
+                = {cos(half_angle),
+                   sin_half * kin_op.axis.x,
+                   sin_half * kin_op.axis.y,
+                   sin_half * kin_op.axis.z};
+            result = {quat_multiply(tr_pj.rotation, quat_joint), tr_pj.translation};
+            break;
+        }
+        case KinematicOpKind::PRISMATIC:
+        {
+            result
+                = {tr_pj.rotation,
+                   vector_add(
+                       tr_pj.translation,
+                       vector_scale(joint_position.q[coord], kin_op.linear_axis))};
+            break;
+        }
+        case KinematicOpKind::SPHERICAL:
+        {
+            const Quaternion quat_joint
+                = {joint_position.q[coord],
+                   joint_position.q[coord + 1U],
+                   joint_position.q[coord + 2U],
+                   joint_position.q[coord + 3U]};
+            result = {quat_multiply(tr_pj.rotation, quat_joint), tr_pj.translation};
+            break;
+        }
+        case KinematicOpKind::CARTESIAN:
+        {
+            const Transform tr_joint
+                = {{joint_position.q[coord],
+                    joint_position.q[coord + 1U],
+                    joint_position.q[coord + 2U],
+                    joint_position.q[coord + 3U]},
+                   {joint_position.q[coord + 4U],
+                    joint_position.q[coord + 5U],
+                    joint_position.q[coord + 6U]}};
+            result = coord_transform(tr_pj, tr_joint);
+            break;
+        }
+        case KinematicOpKind::IDENTITY:
+        default:
+        {
+            // result is identity transform
+            break;
+        }
+    }
+    return result;
+}
+
+MotionVector kinematic_op_motion(const KinematicOp& kin_op, const JointSpace& joint_motion)
+{
+    const Quaternion& rot_pj = kin_op.parent_joint_transform.rotation;
+    const size_t      dof = kin_op.dof_index;
+    MotionVector      result = {};
+    switch (kin_op.kind)
+    {
+        case KinematicOpKind::REVOLUTE:
+        case KinematicOpKind::PRISMATIC:
+        {
+            // one of the axes is zero
+            const Real qv = joint_motion.qv[dof];
+            result
+                = {vector_scale(qv, kin_op.angular_axis), vector_scale(qv, kin_op.linear_axis)};
+            break;
+        }
+        case KinematicOpKind::SPHERICAL:
+        {
+            result.angular = quat_rotate_vector(
+                rot_pj, {joint_motion.qv[dof], joint_motion.qv[dof + 1U], joint_motion.qv[dof + 2U]});
+            break;
+        }
+        case KinematicOpKind::CARTESIAN:
+        {
+            result
+                = {quat_rotate_vector(
+                       rot_pj,
+                       {joint_motion.qv[dof], joint_motion.qv[dof + 1U], joint_motion.qv[dof + 2U]}),
+                   quat_rotate_vector(
+                       rot_pj,
+                       {joint_motion.qv[dof + 3U],
+                        joint_motion.qv[dof + 4U],
+                        joint_motion.qv[dof + 5U]})};
+            break;
+        }
+        case KinematicOpKind::FIXED:
+        case KinematicOpKind::IDENTITY:
+        default:
+        {
+            // no joint motion
+            break;
+        }
+    }
+    return result;
+}
+
+static void compute_program_child_kinematics(
+    const KinematicOp& kin_op, const JointPva& joint_pva, const bool calc_velocity,
+    const bool calc_acceleration, BodyCartesianPva& body_cartesian)
+{
+    const CartesianPva& body_pva = body_cartesian.body[kin_op.parent_index];
+    CartesianPva&       child_body_pva = body_cartesian.body[kin_op.child_index];
+
+    const Transform tr_parent_child = kinematic_op_transform(kin_op, joint_pva.position);
+    child_body_pva.pose = coord_transform(body_pva.pose, tr_parent_child);
+    if (calc_velocity)
+    {
+        const MotionVector vel_parent_child = kinematic_op_motion(kin_op, joint_pva.velocity);
+        child_body_pva.velocity = motion_transform_velocity(
+            body_pva.pose, body_pva.velocity, tr_parent_child, vel_parent_child);
+        if (calc_acceleration)
+        {
+            child_body_pva.acceleration = motion_transform_acceleration(
+                body_pva.pose,
+                body_pva.velocity,
+                body_pva.acceleration,
+                tr_parent_child,
+                vel_parent_child,
+                kinematic_op_motion(kin_op, joint_pva.acceleration));
+        }
+    }
+}
+
+void forward_kinematics_program(
+    const KinematicProgram& program, const JointPva& joint_pva, const CartesianPva& base_pva,
+    const ForwardKinematicsOption opt, BodyCartesianPva& body_cartesian)
+{
+    // set base pva, ensure base quaternion is normalized
+    constexpr size_t BaseIndex = 0U;
+    body_cartesian.body[BaseIndex] = base_pva;
+    quat_normalize(body_cartesian.body[BaseIndex].pose.rotation);
+
+    const bool calc_velocity = (opt == ForwardKinematicsOption::POSE_VELOCITY)
+                               || (opt == ForwardKinematicsOption::POSE_VELOCITY_ACCELERATION);
+    const bool calc_acceleration = (opt == ForwardKinematicsOption::POSE_VELOCITY_ACCELERATION);
+    for (size_t op_index = 0U; op_index < program.num_ops; ++op_index)
+    {
+        compute_program_child_kinematics(
+            program.op[op_index], joint_pva, calc_velocity, calc_acceleration, body_cartesian);
+    }
+}
+
+static void compute_program_joint_axes(
+    const KinematicOp& kin_op, const Transform& parent_pose, const Transform& child_pose,
+    JointAxes& joint_axes)
+{
+    joint_axes.kind = kin_op.kind;
+    joint_axes.parent_index = kin_op.parent_index;
+    joint_axes.dof_index = kin_op.dof_index;
+    joint_axes.axis = {};
+    switch (kin_op.kind)
+    {
+        case KinematicOpKind::REVOLUTE:
+        {
+            // rotation about the joint axis does not move the joint origin
+            joint_axes.origin = child_pose.translation;
+            joint_axes.axis[0U] = quat_rotate_vector(parent_pose.rotation, kin_op.angular_axis);
+            break;
+        }
+        case KinematicOpKind::PRISMATIC:
+        {
+            joint_axes.origin
+                = coord_transform_position(parent_pose, kin_op.parent_joint_transform.translation);
+            joint_axes.axis[0U] = quat_rotate_vector(parent_pose.rotation, kin_op.linear_axis);
+            break;
+        }
+        case KinematicOpKind::SPHERICAL:
+        case KinematicOpKind::CARTESIAN:
+        {
+            joint_axes.origin
+                = coord_transform_position(parent_pose, kin_op.parent_joint_transform.translation);
+            const Mat3 rot = quat_to_rot(
+                quat_multiply(parent_pose.rotation, kin_op.parent_joint_transform.rotation));
+            joint_axes.axis[0U] = {rot.m00, rot.m10, rot.m20};
+            joint_axes.axis[1U] = {rot.m01, rot.m11, rot.m21};
+            joint_axes.axis[2U] = {rot.m02, rot.m12, rot.m22};
+            break;
+        }
+        case KinematicOpKind::FIXED:
+        case KinematicOpKind::IDENTITY:
+        default:
+        {
+            // no joint motion
+            joint_axes.origin = child_pose.translation;
+            break;
+        }
+    }
+}
+
+void forward_kinematics_program_axes(
+    const KinematicProgram& program, const JointPva& joint_pva, const CartesianPva& base_pva,
+    const ForwardKinematicsOption opt, BodyCartesianPva& body_cartesian, BodyJointAxes& joint_axes)
+{
+    // set base pva, ensure base quaternion is normalized
+    constexpr size_t BaseIndex = 0U;
+    body_cartesian.body[BaseIndex] = base_pva;
+    quat_normalize(body_cartesian.body[BaseIndex].pose.rotation);
+    joint_axes.body[BaseIndex] = {};
+    joint_axes.body[BaseIndex].origin = body_cartesian.body[BaseIndex].pose.translation;
+    joint_axes.num_bodies = program.num_bodies;
+
+    const bool calc_velocity = (opt == ForwardKinematicsOption::POSE_VELOCITY)
+                               || (opt == ForwardKinematicsOption::POSE_VELOCITY_ACCELERATION);
+    const bool calc_acceleration = (opt == ForwardKinematicsOption::POSE_VELOCITY_ACCELERATION);
+    for (size_t op_index = 0U; op_index < program.num_ops; ++op_index)
+    {
+        const KinematicOp& kin_op = program.op[op_index];
+        compute_program_child_kinematics(
+            kin_op, joint_pva, calc_velocity, calc_acceleration, body_cartesian);
+        compute_program_joint_axes(
+            kin_op,
+            body_cartesian.body[kin_op.parent_index].pose,
+            body_cartesian.body[kin_op.child_index].pose,
+            joint_axes.body[kin_op.child_index]);
+    }
+}
+
+void kinematic_program_joint_axes(
+    const KinematicProgram& program, const BodyCartesianPva& body_cartesian,
+    BodyJointAxes& joint_axes)
+{
+    constexpr size_t BaseIndex = 0U;
+    joint_axes.body[BaseIndex] = {};
+    joint_axes.body[BaseIndex].origin = body_cartesian.body[BaseIndex].pose.translation;
+    joint_axes.num_bodies = program.num_bodies;
+    for (size_t op_index = 0U; op_index < program.num_ops; ++op_index)
+    {
+        const KinematicOp& kin_op = program.op[op_index];
+        compute_program_joint_axes(
+            kin_op,
+            body_cartesian.body[kin_op.parent_index].pose,
+            body_cartesian.body[kin_op.child_index].pose,
+            joint_axes.body[kin_op.child_index]);
+    }
+}
+
+bool forward_kinematics_chain(
+    const BodyTree& body_tree, const JointPva& joint_pva, const CartesianPva& base_pva,
+    const size_t target_body, const ForwardKinematicsOption opt, BodyCartesianPva& body_cartesian)
+{
+    KinematicProgram chain = {};
+    const bool       result = kinematic_program_compile_chain(body_tree, target_body, chain);
+    if (result)
+    {
+        forward_kinematics_program(chain, joint_pva, base_pva, opt, body_cartesian);
+    }
+    return result;
+}
+
+static bool vector_equal(const Vec3& v_a, const Vec3& v_b)
+{
+    return (v_a.x == v_b.x) && (v_a.y == v_b.y) && (v_a.z == v_b.z);
+}
+
+static bool motion_equal(const MotionVector& m_a, const MotionVector& m_b)
+{
+    return vector_equal(m_a.angular, m_b.angular) && vector_equal(m_a.linear, m_b.linear);
+}
+
+static bool base_equal(
+    const CartesianPva& pva_a, const CartesianPva& pva_b, const bool calc_velocity,
+    const bool calc_acceleration)
+{
+    const Quaternion& q_a = pva_a.pose.rotation;
+    const Quaternion& q_b = pva_b.pose.rotation;
+    bool              result = (q_a.qw == q_b.qw) && (q_a.qx == q_b.qx) && (q_a.qy == q_b.qy)
+                  && (q_a.qz == q_b.qz)
+                  && vector_equal(pva_a.pose.translation, pva_b.pose.translation);
+    if (result && calc_velocity)
+    {
+        result = motion_equal(pva_a.velocity, pva_b.velocity);
+    }
+    if (result && calc_acceleration)
+    {
+        result = motion_equal(pva_a.acceleration, pva_b.acceleration);
+    }
+    return result;
+}
+
+static bool joint_op_changed(
+    const KinematicOp& kin_op, const JointPva& joint_pva, const JointPva& prev_joint_pva,
+    const bool calc_velocity, const bool calc_acceleration)
+{
+    bool changed = false;
+    for (size_t coord = 0U; coord < kin_op.num_coordinates; ++coord)
+    {
+        const size_t index = kin_op.coord_index + coord;
+        changed = changed || (joint_pva.position.q[index] != prev_joint_pva.position.q[index]);
+    }
+    for (size_t dof = 0U; dof < kin_op.num_dofs; ++dof)
+    {
+        const size_t index = kin_op.dof_index + dof;
+        if (calc_velocity)
+        {
+            changed = changed || (joint_pva.velocity.qv[index] != prev_joint_pva.velocity.qv[index]);
+        }
+        if (calc_acceleration)
+        {
+            changed = changed
+                      || (joint_pva.acceleration.qv[index] != prev_joint_pva.acceleration.qv[index]);
+        }
+    }
+    return changed;
+}
+
+void kinematics_state_reset(KinematicsState& state)
+{
+    state.valid = false;
+    state.num_updated = 0U;
+}
+
+void forward_kinematics_incremental(
+    const KinematicProgram& program, const JointPva& joint_pva, const CartesianPva& base_pva,
+    const ForwardKinematicsOption opt, KinematicsState& state)
+{
+    const bool calc_velocity = (opt == ForwardKinematicsOption::POSE_VELOCITY)
+                               || (opt == ForwardKinematicsOption::POSE_VELOCITY_ACCELERATION);
+    const bool calc_acceleration = (opt == ForwardKinematicsOption::POSE_VELOCITY_ACCELERATION);
+
+    // full update if cache is empty, cached option computed less data, or base moved
+    const bool full_update = (!state.valid)
+                             || (static_cast<uint8_t>(opt) > static_cast<uint8_t>(state.opt))
+                             || (!base_equal(base_pva, state.base_pva, calc_velocity, calc_acceleration));
+
+    constexpr size_t BaseIndex = 0U;
+    std::array<bool, MaxSize::kBodies> changed = {};
+    changed[BaseIndex] = full_update;
+    if (full_update)
+    {
+        state.base_pva = base_pva;
+        state.body_cartesian.body[BaseIndex] = base_pva;
+        quat_normalize(state.body_cartesian.body[BaseIndex].pose.rotation);
+    }
+
+    // recompute only bodies with a changed parent or changed joint values
+    state.num_updated = 0U;
+    for (size_t op_index = 0U; op_index < program.num_ops; ++op_index)
+    {
+        const KinematicOp& kin_op = program.op[op_index];
+        const bool         body_changed = changed[kin_op.parent_index]
+                                  || joint_op_changed(
+                                      kin_op,
+                                      joint_pva,
+                                      state.joint_pva,
+                                      calc_velocity,
+                                      calc_acceleration);
+        if (body_changed)
+        {
+            compute_program_child_kinematics(
+                kin_op, joint_pva, calc_velocity, calc_acceleration, state.body_cartesian);
+            ++state.num_updated;
+        }
+        changed[kin_op.child_index] = body_changed;
+    }
+
+    state.joint_pva = joint_pva;
+    state.opt = opt;
+    state.valid = true;
+}
+
 JointSpacePosition joint_add_offset(
     const BodyTree& body_tree, const JointSpacePosition& joint_position,
     const JointSpace& joint_offset)
@@ -151,6 +723,56 @@ JointSpacePosition joint_add_offset(
     return result;
 }
 
+static void joint_position_rotate(
+    const size_t coord, const size_t dof, const JointSpace& joint_offset,
+    JointSpacePosition& joint_position)
+{
+    const Quaternion q_current
+        = {joint_position.q[coord],
+           joint_position.q[coord + 1U],
+           joint_position.q[coord + 2U],
+           joint_position.q[coord + 3U]};
+    const Quaternion q_new = quat_boxplus(
+        q_current, {joint_offset.qv[dof], joint_offset.qv[dof + 1U], joint_offset.qv[dof + 2U]});
+    joint_position.q[coord] = q_new.qw;
+    joint_position.q[coord + 1U] = q_new.qx;
+    joint_position.q[coord + 2U] = q_new.qy;
+    joint_position.q[coord + 3U] = q_new.qz;
+}
+
+void kinematic_program_add_offset(
+    const KinematicProgram& program, const JointSpace& joint_offset,
+    JointSpacePosition& joint_position)
+{
+    for (size_t op_index = 0U; op_index < program.num_ops; ++op_index)
+    {
+        const KinematicOp& kin_op = program.op[op_index];
+        const size_t       coord = kin_op.coord_index;
+        const size_t       dof = kin_op.dof_index;
+        switch (kin_op.kind)
+        {
+            case KinematicOpKind::REVOLUTE:
+            case KinematicOpKind::PRISMATIC:
+                joint_position.q[coord] += joint_offset.qv[dof];
+                break;
+            case KinematicOpKind::SPHERICAL:
+                joint_position_rotate(coord, dof, joint_offset, joint_position);
+                break;
+            case KinematicOpKind::CARTESIAN:
+                joint_position_rotate(coord, dof, joint_offset, joint_position);
+                joint_position.q[coord + 4U] += joint_offset.qv[dof + 3U];
+                joint_position.q[coord + 5U] += joint_offset.qv[dof + 4U];
+                joint_position.q[coord + 6U] += joint_offset.qv[dof + 5U];
+                break;
+            case KinematicOpKind::FIXED:
+            case KinematicOpKind::IDENTITY:
+            default:
+                // no joint coordinates
+                break;
+        }
+    }
+}
+
 JointSpace joint_difference(
     const BodyTree& body_tree, const JointSpacePosition& joint_position_a,
     const JointSpacePosition& joint_position_b)
@@ -0,0 +1,339 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#include "fsb_types.h"
+#include "fsb_kinematics_batch.h"
+#include "fsb_body_tree.h"
+#include "fsb_kinematics.h"
+#include "fsb_motion.h"
+#include "fsb_quaternion.h"
+
+namespace fsb
+{
+
+/**
+ * Largest magnitude of angle with accurate reduction in @c batch_cos_sin
+ */
+constexpr Real kBatchTrigMaxAngle = 1.0e6;
+
+// same value in all lanes
+static void batch_quat_fill(const Quaternion& quat, QuaternionBatch& q_out)
+{
+    q_out.qw.fill(quat.qw);
+    q_out.qx.fill(quat.qx);
+    q_out.qy.fill(quat.qy);
+    q_out.qz.fill(quat.qz);
+}
+
+// same value in all lanes
+static void batch_vec_fill(const Vec3& vec, Vec3Batch& v_out)
+{
+    v_out.x.fill(vec.x);
+    v_out.y.fill(vec.y);
+    v_out.z.fill(vec.z);
+}
+
+// out = q_a * q_b for all lanes
+static void batch_quat_multiply(
+    const QuaternionBatch& q_a, const QuaternionBatch& q_b, QuaternionBatch& q_out)
+{
+    for (size_t lane = 0U; lane < kKinematicsBatchSize; ++lane)
+    {
+        const Real aw = q_a.qw[lane];
+        const Real ax = q_a.qx[lane];
+        const Real ay = q_a.qy[lane];
+        const Real az = q_a.qz[lane];
+        const Real bw = q_b.qw[lane];
+        const Real bx = q_b.qx[lane];
+        const Real by = q_b.qy[lane];
+        const Real bz = q_b.qz[lane];
+        q_out.qw[lane] = aw * bw - ax * bx - ay * by - az * bz;
+        q_out.qx[lane] = aw * bx + ax * bw + ay * bz - az * by;
+        q_out.qy[lane] = aw * by + ay * bw - ax * bz + az * bx;
+        q_out.qz[lane] = aw * bz + ax * by - ay * bx + az * bw;
+    }
+}
+
+// out = t + rot(q, v) for all lanes
+static void batch_quat_rotate_add(
+    const QuaternionBatch& quat, const Vec3Batch& vec, const Vec3Batch& trans, Vec3Batch& v_out)
+{
+    for (size_t lane = 0U; lane < kKinematicsBatchSize; ++lane)
+    {
+        const Real qw = quat.qw[lane];
+        const Real qx = quat.qx[lane];
+        const Real qy = quat.qy[lane];
+        const Real qz = quat.qz[lane];
+        const Real vx = vec.x[lane];
+        const Real vy = vec.y[lane];
+        const Real vz = vec.z[lane];
+        // v + 2 * qv x (qv x v + qw * v)
+        const Real tx = qy * vz - qz * vy + qw * vx;
+        const Real ty = qz * vx - qx * vz + qw * vy;
+        const Real tz = qx * vy - qy * vx + qw * vz;
+        v_out.x[lane] = trans.x[lane] + vx + 2.0 * (qy * tz - qz * ty);
+        v_out.y[lane] = trans.y[lane] + vy + 2.0 * (qz * tx - qx * tz);
+        v_out.z[lane] = trans.z[lane] + vz + 2.0 * (qx * ty - qy * tx);
+    }
+}
+
+/**
+ * Cosine and sine of all lanes. The library functions are not vectorized, so the angle is reduced
+ * by the nearest multiple of pi / 2 and the Cephes polynomials are evaluated on [-pi / 4, pi / 4]
+ * with branch-free quadrant selection. Lanes beyond @c kBatchTrigMaxAngle use the library functions.
+ */
+static void batch_cos_sin(const BatchLanes& angle, BatchLanes& cos_out, BatchLanes& sin_out)
+{
+    constexpr Real two_over_pi = 0.63661977236758134308;
+    // adding and subtracting 1.5 * 2^52 rounds to the nearest integer
+    constexpr Real round_shift = 6755399441055744.0;
+    // pi / 2 in three parts, products with the quadrant of the first two parts are exact
+    constexpr Real pio2_1 = 1.57079625129699707031;
+    constexpr Real pio2_2 = 7.54978941586159635336e-8;
+    constexpr Real pio2_3 = 5.39030285815811905290e-15;
+    for (size_t lane = 0U; lane < kKinematicsBatchSize; ++lane)
+    {
+        const Real quadrant = ((angle[lane] * two_over_pi) + round_shift) - round_shift;
+        const Real red = ((angle[lane] - (quadrant * pio2_1)) - (quadrant * pio2_2)) - (quadrant * pio2_3);
+        const Real red2 = red * red;
+        const Real sin_red
+            = red
+              + red * red2
+                    * ((((((1.58962301576546568060e-10 * red2) - 2.50507477628578072866e-8) * red2
+                          + 2.75573136213857245213e-6)
+                             * red2
+                         - 1.98412698295895385996e-4)
+                            * red2
+                        + 8.33333333332211858878e-3)
+                           * red2
+                       - 1.66666666666666307295e-1);
+        const Real cos_red
+            = 1.0 - (0.5 * red2)
+              + red2 * red2
+                    * ((((((-1.13585365213876817300e-11 * red2) + 2.08757008419747316778e-9) * red2
+                          - 2.75573141792967388112e-7)
+                             * red2
+                         + 2.48015872888517045348e-5)
+                            * red2
+                        - 1.38888888888730564116e-3)
+                           * red2
+                       + 4.16666666666665929218e-2);
+        // quadrant modulo 4 in [0, 3], single comparisons per select keep the loop branch-free
+        const Real turn_signed = quadrant - (4.0 * ((((0.25 * quadrant) + round_shift) - round_shift)));
+        const Real turn = turn_signed + ((turn_signed < 0.0) ? 4.0 : 0.0);
+        const bool odd = (std::fabs(turn - 2.0) == 1.0);
+        const Real cos_base = odd ? sin_red : cos_red;
+        const Real sin_base = odd ? cos_red : sin_red;
+        cos_out[lane] = (std::fabs(turn - 1.5) < 1.0) ? -cos_base : cos_base;
+        sin_out[lane] = (turn > 1.5) ? -sin_base : sin_base;
+    }
+    for (size_t lane = 0U; lane < kKinematicsBatchSize; ++lane)
+    {
+        if (std::fabs(angle[lane]) > kBatchTrigMaxAngle)
+        {
+            cos_out[lane] = cos(angle[lane]);
+            sin_out[lane] = sin(angle[lane]);
+        }
+    }
+}
+
+// flip quaternion sign so that the scalar part is positive, as done by coord_transform
+static void batch_quat_positive(QuaternionBatch& quat)
+{
+    for (size_t lane = 0U; lane < kKinematicsBatchSize; ++lane)
+    {
+        const Real sign = (quat.qw[lane] < 0.0) ? -1.0 : 1.0;
+        quat.qw[lane] *= sign;
+        quat.qx[lane] *= sign;
+        quat.qy[lane] *= sign;
+        quat.qz[lane] *= sign;
+    }
+}
+
+static void compute_program_child_pose_batch(
+    const KinematicOp& kin_op, const JointSpacePositionBatch& joint_position,
+    BodyTransformBatch& body_pose)
+{
+    const TransformBatch& parent = body_pose.body[kin_op.parent_index];
+    TransformBatch&       child = body_pose.body[kin_op.child_index];
+    const Transform&      tr_pj = kin_op.parent_joint_transform;
+    const size_t          coord = kin_op.coord_index;
+
+    // parent to joint rotation and joint origin of all joint kinds
+    QuaternionBatch rot_pj = {};
+    batch_quat_fill(tr_pj.rotation, rot_pj);
+    QuaternionBatch parent_rot_pj = {};
+    batch_quat_multiply(parent.rotation, rot_pj, parent_rot_pj);
+    Vec3Batch trans_pj = {};
+    batch_vec_fill(tr_pj.translation, trans_pj);
+    Vec3Batch joint_origin = {};
+    batch_quat_rotate_add(parent.rotation, trans_pj, parent.translation, joint_origin);
+
+    switch (kin_op.kind)
+    {
+        case KinematicOpKind::FIXED:
+        {
+            child = {parent_rot_pj, joint_origin};
+            break;
+        }
+        case KinematicOpKind::REVOLUTE:
+        {
+            // joint origin is not changed by rotation about the joint axis
+            BatchLanes half_angle = {};
+            for (size_t lane = 0U; lane < kKinematicsBatchSize; ++lane)
+            {
+                half_angle[lane] = 0.5 * kin_op.sign * joint_position.q[coord][lane];
+            }
+            QuaternionBatch quat_joint = {};
+            batch_cos_sin(half_angle, quat_joint.qw, quat_joint.qx);
+            for (size_t lane = 0U; lane < kKinematicsBatchSize; ++lane)
+            {
+                const Real sin_half = quat_joint.qx[lane];
+                quat_joint.qx[lane] = sin_half * kin_op.axis.x;
+                quat_joint.qy[lane] = sin_half * kin_op.axis.y;
+                quat_joint.qz[lane] = sin_half * kin_op.axis.z;
+            }
+            batch_quat_multiply(parent_rot_pj, quat_joint, child.rotation);
+            child.translation = joint_origin;
+            break;
+        }
+        case KinematicOpKind::PRISMATIC:
+        {
+            // signed displacement along joint axis in parent frame
+            Vec3Batch pos = {};
+            for (size_t lane = 0U; lane < kKinematicsBatchSize; ++lane)
+            {
+                const Real displacement = joint_position.q[coord][lane];
+                pos.x[lane] = tr_pj.translation.x + displacement * kin_op.linear_axis.x;
+                pos.y[lane] = tr_pj.translation.y + displacement * kin_op.linear_axis.y;
+                pos.z[lane] = tr_pj.translation.z + displacement * kin_op.linear_axis.z;
+            }
+            batch_quat_rotate_add(parent.rotation, pos, parent.translation, child.translation);
+            child.rotation = parent_rot_pj;
+            break;
+        }
+        case KinematicOpKind::SPHERICAL:
+        {
+            const QuaternionBatch quat_joint
+                = {joint_position.q[coord],
+                   joint_position.q[coord + 1U],
+                   joint_position.q[coord + 2U],
+                   joint_position.q[coord + 3U]};
+            batch_quat_multiply(parent_rot_pj, quat_joint, child.rotation);
+            child.translation = joint_origin;
+            break;
+        }
+        case KinematicOpKind::CARTESIAN:
+        {
+            const QuaternionBatch quat_joint
+                = {joint_position.q[coord],
+                   joint_position.q[coord + 1U],
+                   joint_position.q[coord + 2U],
+                   joint_position.q[coord + 3U]};
+            const Vec3Batch pos_joint
+                = {joint_position.q[coord + 4U],
+                   joint_position.q[coord + 5U],
+                   joint_position.q[coord + 6U]};
+            batch_quat_rotate_add(parent_rot_pj, pos_joint, joint_origin, child.translation);
+            batch_quat_multiply(parent_rot_pj, quat_joint, child.rotation);
+            break;
+        }
+        case KinematicOpKind::IDENTITY:
+        default:
+        {
+            // identity parent to child transform, consistent with kinematic_op_transform
+            child = parent;
+            break;
+        }
+    }
+    batch_quat_positive(child.rotation);
+}
+
+void forward_kinematics_batch(
+    const KinematicProgram& program, const JointSpacePositionBatch& joint_position,
+    const Transform& base_pose, BodyTransformBatch& body_pose)
+{
+    // set base pose, ensure base quaternion is normalized
+    constexpr size_t BaseIndex = 0U;
+    Quaternion       base_rotation = base_pose.rotation;
+    quat_normalize(base_rotation);
+    batch_quat_fill(base_rotation, body_pose.body[BaseIndex].rotation);
+    batch_vec_fill(base_pose.translation, body_pose.body[BaseIndex].translation);
+
+    // propagate through tree
+    for (size_t op_index = 0U; op_index < program.num_ops; ++op_index)
+    {
+        compute_program_child_pose_batch(program.op[op_index], joint_position, body_pose);
+    }
+}
+
+void forward_kinematics_batch(
+    const BodyTree& body_tree, const JointSpacePositionBatch& joint_position,
+    const Transform& base_pose, BodyTransformBatch& body_pose)
+{
+    KinematicProgram program = {};
+    (void)kinematic_program_compile(body_tree, program);
+    forward_kinematics_batch(program, joint_position, base_pose, body_pose);
+}
+
+bool forward_kinematics_batch(
+    const KinematicProgram& program, const JointSpacePosition joint_position[],
+    const size_t num_configurations, const Transform& base_pose, const size_t body_index,
+    Transform body_pose[])
+{
+    const bool result = (body_index < program.num_bodies);
+    if (result)
+    {
+        JointSpacePositionBatch joint_batch = {};
+        BodyTransformBatch      pose_batch = {};
+        for (size_t first = 0U; first < num_configurations; first += kKinematicsBatchSize)
+        {
+            // last block is padded with the last configuration
+            const size_t num_lanes = std::min(kKinematicsBatchSize, num_configurations - first);
+            for (size_t lane = 0U; lane < kKinematicsBatchSize; ++lane)
+            {
+                batch_set_joint_position(
+                    lane, joint_position[first + std::min(lane, num_lanes - 1U)], joint_batch);
+            }
+            forward_kinematics_batch(program, joint_batch, base_pose, pose_batch);
+            for (size_t lane = 0U; lane < num_lanes; ++lane)
+            {
+                body_pose[first + lane] = batch_get_body_pose(pose_batch, body_index, lane);
+            }
+        }
+    }
+    return result;
+}
+
+void batch_set_joint_position(
+    const size_t lane, const JointSpacePosition& joint_position,
+    JointSpacePositionBatch& joint_position_batch)
+{
+    if (lane < kKinematicsBatchSize)
+    {
+        for (size_t coord = 0U; coord < MaxSize::kCoordinates; ++coord)
+        {
+            joint_position_batch.q[coord][lane] = joint_position.q[coord];
+        }
+    }
+}
+
+Transform
+batch_get_body_pose(const BodyTransformBatch& body_pose, const size_t body_index, const size_t lane)
+{
+    Transform result = transform_identity();
+    if ((body_index < MaxSize::kBodies) && (lane < kKinematicsBatchSize))
+    {
+        const TransformBatch& pose = body_pose.body[body_index];
+        result
+            = {{pose.rotation.qw[lane],
+                pose.rotation.qx[lane],
+                pose.rotation.qy[lane],
+                pose.rotation.qz[lane]},
+               {pose.translation.x[lane], pose.translation.y[lane], pose.translation.z[lane]}};
+    }
+    return result;
+}
+
+} // namespace fsb
@@ -6,15 +6,12 @@
 
 #include "openblas/lapack.h"
 
-extern "C" FsbLinalgErrorType fsb_linalg_svd(
-               const double_t mat[], const size_t rows, const size_t cols,
-               const bool u_full, const bool v_full,
-               const size_t work_len, double_t work[],
-               double_t unitary_u[], double_t sing_val[], double_t unitary_vt[])
+extern "C" FsbLinalgErrorType fsb_linalg_svd_plan(
+    const size_t rows, const size_t cols, const bool u_full, const bool v_full, FsbLinalgSvdPlan* plan)
 {
     FsbLinalgErrorType retval = EFSB_LAPACK_ERROR_NONE;
 
-    if ((rows == 0U) || (cols == 0U))
+    if ((plan == nullptr) || (rows == 0U) || (cols == 0U))
     {
         retval = EFSB_LAPACK_ERROR_INPUT;
     }
@@ -22,71 +19,112 @@ extern "C" FsbLinalgErrorType fsb_linalg_svd(
     {
         retval = EFSB_LAPACK_ERROR_INPUT;
     }
-    else if (work_len < (rows * cols))
-    {
-        // not enough buffer for copy of A
-        retval = EFSB_LAPACK_ERROR_MEMORY;
-    }
     else
     {
-        const size_t a_len = rows * cols;
-        double_t* a_mat_tmp = work;
-        const size_t work_partial_len = a_len;
-
+        *plan = {};
         const char* u_opt = (u_full ? "A" : "S");
         const char* v_opt = (v_full ? "A" : "S");
         const size_t u_opt_size = 1U;
         const size_t v_opt_size = 1U;
 
-        // copy A to buffer
-        std::copy_n(mat, a_len, a_mat_tmp);
-
         const lapack_int l_m = static_cast<lapack_int>(rows);
         const lapack_int l_n = static_cast<lapack_int>(cols);
         const lapack_int ldvt = static_cast<lapack_int>(((rows < cols) && !v_full) ? rows : cols);
+        // matrices are not referenced by workspace query
+        double_t dummy = 0.0;
         double_t work_query = 0.0;
         lapack_int lwork = -1;
         lapack_int info = 0;
-        dgesvd_(u_opt, v_opt, &l_m, &l_n, a_mat_tmp, &l_m, sing_val, unitary_u, &l_m, unitary_vt, &ldvt, &work_query, &lwork, &info, u_opt_size, v_opt_size);
-        lwork = static_cast<lapack_int>(work_query);
-        const size_t s_lwork = static_cast<size_t>(lwork);
+        dgesvd_(u_opt, v_opt, &l_m, &l_n, &dummy, &l_m, &dummy, &dummy, &l_m, &dummy, &ldvt, &work_query, &lwork, &info, u_opt_size, v_opt_size);
 
         if (info != 0)
         {
             /* dgesvd work query failed */
             retval = EFSB_LAPACK_ERROR_QUERY;
         }
-        else if (work_len < (work_partial_len + s_lwork))
+        else
         {
-            // not enough buffer for svd operation
-            retval = EFSB_LAPACK_ERROR_MEMORY;
+            plan->rows = rows;
+            plan->cols = cols;
+            plan->u_full = u_full;
+            plan->v_full = v_full;
+            plan->lwork = static_cast<size_t>(work_query);
+            plan->work_len = (rows * cols) + plan->lwork;
+        }
+    }
+    return retval;
+}
+
+extern "C" FsbLinalgErrorType fsb_linalg_svd_execute(
+    const FsbLinalgSvdPlan* plan, const double_t mat[], const size_t work_len, double_t work[],
+    double_t unitary_u[], double_t sing_val[], double_t unitary_vt[])
+{
+    FsbLinalgErrorType retval = EFSB_LAPACK_ERROR_NONE;
+
+    if ((plan == nullptr) || (plan->lwork == 0U))
+    {
+        retval = EFSB_LAPACK_ERROR_INPUT;
+    }
+    else if (work_len < plan->work_len)
+    {
+        // not enough buffer for copy of A and svd operation
+        retval = EFSB_LAPACK_ERROR_MEMORY;
+    }
+    else
+    {
+        const size_t a_len = plan->rows * plan->cols;
+        double_t* a_mat_tmp = work;
+        double_t* svd_work = &work[a_len];
+
+        const char* u_opt = (plan->u_full ? "A" : "S");
+        const char* v_opt = (plan->v_full ? "A" : "S");
+        const size_t u_opt_size = 1U;
+        const size_t v_opt_size = 1U;
+
+        // copy A to buffer
+        std::copy_n(mat, a_len, a_mat_tmp);
+
+        const lapack_int l_m = static_cast<lapack_int>(plan->rows);
+        const lapack_int l_n = static_cast<lapack_int>(plan->cols);
+        const lapack_int ldvt = static_cast<lapack_int>(((plan->rows < plan->cols) && !plan->v_full) ? plan->rows : plan->cols);
+        const lapack_int lwork = static_cast<lapack_int>(plan->lwork);
+        lapack_int info = 0;
+
+        /* perform SVD */
+        dgesvd_(u_opt, v_opt, &l_m, &l_n, a_mat_tmp, &l_m, sing_val, unitary_u, &l_m, unitary_vt, &ldvt, svd_work, &lwork, &info, u_opt_size, v_opt_size);
+        if (info < 0)
+        {
+            // Some input error
+            retval = EFSB_LAPACK_ERROR_INPUT;
+        }
+        else if (info > 0)
+        {
+            // DBDSQR did not converge (see DGESVD)
+            retval = EFSB_LAPACK_ERROR_CONVERGE;
         }
         else
         {
-            // allocate work
-            double_t* svd_work = &work[work_partial_len];
-
-            /* perform SVD */
-            dgesvd_(u_opt, v_opt, &l_m, &l_n, a_mat_tmp, &l_m, sing_val, unitary_u, &l_m, unitary_vt, &ldvt, svd_work, &lwork, &info, u_opt_size, v_opt_size);
-            if (info < 0)
-            {
-                // Some input error
-                retval = EFSB_LAPACK_ERROR_INPUT;
-            }
-            else if (info > 0)
-            {
-                // DBDSQR did not converge (see DGESVD)
-                retval = EFSB_LAPACK_ERROR_CONVERGE;
-            }
-            else
-            {
-                // success
-            }
+            // success
         }
     }
     return retval;
 }
 
+extern "C" FsbLinalgErrorType fsb_linalg_svd(
+               const double_t mat[], const size_t rows, const size_t cols,
+               const bool u_full, const bool v_full,
+               const size_t work_len, double_t work[],
+               double_t unitary_u[], double_t sing_val[], double_t unitary_vt[])
+{
+    FsbLinalgSvdPlan plan = {};
+    FsbLinalgErrorType retval = fsb_linalg_svd_plan(rows, cols, u_full, v_full, &plan);
+    if (retval == EFSB_LAPACK_ERROR_NONE)
+    {
+        retval = fsb_linalg_svd_execute(&plan, mat, work_len, work, unitary_u, sing_val, unitary_vt);
+    }
+    return retval;
+}
+
 extern "C" FsbLinalgErrorType fsb_linalg_matrix_eig(
         const double_t mat[], const size_t dim, const size_t work_len, double_t work[],
         double_t val_real[], double_t val_imag[],
@@ -488,106 +526,179 @@ extern "C" FsbLinalgErrorType fsb_linalg_matrix_sqr_solve(
     return retval;
 }
 
-extern "C" FsbLinalgErrorType fsb_linalg_pseudoinverse(
-    const double_t mat[], const size_t rows, const size_t columns, const size_t work_len, double_t work[], double_t inv_mat[])
+extern "C" FsbLinalgErrorType fsb_linalg_pseudoinverse_plan(
+    const size_t rows, const size_t columns, FsbLinalgPseudoinversePlan* plan)
 {
     FsbLinalgErrorType retval = EFSB_LAPACK_ERROR_NONE;
 
-    if ((rows == 0U) || (columns == 0U))
+    if (plan == nullptr)
+    {
+        retval = EFSB_LAPACK_ERROR_INPUT;
+    }
+    else
     {
-        return EFSB_LAPACK_ERROR_INPUT;
+        *plan = {};
+        retval = fsb_linalg_svd_plan(rows, columns, false, false, &plan->svd);
     }
-    if (rows >= (static_cast<size_t>(INT32_MAX) / columns))
+    if (retval == EFSB_LAPACK_ERROR_NONE)
     {
-        return EFSB_LAPACK_ERROR_INPUT;
+        // U (rows x min_dim), S (min_dim) and V^T (min_dim x columns) followed by svd work
+        const size_t min_dim = (rows < columns) ? rows : columns;
+        plan->work_len = (rows * min_dim) + min_dim + (min_dim * columns) + plan->svd.work_len;
     }
+    return retval;
+}
 
-    // Calculate the minimum dimension
-    const size_t min_dim = (rows < columns) ? rows : columns;
-
-    // Allocate working memory:
-    // - For U matrix: rows × min_dim
-    // - For S vector: min_dim
-    // - For V^T matrix: min_dim × columns
-    const size_t size_u = rows * min_dim;
-    const size_t size_s = min_dim;
-    const size_t size_vt = min_dim * columns;
+extern "C" FsbLinalgErrorType fsb_linalg_pseudoinverse_execute(
+    const FsbLinalgPseudoinversePlan* plan, const double_t mat[], const size_t work_len,
+    double_t work[], double_t inv_mat[])
+{
+    FsbLinalgErrorType retval = EFSB_LAPACK_ERROR_NONE;
 
-    // Determine if we have enough work space
-    const size_t size_usvt_work = size_u + size_s + size_vt;
-    if (work_len < size_usvt_work)
+    if ((plan == nullptr) || (plan->work_len == 0U))
     {
-        return EFSB_LAPACK_ERROR_MEMORY;
+        retval = EFSB_LAPACK_ERROR_INPUT;
     }
+    else if (work_len < plan->work_len)
+    {
+        retval = EFSB_LAPACK_ERROR_MEMORY;
+    }
+    else
+    {
+        const size_t rows = plan->svd.rows;
+        const size_t columns = plan->svd.cols;
+        const size_t min_dim = (rows < columns) ? rows : columns;
+        const size_t size_u = rows * min_dim;
+        const size_t size_s = min_dim;
+        const size_t size_vt = min_dim * columns;
+        const size_t size_usvt_work = size_u + size_s + size_vt;
+
+        // Partition the work buffer
+        double_t* u_mat = work;
+        double_t* s_vec = &work[size_u];
+        double_t* vt_mat = &work[size_u + size_s];
+
+        // Use remaining workspace for SVD computation
+        retval = fsb_linalg_svd_execute(
+            &plan->svd, mat, work_len - size_usvt_work, &work[size_usvt_work], u_mat, s_vec, vt_mat);
+
+        if (retval == EFSB_LAPACK_ERROR_NONE)
+        {
+            const double_t epsilon = 1.0e-12;  // Small threshold for numerical stability
 
-    // Partition the work buffer
-    double_t* u_mat = work;
-    double_t* s_vec = &work[size_u];
-    double_t* vt_mat = &work[size_u + size_s];
+            // Initialize the output inverse matrix with zeros
+            std::fill_n(inv_mat, columns * rows, 0.0);
 
-    // Use remaining workspace for SVD computation
-    const size_t svd_work_len = work_len - size_usvt_work;
-    double_t* svd_work = &work[size_usvt_work];
+            // Accumulate: inv_mat(i,j) += V(i,k) * (1/s_k) * U(j,k)
+            // where inv_mat is (columns x rows).
+            for (size_t k = 0U; k < min_dim; ++k)
+            {
+                const double_t s = s_vec[k];
+                if (s > epsilon)
+                {
+                    const double_t inv_s = 1.0 / s;
 
-    // Perform SVD
-    retval = fsb_linalg_svd(mat, rows, columns, false, false, svd_work_len, svd_work,
-                           u_mat, s_vec, vt_mat);
-    if (retval != EFSB_LAPACK_ERROR_NONE)
-    {
-        return retval;
+                    // V(i,k) can be read from V^T(k,i) stored in vt_mat (col-major): vt_mat[i*min_dim + k]
+                    for (size_t i = 0U; i < columns; ++i)
+                    {
+                        const double_t v_ik = vt_mat[i * min_dim + k];
+                        const double_t scale = v_ik * inv_s;
+
+                        // U(j,k) is u_mat[k*rows + j] (col-major)
+                        for (size_t j = 0U; j < rows; ++j)
+                        {
+                            inv_mat[j * columns + i] += scale * u_mat[k * rows + j];
+                        }
+                    }
+                }
+            }
+        }
     }
+    return retval;
+}
 
-    const double_t epsilon = 1.0e-12;  // Small threshold for numerical stability
+extern "C" FsbLinalgErrorType fsb_linalg_pseudoinverse(
+    const double_t mat[], const size_t rows, const size_t columns, const size_t work_len, double_t work[], double_t inv_mat[])
+{
+    FsbLinalgPseudoinversePlan plan = {};
+    FsbLinalgErrorType retval = fsb_linalg_pseudoinverse_plan(rows, columns, &plan);
+    if (retval == EFSB_LAPACK_ERROR_NONE)
+    {
+        retval = fsb_linalg_pseudoinverse_execute(&plan, mat, work_len, work, inv_mat);
+    }
+    return retval;
+}
 
-    // Initialize the output inverse matrix with zeros
-    std::fill_n(inv_mat, columns * rows, 0.0);
+extern "C" FsbLinalgErrorType fsb_linalg_leastsquares_plan(
+    const size_t rows, const size_t columns, const size_t nrhs, FsbLinalgLeastSquaresPlan* plan)
+{
+    FsbLinalgErrorType retval = EFSB_LAPACK_ERROR_NONE;
 
-    // Accumulate: inv_mat(i,j) += V(i,k) * (1/s_k) * U(j,k)
-    // where inv_mat is (columns x rows).
-    for (size_t k = 0U; k < min_dim; ++k)
+    if ((plan == nullptr) || rows == 0U || columns == 0U || nrhs == 0U ||
+        (rows >= (static_cast<size_t>(INT32_MAX) / columns) || (nrhs >= static_cast<size_t>(INT32_MAX) / columns) || (nrhs >= static_cast<size_t>(INT32_MAX) / rows)))
+    {
+        // Input dimensions are too large
+        retval = EFSB_LAPACK_ERROR_INPUT;
+    }
+    else
     {
-        const double_t s = s_vec[k];
-        if (s <= epsilon)
+        *plan = {};
+        const size_t size_ldb = FSB_MAX(rows, columns);
+
+        // Set up parameters for dgels
+        const char* trans_opt = "N";  // No transpose
+        const size_t trans_opt_size = 1U;
+        const lapack_int l_rows = static_cast<lapack_int>(rows);
+        const lapack_int l_cols = static_cast<lapack_int>(columns);
+        const lapack_int l_nrhs = static_cast<lapack_int>(nrhs);
+        const lapack_int lda = l_rows;
+        const lapack_int ldb = static_cast<lapack_int>(size_ldb);  // leading dimension of b
+        lapack_int info = 0;
+
+        // Query workspace size, matrices are not referenced
+        double_t dummy = 0.0;
+        double_t work_query = 0.0;
+        lapack_int lwork = -1;
+        dgels_(trans_opt, &l_rows, &l_cols, &l_nrhs,
+               &dummy, &lda, &dummy, &ldb,
+               &work_query, &lwork, &info,
+               trans_opt_size);
+        if (info != 0)
         {
-            continue;
+            retval = EFSB_LAPACK_ERROR_QUERY;
         }
-        const double_t inv_s = 1.0 / s;
-
-        // V(i,k) can be read from V^T(k,i) stored in vt_mat (col-major): vt_mat[i*min_dim + k]
-        for (size_t i = 0U; i < columns; ++i)
+        else
         {
-            const double_t v_ik = vt_mat[i * min_dim + k];
-            const double_t scale = v_ik * inv_s;
-
-            // U(j,k) is u_mat[k*rows + j] (col-major)
-            for (size_t j = 0U; j < rows; ++j)
-            {
-                inv_mat[j * columns + i] += scale * u_mat[k * rows + j];
-            }
+            // copy of A and B followed by dgels work
+            plan->rows = rows;
+            plan->columns = columns;
+            plan->nrhs = nrhs;
+            plan->lwork = static_cast<size_t>(work_query);
+            plan->work_len = (rows * columns) + (size_ldb * nrhs) + plan->lwork;
         }
     }
-
     return retval;
 }
 
-extern "C" FsbLinalgErrorType fsb_linalg_leastsquares_solve(
-    const double_t mat[], const size_t rows, const size_t columns, const double_t b_vec[], const size_t nrhs,
+extern "C" FsbLinalgErrorType fsb_linalg_leastsquares_execute(
+    const FsbLinalgLeastSquaresPlan* plan, const double_t mat[], const double_t b_vec[],
     const size_t work_len, double_t work[], double_t x_vec[])
 {
     FsbLinalgErrorType retval = EFSB_LAPACK_ERROR_NONE;
 
-    if (rows == 0U || columns == 0U || nrhs == 0U || work_len == 0U ||
-        (rows >= (static_cast<size_t>(INT32_MAX) / columns) || (nrhs >= static_cast<size_t>(INT32_MAX) / columns) || (nrhs >= static_cast<size_t>(INT32_MAX) / rows)))
+    if ((plan == nullptr) || (plan->lwork == 0U))
     {
-        // Input dimensions are too large
         retval = EFSB_LAPACK_ERROR_INPUT;
     }
-    else if (work_len < ((rows * columns) + (FSB_MAX(rows, columns) * nrhs)))
+    else if (work_len < plan->work_len)
     {
         retval = EFSB_LAPACK_ERROR_MEMORY;
     }
     else
     {
+        const size_t rows = plan->rows;
+        const size_t columns = plan->columns;
+        const size_t nrhs = plan->nrhs;
         // Calculate required work space:
         // - For A matrix: rows * columns
         const size_t size_a = rows * columns;
@@ -616,51 +727,25 @@ extern "C" FsbLinalgErrorType fsb_linalg_leastsquares_solve(
         const lapack_int l_nrhs = static_cast<lapack_int>(nrhs);
         const lapack_int lda = l_rows;
         const lapack_int ldb = static_cast<lapack_int>(size_ldb);  // leading dimension of b
+        const lapack_int lwork = static_cast<lapack_int>(plan->lwork);
         lapack_int info = 0;
 
-        // Query workspace size
-        double_t work_query = 0.0;
-        lapack_int lwork = -1;
+        // Allocate workspace for dgels
+        double_t* dgels_work = &work[work_len_ab];
+        // Solve least squares problem using dgels
         dgels_(trans_opt, &l_rows, &l_cols, &l_nrhs,
                a_copy, &lda, b_work, &ldb,
-               &work_query, &lwork, &info,
+               dgels_work, &lwork, &info,
                trans_opt_size);
-        if (info != 0)
+        if (info < 0)
         {
-            retval = EFSB_LAPACK_ERROR_QUERY;
-        }
-        else
-        {
-            lwork = static_cast<lapack_int>(work_query);
-            const size_t s_lwork = static_cast<size_t>(lwork);
-            // Check if we have enough workspace
-            if (work_len < (work_len_ab + s_lwork))
-            {
-                retval = EFSB_LAPACK_ERROR_MEMORY;
-            }
+            retval = EFSB_LAPACK_ERROR_INPUT;
         }
-
-        // Solve with dgels
-        if (retval == EFSB_LAPACK_ERROR_NONE)
+        else if (info > 0)
         {
-            // Allocate workspace for dgels
-            double_t* dgels_work = &work[work_len_ab];
-            // Solve least squares problem using dgels
-            dgels_(trans_opt, &l_rows, &l_cols, &l_nrhs,
-                   a_copy, &lda, b_work, &ldb,
-                   dgels_work, &lwork, &info,
-                   trans_opt_size);
-            if (info < 0)
-            {
-                retval = EFSB_LAPACK_ERROR_INPUT;
-            }
-            else if (info > 0)
-            {
-                retval = EFSB_LAPACK_ERROR_NOT_FULL_RANK;
-            }
+            retval = EFSB_LAPACK_ERROR_NOT_FULL_RANK;
         }
-
-        if (retval == EFSB_LAPACK_ERROR_NONE)
+        else
         {
             // b_work to x_vec conversion
             const size_t output_rows = columns;
@@ -675,3 +760,20 @@ extern "C" FsbLinalgErrorType fsb_linalg_leastsquares_solve(
     }
     return retval;
 }
+
+extern "C" FsbLinalgErrorType fsb_linalg_leastsquares_solve(
+    const double_t mat[], const size_t rows, const size_t columns, const double_t b_vec[], const size_t nrhs,
+    const size_t work_len, double_t work[], double_t x_vec[])
+{
+    FsbLinalgLeastSquaresPlan plan = {};
+    FsbLinalgErrorType retval = EFSB_LAPACK_ERROR_INPUT;
+    if (work_len > 0U)
+    {
+        retval = fsb_linalg_leastsquares_plan(rows, columns, nrhs, &plan);
+    }
+    if (retval == EFSB_LAPACK_ERROR_NONE)
+    {
+        retval = fsb_linalg_leastsquares_execute(&plan, mat, b_vec, work_len, work, x_vec);
+    }
+    return retval;
+}
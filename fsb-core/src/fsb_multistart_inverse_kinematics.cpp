@@ -0,0 +1,347 @@
+#include <array>
+#include <atomic>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include "fsb_multistart_inverse_kinematics.h"
+#include "fsb_body.h"
+#include "fsb_body_tree.h"
+#include "fsb_configuration.h"
+#include "fsb_inverse_kinematics.h"
+#include "fsb_kinematics.h"
+#include "fsb_motion.h"
+#include "fsb_types.h"
+
+namespace fsb
+{
+
+Real multistart_cost_joint_distance(const InverseKinematicsResult& result, const void* context)
+{
+    const auto* reference = static_cast<const JointSpacePosition*>(context);
+    Real        cost = 0.0;
+    for (size_t coord = 0U; coord < MaxSize::kCoordinates; ++coord)
+    {
+        const Real diff = result.joint_position.q[coord] - reference->q[coord];
+        cost += diff * diff;
+    }
+    return cost;
+}
+
+static Real weighted_squared_error(const MotionVector& weights, const MotionVector& error)
+{
+    return weights.angular.x * error.angular.x * error.angular.x
+           + weights.angular.y * error.angular.y * error.angular.y
+           + weights.angular.z * error.angular.z * error.angular.z
+           + weights.linear.x * error.linear.x * error.linear.x
+           + weights.linear.y * error.linear.y * error.linear.y
+           + weights.linear.z * error.linear.z * error.linear.z;
+}
+
+/**
+ * Candidate a is better than b if it converged and b did not, or it has lower cost, or the same
+ * cost with lower seed index.
+ */
+static bool is_better_candidate(
+    const bool converged_a, const Real cost_a, const size_t seed_a, const bool converged_b,
+    const Real cost_b, const size_t seed_b)
+{
+    bool result = false;
+    if (converged_a != converged_b)
+    {
+        result = converged_a;
+    }
+    else if (cost_a != cost_b)
+    {
+        result = cost_a < cost_b;
+    }
+    else
+    {
+        result = seed_a < seed_b;
+    }
+    return result;
+}
+
+/**
+ * Xorshift random number generator, returns uniform sample in range [0, 1)
+ */
+static Real random_uniform(uint32_t& state)
+{
+    state ^= state << 13U;
+    state ^= state >> 17U;
+    state ^= state << 5U;
+    return static_cast<Real>(state) / 4294967296.0;
+}
+
+MultiStartInverseKinematics::~MultiStartInverseKinematics()
+{
+    stop_threads();
+}
+
+InverseKinematicsInfo MultiStartInverseKinematics::initialize(
+    const BodyTree& body_tree, const size_t body_index, const OptimParameters& params,
+    const MultiStartParameters& multistart_params, const Transform& base_pose)
+{
+    auto result = InverseKinematicsInfo::SUCCESS;
+    stop_threads();
+    m_params = params;
+    m_multistart_params = multistart_params;
+    m_num_workers = std::min(std::max(multistart_params.num_workers, size_t{1U}), kMultiStartMaxWorkers);
+    m_random_state = (multistart_params.random_seed == 0U) ? 1U : multistart_params.random_seed;
+    m_result = {};
+    m_sampled = {};
+
+    for (size_t index = 0U; (index < m_num_workers) && (result == InverseKinematicsInfo::SUCCESS); ++index)
+    {
+        result = m_worker[index].solver.initialize(body_tree, body_index, params, base_pose);
+        m_worker[index].solver.set_cancel_flag(&m_cancel);
+    }
+    if ((result == InverseKinematicsInfo::SUCCESS)
+        && !kinematic_program_compile_chain(body_tree, body_index, m_chain))
+    {
+        result = InverseKinematicsInfo::INVALID_INPUT;
+    }
+    // sampling range of single coordinate joints
+    for (size_t op_index = 0U; (op_index < m_chain.num_ops) && (result == InverseKinematicsInfo::SUCCESS); ++op_index)
+    {
+        const KinematicOp& kin_op = m_chain.op[op_index];
+        auto        err = BodyTreeError::SUCCESS;
+        const Body  body = body_tree.get_body(kin_op.child_index, err);
+        bool        is_set = false;
+        Real        lower = 0.0;
+        Real        upper = 0.0;
+        if (err == BodyTreeError::SUCCESS)
+        {
+            err = body_tree.get_joint_position_limit(body.joint_index, is_set, lower, upper);
+        }
+        switch (kin_op.kind)
+        {
+            case KinematicOpKind::REVOLUTE:
+                m_sampled[kin_op.coord_index] = true;
+                m_lower[kin_op.coord_index] = is_set ? lower : -M_PI;
+                m_upper[kin_op.coord_index] = is_set ? upper : M_PI;
+                break;
+            case KinematicOpKind::PRISMATIC:
+                m_sampled[kin_op.coord_index] = is_set;
+                m_lower[kin_op.coord_index] = lower;
+                m_upper[kin_op.coord_index] = upper;
+                break;
+            case KinematicOpKind::FIXED:
+            case KinematicOpKind::SPHERICAL:
+            case KinematicOpKind::CARTESIAN:
+            case KinematicOpKind::IDENTITY:
+            default:
+                break;
+        }
+    }
+    if (result == InverseKinematicsInfo::SUCCESS)
+    {
+        start_threads();
+    }
+    else
+    {
+        m_num_workers = 0U;
+    }
+    return result;
+}
+
+void MultiStartInverseKinematics::start_threads()
+{
+    // workers after the first run on pool threads, a thread that cannot be created ends the pool
+    bool started = true;
+    for (size_t index = 1U; (index < m_num_workers) && started; ++index)
+    {
+        try
+        {
+            m_thread[index] = std::thread(&MultiStartInverseKinematics::run_thread, this, index);
+            m_num_threads += 1U;
+        }
+        catch (const std::system_error&)
+        {
+            started = false;
+        }
+    }
+    m_num_workers = m_num_threads + 1U;
+}
+
+void MultiStartInverseKinematics::stop_threads()
+{
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        m_shutdown = true;
+    }
+    m_start_condition.notify_all();
+    for (std::thread& thread : m_thread)
+    {
+        if (thread.joinable())
+        {
+            thread.join();
+        }
+    }
+    // new pool threads start at generation zero and must not see the job of this pool
+    m_shutdown = false;
+    m_num_threads = 0U;
+    m_num_running = 0U;
+    m_generation = 0U;
+    m_job = {};
+}
+
+void MultiStartInverseKinematics::run_thread(const size_t worker_index)
+{
+    uint64_t                     generation = 0U;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_shutdown)
+    {
+        while (!m_shutdown && (m_generation == generation))
+        {
+            m_start_condition.wait(lock);
+        }
+        if (!m_shutdown)
+        {
+            generation = m_generation;
+            const Job job = m_job;
+            if (worker_index < job.num_workers)
+            {
+                lock.unlock();
+                run_worker(m_worker[worker_index], *job.target_pose, *job.seeds, job.cost, job.context);
+                lock.lock();
+            }
+            m_num_running -= 1U;
+            if (m_num_running == 0U)
+            {
+                m_done_condition.notify_one();
+            }
+        }
+    }
+}
+
+void MultiStartInverseKinematics::generate_seeds(
+    const JointSpacePosition& initial_config, const size_t num_seeds, MultiStartSeeds& seeds)
+{
+    seeds.num_seeds = std::min(num_seeds, kMultiStartMaxSeeds);
+    for (size_t index = 0U; index < seeds.num_seeds; ++index)
+    {
+        seeds.seed[index] = initial_config;
+        for (size_t coord = 0U; (index > 0U) && (coord < MaxSize::kCoordinates); ++coord)
+        {
+            if (m_sampled[coord])
+            {
+                const Real sample = random_uniform(m_random_state);
+                seeds.seed[index].q[coord] = m_lower[coord] + sample * (m_upper[coord] - m_lower[coord]);
+            }
+        }
+    }
+}
+
+void MultiStartInverseKinematics::run_worker(
+    Worker& worker, const Transform& target_pose, const MultiStartSeeds& seeds,
+    const InverseKinematicsCost cost, const void* context)
+{
+    worker.best_converged = false;
+    worker.best_cost = 0.0;
+    worker.best_seed_index = kMultiStartMaxSeeds;
+    worker.num_solved = 0U;
+    worker.num_converged = 0U;
+
+    size_t seed_index = m_next_seed.fetch_add(1U);
+    while ((seed_index < seeds.num_seeds) && !m_cancel.load(std::memory_order_relaxed))
+    {
+        const InverseKinematicsResult& result = worker.solver.solve(target_pose, seeds.seed[seed_index]);
+        if (result.info != InverseKinematicsInfo::CANCELLED)
+        {
+            worker.num_solved += 1U;
+            const bool converged = inverse_kinematics_converged(result.info);
+            const Real result_cost = (converged && (cost != nullptr))
+                                         ? cost(result, context)
+                                         : weighted_squared_error(m_params.objective_weights, result.error_pose);
+            if (converged)
+            {
+                worker.num_converged += 1U;
+            }
+            if ((worker.best_seed_index == kMultiStartMaxSeeds)
+                || is_better_candidate(
+                    converged, result_cost, seed_index,
+                    worker.best_converged, worker.best_cost, worker.best_seed_index))
+            {
+                worker.best = result;
+                worker.best_converged = converged;
+                worker.best_cost = result_cost;
+                worker.best_seed_index = seed_index;
+            }
+            if (m_multistart_params.stop_on_success && (result.info == InverseKinematicsInfo::SUCCESS))
+            {
+                // objective tolerance reached, stop other workers
+                m_cancel.store(true, std::memory_order_relaxed);
+            }
+        }
+        seed_index = m_next_seed.fetch_add(1U);
+    }
+}
+
+const MultiStartResult& MultiStartInverseKinematics::solve(
+    const Transform& target_pose, const MultiStartSeeds& seeds, const InverseKinematicsCost cost,
+    const void* context)
+{
+    m_result = {};
+    if ((m_num_workers == 0U) || (seeds.num_seeds == 0U) || (seeds.num_seeds > kMultiStartMaxSeeds))
+    {
+        m_result.result.info = InverseKinematicsInfo::INVALID_INPUT;
+    }
+    else
+    {
+        m_next_seed.store(0U);
+        m_cancel.store(false);
+
+        // release pool threads, first worker runs on the calling thread
+        const size_t num_threads = std::min(m_num_workers, seeds.num_seeds);
+        {
+            const std::lock_guard<std::mutex> lock(m_mutex);
+            m_job = {&target_pose, &seeds, cost, context, num_threads};
+            m_num_running = m_num_threads;
+            m_generation += 1U;
+        }
+        m_start_condition.notify_all();
+        run_worker(m_worker[0U], target_pose, seeds, cost, context);
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            while (m_num_running > 0U)
+            {
+                m_done_condition.wait(lock);
+            }
+        }
+
+        // select best result of workers
+        size_t best_worker = kMultiStartMaxWorkers;
+        for (size_t index = 0U; index < num_threads; ++index)
+        {
+            const Worker& worker = m_worker[index];
+            m_result.num_solved += worker.num_solved;
+            m_result.num_converged += worker.num_converged;
+            if ((worker.best_seed_index < kMultiStartMaxSeeds)
+                && ((best_worker == kMultiStartMaxWorkers)
+                    || is_better_candidate(
+                        worker.best_converged, worker.best_cost, worker.best_seed_index,
+                        m_worker[best_worker].best_converged, m_worker[best_worker].best_cost,
+                        m_worker[best_worker].best_seed_index)))
+            {
+                best_worker = index;
+            }
+        }
+        if (best_worker == kMultiStartMaxWorkers)
+        {
+            m_result.result.info = InverseKinematicsInfo::CANCELLED;
+        }
+        else
+        {
+            m_result.result = m_worker[best_worker].best;
+            m_result.seed_index = m_worker[best_worker].best_seed_index;
+            m_result.cost = m_worker[best_worker].best_cost;
+        }
+    }
+    return m_result;
+}
+
+} // namespace fsb
@@ -76,7 +76,8 @@ Vec3 quat_log(const Quaternion& q_in)
     Vec3 p_out = {0.0, 0.0, 0.0};
     if (p_norm >= FSB_TOL)
     {
-        const Real phi_norm = acos(q_in.qw) / p_norm;
+        // atan2 stays finite when rounding puts the scalar part outside [-1, 1]
+        const Real phi_norm = atan2(p_norm, q_in.qw) / p_norm;
         p_out.x = phi_norm * q_in.qx;
         p_out.y = phi_norm * q_in.qy;
         p_out.z = phi_norm * q_in.qz;
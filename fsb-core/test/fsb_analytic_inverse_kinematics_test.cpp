@@ -0,0 +1,216 @@
+#include <doctest/doctest.h>
+#include <array>
+#include <cmath>
+#include "fsb_test_macros.h"
+#include "fsb_analytic_inverse_kinematics.h"
+#include "fsb_inverse_kinematics.h"
+#include "fsb_kinematics.h"
+#include "fsb_quaternion.h"
+#include "fsb_body_tree_sample.h"
+
+TEST_SUITE_BEGIN("analytic_inverse_kinematics");
+
+static fsb::BodyTree create_spherical_wrist_body_tree(size_t& ee_index)
+{
+    auto          err = fsb::BodyTreeError::SUCCESS;
+    fsb::BodyTree body_tree = {};
+
+    const fsb::Transform tr1 = {fsb::quat_identity(), {0.0, 0.0, 0.4}};
+    size_t link_index = body_tree.add_massless_body(fsb::BodyTree::kBaseIndex, fsb::JointType::REVOLUTE_Z, tr1, {}, err);
+    REQUIRE(err == fsb::BodyTreeError::SUCCESS);
+    // shoulder offset
+    const fsb::Transform tr2 = {fsb::quat_identity(), {0.025, 0.0, 0.0}};
+    link_index = body_tree.add_massless_body(link_index, fsb::JointType::REVOLUTE_Y, tr2, {}, err);
+    REQUIRE(err == fsb::BodyTreeError::SUCCESS);
+    const fsb::Transform tr3 = {fsb::quat_identity(), {0.0, 0.0, 0.455}};
+    link_index = body_tree.add_massless_body(link_index, fsb::JointType::REVOLUTE_Y, tr3, {}, err);
+    REQUIRE(err == fsb::BodyTreeError::SUCCESS);
+    // elbow offset
+    const fsb::Transform tr4 = {fsb::quat_identity(), {0.2, 0.0, 0.035}};
+    link_index = body_tree.add_massless_body(link_index, fsb::JointType::REVOLUTE_X, tr4, {}, err);
+    REQUIRE(err == fsb::BodyTreeError::SUCCESS);
+    // wrist center
+    const fsb::Transform tr5 = {fsb::quat_identity(), {0.22, 0.0, 0.0}};
+    link_index = body_tree.add_massless_body(link_index, fsb::JointType::REVOLUTE_Y, tr5, {}, err);
+    REQUIRE(err == fsb::BodyTreeError::SUCCESS);
+    const fsb::Transform tr6 = fsb::transform_identity();
+    link_index = body_tree.add_massless_body(link_index, fsb::JointType::REVOLUTE_X, tr6, {}, err);
+    REQUIRE(err == fsb::BodyTreeError::SUCCESS);
+    // tool flange
+    const fsb::Transform tr7 = {fsb::quat_ry(M_PI_2), {0.08, 0.0, 0.0}};
+    ee_index = body_tree.add_massless_body(link_index, fsb::JointType::FIXED, tr7, {}, err);
+    REQUIRE(err == fsb::BodyTreeError::SUCCESS);
+    return body_tree;
+}
+
+static void check_analytic_solutions(
+    const fsb::BodyTree& body_tree, const size_t ee_index, const fsb::Transform& base_pose,
+    const fsb::AnalyticInverseKinematics& solver, const fsb::JointSpacePosition& joint_position)
+{
+    fsb::JointPva         joint_pva = {joint_position, {}, {}};
+    const fsb::CartesianPva base_pva = {base_pose, {}, {}};
+    fsb::BodyCartesianPva cartesian = {};
+    fsb::forward_kinematics(body_tree, joint_pva, base_pva, fsb::ForwardKinematicsOption::POSE, cartesian);
+    const fsb::Transform target_pose = cartesian.body[ee_index].pose;
+
+    fsb::AnalyticInverseKinematicsSolutions solutions = {};
+    REQUIRE(solver.solve_all(target_pose, solutions) == fsb::kAnalyticIkMaxSolutions);
+
+    bool found_input = false;
+    for (size_t index = 0U; index < solutions.num_solutions; ++index)
+    {
+        // every solution reaches the target
+        joint_pva.position = solutions.joint_position[index];
+        fsb::forward_kinematics(body_tree, joint_pva, base_pva, fsb::ForwardKinematicsOption::POSE, cartesian);
+        const fsb::MotionVector error = fsb::coord_transform_get_error(cartesian.body[ee_index].pose, target_pose);
+        REQUIRE(fsb::vector_norm(error.linear) == FsbApprox(0.0, 1.0e-9));
+        REQUIRE(fsb::vector_norm(error.angular) == FsbApprox(0.0, 1.0e-9));
+
+        fsb::Real max_diff = 0.0;
+        for (size_t coord = 0U; coord < fsb::kAnalyticIkJoints; ++coord)
+        {
+            const fsb::Real diff = std::remainder(solutions.joint_position[index].q[coord] - joint_position.q[coord], 2.0 * M_PI);
+            max_diff = std::max(max_diff, std::fabs(diff));
+        }
+        found_input = found_input || (max_diff < 1.0e-9);
+    }
+    REQUIRE(found_input);
+}
+
+TEST_CASE("Analytic inverse kinematics UR5" * doctest::description("[fsb_analytic_inverse_kinematics][fsb::AnalyticInverseKinematics]"))
+{
+    size_t              ee_index = 0U;
+    const fsb::BodyTree body_tree = create_ur5_body_tree(ee_index);
+    const fsb::Transform base_pose = {fsb::quat_rz(0.3), {0.1, -0.2, 0.5}};
+
+    fsb::AnalyticInverseKinematics solver = {};
+    REQUIRE(solver.initialize(body_tree, ee_index, {}, base_pose) == fsb::InverseKinematicsInfo::SUCCESS);
+    REQUIRE(solver.get_geometry() == fsb::AnalyticGeometry::OFFSET_WRIST);
+
+    const std::array<fsb::JointSpacePosition, 3U> joint_positions = {{
+        {{0.3, -1.2, 1.5, -0.7, 1.1, 0.4}},
+        {{-2.1, -0.4, -1.9, 2.5, -0.6, -2.8}},
+        {{1.4, -2.3, 0.8, 0.2, 2.2, 1.9}}
+    }};
+    for (const fsb::JointSpacePosition& joint_position : joint_positions)
+    {
+        check_analytic_solutions(body_tree, ee_index, base_pose, solver, joint_position);
+    }
+
+    // closest solution to seed
+    const fsb::JointPva joint_pva = {joint_positions[0U], {}, {}};
+    fsb::BodyCartesianPva cartesian = {};
+    fsb::forward_kinematics(body_tree, joint_pva, {base_pose, {}, {}}, fsb::ForwardKinematicsOption::POSE, cartesian);
+    fsb::JointSpacePosition seed = joint_positions[0U];
+    seed.q[1U] += 0.05;
+    seed.q[4U] -= 0.05;
+    const fsb::InverseKinematicsResult& result = solver.solve(cartesian.body[ee_index].pose, seed);
+    REQUIRE(result.info == fsb::InverseKinematicsInfo::SUCCESS);
+    REQUIRE(result.iterations == 0U);
+    for (size_t coord = 0U; coord < fsb::kAnalyticIkJoints; ++coord)
+    {
+        REQUIRE(result.joint_position.q[coord] == FsbApprox(joint_positions[0U].q[coord]));
+    }
+
+    // unreachable target falls back to numeric solver
+    const fsb::Transform far_pose = {fsb::quat_identity(), {5.0, 0.0, 0.0}};
+    fsb::AnalyticInverseKinematicsSolutions solutions = {};
+    REQUIRE(solver.solve_all(far_pose, solutions) == 0U);
+    REQUIRE(solver.solve(far_pose, seed).info != fsb::InverseKinematicsInfo::SUCCESS);
+}
+
+TEST_CASE("Analytic inverse kinematics joint limits" * doctest::description("[fsb_analytic_inverse_kinematics][fsb::AnalyticInverseKinematics]"))
+{
+    size_t        ee_index = 0U;
+    fsb::BodyTree body_tree = create_ur5_body_tree(ee_index);
+    const fsb::JointSpacePosition joint_position = {{0.3, -1.2, 1.5, -0.7, 1.1, 0.4}};
+    fsb::JointPva         joint_pva = {joint_position, {}, {}};
+    fsb::BodyCartesianPva cartesian = {};
+    fsb::forward_kinematics(body_tree, joint_pva, {fsb::transform_identity(), {}, {}}, fsb::ForwardKinematicsOption::POSE, cartesian);
+    const fsb::Transform target_pose = cartesian.body[ee_index].pose;
+    fsb::OptimParameters params = {};
+    params.joint_limits = true;
+
+    // solution of other elbow branch within limits
+    REQUIRE(body_tree.set_joint_position_limit(2U, -M_PI, 0.0) == fsb::BodyTreeError::SUCCESS);
+    fsb::AnalyticInverseKinematics solver = {};
+    REQUIRE(solver.initialize(body_tree, ee_index, params) == fsb::InverseKinematicsInfo::SUCCESS);
+    const fsb::InverseKinematicsResult& elbow_result = solver.solve(target_pose, joint_position);
+    REQUIRE(elbow_result.info == fsb::InverseKinematicsInfo::SUCCESS);
+    REQUIRE(elbow_result.iterations == 0U);
+    REQUIRE(elbow_result.joint_position.q[2U] < 0.0);
+    REQUIRE(fsb::vector_norm(elbow_result.error_pose.linear) == FsbApprox(0.0, 1.0e-6));
+    REQUIRE(elbow_result.num_active_limits == 0U);
+
+    // no closed form solution within limits falls back to numeric solver
+    REQUIRE(body_tree.unset_joint_position_limit(2U) == fsb::BodyTreeError::SUCCESS);
+    REQUIRE(body_tree.set_joint_position_limit(0U, 0.4, 0.45) == fsb::BodyTreeError::SUCCESS);
+    REQUIRE(solver.initialize(body_tree, ee_index, params) == fsb::InverseKinematicsInfo::SUCCESS);
+    fsb::AnalyticInverseKinematicsSolutions solutions = {};
+    const size_t num_solutions = solver.solve_all(target_pose, solutions);
+    REQUIRE(num_solutions > 0U);
+    for (size_t index = 0U; index < num_solutions; ++index)
+    {
+        const fsb::Real angle = solutions.joint_position[index].q[0U];
+        REQUIRE(((angle < 0.4) || (angle > 0.45)));
+    }
+    const fsb::InverseKinematicsResult& limit_result = solver.solve(target_pose, joint_position);
+    REQUIRE(limit_result.iterations > 0U);
+    REQUIRE(limit_result.joint_position.q[0U] == FsbApprox(0.4));
+    REQUIRE(limit_result.active_limits[0U]);
+    REQUIRE(limit_result.num_active_limits == 1U);
+
+    // closed form solution does not keep limits of previous result
+    fsb::JointSpacePosition inside_position = joint_position;
+    inside_position.q[0U] = 0.42;
+    joint_pva.position = inside_position;
+    fsb::forward_kinematics(body_tree, joint_pva, {fsb::transform_identity(), {}, {}}, fsb::ForwardKinematicsOption::POSE, cartesian);
+    const fsb::InverseKinematicsResult& inside_result = solver.solve(cartesian.body[ee_index].pose, joint_position);
+    REQUIRE(inside_result.info == fsb::InverseKinematicsInfo::SUCCESS);
+    REQUIRE(inside_result.iterations == 0U);
+    REQUIRE(inside_result.joint_position.q[0U] == FsbApprox(0.42));
+    REQUIRE(inside_result.num_active_limits == 0U);
+}
+
+TEST_CASE("Analytic inverse kinematics spherical wrist" * doctest::description("[fsb_analytic_inverse_kinematics][fsb::AnalyticInverseKinematics]"))
+{
+    size_t              ee_index = 0U;
+    const fsb::BodyTree body_tree = create_spherical_wrist_body_tree(ee_index);
+    const fsb::Transform base_pose = fsb::transform_identity();
+
+    fsb::AnalyticInverseKinematics solver = {};
+    REQUIRE(solver.initialize(body_tree, ee_index, {}) == fsb::InverseKinematicsInfo::SUCCESS);
+    REQUIRE(solver.get_geometry() == fsb::AnalyticGeometry::SPHERICAL_WRIST);
+
+    const std::array<fsb::JointSpacePosition, 3U> joint_positions = {{
+        {{0.3, -0.2, 0.5, -0.7, 1.1, 0.4}},
+        {{-2.1, 0.4, -1.9, 2.5, -0.6, -2.8}},
+        {{1.4, 0.9, 0.8, 0.2, 2.2, 1.9}}
+    }};
+    for (const fsb::JointSpacePosition& joint_position : joint_positions)
+    {
+        check_analytic_solutions(body_tree, ee_index, base_pose, solver, joint_position);
+    }
+}
+
+TEST_CASE("Analytic inverse kinematics unsupported geometry" * doctest::description("[fsb_analytic_inverse_kinematics][fsb::AnalyticInverseKinematics]"))
+{
+    size_t              ee_index = 0U;
+    const fsb::BodyTree body_tree = create_panda_body_tree(ee_index);
+    const fsb::JointSpacePosition initial_config = {{1.0, -0.32, 0.08, -2.15, 0.04, -2.0, 0.78}};
+    const fsb::Transform target_pose = {
+        {0.9218430590013226, -0.3843272787743501, 0.04613060152655873, -0.019232393605190336},
+        {0.47372404011176217, 0.07, 0.5155132061520504}};
+
+    fsb::AnalyticInverseKinematics solver = {};
+    REQUIRE(solver.initialize(body_tree, ee_index, {}) == fsb::InverseKinematicsInfo::SUCCESS);
+    REQUIRE(solver.get_geometry() == fsb::AnalyticGeometry::UNSUPPORTED);
+
+    // numeric fallback
+    const fsb::InverseKinematicsResult& result = solver.solve(target_pose, initial_config);
+    REQUIRE(result.info == fsb::InverseKinematicsInfo::SUCCESS);
+    REQUIRE(result.iterations > 0U);
+    REQUIRE(fsb::vector_norm(result.error_pose.linear) == FsbApprox(0.0, 1.0e-5));
+}
+
+TEST_SUITE_END();
@@ -111,6 +111,62 @@ BodyTree create_panda_body_tree(size_t& ee_index)
     return body_tree;
 }
 
+BodyTree create_ur5_body_tree(size_t& ee_index)
+{
+    BodyTreeError err = BodyTreeError::SUCCESS;
+    BodyTree body_tree = {};
+    ee_index = 0U;
+
+    // shoulder_pan_joint
+    Transform tr1 = transform_identity();
+    tr1.translation.z = 0.089159;
+    size_t link_index
+        = body_tree.add_massless_body(BodyTree::kBaseIndex, JointType::REVOLUTE_Z, tr1, {}, err);
+    REQUIRE(err == BodyTreeError::SUCCESS);
+
+    // shoulder_lift_joint
+    Transform tr2 = transform_identity();
+    tr2.translation.y = 0.13585;
+    tr2.rotation = quat_ry(M_PI_2);
+    link_index = body_tree.add_massless_body(link_index, JointType::REVOLUTE_Y, tr2, {}, err);
+    REQUIRE(err == BodyTreeError::SUCCESS);
+
+    // elbow_joint
+    Transform tr3 = transform_identity();
+    tr3.translation.y = -0.1197;
+    tr3.translation.z = 0.425;
+    link_index = body_tree.add_massless_body(link_index, JointType::REVOLUTE_Y, tr3, {}, err);
+    REQUIRE(err == BodyTreeError::SUCCESS);
+
+    // wrist_1_joint
+    Transform tr4 = transform_identity();
+    tr4.translation.z = 0.39225;
+    tr4.rotation = quat_ry(M_PI_2);
+    link_index = body_tree.add_massless_body(link_index, JointType::REVOLUTE_Y, tr4, {}, err);
+    REQUIRE(err == BodyTreeError::SUCCESS);
+
+    // wrist_2_joint
+    Transform tr5 = transform_identity();
+    tr5.translation.y = 0.093;
+    link_index = body_tree.add_massless_body(link_index, JointType::REVOLUTE_Z, tr5, {}, err);
+    REQUIRE(err == BodyTreeError::SUCCESS);
+
+    // wrist_3_joint
+    Transform tr6 = transform_identity();
+    tr6.translation.z = 0.09465;
+    link_index = body_tree.add_massless_body(link_index, JointType::REVOLUTE_Y, tr6, {}, err);
+    REQUIRE(err == BodyTreeError::SUCCESS);
+
+    // ee_fixed_joint
+    Transform tr7 = transform_identity();
+    tr7.translation.y = 0.0823;
+    tr7.rotation = quat_rz(M_PI_2);
+    ee_index = body_tree.add_massless_body(link_index, JointType::FIXED, tr7, {}, err);
+    REQUIRE(err == BodyTreeError::SUCCESS);
+
+    return body_tree;
+}
+
 //BodyTree create_panda_body_tree_fk(size_t& ee_index)
 //{
 //    BodyTreeError err = BodyTreeError::SUCCESS;
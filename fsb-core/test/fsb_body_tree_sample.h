@@ -28,4 +28,5 @@ fsb::BodyTree body_tree_sample_srs(
 
 fsb::BodyTree create_panda_body_tree(size_t& ee_index);
 
-// fsb::BodyTree create_ur5_body_tree(size_t& ee_index);
+// UR5 joints from fsb-urdf/test/data/ur5/ur5.urdf, end effector is ee_link
+fsb::BodyTree create_ur5_body_tree(size_t& ee_index);
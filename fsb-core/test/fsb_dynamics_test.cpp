@@ -1,9 +1,11 @@
 
 #include <doctest/doctest.h>
+#include <array>
 #include "fsb_test_macros.h"
 #include "fsb_body_tree_sample.h"
 #include "fsb_kinematics.h"
 #include "fsb_dynamics.h"
+#include "fsb_quaternion.h"
 
 TEST_SUITE_BEGIN("dynamics");
 
@@ -67,4 +69,429 @@ TEST_CASE("Inverse dynamics" * doctest::description("[fsb_dynamics][fsb::inverse
     CHECK(actual_joint_torque.qv[2] == FsbApprox(expected_joint_torque.qv[2]));
 }
 
+static void check_body_force(const fsb::ForceVector& actual, const fsb::ForceVector& expected)
+{
+    CHECK(actual.torque.x == FsbApprox(expected.torque.x));
+    CHECK(actual.torque.y == FsbApprox(expected.torque.y));
+    CHECK(actual.torque.z == FsbApprox(expected.torque.z));
+    CHECK(actual.force.x == FsbApprox(expected.force.x));
+    CHECK(actual.force.y == FsbApprox(expected.force.y));
+    CHECK(actual.force.z == FsbApprox(expected.force.z));
+}
+
+TEST_CASE("Recursive Newton-Euler inverse dynamics" * doctest::description("[fsb_dynamics][fsb::inverse_dynamics_rnea]"))
+{
+    const fsb::CartesianPva base_pva = {
+        {
+            {0.713252796614972, 0.110018106106709, 0.314124660380793, 0.616840467374075},
+           {0.12, -0.34, 0.921}
+        }, {},{}
+    };
+    const fsb::Transform joint1_tr = {{0.57072141808226, 0.575121276132167, 0.0939451898978092, 0.578521289130613},{-0.872, 1.235, -0.02}};
+    const fsb::Transform joint2_tr = {{0.466361491477014, -0.571547679819811, -0.124868616337094, 0.663511897115633}, {0.125, -0.2, 1}};
+    const fsb::Transform joint3_tr = {{0.461283965309215, 0.607100248856612, 0.205771002489209, -0.613436782171915}, {-0.44, 0.2, -0.1}};
+    const fsb::JointPva joint_pva = {
+        {{0.45, 1.73,  0.97}},
+        {{-0.5, 0.71, -0.43}},
+        {{1.5, 1.03, 0.62}}
+    };
+    const fsb::MassProps body1_massprops = {
+    0.8447, {0.01, 0.25, -0.17}, {1.21, 0.14, 0.2, 0.0, 0.0, 0.0}};
+    const fsb::MassProps body2_massprops = {
+      0.3, {0.1, -0.0254, 0.05}, {0.78, 0.2, 0.99, 0.0, 0.0, 0.0}};
+    const fsb::MassProps body3_massprops = {
+     0.1, {0.87, -0.11, 0.004}, {0.111, 1.54, 0.88, 0.0, 0.0, 0.0}};
+    const fsb::BodyForce external_force = {};
+
+    size_t last_body_index = 0U;
+    fsb::BodyTree body_tree = body_tree_sample_rpr(
+        joint1_tr, joint2_tr, joint3_tr,
+        body1_massprops, body2_massprops, body3_massprops, last_body_index);
+    body_tree.set_gravity({0.0, 0.0, -9.81});
+
+    fsb::DynamicsModel model = {};
+    REQUIRE(fsb::dynamics_model_compile(body_tree, model));
+    REQUIRE(model.num_bodies == body_tree.get_num_bodies());
+    REQUIRE(model.num_dofs == 3U);
+
+    // reference
+    fsb::BodyCartesianPva body_pva = {};
+    fsb::forward_kinematics(
+        body_tree, joint_pva, base_pva, fsb::ForwardKinematicsOption::POSE_VELOCITY_ACCELERATION,
+        body_pva);
+    fsb::BodyForce expected_body_force = {};
+    const fsb::JointSpace expected_joint_torque = fsb::inverse_dynamics(
+        body_tree, body_pva, external_force, expected_body_force);
+
+    fsb::BodyForce actual_body_force = {};
+    const fsb::JointSpace actual_joint_torque = fsb::inverse_dynamics_rnea(
+        model, joint_pva, base_pva, external_force, actual_body_force);
+
+    CHECK(actual_joint_torque.qv[0] == FsbApprox(-1.0903032895805924));
+    CHECK(actual_joint_torque.qv[1] == FsbApprox(-2.9215345457188304));
+    CHECK(actual_joint_torque.qv[2] == FsbApprox(1.469521518393904));
+    for (size_t index = 0U; index < 3U; ++index)
+    {
+        CHECK(actual_joint_torque.qv[index] == FsbApprox(expected_joint_torque.qv[index]));
+    }
+    for (size_t index = 0U; index < body_tree.get_num_bodies(); ++index)
+    {
+        check_body_force(actual_body_force.body[index], expected_body_force.body[index]);
+    }
+}
+
+// floating base with Cartesian, spherical, reversed prismatic, revolute and fixed joints
+static fsb::BodyTree body_tree_sample_floating()
+{
+    using fsb::JointType;
+    auto            err = fsb::BodyTreeError::SUCCESS;
+    fsb::BodyTree   body_tree = {};
+    const fsb::Body body_a = {{}, {2.1, {0.05, -0.02, 0.11}, {0.03, 0.04, 0.05, 0.001, -0.002, 0.003}}, {}, 0U, false};
+    const fsb::Body body_b = {{}, {0.9, {0.2, 0.01, -0.03}, {0.011, 0.021, 0.017, 0.0, 0.0, 0.0}}, {}, 0U, false};
+    const fsb::Body body_c = {{}, {0.4, {-0.01, 0.15, 0.02}, {0.005, 0.002, 0.006, 0.0, 0.001, 0.0}}, {}, 0U, false};
+    const fsb::Body body_d = {{}, {0.7, {0.0, 0.03, 0.21}, {0.009, 0.008, 0.004, 0.0, 0.0, -0.001}}, {}, 0U, false};
+    const fsb::Body body_e = {{}, {0.2, {0.04, 0.0, 0.0}, {0.001, 0.002, 0.002, 0.0, 0.0, 0.0}}, {}, 0U, true};
+    const fsb::Transform tr_a = {{0.9238795325112867, 0.0, 0.3826834323650898, 0.0}, {0.1, 0.0, 0.3}};
+    const fsb::Transform tr_b = {{0.8660254037844387, 0.5, 0.0, 0.0}, {0.0, 0.2, 0.1}};
+    const fsb::Transform tr_c = {{0.7071067811865476, 0.0, 0.0, 0.7071067811865476}, {0.3, -0.1, 0.0}};
+    const fsb::Transform tr_d = {{0.9659258262890683, 0.0, -0.25881904510252074, 0.0}, {0.0, 0.15, 0.05}};
+    const fsb::Transform tr_e = {{1.0, 0.0, 0.0, 0.0}, {0.05, 0.0, 0.25}};
+    const size_t index_a = body_tree.add_body(fsb::BodyTree::kBaseIndex, JointType::CARTESIAN, tr_a, body_a, err);
+    REQUIRE(err == fsb::BodyTreeError::SUCCESS);
+    const size_t index_b = body_tree.add_body(index_a, JointType::SPHERICAL, tr_b, body_b, err);
+    REQUIRE(err == fsb::BodyTreeError::SUCCESS);
+    const size_t index_c = body_tree.add_body(index_b, JointType::PRISMATIC_Y, tr_c, body_c, err);
+    REQUIRE(err == fsb::BodyTreeError::SUCCESS);
+    const size_t index_d = body_tree.add_body(index_a, JointType::REVOLUTE_X, tr_d, body_d, err);
+    REQUIRE(err == fsb::BodyTreeError::SUCCESS);
+    (void)body_tree.add_body(index_d, JointType::FIXED, tr_e, body_e, err);
+    REQUIRE(err == fsb::BodyTreeError::SUCCESS);
+    REQUIRE(body_tree.set_joint_reversed(body_tree.get_body(index_c, err).joint_index, true) == fsb::BodyTreeError::SUCCESS);
+    body_tree.set_gravity({0.0, 0.0, -9.81});
+    return body_tree;
+}
+
+static fsb::JointPva joint_pva_sample_floating(fsb::Quaternion& quat_a, fsb::Quaternion& quat_b)
+{
+    quat_a = {0.8, 0.1, -0.3, 0.2};
+    quat_b = {0.6, -0.4, 0.5, 0.1};
+    fsb::quat_normalize(quat_a);
+    fsb::quat_normalize(quat_b);
+    return {
+        {{quat_a.qw, quat_a.qx, quat_a.qy, quat_a.qz, 0.4, -0.2, 0.7, quat_b.qw, quat_b.qx, quat_b.qy, quat_b.qz, 0.12, -0.6}},
+        {{0.3, -0.5, 0.8, 0.2, 0.1, -0.4, 1.1, -0.7, 0.25, 0.6, -1.3}},
+        {{-0.9, 0.4, 0.2, -1.5, 0.8, 0.3, 0.5, 1.2, -0.6, -0.35, 2.1}}
+    };
+}
+
+TEST_CASE("Recursive Newton-Euler floating base" * doctest::description("[fsb_dynamics][fsb::inverse_dynamics_rnea]"))
+{
+    const fsb::BodyTree body_tree = body_tree_sample_floating();
+    fsb::Quaternion     quat_a = {};
+    fsb::Quaternion     quat_b = {};
+    const fsb::JointPva joint_pva = joint_pva_sample_floating(quat_a, quat_b);
+    const fsb::CartesianPva base_pva = {
+        {{0.9, 0.2, -0.1, 0.3}, {0.5, -0.2, 0.1}},
+        {{0.1, -0.2, 0.3}, {0.4, 0.2, -0.1}},
+        {{-0.3, 0.5, 0.1}, {1.0, -0.4, 0.6}}
+    };
+    const fsb::BodyForce external_force = {};
+
+    fsb::DynamicsModel model = {};
+    REQUIRE(fsb::dynamics_model_compile(body_tree, model));
+
+    fsb::BodyCartesianPva body_pva = {};
+    fsb::forward_kinematics(
+        body_tree, joint_pva, base_pva, fsb::ForwardKinematicsOption::POSE_VELOCITY_ACCELERATION,
+        body_pva);
+    fsb::BodyForce expected_body_force = {};
+    const fsb::JointSpace expected_joint_torque = fsb::inverse_dynamics(
+        body_tree, body_pva, external_force, expected_body_force);
+
+    fsb::BodyForce actual_body_force = {};
+    const fsb::JointSpace actual_joint_torque = fsb::inverse_dynamics_rnea(
+        model, joint_pva, base_pva, external_force, actual_body_force);
+
+    // body forces acting at joints
+    for (size_t index = 0U; index < body_tree.get_num_bodies(); ++index)
+    {
+        check_body_force(actual_body_force.body[index], expected_body_force.body[index]);
+    }
+    // revolute and prismatic joints
+    CHECK(actual_joint_torque.qv[9] == FsbApprox(expected_joint_torque.qv[9]));
+    CHECK(actual_joint_torque.qv[10] == FsbApprox(expected_joint_torque.qv[10]));
+    // spherical and Cartesian joint torques are the child body forces rotated to the joint frame
+    const fsb::ForceVector& force_child_a = expected_body_force.body[1U];
+    const fsb::ForceVector& force_child_b = expected_body_force.body[2U];
+    const fsb::Vec3 torque_b = fsb::quat_rotate_vector(quat_b, force_child_b.torque);
+    CHECK(actual_joint_torque.qv[6] == FsbApprox(torque_b.x));
+    CHECK(actual_joint_torque.qv[7] == FsbApprox(torque_b.y));
+    CHECK(actual_joint_torque.qv[8] == FsbApprox(torque_b.z));
+    const fsb::Vec3 torque_a = fsb::quat_rotate_vector(quat_a, force_child_a.torque);
+    const fsb::Vec3 force_a = fsb::quat_rotate_vector(quat_a, force_child_a.force);
+    CHECK(actual_joint_torque.qv[0] == FsbApprox(torque_a.x));
+    CHECK(actual_joint_torque.qv[1] == FsbApprox(torque_a.y));
+    CHECK(actual_joint_torque.qv[2] == FsbApprox(torque_a.z));
+    CHECK(actual_joint_torque.qv[3] == FsbApprox(force_a.x));
+    CHECK(actual_joint_torque.qv[4] == FsbApprox(force_a.y));
+    CHECK(actual_joint_torque.qv[5] == FsbApprox(force_a.z));
+    // legacy function agrees on all joints
+    for (size_t index = 0U; index < model.num_dofs; ++index)
+    {
+        CHECK(actual_joint_torque.qv[index] == FsbApprox(expected_joint_torque.qv[index]));
+    }
+}
+
+TEST_CASE("Composite rigid body mass matrix" * doctest::description("[fsb_dynamics][fsb::mass_matrix_crba]"))
+{
+    const fsb::BodyTree body_tree = body_tree_sample_floating();
+    fsb::Quaternion     quat_a = {};
+    fsb::Quaternion     quat_b = {};
+    const fsb::JointPva joint_pva = joint_pva_sample_floating(quat_a, quat_b);
+    const fsb::CartesianPva base_pva = {{{0.9, 0.2, -0.1, 0.3}, {0.5, -0.2, 0.1}}, {}, {}};
+
+    fsb::DynamicsModel model = {};
+    REQUIRE(fsb::dynamics_model_compile(body_tree, model));
+    const size_t dofs = model.num_dofs;
+    REQUIRE(dofs == 11U);
+
+    fsb::JointMatrix mass_full = {};
+    REQUIRE(fsb::mass_matrix_crba(model, joint_pva.position, fsb::MassMatrixOption::FULL, mass_full));
+
+    // columns from inverse dynamics with unit joint acceleration, no velocity and no gravity
+    fsb::DynamicsModel model_no_gravity = model;
+    model_no_gravity.gravity = {};
+    for (size_t col = 0U; col < dofs; ++col)
+    {
+        fsb::JointPva unit_pva = {joint_pva.position, {}, {}};
+        unit_pva.acceleration.qv[col] = 1.0;
+        fsb::BodyForce        body_force = {};
+        const fsb::JointSpace column
+            = fsb::inverse_dynamics_rnea(model_no_gravity, unit_pva, base_pva, {}, body_force);
+        for (size_t row = 0U; row < dofs; ++row)
+        {
+            CHECK(mass_full.j[fsb::joint_matrix_index(row, col, dofs)] == FsbApprox(column.qv[row]));
+        }
+    }
+
+    // lower triangle
+    fsb::JointMatrix mass_lower = {};
+    REQUIRE(fsb::mass_matrix_crba(body_tree, joint_pva.position, fsb::MassMatrixOption::LOWER, mass_lower));
+    for (size_t col = 0U; col < dofs; ++col)
+    {
+        for (size_t row = 0U; row < dofs; ++row)
+        {
+            const size_t index = fsb::joint_matrix_index(row, col, dofs);
+            const fsb::Real expected = (row >= col) ? mass_full.j[index] : 0.0;
+            CHECK(mass_lower.j[index] == FsbApprox(expected));
+        }
+    }
+
+    // Cholesky factor reproduces mass matrix
+    fsb::JointMatrix mass_chol = {};
+    REQUIRE(fsb::mass_matrix_crba(model, joint_pva.position, fsb::MassMatrixOption::CHOLESKY, mass_chol));
+    for (size_t col = 0U; col < dofs; ++col)
+    {
+        for (size_t row = 0U; row < dofs; ++row)
+        {
+            fsb::Real value = 0.0;
+            for (size_t ind = 0U; ind < dofs; ++ind)
+            {
+                value += mass_chol.j[fsb::joint_matrix_index(row, ind, dofs)]
+                         * mass_chol.j[fsb::joint_matrix_index(col, ind, dofs)];
+            }
+            CHECK(value == FsbApprox(mass_full.j[fsb::joint_matrix_index(row, col, dofs)]));
+        }
+    }
+}
+
+TEST_CASE("Composite rigid body mass matrix at maximum degrees of freedom" * doctest::description("[fsb_dynamics][fsb::mass_matrix_crba]"))
+{
+    // floating chain with as many degrees of freedom as the configuration allows, beyond the fixed
+    // size Cholesky factorization for configurations with more than 12 degrees of freedom
+    using fsb::JointType;
+    auto            err = fsb::BodyTreeError::SUCCESS;
+    fsb::BodyTree   body_tree = {};
+    const fsb::Body body = {{}, {0.9, {0.2, 0.01, -0.03}, {0.011, 0.021, 0.017, 0.001, 0.0, -0.002}}, {}, 0U, false};
+    const fsb::Transform joint_tr = {{0.8660254037844387, 0.5, 0.0, 0.0}, {0.0, 0.2, 0.1}};
+    fsb::JointSpacePosition joint_position = {};
+    fsb::Quaternion quat_a = {0.8, 0.1, -0.3, 0.2};
+    fsb::Quaternion quat_b = {0.6, -0.4, 0.5, 0.1};
+    fsb::quat_normalize(quat_a);
+    fsb::quat_normalize(quat_b);
+    joint_position.q = {quat_a.qw, quat_a.qx, quat_a.qy, quat_a.qz, 0.4, -0.2, 0.7, quat_b.qw, quat_b.qx, quat_b.qy, quat_b.qz};
+
+    size_t body_index = body_tree.add_body(fsb::BodyTree::kBaseIndex, JointType::CARTESIAN, joint_tr, body, err);
+    REQUIRE(err == fsb::BodyTreeError::SUCCESS);
+    body_index = body_tree.add_body(body_index, JointType::SPHERICAL, joint_tr, body, err);
+    REQUIRE(err == fsb::BodyTreeError::SUCCESS);
+    const std::array<JointType, 3U> revolute = {JointType::REVOLUTE_X, JointType::REVOLUTE_Y, JointType::REVOLUTE_Z};
+    size_t dofs = 9U;
+    size_t coord = 11U;
+    while ((dofs < fsb::MaxSize::kDofs) && (coord < fsb::MaxSize::kCoordinates))
+    {
+        body_index = body_tree.add_body(body_index, revolute[dofs % 3U], joint_tr, body, err);
+        REQUIRE(err == fsb::BodyTreeError::SUCCESS);
+        joint_position.q[coord] = 0.3 * static_cast<fsb::Real>(dofs) - 2.0;
+        ++dofs;
+        ++coord;
+    }
+
+    fsb::DynamicsModel model = {};
+    REQUIRE(fsb::dynamics_model_compile(body_tree, model));
+    REQUIRE(model.num_dofs == dofs);
+    fsb::JointMatrix mass_full = {};
+    REQUIRE(fsb::mass_matrix_crba(model, joint_position, fsb::MassMatrixOption::FULL, mass_full));
+    fsb::JointMatrix mass_chol = {};
+    REQUIRE(fsb::mass_matrix_crba(model, joint_position, fsb::MassMatrixOption::CHOLESKY, mass_chol));
+    for (size_t col = 0U; col < dofs; ++col)
+    {
+        for (size_t row = 0U; row < dofs; ++row)
+        {
+            fsb::Real value = 0.0;
+            for (size_t ind = 0U; ind < dofs; ++ind)
+            {
+                value += mass_chol.j[fsb::joint_matrix_index(row, ind, dofs)]
+                         * mass_chol.j[fsb::joint_matrix_index(col, ind, dofs)];
+            }
+            CHECK(value == FsbApprox(mass_full.j[fsb::joint_matrix_index(row, col, dofs)]));
+            if (row < col)
+            {
+                CHECK(mass_chol.j[fsb::joint_matrix_index(row, col, dofs)] == 0.0);
+            }
+        }
+    }
+}
+
+TEST_CASE("Composite rigid body mass matrix of massless tree" * doctest::description("[fsb_dynamics][fsb::mass_matrix_crba]"))
+{
+    size_t                        ee_index = 0U;
+    const fsb::BodyTree           body_tree = create_panda_body_tree(ee_index);
+    const fsb::JointSpacePosition joint_position = {{0.1, -0.3, 0.2, -2.0, 0.1, 1.5, 0.7}};
+    fsb::JointMatrix              mass = {};
+    CHECK(fsb::mass_matrix_crba(body_tree, joint_position, fsb::MassMatrixOption::FULL, mass));
+    CHECK_FALSE(fsb::mass_matrix_crba(body_tree, joint_position, fsb::MassMatrixOption::CHOLESKY, mass));
+}
+
+TEST_CASE("Articulated body forward dynamics" * doctest::description("[fsb_dynamics][fsb::forward_dynamics_aba]"))
+{
+    const fsb::BodyTree body_tree = body_tree_sample_floating();
+    fsb::Quaternion     quat_a = {};
+    fsb::Quaternion     quat_b = {};
+    const fsb::JointPva joint_pva = joint_pva_sample_floating(quat_a, quat_b);
+    const fsb::CartesianPva base_pva = {
+        {{0.9, 0.2, -0.1, 0.3}, {0.5, -0.2, 0.1}},
+        {{0.1, -0.2, 0.3}, {0.4, 0.2, -0.1}},
+        {{-0.3, 0.5, 0.1}, {1.0, -0.4, 0.6}}
+    };
+    fsb::BodyForce external_force = {};
+    external_force.body[2U] = {{0.1, -0.3, 0.2}, {1.5, 0.4, -0.7}};
+    external_force.body[4U] = {{-0.05, 0.0, 0.12}, {0.0, -2.0, 0.3}};
+    const fsb::JointSpace joint_torque = {{1.2, -0.4, 0.8, 3.0, -1.5, 20.0, 0.3, -0.2, 0.1, 4.0, -0.6}};
+
+    fsb::DynamicsModel model = {};
+    REQUIRE(fsb::dynamics_model_compile(body_tree, model));
+    fsb::JointSpace joint_acceleration = {};
+    REQUIRE(fsb::forward_dynamics_aba(
+        model, joint_pva.position, joint_pva.velocity, joint_torque, base_pva, external_force,
+        joint_acceleration));
+
+    // inverse dynamics of forward dynamics solution recovers joint torque
+    const fsb::JointPva solved_pva = {joint_pva.position, joint_pva.velocity, joint_acceleration};
+    fsb::BodyForce        body_force = {};
+    const fsb::JointSpace actual_torque
+        = fsb::inverse_dynamics_rnea(model, solved_pva, base_pva, external_force, body_force);
+    for (size_t dof = 0U; dof < model.num_dofs; ++dof)
+    {
+        CHECK(actual_torque.qv[dof] == FsbApprox(joint_torque.qv[dof]));
+    }
+
+    // mass matrix times acceleration equals torque less bias torque
+    fsb::JointMatrix mass = {};
+    REQUIRE(fsb::mass_matrix_crba(model, joint_pva.position, fsb::MassMatrixOption::FULL, mass));
+    const fsb::JointPva   bias_pva = {joint_pva.position, joint_pva.velocity, {}};
+    const fsb::JointSpace bias_torque
+        = fsb::inverse_dynamics_rnea(model, bias_pva, base_pva, external_force, body_force);
+    for (size_t row = 0U; row < model.num_dofs; ++row)
+    {
+        fsb::Real value = 0.0;
+        for (size_t col = 0U; col < model.num_dofs; ++col)
+        {
+            value += mass.j[fsb::joint_matrix_index(row, col, model.num_dofs)] * joint_acceleration.qv[col];
+        }
+        CHECK(value == FsbApprox(joint_torque.qv[row] - bias_torque.qv[row]));
+    }
+
+    // body tree overload
+    fsb::JointSpace tree_acceleration = {};
+    REQUIRE(fsb::forward_dynamics_aba(
+        body_tree, joint_pva.position, joint_pva.velocity, joint_torque, base_pva, external_force,
+        tree_acceleration));
+    for (size_t dof = 0U; dof < model.num_dofs; ++dof)
+    {
+        CHECK(tree_acceleration.qv[dof] == FsbApprox(joint_acceleration.qv[dof]));
+    }
+}
+
+TEST_CASE("Articulated body forward dynamics of massless tree" * doctest::description("[fsb_dynamics][fsb::forward_dynamics_aba]"))
+{
+    size_t                        ee_index = 0U;
+    const fsb::BodyTree           body_tree = create_panda_body_tree(ee_index);
+    const fsb::JointSpacePosition joint_position = {{0.1, -0.3, 0.2, -2.0, 0.1, 1.5, 0.7}};
+    const fsb::CartesianPva       base_pva = {{{1.0, 0.0, 0.0, 0.0}, {}}, {}, {}};
+    fsb::JointSpace               joint_acceleration = {};
+    CHECK_FALSE(fsb::forward_dynamics_aba(
+        body_tree, joint_position, {}, {}, base_pva, {}, joint_acceleration));
+}
+
+TEST_CASE("Gravity and Coriolis joint torques" * doctest::description("[fsb_dynamics][fsb::gravity_torques][fsb::coriolis_torques]"))
+{
+    const fsb::BodyTree body_tree = body_tree_sample_floating();
+    fsb::Quaternion     quat_a = {};
+    fsb::Quaternion     quat_b = {};
+    const fsb::JointPva joint_pva = joint_pva_sample_floating(quat_a, quat_b);
+    const fsb::Transform base_pose = {{0.9, 0.2, -0.1, 0.3}, {0.5, -0.2, 0.1}};
+    const fsb::CartesianPva base_pva = {base_pose, {}, {}};
+
+    fsb::DynamicsModel model = {};
+    REQUIRE(fsb::dynamics_model_compile(body_tree, model));
+    fsb::DynamicsModel model_no_gravity = model;
+    model_no_gravity.gravity = {};
+
+    // gravity torque is inverse dynamics at rest
+    const fsb::JointSpace gravity_torque = fsb::gravity_torques(model, joint_pva.position, base_pose);
+    fsb::BodyForce        body_force = {};
+    const fsb::JointSpace rest_torque
+        = fsb::inverse_dynamics_rnea(model, {joint_pva.position, {}, {}}, base_pva, {}, body_force);
+    for (size_t dof = 0U; dof < model.num_dofs; ++dof)
+    {
+        CHECK(gravity_torque.qv[dof] == FsbApprox(rest_torque.qv[dof]));
+    }
+
+    // Coriolis torque is inverse dynamics without gravity and joint acceleration
+    const fsb::JointSpace coriolis_torque
+        = fsb::coriolis_torques(model, joint_pva.position, joint_pva.velocity);
+    const fsb::JointSpace velocity_torque = fsb::inverse_dynamics_rnea(
+        model_no_gravity, {joint_pva.position, joint_pva.velocity, {}}, base_pva, {}, body_force);
+    for (size_t dof = 0U; dof < model.num_dofs; ++dof)
+    {
+        CHECK(coriolis_torque.qv[dof] == FsbApprox(velocity_torque.qv[dof]));
+    }
+
+    // mass matrix times acceleration plus Coriolis and gravity torque equals inverse dynamics
+    fsb::JointMatrix mass = {};
+    REQUIRE(fsb::mass_matrix_crba(model, joint_pva.position, fsb::MassMatrixOption::FULL, mass));
+    const fsb::JointSpace joint_torque
+        = fsb::inverse_dynamics_rnea(model, joint_pva, base_pva, {}, body_force);
+    for (size_t row = 0U; row < model.num_dofs; ++row)
+    {
+        fsb::Real value = gravity_torque.qv[row] + coriolis_torque.qv[row];
+        for (size_t col = 0U; col < model.num_dofs; ++col)
+        {
+            value += mass.j[fsb::joint_matrix_index(row, col, model.num_dofs)] * joint_pva.acceleration.qv[col];
+        }
+        CHECK(value == FsbApprox(joint_torque.qv[row]));
+    }
+}
+
 TEST_SUITE_END();
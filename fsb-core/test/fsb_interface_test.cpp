@@ -109,3 +109,131 @@ TEST_CASE("Interface forward kinematics" * doctest::description("[fsb_compute_ki
     REQUIRE(expected_body3_pva.acceleration.angular.z == FsbApprox(body3_pva.acceleration.angular.z));
 
 }
+
+static void check_body_pva_equal(
+    const fsb::BodyCartesianPva& expected, const fsb::BodyCartesianPva& actual, const size_t num_bodies)
+{
+    for (size_t body_index = 0U; body_index < num_bodies; ++body_index)
+    {
+        const fsb::CartesianPva& exp_pva = expected.body[body_index];
+        const fsb::CartesianPva& act_pva = actual.body[body_index];
+        REQUIRE(exp_pva.pose.translation.x == FsbApprox(act_pva.pose.translation.x));
+        REQUIRE(exp_pva.pose.translation.y == FsbApprox(act_pva.pose.translation.y));
+        REQUIRE(exp_pva.pose.translation.z == FsbApprox(act_pva.pose.translation.z));
+        REQUIRE(exp_pva.pose.rotation.qw == FsbApprox(act_pva.pose.rotation.qw));
+        REQUIRE(exp_pva.pose.rotation.qx == FsbApprox(act_pva.pose.rotation.qx));
+        REQUIRE(exp_pva.pose.rotation.qy == FsbApprox(act_pva.pose.rotation.qy));
+        REQUIRE(exp_pva.pose.rotation.qz == FsbApprox(act_pva.pose.rotation.qz));
+        REQUIRE(exp_pva.velocity.angular.x == FsbApprox(act_pva.velocity.angular.x));
+        REQUIRE(exp_pva.velocity.angular.y == FsbApprox(act_pva.velocity.angular.y));
+        REQUIRE(exp_pva.velocity.angular.z == FsbApprox(act_pva.velocity.angular.z));
+        REQUIRE(exp_pva.velocity.linear.x == FsbApprox(act_pva.velocity.linear.x));
+        REQUIRE(exp_pva.velocity.linear.y == FsbApprox(act_pva.velocity.linear.y));
+        REQUIRE(exp_pva.velocity.linear.z == FsbApprox(act_pva.velocity.linear.z));
+        REQUIRE(exp_pva.acceleration.angular.x == FsbApprox(act_pva.acceleration.angular.x));
+        REQUIRE(exp_pva.acceleration.angular.y == FsbApprox(act_pva.acceleration.angular.y));
+        REQUIRE(exp_pva.acceleration.angular.z == FsbApprox(act_pva.acceleration.angular.z));
+        REQUIRE(exp_pva.acceleration.linear.x == FsbApprox(act_pva.acceleration.linear.x));
+        REQUIRE(exp_pva.acceleration.linear.y == FsbApprox(act_pva.acceleration.linear.y));
+        REQUIRE(exp_pva.acceleration.linear.z == FsbApprox(act_pva.acceleration.linear.z));
+    }
+}
+
+TEST_CASE("Interface incremental forward kinematics" * doctest::description("[fsb_compute_kinematics][fsb::ComputeKinematics::compute_forward_kinematics_incremental]"))
+{
+    size_t ee_index = 0U;
+    const fsb::BodyTree body_tree = create_panda_body_tree(ee_index);
+    const size_t num_bodies = body_tree.get_num_bodies();
+    fsb::ComputeKinematics compute = {};
+    REQUIRE(compute.initialize(body_tree) == fsb::ComputeKinematicsError::SUCCESS);
+
+    fsb::JointPva joint_pva = {
+        {{1.0, -0.32, 0.08, -2.15, 0.04, -2.0, 0.78}},
+        {{0.1, 0.2, -0.3, 0.4, -0.5, 0.6, -0.7}},
+        {{-1.0, 0.9, 0.8, -0.7, 0.6, 0.5, 0.4}}
+    };
+    fsb::BodyCartesianPva expected = {};
+    fsb::BodyCartesianPva actual = {};
+
+    // first call computes all bodies
+    auto opt = fsb::ForwardKinematicsOption::POSE;
+    compute.compute_forward_kinematics_incremental(opt, joint_pva, actual);
+    REQUIRE(compute.get_num_updated_bodies() == num_bodies - 1U);
+
+    // unchanged joints reuse all bodies
+    compute.compute_forward_kinematics_incremental(opt, joint_pva, actual);
+    REQUIRE(compute.get_num_updated_bodies() == 0U);
+    compute.compute_forward_kinematics(opt, joint_pva, expected);
+    check_body_pva_equal(expected, actual, num_bodies);
+
+    // change of sixth joint recomputes links 6, 7 and flange
+    joint_pva.position.q[5] = -1.7;
+    compute.compute_forward_kinematics_incremental(opt, joint_pva, actual);
+    REQUIRE(compute.get_num_updated_bodies() == 3U);
+    compute.compute_forward_kinematics(opt, joint_pva, expected);
+    check_body_pva_equal(expected, actual, num_bodies);
+
+    // velocity and acceleration not in cache recomputes all bodies
+    opt = fsb::ForwardKinematicsOption::POSE_VELOCITY_ACCELERATION;
+    compute.compute_forward_kinematics_incremental(opt, joint_pva, actual);
+    REQUIRE(compute.get_num_updated_bodies() == num_bodies - 1U);
+    compute.compute_forward_kinematics(opt, joint_pva, expected);
+    check_body_pva_equal(expected, actual, num_bodies);
+
+    // change of joint acceleration only recomputes subtree
+    joint_pva.acceleration.qv[3] = 0.25;
+    compute.compute_forward_kinematics_incremental(opt, joint_pva, actual);
+    REQUIRE(compute.get_num_updated_bodies() == 5U);
+    compute.compute_forward_kinematics(opt, joint_pva, expected);
+    check_body_pva_equal(expected, actual, num_bodies);
+
+    // reset recomputes all bodies
+    compute.reset_kinematics_state();
+    compute.compute_forward_kinematics_incremental(opt, joint_pva, actual);
+    REQUIRE(compute.get_num_updated_bodies() == num_bodies - 1U);
+    check_body_pva_equal(expected, actual, num_bodies);
+}
+
+TEST_CASE("Interface forward kinematics and Jacobians" * doctest::description("[fsb_compute_kinematics][fsb::ComputeKinematics::compute_forward_kinematics_and_jacobians]"))
+{
+    size_t ee_index = 0U;
+    const fsb::BodyTree body_tree = create_panda_body_tree(ee_index);
+    fsb::ComputeKinematics compute = {};
+    REQUIRE(compute.initialize(body_tree) == fsb::ComputeKinematicsError::SUCCESS);
+
+    const fsb::JointPva joint_pva = {{{1.0, -0.32, 0.08, -2.15, 0.04, -2.0, 0.78}}, {}, {}};
+    const auto opt = fsb::ForwardKinematicsOption::POSE;
+    fsb::BodyCartesianPva expected_cartesian = {};
+    compute.compute_forward_kinematics(opt, joint_pva, expected_cartesian);
+
+    // single body
+    fsb::BodyCartesianPva cartesian = {};
+    fsb::Jacobian jacobian = {};
+    REQUIRE(compute.compute_forward_kinematics_and_jacobians(opt, joint_pva, ee_index, cartesian, jacobian) == fsb::JacobianError::SUCCESS);
+    check_body_pva_equal(expected_cartesian, cartesian, body_tree.get_num_bodies());
+    fsb::Jacobian expected_jacobian = {};
+    REQUIRE(compute.compute_jacobian(ee_index, expected_cartesian, expected_jacobian) == fsb::JacobianError::SUCCESS);
+    for (size_t index = 0U; index < expected_jacobian.j.size(); ++index)
+    {
+        REQUIRE(expected_jacobian.j[index] == FsbApprox(jacobian.j[index]));
+    }
+
+    // multiple bodies
+    const std::array<size_t, fsb::MaxSize::kBodies> body_indices = {ee_index, 4U, 2U};
+    std::array<fsb::Jacobian, fsb::MaxSize::kBodies> jacobians = {};
+    REQUIRE(compute.compute_forward_kinematics_and_jacobians(opt, joint_pva, body_indices, 3U, cartesian, jacobians) == fsb::JacobianError::SUCCESS);
+    for (size_t body = 0U; body < 3U; ++body)
+    {
+        REQUIRE(compute.compute_jacobian(body_indices[body], expected_cartesian, expected_jacobian) == fsb::JacobianError::SUCCESS);
+        for (size_t index = 0U; index < expected_jacobian.j.size(); ++index)
+        {
+            REQUIRE(expected_jacobian.j[index] == FsbApprox(jacobians[body].j[index]));
+        }
+    }
+
+    // invalid body
+    const std::array<size_t, fsb::MaxSize::kBodies> invalid_indices = {ee_index, 10U};
+    REQUIRE(compute.compute_forward_kinematics_and_jacobians(opt, joint_pva, invalid_indices, 2U, cartesian, jacobians) == fsb::JacobianError::BODY_NOT_IN_TREE);
+}
+
+TEST_SUITE_END();
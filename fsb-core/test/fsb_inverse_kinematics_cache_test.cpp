@@ -0,0 +1,180 @@
+#include <doctest/doctest.h>
+#include <cmath>
+#include "fsb_test_macros.h"
+#include "fsb_inverse_kinematics_cache.h"
+#include "fsb_inverse_kinematics.h"
+#include "fsb_kinematics.h"
+#include "fsb_body_tree_sample.h"
+
+TEST_SUITE_BEGIN("inverse_kinematics_cache");
+
+TEST_CASE("Seed cache lookup and replacement" * doctest::description("[fsb_inverse_kinematics_cache][fsb::InverseKinematicsSeedCache]"))
+{
+    fsb::InverseKinematicsSeedCache cache = {};
+    REQUIRE(cache.initialize({0.01, 0.05}));
+    const fsb::Transform target_pose = {fsb::quat_identity(), {0.5, 0.1, 0.3}};
+    const fsb::JointSpacePosition solution = {{0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7}};
+    fsb::JointSpacePosition seed = {};
+
+    REQUIRE_FALSE(cache.lookup(target_pose, seed));
+    cache.insert(target_pose, solution);
+    REQUIRE(cache.get_size() == 1U);
+
+    // same cell
+    const fsb::Transform near_pose = {fsb::quat_identity(), {0.502, 0.101, 0.303}};
+    REQUIRE(cache.lookup(near_pose, seed));
+    REQUIRE(seed.q[6] == FsbApprox(solution.q[6]));
+
+    // quaternion sign does not change the cell
+    const fsb::Transform negated_pose = {{-1.0, 0.0, 0.0, 0.0}, {0.5, 0.1, 0.3}};
+    REQUIRE(cache.lookup(negated_pose, seed));
+
+    // neighbouring cells in position and orientation
+    const fsb::Transform far_pose = {fsb::quat_identity(), {0.52, 0.1, 0.3}};
+    REQUIRE_FALSE(cache.lookup(far_pose, seed));
+    const fsb::Transform rotated_pose = {{0.9950041652780258, 0.0, 0.0, 0.09983341664682815}, {0.5, 0.1, 0.3}};
+    REQUIRE_FALSE(cache.lookup(rotated_pose, seed));
+
+    // solution of same cell is replaced
+    fsb::JointSpacePosition other_solution = solution;
+    other_solution.q[6] = -0.7;
+    cache.insert(near_pose, other_solution);
+    REQUIRE(cache.get_size() == 1U);
+    REQUIRE(cache.lookup(target_pose, seed));
+    REQUIRE(seed.q[6] == FsbApprox(-0.7));
+
+    const fsb::SeedCacheStatistics& stats = cache.get_statistics();
+    REQUIRE(stats.hits == 3U);
+    REQUIRE(stats.misses == 3U);
+    REQUIRE(stats.insertions == 2U);
+    REQUIRE(stats.evictions == 0U);
+
+    // memory is bounded
+    for (size_t index = 0U; index < 2U * fsb::kSeedCacheSets * fsb::kSeedCacheWays; ++index)
+    {
+        const fsb::Transform pose = {fsb::quat_identity(), {0.01 * static_cast<fsb::Real>(index), 0.0, 0.0}};
+        cache.insert(pose, solution);
+    }
+    REQUIRE(cache.get_size() <= fsb::kSeedCacheSets * fsb::kSeedCacheWays);
+    REQUIRE(cache.get_statistics().evictions > 0U);
+
+    cache.clear();
+    REQUIRE(cache.get_size() == 0U);
+    REQUIRE(cache.get_statistics().insertions == 0U);
+}
+
+TEST_CASE("Seed cache neighbouring cells" * doctest::description("[fsb_inverse_kinematics_cache][fsb::InverseKinematicsSeedCache]"))
+{
+    fsb::InverseKinematicsSeedCache cache = {};
+    REQUIRE(cache.initialize({0.01, 0.05}));
+    const fsb::JointSpacePosition solution = {{0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7}};
+    fsb::JointSpacePosition seed = {};
+
+    // target across a position cell boundary
+    const fsb::Transform target_pose = {fsb::quat_identity(), {0.5095, 0.1, 0.3}};
+    cache.insert(target_pose, solution);
+    const fsb::Transform boundary_pose = {fsb::quat_identity(), {0.5103, 0.1, 0.3}};
+    REQUIRE(cache.lookup(boundary_pose, seed));
+    REQUIRE(seed.q[6] == FsbApprox(solution.q[6]));
+
+    // nearest of two stored targets
+    fsb::JointSpacePosition other_solution = solution;
+    other_solution.q[6] = -0.7;
+    const fsb::Transform other_pose = {fsb::quat_identity(), {0.5115, 0.1, 0.3}};
+    cache.insert(other_pose, other_solution);
+    REQUIRE(cache.lookup(boundary_pose, seed));
+    REQUIRE(seed.q[6] == FsbApprox(solution.q[6]));
+    const fsb::Transform other_near_pose = {fsb::quat_identity(), {0.5112, 0.1, 0.3}};
+    REQUIRE(cache.lookup(other_near_pose, seed));
+    REQUIRE(seed.q[6] == FsbApprox(-0.7));
+
+    // rotations on either side of half a turn
+    const fsb::Real angle_before = M_PI - 0.01;
+    const fsb::Real angle_after = M_PI + 0.01;
+    const fsb::Transform half_turn_pose = {
+        {std::cos(0.5 * angle_before), std::sin(0.5 * angle_before), 0.0, 0.0}, {0.0, 0.5, 0.3}};
+    cache.insert(half_turn_pose, solution);
+    const fsb::Transform past_half_turn_pose = {
+        {std::cos(0.5 * angle_after), std::sin(0.5 * angle_after), 0.0, 0.0}, {0.0, 0.5, 0.3}};
+    REQUIRE(cache.lookup(past_half_turn_pose, seed));
+    REQUIRE(seed.q[6] == FsbApprox(solution.q[6]));
+
+    REQUIRE(cache.get_statistics().hits == 4U);
+    REQUIRE(cache.get_statistics().misses == 0U);
+}
+
+TEST_CASE("Seed cache invalid resolution" * doctest::description("[fsb_inverse_kinematics_cache][fsb::InverseKinematicsSeedCache]"))
+{
+    fsb::InverseKinematicsSeedCache cache = {};
+    const fsb::Transform target_pose = {fsb::quat_identity(), {0.5, 0.1, 0.3}};
+    const fsb::JointSpacePosition solution = {{0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7}};
+    fsb::JointSpacePosition seed = {};
+
+    REQUIRE_FALSE(cache.initialize({0.0, 0.05}));
+    REQUIRE_FALSE(cache.initialize({0.01, -0.05}));
+    REQUIRE_FALSE(cache.initialize({std::nan(""), 0.05}));
+    REQUIRE_FALSE(cache.initialize({0.01, INFINITY}));
+
+    // disabled cache stores and finds nothing
+    cache.insert(target_pose, solution);
+    REQUIRE(cache.get_size() == 0U);
+    REQUIRE(cache.get_statistics().insertions == 0U);
+    REQUIRE_FALSE(cache.lookup(target_pose, seed));
+    REQUIRE(seed.q[6] == FsbApprox(0.0));
+
+    // valid parameters enable cache again
+    REQUIRE(cache.initialize({}));
+    cache.insert(target_pose, solution);
+    REQUIRE(cache.lookup(target_pose, seed));
+    REQUIRE(seed.q[6] == FsbApprox(solution.q[6]));
+}
+
+TEST_CASE("Seed cache inverse kinematics Panda 7 DoF" * doctest::description("[fsb_inverse_kinematics_cache][fsb::compute_inverse_kinematics]"))
+{
+    size_t              ee_index = 0U;
+    const fsb::BodyTree panda_tree = create_panda_body_tree(ee_index);
+    const fsb::JointSpacePosition initial_config = {{1.0, -0.32, 0.08, -2.15, 0.04, -2.0, 0.78}};
+    const fsb::Transform target_pose = {
+        {0.9218430590013226, -0.3843272787743501, 0.04613060152655873, -0.019232393605190336},
+        {0.47372404011176217, 0.07, 0.5155132061520504}};
+    const fsb::OptimParameters optim_params = {};
+    fsb::InverseKinematicsSeedCache cache = {};
+    REQUIRE(cache.initialize({}));
+
+    // first solution is stored
+    const fsb::InverseKinematicsResult first = fsb::compute_inverse_kinematics(
+        panda_tree, optim_params, initial_config, ee_index, target_pose, fsb::transform_identity(), &cache);
+    REQUIRE(first.info == fsb::InverseKinematicsInfo::SUCCESS);
+    REQUIRE(cache.get_statistics().insertions == 1U);
+
+    // repeated target keeps explicit initial configuration
+    const fsb::InverseKinematicsResult repeat = fsb::compute_inverse_kinematics(
+        panda_tree, optim_params, initial_config, ee_index, target_pose, fsb::transform_identity(), &cache);
+    REQUIRE(repeat.info == fsb::InverseKinematicsInfo::SUCCESS);
+    REQUIRE(repeat.iterations == first.iterations);
+    REQUIRE(cache.get_statistics().hits == 0U);
+    REQUIRE(cache.get_statistics().misses == 0U);
+    REQUIRE(cache.get_statistics().insertions == 2U);
+
+    // nearby target replaces warm start of persistent solver
+    fsb::InverseKinematicsSolver solver = {};
+    REQUIRE(solver.initialize(panda_tree, ee_index, optim_params) == fsb::InverseKinematicsInfo::SUCCESS);
+    solver.set_seed_cache(&cache);
+    fsb::Transform near_pose = target_pose;
+    near_pose.translation.z += 0.001;
+    const fsb::InverseKinematicsResult& near_result = solver.solve(near_pose);
+    REQUIRE(near_result.info == fsb::InverseKinematicsInfo::SUCCESS);
+    REQUIRE(cache.get_statistics().hits == 1U);
+    REQUIRE(near_result.iterations < first.iterations);
+
+    // explicit seed and warm start set by caller are kept
+    const fsb::InverseKinematicsResult& seed_result = solver.solve(near_pose, initial_config);
+    REQUIRE(seed_result.info == fsb::InverseKinematicsInfo::SUCCESS);
+    solver.set_warm_start(initial_config);
+    const fsb::InverseKinematicsResult& warm_result = solver.solve(near_pose);
+    REQUIRE(warm_result.info == fsb::InverseKinematicsInfo::SUCCESS);
+    REQUIRE(cache.get_statistics().hits == 1U);
+    REQUIRE(cache.get_statistics().misses == 0U);
+}
+
+TEST_SUITE_END();
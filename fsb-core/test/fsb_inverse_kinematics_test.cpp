@@ -1,4 +1,5 @@
-
+#include <cstdint>
+#include <limits>
 #include <doctest/doctest.h>
 #include "fsb_test_macros.h"
 #include "fsb_kinematics.h"
@@ -54,6 +55,283 @@ TEST_CASE("Inverse Kinematics Panda 7 DoF" * doctest::description("[fsb_inverse_
     REQUIRE(result.computed_pose.translation.z == FsbApprox(target_pose.translation.z, pose_tolerance));
 }
 
+TEST_CASE("Inverse Kinematics solver Panda 7 DoF" * doctest::description("[fsb_inverse_kinematics][fsb::InverseKinematicsSolver]"))
+{
+    size_t              ee_index = 0;
+    const fsb::BodyTree panda_tree = create_panda_body_tree(ee_index);
+    const size_t        target_body_index = 8U;
+    const fsb::JointSpacePosition initial_config = {{1.0, -0.32, 0.08, -2.15, 0.04, -2.0, 0.78}};
+    const fsb::OptimParameters optim_params = {};
+
+    fsb::InverseKinematicsSolver solver = {};
+    REQUIRE(solver.solve(fsb::transform_identity()).info == fsb::InverseKinematicsInfo::INVALID_INPUT);
+    REQUIRE(solver.initialize(panda_tree, panda_tree.get_num_bodies(), optim_params) == fsb::InverseKinematicsInfo::INVALID_INPUT);
+    REQUIRE(solver.initialize(panda_tree, target_body_index, optim_params) == fsb::InverseKinematicsInfo::SUCCESS);
+
+    // same result as single computation
+    const fsb::Transform target_pose = {
+        {0.9218430590013226, -0.3843272787743501, 0.04613060152655873, -0.019232393605190336},
+        {0.47372404011176217, 0.07, 0.5155132061520504}};
+    const fsb::InverseKinematicsResult expected = fsb::compute_inverse_kinematics(
+        panda_tree, optim_params, initial_config, target_body_index, target_pose);
+    const fsb::InverseKinematicsResult& result = solver.solve(target_pose, initial_config);
+    REQUIRE(result.info == fsb::InverseKinematicsInfo::SUCCESS);
+    REQUIRE(result.iterations == expected.iterations);
+    for (size_t index = 0U; index < panda_tree.get_num_coordinates(); ++index)
+    {
+        REQUIRE(result.joint_position.q[index] == FsbApprox(expected.joint_position.q[index]));
+    }
+    for (size_t index = 0U; index < panda_tree.get_num_bodies(); ++index)
+    {
+        const fsb::MotionVector pose_err = fsb::coord_transform_get_error(
+            expected.body_poses.body[index].pose, result.body_poses.body[index].pose);
+        REQUIRE(fsb::vector_norm(pose_err.linear) == FsbApprox(0.0, 1.0e-12));
+        REQUIRE(fsb::vector_norm(pose_err.angular) == FsbApprox(0.0, 1.0e-12));
+    }
+
+    // stream of targets along a joint space path, warm started from previous solution
+    REQUIRE(solver.get_warm_start().q[0] == FsbApprox(result.joint_position.q[0]));
+    // targets follow a path from the initial configuration
+    solver.set_warm_start(initial_config);
+    fsb::JointPva joint_pva = {initial_config, {}, {}};
+    fsb::BodyCartesianPva cartesian = {};
+    for (size_t sample = 1U; sample <= 10U; ++sample)
+    {
+        const auto step = 0.01 * static_cast<fsb::Real>(sample);
+        joint_pva.position.q[0] = initial_config.q[0] + step;
+        joint_pva.position.q[3] = initial_config.q[3] - step;
+        joint_pva.position.q[5] = initial_config.q[5] + step;
+        fsb::forward_kinematics(panda_tree, joint_pva, {}, fsb::ForwardKinematicsOption::POSE, cartesian);
+        const fsb::Transform& sample_pose = cartesian.body[target_body_index].pose;
+        const fsb::InverseKinematicsResult& sample_result = solver.solve(sample_pose);
+        REQUIRE(sample_result.info == fsb::InverseKinematicsInfo::SUCCESS);
+        REQUIRE(sample_result.iterations < expected.iterations);
+        REQUIRE(fsb::vector_norm(sample_result.error_pose.linear) == FsbApprox(0.0, 1.0e-5));
+        REQUIRE(fsb::vector_norm(sample_result.error_pose.angular) == FsbApprox(0.0, 1.0e-5));
+    }
+}
+
+TEST_CASE("Inverse Kinematics unreachable target Panda 7 DoF" * doctest::description("[fsb_inverse_kinematics]"))
+{
+    size_t              ee_index = 0;
+    const fsb::BodyTree panda_tree = create_panda_body_tree(ee_index);
+    const fsb::JointSpacePosition initial_config = {{1.0, -0.32, 0.08, -2.15, 0.04, -2.0, 0.78}};
+    const fsb::Transform target_pose = {fsb::quat_identity(), {2.0, 0.0, 0.5}};
+    fsb::OptimParameters optim_params = {};
+    optim_params.max_iterations = 500U;
+
+    // relative reduction of objective function
+    optim_params.reduction_tol = 1.0e-6;
+    const fsb::InverseKinematicsResult ftol_result = fsb::compute_inverse_kinematics(
+        panda_tree, optim_params, initial_config, ee_index, target_pose);
+    REQUIRE(ftol_result.info == fsb::InverseKinematicsInfo::WITHIN_FTOL);
+    REQUIRE(ftol_result.iterations < optim_params.max_iterations);
+
+    // relative change of state vector
+    optim_params.reduction_tol = 1.0e-12;
+    optim_params.state_tol = 1.0e-6;
+    const fsb::InverseKinematicsResult xtol_result = fsb::compute_inverse_kinematics(
+        panda_tree, optim_params, initial_config, ee_index, target_pose);
+    REQUIRE(xtol_result.info == fsb::InverseKinematicsInfo::WITHIN_XTOL);
+    REQUIRE(xtol_result.iterations < optim_params.max_iterations);
+}
+
+TEST_CASE("Inverse Kinematics joint limits Panda 7 DoF" * doctest::description("[fsb_inverse_kinematics]"))
+{
+    size_t        ee_index = 0;
+    fsb::BodyTree panda_tree = create_panda_body_tree(ee_index);
+    const fsb::JointSpacePosition initial_config = {{1.0, -0.32, 0.08, -2.15, 0.04, -2.0, 0.78}};
+    const fsb::Transform target_pose = {
+        {0.9218430590013226, -0.3843272787743501, 0.04613060152655873, -0.019232393605190336},
+        {0.47372404011176217, 0.07, 0.5155132061520504}};
+    const fsb::JointSpacePosition lower = {{-2.8973, -1.7628, -2.8973, -3.0718, -2.8973, -0.0175, -2.8973}};
+    const fsb::JointSpacePosition upper = {{2.8973, 1.7628, 2.8973, -0.0698, 2.8973, 3.7525, 2.8973}};
+    for (size_t joint = 0U; joint < panda_tree.get_num_coordinates(); ++joint)
+    {
+        REQUIRE(panda_tree.set_joint_position_limit(joint, lower.q[joint], upper.q[joint]) == fsb::BodyTreeError::SUCCESS);
+    }
+    fsb::OptimParameters optim_params = {};
+
+    // unconstrained solution exceeds the limit of the last joint
+    const fsb::InverseKinematicsResult free_result = fsb::compute_inverse_kinematics(
+        panda_tree, optim_params, initial_config, ee_index, target_pose);
+    REQUIRE(free_result.info == fsb::InverseKinematicsInfo::SUCCESS);
+    REQUIRE(free_result.joint_position.q[6] > upper.q[6]);
+    REQUIRE(free_result.num_active_limits == 0U);
+
+    // constrained solution reaches the target within limits
+    optim_params.joint_limits = true;
+    const fsb::InverseKinematicsResult result = fsb::compute_inverse_kinematics(
+        panda_tree, optim_params, initial_config, ee_index, target_pose);
+    REQUIRE(result.info == fsb::InverseKinematicsInfo::SUCCESS);
+    REQUIRE(fsb::vector_norm(result.error_pose.linear) == FsbApprox(0.0, 1.0e-5));
+    REQUIRE(fsb::vector_norm(result.error_pose.angular) == FsbApprox(0.0, 1.0e-5));
+    for (size_t coord = 0U; coord < panda_tree.get_num_coordinates(); ++coord)
+    {
+        REQUIRE(result.joint_position.q[coord] >= lower.q[coord]);
+        REQUIRE(result.joint_position.q[coord] <= upper.q[coord]);
+    }
+
+    // joint fixed by its limits is reported as active and not moved
+    REQUIRE(panda_tree.set_joint_position_limit(0U, 1.2, 1.2) == fsb::BodyTreeError::SUCCESS);
+    fsb::InverseKinematicsSolver solver = {};
+    REQUIRE(solver.initialize(panda_tree, ee_index, optim_params) == fsb::InverseKinematicsInfo::SUCCESS);
+    const fsb::InverseKinematicsResult& fixed_result = solver.solve(target_pose, initial_config);
+    REQUIRE(fixed_result.joint_position.q[0] == FsbApprox(1.2));
+    REQUIRE(fixed_result.active_limits[0]);
+    REQUIRE(fixed_result.num_active_limits >= 1U);
+    for (size_t coord = 1U; coord < panda_tree.get_num_coordinates(); ++coord)
+    {
+        REQUIRE(fixed_result.joint_position.q[coord] >= lower.q[coord]);
+        REQUIRE(fixed_result.joint_position.q[coord] <= upper.q[coord]);
+    }
+}
+
+TEST_CASE("Inverse Kinematics sequence Panda 7 DoF" * doctest::description("[fsb_inverse_kinematics][fsb::InverseKinematicsSolver]"))
+{
+    size_t              ee_index = 0;
+    const fsb::BodyTree panda_tree = create_panda_body_tree(ee_index);
+    const fsb::JointSpacePosition initial_config = {{1.0, -0.32, 0.08, -2.15, 0.04, -2.0, 0.78}};
+    fsb::OptimParameters optim_params = {};
+    optim_params.objective_tol = 1.0e-14;
+
+    // targets along a smooth joint space path
+    constexpr size_t num_targets = 100U;
+    std::array<fsb::Transform, num_targets> target_poses = {};
+    fsb::JointPva joint_pva = {initial_config, {}, {}};
+    fsb::BodyCartesianPva cartesian = {};
+    for (size_t sample = 0U; sample < num_targets; ++sample)
+    {
+        const auto phase = 0.02 * static_cast<fsb::Real>(sample);
+        joint_pva.position.q[0] = initial_config.q[0] + 0.3 * std::sin(phase);
+        joint_pva.position.q[1] = initial_config.q[1] + 0.2 * (1.0 - std::cos(phase));
+        joint_pva.position.q[3] = initial_config.q[3] - 0.2 * std::sin(phase);
+        joint_pva.position.q[5] = initial_config.q[5] + 0.1 * std::sin(phase);
+        fsb::forward_kinematics(panda_tree, joint_pva, {}, fsb::ForwardKinematicsOption::POSE, cartesian);
+        target_poses[sample] = cartesian.body[ee_index].pose;
+    }
+
+    std::array<fsb::InverseKinematicsSample, num_targets> samples = {};
+    std::array<fsb::InverseKinematicsSequenceSummary, 2U> summary = {};
+    const std::array<fsb::InverseKinematicsSeedPrediction, 2U> predictions = {
+        fsb::InverseKinematicsSeedPrediction::PREVIOUS_SOLUTION,
+        fsb::InverseKinematicsSeedPrediction::VELOCITY};
+    for (size_t mode = 0U; mode < predictions.size(); ++mode)
+    {
+        fsb::InverseKinematicsSolver solver = {};
+        REQUIRE(solver.initialize(panda_tree, ee_index, optim_params) == fsb::InverseKinematicsInfo::SUCCESS);
+        solver.set_warm_start(initial_config);
+        summary[mode] = solver.solve_sequence(target_poses.data(), num_targets, predictions[mode], samples.data());
+        REQUIRE(summary[mode].num_samples == num_targets);
+        REQUIRE(summary[mode].num_failures == 0U);
+        for (size_t sample = 0U; sample < num_targets; ++sample)
+        {
+            REQUIRE(samples[sample].info == fsb::InverseKinematicsInfo::SUCCESS);
+            joint_pva.position = samples[sample].joint_position;
+            fsb::forward_kinematics(panda_tree, joint_pva, {}, fsb::ForwardKinematicsOption::POSE, cartesian);
+            const fsb::MotionVector error = fsb::coord_transform_get_error(cartesian.body[ee_index].pose, target_poses[sample]);
+            REQUIRE(fsb::vector_norm(error.linear) == FsbApprox(0.0, 1.0e-6));
+            REQUIRE(fsb::vector_norm(error.angular) == FsbApprox(0.0, 1.0e-6));
+        }
+    }
+    // velocity prediction reduces iterations
+    REQUIRE(summary[1U].total_iterations < summary[0U].total_iterations);
+    REQUIRE(summary[1U].max_iterations <= summary[0U].max_iterations);
+}
+
+TEST_CASE("Inverse Kinematics sequence unreachable Panda 7 DoF" * doctest::description("[fsb_inverse_kinematics][fsb::InverseKinematicsSolver]"))
+{
+    size_t              ee_index = 0;
+    const fsb::BodyTree panda_tree = create_panda_body_tree(ee_index);
+    const fsb::JointSpacePosition initial_config = {{1.0, -0.32, 0.08, -2.15, 0.04, -2.0, 0.78}};
+    fsb::OptimParameters optim_params = {};
+    optim_params.max_iterations = 1000U;
+
+    // targets beyond reach of the arm stall on relative reduction without reaching the objective
+    // tolerance
+    constexpr size_t num_targets = 3U;
+    const std::array<fsb::Transform, num_targets> target_poses = {{
+        {{1.0, 0.0, 0.0, 0.0}, {2.0, 0.0, 0.5}},
+        {{1.0, 0.0, 0.0, 0.0}, {2.1, 0.0, 0.5}},
+        {{1.0, 0.0, 0.0, 0.0}, {2.2, 0.0, 0.5}}}};
+    std::array<fsb::InverseKinematicsSample, num_targets> samples = {};
+
+    fsb::InverseKinematicsSolver solver = {};
+    REQUIRE(solver.initialize(panda_tree, ee_index, optim_params) == fsb::InverseKinematicsInfo::SUCCESS);
+    solver.set_warm_start(initial_config);
+    const fsb::InverseKinematicsSequenceSummary summary = solver.solve_sequence(
+        target_poses.data(), num_targets, fsb::InverseKinematicsSeedPrediction::VELOCITY, samples.data());
+    REQUIRE(summary.num_samples == num_targets);
+    REQUIRE(summary.num_failures == num_targets);
+    for (size_t sample = 0U; sample < num_targets; ++sample)
+    {
+        REQUIRE(samples[sample].info != fsb::InverseKinematicsInfo::SUCCESS);
+        REQUIRE_FALSE(fsb::inverse_kinematics_converged(samples[sample].info));
+    }
+    REQUIRE(fsb::vector_norm(solver.get_result().error_pose.linear) > 1.0);
+    // failed samples keep the warm start
+    for (size_t coord = 0U; coord < panda_tree.get_num_coordinates(); ++coord)
+    {
+        REQUIRE(solver.get_warm_start().q[coord] == FsbApprox(initial_config.q[coord]));
+    }
+}
+
+TEST_CASE("Inverse Kinematics deadline Panda 7 DoF" * doctest::description("[fsb_inverse_kinematics][fsb::InverseKinematicsSolver]"))
+{
+    size_t              ee_index = 0;
+    const fsb::BodyTree panda_tree = create_panda_body_tree(ee_index);
+    const fsb::JointSpacePosition initial_config = {{1.0, -0.32, 0.08, -2.15, 0.04, -2.0, 0.78}};
+    const fsb::Transform target_pose = {
+        {0.9218430590013226, -0.3843272787743501, 0.04613060152655873, -0.019232393605190336},
+        {0.47372404011176217, 0.07, 0.5155132061520504}};
+    const fsb::OptimParameters optim_params = {};
+
+    fsb::InverseKinematicsSolver solver = {};
+    REQUIRE(solver.initialize(panda_tree, ee_index, optim_params) == fsb::InverseKinematicsInfo::SUCCESS);
+    const fsb::InverseKinematicsResult expected = fsb::compute_inverse_kinematics(
+        panda_tree, optim_params, initial_config, ee_index, target_pose);
+    REQUIRE(expected.info == fsb::InverseKinematicsInfo::SUCCESS);
+
+    // expired deadline computes a single iteration and resumes from it on the next call
+    const timespec expired = {0, 0};
+    solver.set_warm_start(initial_config);
+    size_t num_calls = 0U;
+    const auto squared_error = [](const fsb::MotionVector& error) {
+        return fsb::vector_dot(error.angular, error.angular) + fsb::vector_dot(error.linear, error.linear);
+    };
+    fsb::Real previous_error = squared_error(
+        fsb::compute_inverse_kinematics(panda_tree, {1U}, initial_config, ee_index, target_pose).error_pose);
+    while ((solver.get_result().info != fsb::InverseKinematicsInfo::SUCCESS) && (num_calls < optim_params.max_iterations))
+    {
+        const fsb::InverseKinematicsResult& result = solver.solve_until(target_pose, expired);
+        num_calls += 1U;
+        if (result.info == fsb::InverseKinematicsInfo::DEADLINE_REACHED)
+        {
+            REQUIRE(result.iterations == 2U);
+            REQUIRE(solver.get_warm_start().q[0] == FsbApprox(result.joint_position.q[0]));
+            // best iterate is returned
+            REQUIRE(squared_error(result.error_pose) <= previous_error);
+            previous_error = squared_error(result.error_pose);
+        }
+    }
+    REQUIRE(solver.get_result().info == fsb::InverseKinematicsInfo::SUCCESS);
+    REQUIRE(num_calls <= expected.iterations);
+    REQUIRE(fsb::vector_norm(solver.get_result().error_pose.linear) == FsbApprox(0.0, 1.0e-5));
+
+    // time budget large enough to converge
+    solver.set_warm_start(initial_config);
+    const fsb::InverseKinematicsResult& result = solver.solve_within(target_pose, 1000000000);
+    REQUIRE(result.info == fsb::InverseKinematicsInfo::SUCCESS);
+    REQUIRE(result.iterations == expected.iterations);
+
+    // largest time budget is clamped
+    solver.set_warm_start(initial_config);
+    const fsb::InverseKinematicsResult& unbounded_result
+        = solver.solve_within(target_pose, std::numeric_limits<int64_t>::max());
+    REQUIRE(unbounded_result.info == fsb::InverseKinematicsInfo::SUCCESS);
+    REQUIRE(unbounded_result.iterations == expected.iterations);
+}
+
 TEST_CASE("Velocity Inverse Kinematics Panda 7 DoF" * doctest::description("[fsb_inverse_kinematics]"))
 {
     // Create the Panda robot's BodyTree
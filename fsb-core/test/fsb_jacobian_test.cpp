@@ -498,4 +498,123 @@ TEST_CASE("Jacobian derivative from Hessian RPR" * doctest::description("[fsb_ja
     }
 }
 
+static void check_jacobian_equal(const fsb::Jacobian& expected, const fsb::Jacobian& actual)
+{
+    for (size_t index = 0U; index < expected.j.size(); ++index)
+    {
+        REQUIRE(expected.j[index] == FsbApprox(actual.j[index]));
+    }
+}
+
+TEST_CASE("Jacobian from joint axes" * doctest::description("[fsb_jacobian][fsb::calculate_jacobian_from_axes]"))
+{
+    const fsb::Transform joint1_tr = {{0.57072141808226, 0.575121276132167, 0.0939451898978092, 0.578521289130613}, {-0.872, 1.235, -0.02}};
+    const fsb::Transform joint2_tr = {{0.466361491477014, -0.571547679819811, -0.124868616337094, 0.663511897115633}, {0.12, 0.05, -0.01}};
+    const fsb::Transform joint3_tr = {{0.461283965309215, 0.607100248856612, 0.205771002489209, -0.613436782171915}, {0.1, -0.8, 1.4}};
+    constexpr fsb::MassProps unit_mass_props = { 1.0, {}, {1.0, 1.0, 1.0, 0.0, 0.0, 0.0}};
+    const fsb::CartesianPva base_pva = {{{0.713252796614972, 0.110018106106709, 0.314124660380793, 0.616840467374075}, {0.12, -0.34, 0.921}}, {}, {}};
+    size_t body_index = 3U;
+
+    fsb::BodyTree body_tree = {};
+    fsb::JointPva joint_pva = {};
+    SUBCASE("RPR with reversed prismatic joint")
+    {
+        body_tree = body_tree_sample_rpr(
+            joint1_tr, joint2_tr, joint3_tr, unit_mass_props, unit_mass_props, unit_mass_props, body_index);
+        REQUIRE(body_tree.set_joint_reversed(1U, true) == fsb::BodyTreeError::SUCCESS);
+        joint_pva.position = {{0.45, 1.73, 0.97}};
+    }
+    SUBCASE("SRS")
+    {
+        body_tree = body_tree_sample_srs(
+            joint1_tr, joint2_tr, joint3_tr, unit_mass_props, unit_mass_props, unit_mass_props, body_index);
+        joint_pva.position = {{0.2082929004216056, 0.45810638043384594, -0.6268184243409775, -0.5948539944780146, 1.73,
+                               0.44656205339018834, -0.5178471877140327, 0.7161490741756802, 0.13981103749676618}};
+    }
+    SUBCASE("Cartesian floating base with revolute joint")
+    {
+        auto err = fsb::BodyTreeError::SUCCESS;
+        const size_t floating_index = body_tree.add_massless_body(fsb::BodyTree::kBaseIndex, fsb::JointType::CARTESIAN, joint1_tr, {}, err);
+        REQUIRE(err == fsb::BodyTreeError::SUCCESS);
+        body_index = body_tree.add_massless_body(floating_index, fsb::JointType::REVOLUTE_X, joint2_tr, {}, err);
+        REQUIRE(err == fsb::BodyTreeError::SUCCESS);
+        joint_pva.position = {{0.4514982278748776, -0.7407761160842639, -0.022397671379960134, -0.4968887605709308, 0.3, -0.2, 0.1, 0.8}};
+    }
+    SUBCASE("Panda")
+    {
+        body_tree = create_panda_body_tree(body_index);
+        joint_pva.position = {{1.0, -0.32, 0.08, -2.15, 0.04, -2.0, 0.78}};
+    }
+
+    fsb::KinematicProgram program = {};
+    REQUIRE(fsb::kinematic_program_compile(body_tree, program));
+    fsb::BodyCartesianPva cartesian = {};
+    fsb::BodyJointAxes joint_axes = {};
+    fsb::forward_kinematics_program_axes(program, joint_pva, base_pva, fsb::ForwardKinematicsOption::POSE, cartesian, joint_axes);
+
+    for (size_t index = 0U; index < body_tree.get_num_bodies(); ++index)
+    {
+        fsb::Jacobian expected = {};
+        REQUIRE(fsb::calculate_jacobian(index, body_tree, cartesian, expected) == fsb::JacobianError::SUCCESS);
+        fsb::Jacobian actual = {};
+        REQUIRE(fsb::calculate_jacobian_from_axes(index, joint_axes, cartesian, actual) == fsb::JacobianError::SUCCESS);
+        check_jacobian_equal(expected, actual);
+    }
+    fsb::Jacobian invalid = {};
+    REQUIRE(fsb::calculate_jacobian_from_axes(body_tree.get_num_bodies(), joint_axes, cartesian, invalid) == fsb::JacobianError::BODY_NOT_IN_TREE);
+}
+
+TEST_CASE("Jacobians of leaf bodies" * doctest::description("[fsb_jacobian][fsb::calculate_jacobians]"))
+{
+    const fsb::Transform joint1_tr = {{0.57072141808226, 0.575121276132167, 0.0939451898978092, 0.578521289130613}, {-0.872, 1.235, -0.02}};
+    const fsb::Transform joint2_tr = {{0.466361491477014, -0.571547679819811, -0.124868616337094, 0.663511897115633}, {0.12, 0.05, -0.01}};
+    const fsb::Transform joint3_tr = {{0.461283965309215, 0.607100248856612, 0.205771002489209, -0.613436782171915}, {0.1, -0.8, 1.4}};
+    const fsb::CartesianPva base_pva = {{{0.713252796614972, 0.110018106106709, 0.314124660380793, 0.616840467374075}, {0.12, -0.34, 0.921}}, {}, {}};
+
+    // branched tree with three leaves
+    fsb::BodyTree body_tree = {};
+    auto err = fsb::BodyTreeError::SUCCESS;
+    const size_t body1 = body_tree.add_massless_body(fsb::BodyTree::kBaseIndex, fsb::JointType::REVOLUTE_Z, joint1_tr, {}, err);
+    REQUIRE(err == fsb::BodyTreeError::SUCCESS);
+    const size_t body2 = body_tree.add_massless_body(body1, fsb::JointType::PRISMATIC_Y, joint2_tr, {}, err);
+    REQUIRE(err == fsb::BodyTreeError::SUCCESS);
+    static_cast<void>(body_tree.add_massless_body(body2, fsb::JointType::SPHERICAL, joint3_tr, {}, err));
+    REQUIRE(err == fsb::BodyTreeError::SUCCESS);
+    static_cast<void>(body_tree.add_massless_body(body1, fsb::JointType::REVOLUTE_X, joint3_tr, {}, err));
+    REQUIRE(err == fsb::BodyTreeError::SUCCESS);
+    static_cast<void>(body_tree.add_massless_body(fsb::BodyTree::kBaseIndex, fsb::JointType::REVOLUTE_Y, joint2_tr, {}, err));
+    REQUIRE(err == fsb::BodyTreeError::SUCCESS);
+
+    const fsb::JointPva joint_pva = {
+        {{0.45, 1.73, 0.2082929004216056, 0.45810638043384594, -0.6268184243409775, -0.5948539944780146, -0.3, 0.97}}, {}, {}};
+    fsb::BodyCartesianPva cartesian = {};
+    fsb::forward_kinematics(body_tree, joint_pva, base_pva, fsb::ForwardKinematicsOption::POSE, cartesian);
+
+    size_t num_leaves = 0U;
+    const std::array<size_t, fsb::MaxSize::kBodies> leaves = body_tree.get_leaves(num_leaves);
+    REQUIRE(num_leaves == 3U);
+    std::array<fsb::Jacobian, fsb::MaxSize::kBodies> jacobians = {};
+    REQUIRE(fsb::calculate_jacobians(leaves, num_leaves, body_tree, cartesian, jacobians) == fsb::JacobianError::SUCCESS);
+    for (size_t index = 0U; index < num_leaves; ++index)
+    {
+        fsb::Jacobian expected = {};
+        REQUIRE(fsb::calculate_jacobian(leaves[index], body_tree, cartesian, expected) == fsb::JacobianError::SUCCESS);
+        check_jacobian_equal(expected, jacobians[index]);
+    }
+
+    // compiled program gives the same jacobians
+    fsb::KinematicProgram program = {};
+    REQUIRE(fsb::kinematic_program_compile(body_tree, program));
+    std::array<fsb::Jacobian, fsb::MaxSize::kBodies> program_jacobians = {};
+    REQUIRE(fsb::calculate_jacobians(leaves, num_leaves, program, cartesian, program_jacobians) == fsb::JacobianError::SUCCESS);
+    for (size_t index = 0U; index < num_leaves; ++index)
+    {
+        check_jacobian_equal(jacobians[index], program_jacobians[index]);
+    }
+
+    std::array<size_t, fsb::MaxSize::kBodies> invalid = leaves;
+    invalid[1U] = body_tree.get_num_bodies();
+    REQUIRE(fsb::calculate_jacobians(invalid, num_leaves, body_tree, cartesian, jacobians) == fsb::JacobianError::BODY_NOT_IN_TREE);
+}
+
 TEST_SUITE_END();
@@ -1,6 +1,7 @@
 #include <doctest/doctest.h>
 
 #include <array>
+#include <cmath>
 
 #include "fsb_test_macros.h"
 
@@ -8,6 +9,9 @@
 #include "fsb_jacobian.h"
 #include "fsb_joint.h"
 #include "fsb_kinematic_redundancy.h"
+#include "fsb_inverse_kinematics.h"
+#include "fsb_kinematics.h"
+#include "fsb_body_tree_sample.h"
 #include <iostream>
 
 TEST_SUITE_BEGIN("kinematic_redundancy");
@@ -256,6 +260,133 @@ TEST_CASE("Pseudoinverse works for rank-deficient Jacobian" * doctest::descripti
     }
 }
 
+TEST_CASE("Pseudoinverse with caller work array" * doctest::description("[fsb_kinematic_redundancy][fsb::jacobian_pseudoinverse]"))
+{
+    // 6x7 with rank 5: first 5 columns identity, remaining columns zero.
+    constexpr size_t dofs = 7U;
+    fsb::Jacobian jac = {};
+    for (size_t col = 0U; col < 5U; ++col)
+    {
+        jac.j[fsb::jacobian_index(col, col)] = 1.0;
+    }
+
+    fsb::Jacobian jac_pinv_expected = {};
+    REQUIRE(fsb::jacobian_pseudoinverse(jac, jac_pinv_expected, dofs) == EFSB_LAPACK_ERROR_NONE);
+
+    fsb::JacobianLinalgPlans plans = {};
+    REQUIRE(fsb::jacobian_linalg_plans_create(plans) == EFSB_LAPACK_ERROR_NONE);
+    REQUIRE(plans.leastsquares[dofs].work_len > 0U);
+    REQUIRE(plans.pseudoinverse[dofs].work_len <= fsb::MaxSize::kLinalgWork);
+    fsb::LinalgWork work;
+    fsb::Jacobian jac_pinv = {};
+    REQUIRE(fsb::jacobian_pseudoinverse(jac, jac_pinv, dofs, plans, work) == EFSB_LAPACK_ERROR_NONE);
+    // Jacobi decomposition converged without LAPACK work space
+    REQUIRE(work.get_used() == 0U);
+    REQUIRE(work.get_peak() == 0U);
+    for (size_t ind = 0U; ind < (dofs * 6U); ++ind)
+    {
+        REQUIRE(jac_pinv.j[ind] == FsbApprox(jac_pinv_expected.j[ind]));
+    }
+
+    // nullspace motion with the same work array
+    fsb::Jacobian jac_full = jac;
+    jac_full.j[fsb::jacobian_index(5U, 5U)] = 1.0;
+    const fsb::JointSpace qd = {{0.1, -0.2, 0.3, -0.4, 0.5, -0.6, 0.7}};
+    const fsb::JointSpace qn = fsb::compute_nullspace_motion(jac_full, qd, dofs, plans, work);
+    REQUIRE(work.get_used() == 0U);
+    for (size_t ind = 0U; ind < 6U; ++ind)
+    {
+        REQUIRE(qn.qv[ind] == FsbApprox(0.0));
+    }
+    REQUIRE(qn.qv[6U] == FsbApprox(qd.qv[6U]));
+
+    // least squares fallback of rank deficient Jacobian runs on the planned work space
+    const fsb::MotionVector cart_velocity = {{0.1, 0.2, 0.3}, {0.4, 0.5, 0.0}};
+    fsb::JointSpace joint_velocity = {};
+    (void)fsb::inverse_velocity_kinematics(jac, cart_velocity, dofs, joint_velocity, plans, work);
+    REQUIRE(work.get_used() == 0U);
+    REQUIRE(work.get_peak() == plans.leastsquares[dofs].work_len);
+}
+
+TEST_CASE("Pseudoinverse at maximum degrees of freedom" * doctest::description("[fsb_kinematic_redundancy][fsb::jacobian_pseudoinverse]"))
+{
+    // beyond the fixed size decomposition for configurations with more than 12 degrees of freedom
+    constexpr size_t dofs = fsb::MaxSize::kDofs;
+    fsb::Jacobian jac = {};
+    for (size_t col = 0U; col < dofs; ++col)
+    {
+        for (size_t row = 0U; row < 6U; ++row)
+        {
+            jac.j[fsb::jacobian_index(row, col)] = std::sin(static_cast<double>(1U + row + (7U * col)));
+        }
+    }
+
+    std::array<double_t, fsb::MaxSize::kLinalgWork> lapack_work = {};
+    fsb::Jacobian pinv_expected = {};
+    REQUIRE(fsb_linalg_pseudoinverse(jac.j.data(), 6U, dofs, lapack_work.size(), lapack_work.data(), pinv_expected.j.data()) == EFSB_LAPACK_ERROR_NONE);
+
+    fsb::JacobianLinalgPlans plans = {};
+    REQUIRE(fsb::jacobian_linalg_plans_create(plans) == EFSB_LAPACK_ERROR_NONE);
+    fsb::LinalgWork work;
+    fsb::Jacobian pinv = {};
+    REQUIRE(fsb::jacobian_pseudoinverse(jac, pinv, dofs, plans, work) == EFSB_LAPACK_ERROR_NONE);
+    REQUIRE(work.get_used() == 0U);
+    fsb::Jacobian pinv_default = {};
+    REQUIRE(fsb::jacobian_pseudoinverse(jac, pinv_default, dofs) == EFSB_LAPACK_ERROR_NONE);
+    for (size_t ind = 0U; ind < (6U * dofs); ++ind)
+    {
+        REQUIRE(pinv.j[ind] == FsbApprox(pinv_expected.j[ind], 1.0e-8));
+        REQUIRE(pinv_default.j[ind] == FsbApprox(pinv_expected.j[ind], 1.0e-8));
+    }
+}
+
+TEST_CASE("Jacobian SVD warm start along trajectory" * doctest::description("[fsb_kinematic_redundancy][fsb::JacobianSvd]"))
+{
+    size_t ee_index = 0U;
+    const fsb::BodyTree body_tree = create_panda_body_tree(ee_index);
+    const size_t dofs = body_tree.get_num_dofs();
+    fsb::JointPva joint_pva = {};
+    joint_pva.position = {{1.0, -0.32, 0.08, -2.15, 0.04, -2.0, 0.78}};
+    fsb::CartesianPva base_pva = {};
+    base_pva.pose = fsb::transform_identity();
+
+    fsb::JacobianSvd svd = {};
+    for (size_t step = 0U; step < 10U; ++step)
+    {
+        fsb::BodyCartesianPva cartesian_pva = {};
+        fsb::forward_kinematics(body_tree, joint_pva, base_pva, fsb::ForwardKinematicsOption::POSE, cartesian_pva);
+        fsb::Jacobian jac = {};
+        REQUIRE(fsb::calculate_jacobian(ee_index, body_tree, cartesian_pva, jac) == fsb::JacobianError::SUCCESS);
+        REQUIRE(svd.update(jac, dofs) == EFSB_LAPACK_ERROR_NONE);
+        if (step > 0U)
+        {
+            REQUIRE(svd.get_sweeps() <= 3U);
+        }
+
+        // pseudoinverse matches LAPACK
+        std::array<double_t, 1024U> work = {};
+        fsb::Jacobian pinv_expected = {};
+        REQUIRE(fsb_linalg_pseudoinverse(jac.j.data(), 6U, dofs, 1024U, work.data(), pinv_expected.j.data()) == EFSB_LAPACK_ERROR_NONE);
+        fsb::Jacobian pinv = {};
+        svd.pseudoinverse(0.0, 1.0e-12, pinv);
+        for (size_t ind = 0U; ind < (6U * dofs); ++ind)
+        {
+            REQUIRE(pinv.j[ind] == FsbApprox(pinv_expected.j[ind], 1.0e-8));
+        }
+
+        // singular values only
+        const fsb::Real manipulability = svd.get_manipulability();
+        REQUIRE(manipulability > 0.0);
+        REQUIRE(svd.update_singular_values(jac, dofs) == EFSB_LAPACK_ERROR_NONE);
+        REQUIRE(svd.get_manipulability() == FsbApprox(manipulability, 1.0e-10));
+
+        for (size_t ind = 0U; ind < dofs; ++ind)
+        {
+            joint_pva.position.q[ind] += 0.002;
+        }
+    }
+}
+
 TEST_CASE("Nullspace motion is zero for 6x6 identity Jacobian" * doctest::description("[fsb_kinematic_redundancy][fsb::compute_nullspace_motion]"))
 {
     constexpr size_t dofs = 6U;
@@ -361,4 +492,130 @@ TEST_CASE("Joint limit avoidance pushes away from limits and clamps" * doctest::
     REQUIRE(qd_clamped.qv[0] == FsbApprox(0.05));
 }
 
+TEST_CASE("Task priority controller Panda" * doctest::description("[fsb_kinematic_redundancy][fsb::TaskPriorityController]"))
+{
+    constexpr size_t dofs = 7U;
+    const fsb::Jacobian jac = {{-0.32983697206672097, 0.17135057568505976, 0.0, 0.0, 0.0, 1.0, 0.24059937623889344, 0.374711327101604, -0.37012935286550924, -0.8414709848078963, 0.5403023058681395, 2.220446049250313e-16, -0.4309645894690529, 0.2383365536189267, -0.010703170917977886, -0.16996103804989837, -0.26469863354927736, 0.9492354180824409, -0.06537472209909931, -0.10037581974562429, 0.3922998357104994, 0.8797658890242653, -0.474742073981774, 0.025138490424573168, 0.11718056947053287, -0.06479866161461803, -0.001809611832704249, 0.4646023860415935, 0.8473588454165946, -0.25715289222311233, -0.06704004103038955, -0.12123783396091165, 0.00014323096740403995, 0.8750320460436324, -0.48387634323441875, -0.013513062376045326, -7.632783294297951e-17, 3.469446951953614e-17, 4.445228907190568e-18, 0.3168987059365215, 0.5515243494818595, 0.771619143168681}};
+    const fsb::MotionVector cart_velocity = {{0.1, -0.2, 0.05}, {0.3, 0.1, -0.15}};
+    constexpr double eps = 1.0e-6;
+
+    fsb::TaskPriorityController controller = {};
+    fsb::JointSpace qd = {};
+    controller.reset(0U);
+    REQUIRE(controller.solve(qd) == EFSB_LAPACK_ERROR_INPUT);
+
+    // single task without damping is the minimum norm least squares solution
+    controller.reset(dofs);
+    REQUIRE(controller.add_cartesian_task(jac, cart_velocity, 0.0));
+    REQUIRE(controller.solve(qd) == EFSB_LAPACK_ERROR_NONE);
+    fsb::JointSpace qd_expected = {};
+    REQUIRE(fsb::inverse_velocity_kinematics(jac, cart_velocity, dofs, qd_expected) == EFSB_LAPACK_ERROR_NONE);
+    for (size_t ind = 0U; ind < dofs; ++ind)
+    {
+        REQUIRE(qd.qv[ind] == FsbApprox(qd_expected.qv[ind], eps));
+    }
+
+    // posture task is resolved in the nullspace of the Cartesian task
+    fsb::JointSpace posture = {};
+    posture.qv = {0.2, -0.1, 0.3, 0.0, -0.4, 0.1, 0.5};
+    const fsb::JointSpace posture_null = fsb::compute_nullspace_motion(jac, posture, dofs);
+    controller.reset(dofs);
+    REQUIRE(controller.add_cartesian_task(jac, cart_velocity, 0.0));
+    REQUIRE(controller.add_joint_task(posture));
+    REQUIRE(controller.get_num_tasks() == 2U);
+    REQUIRE(controller.solve(qd) == EFSB_LAPACK_ERROR_NONE);
+    for (size_t ind = 0U; ind < dofs; ++ind)
+    {
+        REQUIRE(qd.qv[ind] == FsbApprox(qd_expected.qv[ind] + posture_null.qv[ind], eps));
+    }
+    const fsb::MotionVector achieved = fsb::jacobian_multiply(jac, qd, dofs);
+    REQUIRE(achieved.angular.x == FsbApprox(cart_velocity.angular.x, eps));
+    REQUIRE(achieved.angular.y == FsbApprox(cart_velocity.angular.y, eps));
+    REQUIRE(achieved.angular.z == FsbApprox(cart_velocity.angular.z, eps));
+    REQUIRE(achieved.linear.x == FsbApprox(cart_velocity.linear.x, eps));
+    REQUIRE(achieved.linear.y == FsbApprox(cart_velocity.linear.y, eps));
+    REQUIRE(achieved.linear.z == FsbApprox(cart_velocity.linear.z, eps));
+
+    // joint space is exhausted after Cartesian and posture task
+    const fsb::JointMatrix& nullspace = controller.get_nullspace_projector();
+    for (size_t ind = 0U; ind < dofs * dofs; ++ind)
+    {
+        REQUIRE(nullspace.j[ind] == FsbApprox(0.0, 1.0e-5));
+    }
+
+    // singular task without damping
+    const fsb::Jacobian zero_jac = {};
+    controller.reset(dofs);
+    REQUIRE(controller.add_cartesian_task(zero_jac, cart_velocity, 0.0));
+    REQUIRE(controller.solve(qd) == EFSB_LAPACK_NOT_POSITIVE_DEFINITE);
+
+    // task stack is bounded
+    controller.reset(dofs);
+    for (size_t task = 0U; task < fsb::kTaskPriorityMaxTasks; ++task)
+    {
+        REQUIRE(controller.add_joint_task(posture));
+    }
+    REQUIRE_FALSE(controller.add_joint_task(posture));
+}
+
+TEST_CASE("Task priority controller at maximum degrees of freedom" * doctest::description("[fsb_kinematic_redundancy][fsb::TaskPriorityController]"))
+{
+    // joint task has as many rows as degrees of freedom, beyond the fixed size Cholesky solver
+    // for configurations with more than 12 degrees of freedom
+    constexpr size_t dofs = fsb::MaxSize::kDofs;
+    fsb::Jacobian jac = {};
+    fsb::JointSpace posture = {};
+    for (size_t col = 0U; col < dofs; ++col)
+    {
+        for (size_t row = 0U; row < 6U; ++row)
+        {
+            jac.j[fsb::jacobian_index(row, col)] = std::sin(static_cast<double>(1U + row + (7U * col) + (row * col)));
+        }
+        posture.qv[col] = 0.1 * std::cos(static_cast<double>(col));
+    }
+    const fsb::MotionVector cart_velocity = {{0.1, -0.2, 0.05}, {0.3, 0.1, -0.15}};
+    constexpr double eps = 1.0e-6;
+
+    // expected velocity J^+ xd + (I - J^+ J) qd_posture / (1 + damping), the damped posture task
+    // is scaled on the nullspace projector
+    constexpr double damping = 1.0e-6;
+    fsb::Jacobian pinv = {};
+    REQUIRE(fsb::jacobian_pseudoinverse(jac, pinv, dofs) == EFSB_LAPACK_ERROR_NONE);
+    const fsb::MotionVector posture_velocity = fsb::jacobian_multiply(jac, posture, dofs);
+    const std::array<fsb::Real, 6U> posture_cart = {
+        posture_velocity.angular.x, posture_velocity.angular.y, posture_velocity.angular.z,
+        posture_velocity.linear.x, posture_velocity.linear.y, posture_velocity.linear.z};
+    const std::array<fsb::Real, 6U> cart = {
+        cart_velocity.angular.x, cart_velocity.angular.y, cart_velocity.angular.z,
+        cart_velocity.linear.x, cart_velocity.linear.y, cart_velocity.linear.z};
+    fsb::JointSpace qd_expected = {};
+    for (size_t col = 0U; col < dofs; ++col)
+    {
+        fsb::Real task_value = 0.0;
+        fsb::Real posture_value = posture.qv[col];
+        for (size_t row = 0U; row < 6U; ++row)
+        {
+            task_value += pinv.j[fsb::joint_matrix_index(col, row, dofs)] * cart[row];
+            posture_value -= pinv.j[fsb::joint_matrix_index(col, row, dofs)] * posture_cart[row];
+        }
+        qd_expected.qv[col] = task_value + (posture_value / (1.0 + damping));
+    }
+
+    fsb::TaskPriorityController controller = {};
+    fsb::JointSpace qd = {};
+    controller.reset(dofs);
+    REQUIRE(controller.add_cartesian_task(jac, cart_velocity, 0.0));
+    REQUIRE(controller.add_joint_task(posture, damping));
+    REQUIRE(controller.solve(qd) == EFSB_LAPACK_ERROR_NONE);
+    for (size_t ind = 0U; ind < dofs; ++ind)
+    {
+        REQUIRE(qd.qv[ind] == FsbApprox(qd_expected.qv[ind], eps));
+    }
+    const fsb::JointMatrix& nullspace = controller.get_nullspace_projector();
+    for (size_t ind = 0U; ind < dofs * dofs; ++ind)
+    {
+        REQUIRE(nullspace.j[ind] == FsbApprox(0.0, 1.0e-5));
+    }
+}
+
 TEST_SUITE_END();
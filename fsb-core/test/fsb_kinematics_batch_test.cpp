@@ -0,0 +1,212 @@
+#include <doctest/doctest.h>
+#include <array>
+#include <cmath>
+#include "fsb_test_macros.h"
+#include "fsb_kinematics.h"
+#include "fsb_kinematics_batch.h"
+#include "fsb_quaternion.h"
+#include "fsb_body_tree_sample.h"
+
+TEST_SUITE_BEGIN("kinematics_batch");
+
+static void check_batch_lane(
+    const fsb::BodyTree& body_tree, const fsb::JointSpacePosition& joint_position,
+    const fsb::Transform& base_pose, const fsb::BodyTransformBatch& batch_pose, const size_t lane)
+{
+    const fsb::JointPva joint_pva = {joint_position, {}, {}};
+    const fsb::CartesianPva base_pva = {base_pose, {}, {}};
+    fsb::BodyCartesianPva expected_pva = {};
+    fsb::forward_kinematics(body_tree, joint_pva, base_pva, fsb::ForwardKinematicsOption::POSE, expected_pva);
+
+    for (size_t body_index = 0U; body_index < body_tree.get_num_bodies(); ++body_index)
+    {
+        const fsb::Transform& expected = expected_pva.body[body_index].pose;
+        const fsb::Transform actual = fsb::batch_get_body_pose(batch_pose, body_index, lane);
+        const fsb::MotionVector error = fsb::coord_transform_get_error(expected, actual);
+        REQUIRE(fsb::vector_norm(error.linear) == FsbApprox(0.0, 1.0e-12));
+        REQUIRE(fsb::vector_norm(error.angular) == FsbApprox(0.0, 1.0e-12));
+        REQUIRE(actual.rotation.qw >= 0.0);
+    }
+}
+
+TEST_CASE("Batch forward kinematics Panda" * doctest::description("[fsb_kinematics_batch][fsb::forward_kinematics_batch]"))
+{
+    size_t ee_index = 0U;
+    const fsb::BodyTree body_tree = create_panda_body_tree(ee_index);
+    const fsb::Transform base_pose = {{0.9238795325112867, 0.0, 0.0, 0.3826834323650898}, {0.1, -0.2, 0.05}};
+
+    // distinct configuration per lane
+    std::array<fsb::JointSpacePosition, fsb::kKinematicsBatchSize> joint_positions = {};
+    fsb::JointSpacePositionBatch joint_batch = {};
+    for (size_t lane = 0U; lane < fsb::kKinematicsBatchSize; ++lane)
+    {
+        const auto offset = static_cast<fsb::Real>(lane) * 0.37;
+        joint_positions[lane] = {{
+            1.0 - offset, -0.32 + offset, 0.08, -2.15 + 0.5 * offset, 0.04 - offset, -2.0, 0.78 + offset}};
+        fsb::batch_set_joint_position(lane, joint_positions[lane], joint_batch);
+    }
+
+    fsb::BodyTransformBatch batch_pose = {};
+    fsb::forward_kinematics_batch(body_tree, joint_batch, base_pose, batch_pose);
+
+    for (size_t lane = 0U; lane < fsb::kKinematicsBatchSize; ++lane)
+    {
+        check_batch_lane(body_tree, joint_positions[lane], base_pose, batch_pose, lane);
+    }
+}
+
+TEST_CASE("Batch forward kinematics RPR and SRS" * doctest::description("[fsb_kinematics_batch][fsb::forward_kinematics_batch]"))
+{
+    const fsb::Transform joint1_tr = {{0.57072141808226, 0.575121276132167, 0.0939451898978092, 0.578521289130613}, {-0.872, 1.235, -0.02}};
+    const fsb::Transform joint2_tr = {{0.466361491477014, -0.571547679819811, -0.124868616337094, 0.663511897115633}, {0.12, 0.05, -0.01}};
+    const fsb::Transform joint3_tr = {{0.461283965309215, 0.607100248856612, 0.205771002489209, -0.613436782171915}, {0.1, -0.8, 1.4}};
+    const fsb::Transform base_pose = {{0.713252796614972, 0.110018106106709, 0.314124660380793, 0.616840467374075}, {0.12, -0.34, 0.921}};
+    constexpr fsb::MassProps unit_mass_props = { 1.0, {}, {1.0, 1.0, 1.0, 0.0, 0.0, 0.0}};
+    size_t body3_index = 3U;
+
+    SUBCASE("RPR")
+    {
+        const fsb::BodyTree body_tree = body_tree_sample_rpr(
+            joint1_tr, joint2_tr, joint3_tr, unit_mass_props, unit_mass_props, unit_mass_props, body3_index);
+        std::array<fsb::JointSpacePosition, fsb::kKinematicsBatchSize> joint_positions = {};
+        fsb::JointSpacePositionBatch joint_batch = {};
+        for (size_t lane = 0U; lane < fsb::kKinematicsBatchSize; ++lane)
+        {
+            const auto offset = static_cast<fsb::Real>(lane) * 0.21;
+            joint_positions[lane] = {{0.45 + offset, 1.73 - offset, 0.97 - 2.0 * offset}};
+            fsb::batch_set_joint_position(lane, joint_positions[lane], joint_batch);
+        }
+        fsb::BodyTransformBatch batch_pose = {};
+        fsb::forward_kinematics_batch(body_tree, joint_batch, base_pose, batch_pose);
+        for (size_t lane = 0U; lane < fsb::kKinematicsBatchSize; ++lane)
+        {
+            check_batch_lane(body_tree, joint_positions[lane], base_pose, batch_pose, lane);
+        }
+    }
+
+    SUBCASE("SRS")
+    {
+        const fsb::BodyTree body_tree = body_tree_sample_srs(
+            joint1_tr, joint2_tr, joint3_tr, unit_mass_props, unit_mass_props, unit_mass_props, body3_index);
+        std::array<fsb::JointSpacePosition, fsb::kKinematicsBatchSize> joint_positions = {};
+        fsb::JointSpacePositionBatch joint_batch = {};
+        for (size_t lane = 0U; lane < fsb::kKinematicsBatchSize; ++lane)
+        {
+            const auto offset = static_cast<fsb::Real>(lane) * 0.21;
+            const fsb::Quaternion quat1 = fsb::quat_rx(0.3 + offset);
+            const fsb::Quaternion quat3 = fsb::quat_multiply(fsb::quat_ry(offset), fsb::quat_rz(-0.7));
+            joint_positions[lane] = {{
+                quat1.qw, quat1.qx, quat1.qy, quat1.qz, 1.73 - offset, quat3.qw, quat3.qx, quat3.qy, quat3.qz}};
+            fsb::batch_set_joint_position(lane, joint_positions[lane], joint_batch);
+        }
+        fsb::BodyTransformBatch batch_pose = {};
+        fsb::forward_kinematics_batch(body_tree, joint_batch, base_pose, batch_pose);
+        for (size_t lane = 0U; lane < fsb::kKinematicsBatchSize; ++lane)
+        {
+            check_batch_lane(body_tree, joint_positions[lane], base_pose, batch_pose, lane);
+        }
+    }
+}
+
+TEST_CASE("Batch forward kinematics prismatic and Cartesian joints" * doctest::description("[fsb_kinematics_batch][fsb::forward_kinematics_batch]"))
+{
+    using fsb::JointType;
+    auto          err = fsb::BodyTreeError::SUCCESS;
+    fsb::BodyTree body_tree = {};
+    const fsb::Body body = {{}, {1.0, {}, {1.0, 1.0, 1.0, 0.0, 0.0, 0.0}}, {}, 0U, false};
+    const fsb::Transform tr_a = {{0.9238795325112867, 0.0, 0.3826834323650898, 0.0}, {0.1, 0.0, 0.3}};
+    const fsb::Transform tr_b = {{0.8660254037844387, 0.5, 0.0, 0.0}, {0.0, 0.2, 0.1}};
+    const fsb::Transform tr_c = {{0.7071067811865476, 0.0, 0.0, 0.7071067811865476}, {0.3, -0.1, 0.0}};
+    const fsb::Transform tr_d = {{0.9659258262890683, 0.0, -0.25881904510252074, 0.0}, {0.0, 0.15, 0.05}};
+    const fsb::Transform tr_e = {{1.0, 0.0, 0.0, 0.0}, {0.05, 0.0, 0.25}};
+
+    // Cartesian base joint, reversed prismatic, prismatic and reversed revolute chain, spherical branch
+    const size_t index_a = body_tree.add_body(fsb::BodyTree::kBaseIndex, JointType::CARTESIAN, tr_a, body, err);
+    REQUIRE(err == fsb::BodyTreeError::SUCCESS);
+    const size_t index_b = body_tree.add_body(index_a, JointType::PRISMATIC_X, tr_b, body, err);
+    REQUIRE(err == fsb::BodyTreeError::SUCCESS);
+    const size_t index_c = body_tree.add_body(index_b, JointType::PRISMATIC_Y, tr_c, body, err);
+    REQUIRE(err == fsb::BodyTreeError::SUCCESS);
+    const size_t index_d = body_tree.add_body(index_c, JointType::REVOLUTE_Y, tr_d, body, err);
+    REQUIRE(err == fsb::BodyTreeError::SUCCESS);
+    (void)body_tree.add_body(index_d, JointType::FIXED, tr_e, body, err);
+    REQUIRE(err == fsb::BodyTreeError::SUCCESS);
+    (void)body_tree.add_body(index_a, JointType::SPHERICAL, tr_e, body, err);
+    REQUIRE(err == fsb::BodyTreeError::SUCCESS);
+    REQUIRE(body_tree.set_joint_reversed(body_tree.get_body(index_b, err).joint_index, true) == fsb::BodyTreeError::SUCCESS);
+    REQUIRE(body_tree.set_joint_reversed(body_tree.get_body(index_d, err).joint_index, true) == fsb::BodyTreeError::SUCCESS);
+
+    const fsb::Transform base_pose = {{0.713252796614972, 0.110018106106709, 0.314124660380793, 0.616840467374075}, {0.12, -0.34, 0.921}};
+    std::array<fsb::JointSpacePosition, fsb::kKinematicsBatchSize> joint_positions = {};
+    fsb::JointSpacePositionBatch joint_batch = {};
+    for (size_t lane = 0U; lane < fsb::kKinematicsBatchSize; ++lane)
+    {
+        const auto offset = static_cast<fsb::Real>(lane) * 0.43;
+        const fsb::Quaternion quat_a = fsb::quat_multiply(fsb::quat_rz(offset), fsb::quat_rx(0.4 - offset));
+        const fsb::Quaternion quat_f = fsb::quat_ry(-1.2 + offset);
+        joint_positions[lane] = {{
+            quat_a.qw, quat_a.qx, quat_a.qy, quat_a.qz, 0.4 - offset, -0.2, 0.7 + offset,
+            0.12 - offset, -0.6 + 0.5 * offset, 2.0 - 1.5 * offset,
+            quat_f.qw, quat_f.qx, quat_f.qy, quat_f.qz}};
+        fsb::batch_set_joint_position(lane, joint_positions[lane], joint_batch);
+    }
+
+    fsb::BodyTransformBatch batch_pose = {};
+    fsb::forward_kinematics_batch(body_tree, joint_batch, base_pose, batch_pose);
+    for (size_t lane = 0U; lane < fsb::kKinematicsBatchSize; ++lane)
+    {
+        check_batch_lane(body_tree, joint_positions[lane], base_pose, batch_pose, lane);
+    }
+}
+
+TEST_CASE("Batch forward kinematics of many configurations" * doctest::description("[fsb_kinematics_batch][fsb::forward_kinematics_batch]"))
+{
+    size_t ee_index = 0U;
+    const fsb::BodyTree body_tree = create_panda_body_tree(ee_index);
+    const fsb::Transform base_pose = {{0.9238795325112867, 0.0, 0.0, 0.3826834323650898}, {0.1, -0.2, 0.05}};
+
+    // partial last block, angles in all quadrants and beyond the polynomial range
+    constexpr size_t num_configurations = 2U * fsb::kKinematicsBatchSize + 3U;
+    std::array<fsb::JointSpacePosition, num_configurations> joint_positions = {};
+    for (size_t config = 0U; config < num_configurations; ++config)
+    {
+        for (size_t coord = 0U; coord < 7U; ++coord)
+        {
+            joint_positions[config].q[coord]
+                = 7.0 * std::sin(0.37 * static_cast<fsb::Real>(config) + 1.3 * static_cast<fsb::Real>(coord));
+        }
+    }
+    joint_positions[4U].q[2U] = M_PI;
+    joint_positions[5U].q[3U] = -M_PI;
+    joint_positions[6U].q[6U] = 3.0e7 + 0.25;
+
+    fsb::KinematicProgram program = {};
+    REQUIRE(fsb::kinematic_program_compile(body_tree, program));
+    fsb::KinematicProgram chain = {};
+    REQUIRE(fsb::kinematic_program_compile_chain(body_tree, ee_index, chain));
+    std::array<fsb::Transform, num_configurations> ee_pose = {};
+    std::array<fsb::Transform, num_configurations> chain_pose = {};
+    REQUIRE(fsb::forward_kinematics_batch(program, joint_positions.data(), num_configurations, base_pose, ee_index, ee_pose.data()));
+    REQUIRE(fsb::forward_kinematics_batch(chain, joint_positions.data(), num_configurations, base_pose, ee_index, chain_pose.data()));
+
+    for (size_t config = 0U; config < num_configurations; ++config)
+    {
+        const fsb::JointPva joint_pva = {joint_positions[config], {}, {}};
+        fsb::BodyCartesianPva expected_pva = {};
+        fsb::forward_kinematics(body_tree, joint_pva, {base_pose, {}, {}}, fsb::ForwardKinematicsOption::POSE, expected_pva);
+        const fsb::Transform& expected = expected_pva.body[ee_index].pose;
+        for (const fsb::Transform& actual : {ee_pose[config], chain_pose[config]})
+        {
+            const fsb::MotionVector error = fsb::coord_transform_get_error(expected, actual);
+            REQUIRE(fsb::vector_norm(error.linear) == FsbApprox(0.0, 1.0e-12));
+            REQUIRE(fsb::vector_norm(error.angular) == FsbApprox(0.0, 1.0e-12));
+            REQUIRE(actual.rotation.qw >= 0.0);
+        }
+    }
+
+    // invalid body and no configurations
+    REQUIRE_FALSE(fsb::forward_kinematics_batch(program, joint_positions.data(), num_configurations, base_pose, body_tree.get_num_bodies(), ee_pose.data()));
+    REQUIRE(fsb::forward_kinematics_batch(program, joint_positions.data(), 0U, base_pose, ee_index, ee_pose.data()));
+}
+
+TEST_SUITE_END();
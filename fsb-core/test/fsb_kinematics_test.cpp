@@ -1,6 +1,7 @@
 #include <doctest/doctest.h>
 #include "fsb_test_macros.h"
 #include "fsb_kinematics.h"
+#include "fsb_quaternion.h"
 #include "fsb_body_tree_sample.h"
 
 TEST_SUITE_BEGIN("kinematics");
@@ -392,4 +393,136 @@ TEST_CASE("Forward Kinematics SRS" * doctest::description("[fsb_kinematics][fsb:
     REQUIRE(expected_body3_pva.acceleration.angular.y == FsbApprox(acceleration.angular.y));
     REQUIRE(expected_body3_pva.acceleration.angular.z == FsbApprox(acceleration.angular.z));
 }
+
+static void check_cartesian_pva(const fsb::CartesianPva& expected, const fsb::CartesianPva& actual)
+{
+    REQUIRE(expected.pose.translation.x == FsbApprox(actual.pose.translation.x));
+    REQUIRE(expected.pose.translation.y == FsbApprox(actual.pose.translation.y));
+    REQUIRE(expected.pose.translation.z == FsbApprox(actual.pose.translation.z));
+    REQUIRE(expected.pose.rotation.qw == FsbApprox(actual.pose.rotation.qw));
+    REQUIRE(expected.pose.rotation.qx == FsbApprox(actual.pose.rotation.qx));
+    REQUIRE(expected.pose.rotation.qy == FsbApprox(actual.pose.rotation.qy));
+    REQUIRE(expected.pose.rotation.qz == FsbApprox(actual.pose.rotation.qz));
+    REQUIRE(expected.velocity.angular.x == FsbApprox(actual.velocity.angular.x));
+    REQUIRE(expected.velocity.angular.y == FsbApprox(actual.velocity.angular.y));
+    REQUIRE(expected.velocity.angular.z == FsbApprox(actual.velocity.angular.z));
+    REQUIRE(expected.velocity.linear.x == FsbApprox(actual.velocity.linear.x));
+    REQUIRE(expected.velocity.linear.y == FsbApprox(actual.velocity.linear.y));
+    REQUIRE(expected.velocity.linear.z == FsbApprox(actual.velocity.linear.z));
+    REQUIRE(expected.acceleration.angular.x == FsbApprox(actual.acceleration.angular.x));
+    REQUIRE(expected.acceleration.angular.y == FsbApprox(actual.acceleration.angular.y));
+    REQUIRE(expected.acceleration.angular.z == FsbApprox(actual.acceleration.angular.z));
+    REQUIRE(expected.acceleration.linear.x == FsbApprox(actual.acceleration.linear.x));
+    REQUIRE(expected.acceleration.linear.y == FsbApprox(actual.acceleration.linear.y));
+    REQUIRE(expected.acceleration.linear.z == FsbApprox(actual.acceleration.linear.z));
+}
+
+TEST_CASE("Forward Kinematics compiled program" * doctest::description("[fsb_kinematics][fsb::forward_kinematics_program]"))
+{
+    const fsb::Transform joint1_tr = {{0.57072141808226, 0.575121276132167, 0.0939451898978092, 0.578521289130613}, {-0.872, 1.235, -0.02}};
+    const fsb::Transform joint2_tr = {{0.466361491477014, -0.571547679819811, -0.124868616337094, 0.663511897115633}, {0.12, 0.05, -0.01}};
+    const fsb::Transform joint3_tr = {{0.461283965309215, 0.607100248856612, 0.205771002489209, -0.613436782171915}, {0.1, -0.8, 1.4}};
+    const fsb::CartesianPva base_pva = {
+        {{0.713252796614972, 0.110018106106709, 0.314124660380793, 0.616840467374075}, {0.12, -0.34, 0.921}},
+        {{0.123, -0.2, 0.2432}, {-0.9, 0.62, 0.89}},
+        {{0.8268, 0.2647, -0.8049}, {-0.443, 0.0938, 0.915}}
+    };
+    constexpr fsb::MassProps unit_mass_props = { 1.0, {}, {1.0, 1.0, 1.0, 0.0, 0.0, 0.0}};
+    size_t body3_index = 3U;
+
+    fsb::BodyTree body_tree = {};
+    fsb::JointPva joint_pva = {};
+    SUBCASE("RPR with reversed prismatic joint")
+    {
+        body_tree = body_tree_sample_rpr(
+            joint1_tr, joint2_tr, joint3_tr, unit_mass_props, unit_mass_props, unit_mass_props, body3_index);
+        REQUIRE(body_tree.set_joint_reversed(1U, true) == fsb::BodyTreeError::SUCCESS);
+        joint_pva = {{0.45, 1.73, 0.97}, {-0.5, 0.71, -0.43}, {1.5, 1.03, 0.62}};
+    }
+    SUBCASE("SRS with reversed revolute joint")
+    {
+        body_tree = body_tree_sample_srs(
+            joint1_tr, joint2_tr, joint3_tr, unit_mass_props, unit_mass_props, unit_mass_props, body3_index);
+        REQUIRE(body_tree.set_joint_reversed(1U, true) == fsb::BodyTreeError::SUCCESS);
+        joint_pva = {
+            {{0.2082929004216056, 0.45810638043384594, -0.6268184243409775, -0.5948539944780146, 1.73,
+              0.44656205339018834, -0.5178471877140327, 0.7161490741756802, 0.13981103749676618}},
+            {{-0.51, 0.003, 0.443, 0.71, 0.0066, -0.1, 0.02}},
+            {{0.022, -1.23, 0.998, 1.03, 1.0, 2.1, -0.82}}
+        };
+    }
+    SUBCASE("Panda")
+    {
+        body_tree = create_panda_body_tree(body3_index);
+        joint_pva = {
+            {{1.0, -0.32, 0.08, -2.15, 0.04, -2.0, 0.78}},
+            {{0.1, 0.2, -0.3, 0.4, -0.5, 0.6, -0.7}},
+            {{-1.0, 0.9, 0.8, -0.7, 0.6, 0.5, 0.4}}
+        };
+    }
+
+    fsb::KinematicProgram program = {};
+    REQUIRE(fsb::kinematic_program_compile(body_tree, program));
+    REQUIRE(program.num_ops + 1U == body_tree.get_num_bodies());
+
+    const auto opt = fsb::ForwardKinematicsOption::POSE_VELOCITY_ACCELERATION;
+    fsb::BodyCartesianPva expected_body_pva = {};
+    fsb::forward_kinematics(body_tree, joint_pva, base_pva, opt, expected_body_pva);
+    fsb::BodyCartesianPva actual_body_pva = {};
+    fsb::forward_kinematics_program(program, joint_pva, base_pva, opt, actual_body_pva);
+
+    for (size_t body_index = 0U; body_index < body_tree.get_num_bodies(); ++body_index)
+    {
+        check_cartesian_pva(expected_body_pva.body[body_index], actual_body_pva.body[body_index]);
+    }
+}
+
+TEST_CASE("Forward Kinematics chain of branched tree" * doctest::description("[fsb_kinematics][fsb::forward_kinematics_chain]"))
+{
+    // two arms attached to the base
+    auto err = fsb::BodyTreeError::SUCCESS;
+    fsb::BodyTree body_tree = {};
+    fsb::Transform shoulder_a = fsb::transform_identity();
+    shoulder_a.translation = {0.0, 0.3, 0.5};
+    fsb::Transform shoulder_b = fsb::transform_identity();
+    shoulder_b.translation = {0.0, -0.3, 0.5};
+    fsb::Transform elbow = {fsb::quat_rx(-0.5), {0.0, 0.0, 0.4}};
+    const size_t arm_a1 = body_tree.add_massless_body(fsb::BodyTree::kBaseIndex, fsb::JointType::REVOLUTE_Z, shoulder_a, {}, err);
+    const size_t arm_a2 = body_tree.add_massless_body(arm_a1, fsb::JointType::REVOLUTE_Y, elbow, {}, err);
+    const size_t arm_b1 = body_tree.add_massless_body(fsb::BodyTree::kBaseIndex, fsb::JointType::REVOLUTE_Z, shoulder_b, {}, err);
+    const size_t arm_b2 = body_tree.add_massless_body(arm_b1, fsb::JointType::PRISMATIC_X, elbow, {}, err);
+    REQUIRE(err == fsb::BodyTreeError::SUCCESS);
+
+    const fsb::JointPva joint_pva = {{0.3, -0.7, 1.1, 0.25}, {0.5, 0.4, -0.3, 0.2}, {-0.1, 0.6, 0.2, -0.4}};
+    const fsb::CartesianPva base_pva = {
+        {{0.9238795325112867, 0.0, 0.0, 0.3826834323650898}, {0.1, -0.2, 0.05}},
+        {{0.01, 0.02, 0.03}, {0.1, 0.0, -0.1}},
+        {}
+    };
+    const auto opt = fsb::ForwardKinematicsOption::POSE_VELOCITY_ACCELERATION;
+    fsb::BodyCartesianPva expected_body_pva = {};
+    fsb::forward_kinematics(body_tree, joint_pva, base_pva, opt, expected_body_pva);
+
+    fsb::BodyCartesianPva actual_body_pva = {};
+    REQUIRE(fsb::forward_kinematics_chain(body_tree, joint_pva, base_pva, arm_b2, opt, actual_body_pva));
+
+    // chain bodies are computed
+    check_cartesian_pva(expected_body_pva.body[fsb::BodyTree::kBaseIndex], actual_body_pva.body[fsb::BodyTree::kBaseIndex]);
+    check_cartesian_pva(expected_body_pva.body[arm_b1], actual_body_pva.body[arm_b1]);
+    check_cartesian_pva(expected_body_pva.body[arm_b2], actual_body_pva.body[arm_b2]);
+    // bodies of other branch are not modified
+    REQUIRE(actual_body_pva.body[arm_a1].pose.translation.z == 0.0);
+    REQUIRE(actual_body_pva.body[arm_a2].pose.translation.z == 0.0);
+
+    // chain program only contains ancestors of target body
+    fsb::KinematicProgram chain = {};
+    REQUIRE(fsb::kinematic_program_compile_chain(body_tree, arm_a2, chain));
+    REQUIRE(chain.num_ops == 2U);
+    REQUIRE(chain.op[0].child_index == arm_a1);
+    REQUIRE(chain.op[1].child_index == arm_a2);
+
+    // invalid target body
+    REQUIRE_FALSE(fsb::forward_kinematics_chain(body_tree, joint_pva, base_pva, 9U, opt, actual_body_pva));
+}
+
 TEST_SUITE_END();
@@ -0,0 +1,167 @@
+#include <doctest/doctest.h>
+#include <array>
+#include "fsb_test_macros.h"
+#include "fsb_linalg.h"
+#include "fsb_linalg_batch.h"
+#include "fsb_types.h"
+
+TEST_SUITE_BEGIN("linalg_batch");
+
+TEST_CASE("Batched positive definite solve matches fixed size solve" * doctest::description("[fsb_linalg_batch][fsb::linalg_batch_posdef_solve]"))
+{
+    // count not a multiple of lane group size, one problem not positive definite
+    constexpr size_t Dim = 6U;
+    constexpr size_t Count = 11U;
+    constexpr size_t NotPosdef = 9U;
+    std::array<fsb::Real, Dim * Dim * Count> mat = {};
+    std::array<fsb::Real, Dim * Count> b_vec = {};
+    for (size_t prob = 0U; prob < Count; ++prob)
+    {
+        for (size_t col = 0U; col < Dim; ++col)
+        {
+            for (size_t row = 0U; row < Dim; ++row)
+            {
+                const fsb::Real value = 0.1 * static_cast<fsb::Real>(((row + prob + 1U) * (col + prob + 1U)) % 5U);
+                const fsb::Real diag = (prob == NotPosdef) ? -1.0 : static_cast<fsb::Real>(Dim);
+                mat[(Dim * col + row) * Count + prob] = value + ((row == col) ? diag : 0.0);
+            }
+            b_vec[col * Count + prob] = static_cast<fsb::Real>(col) - 0.5 * static_cast<fsb::Real>(prob);
+        }
+    }
+
+    std::array<fsb::Real, Dim * Count> x_vec = {};
+    std::array<FsbLinalgErrorType, Count> status = {};
+    REQUIRE(fsb::linalg_batch_posdef_solve<Dim>(Count, mat.data(), b_vec.data(), x_vec.data(), status.data()) == EFSB_LAPACK_NOT_POSITIVE_DEFINITE);
+
+    for (size_t prob = 0U; prob < Count; ++prob)
+    {
+        std::array<fsb::Real, Dim * Dim> mat_prob = {};
+        std::array<fsb::Real, Dim> x_expected = {};
+        for (size_t ind = 0U; ind < (Dim * Dim); ++ind)
+        {
+            mat_prob[ind] = mat[ind * Count + prob];
+        }
+        for (size_t ind = 0U; ind < Dim; ++ind)
+        {
+            x_expected[ind] = b_vec[ind * Count + prob];
+        }
+        const FsbLinalgErrorType err_expected = fsb::linalg_fixed_posdef_solve<Dim>(mat_prob.data(), x_expected.data());
+        REQUIRE(status[prob] == err_expected);
+        if (err_expected == EFSB_LAPACK_ERROR_NONE)
+        {
+            for (size_t ind = 0U; ind < Dim; ++ind)
+            {
+                REQUIRE(x_vec[ind * Count + prob] == FsbApprox(x_expected[ind], 1.0e-12));
+            }
+        }
+    }
+    REQUIRE(status[NotPosdef] == EFSB_LAPACK_NOT_POSITIVE_DEFINITE);
+}
+
+TEST_CASE("Batched least squares matches LAPACK" * doctest::description("[fsb_linalg_batch][fsb::linalg_batch_leastsquares_solve]"))
+{
+    constexpr size_t Count = 13U;
+    constexpr size_t RankDeficient = 4U;
+
+    SUBCASE("Underdetermined 6x7")
+    {
+        constexpr size_t Rows = 6U;
+        constexpr size_t Cols = 7U;
+        std::array<fsb::Real, Rows * Cols * Count> mat = {};
+        std::array<fsb::Real, Rows * Count> b_vec = {};
+        for (size_t prob = 0U; prob < Count; ++prob)
+        {
+            for (size_t col = 0U; col < Cols; ++col)
+            {
+                for (size_t row = 0U; row < Rows; ++row)
+                {
+                    const fsb::Real value = 0.1 * static_cast<fsb::Real>(((row + 2U) * (col + prob + 3U)) % 11U) - 0.5;
+                    const bool zero_row = (prob == RankDeficient) && (row == 2U);
+                    mat[(Rows * col + row) * Count + prob] = zero_row ? 0.0 : (value + ((row == col) ? 1.0 : 0.0));
+                }
+            }
+            for (size_t row = 0U; row < Rows; ++row)
+            {
+                b_vec[row * Count + prob] = 0.3 * static_cast<fsb::Real>(row) - 0.1 * static_cast<fsb::Real>(prob);
+            }
+        }
+
+        std::array<fsb::Real, Cols * Count> x_vec = {};
+        std::array<FsbLinalgErrorType, Count> status = {};
+        REQUIRE(fsb::linalg_batch_leastsquares_solve<Rows, Cols>(Count, mat.data(), b_vec.data(), x_vec.data(), status.data()) == EFSB_LAPACK_ERROR_NOT_FULL_RANK);
+        for (size_t prob = 0U; prob < Count; ++prob)
+        {
+            std::array<double_t, Rows * Cols> mat_prob = {};
+            std::array<double_t, Rows> b_prob = {};
+            std::array<double_t, Cols> x_expected = {};
+            for (size_t ind = 0U; ind < (Rows * Cols); ++ind)
+            {
+                mat_prob[ind] = mat[ind * Count + prob];
+            }
+            for (size_t ind = 0U; ind < Rows; ++ind)
+            {
+                b_prob[ind] = b_vec[ind * Count + prob];
+            }
+            std::array<double_t, 512U> work = {};
+            const FsbLinalgErrorType err_expected = fsb_linalg_leastsquares_solve(
+                mat_prob.data(), Rows, Cols, b_prob.data(), 1U, 512U, work.data(), x_expected.data());
+            REQUIRE(status[prob] == err_expected);
+            if (err_expected == EFSB_LAPACK_ERROR_NONE)
+            {
+                for (size_t ind = 0U; ind < Cols; ++ind)
+                {
+                    REQUIRE(x_vec[ind * Count + prob] == FsbApprox(x_expected[ind], 1.0e-10));
+                }
+            }
+        }
+        REQUIRE(status[RankDeficient] == EFSB_LAPACK_ERROR_NOT_FULL_RANK);
+    }
+
+    SUBCASE("Overdetermined 7x3")
+    {
+        constexpr size_t Rows = 7U;
+        constexpr size_t Cols = 3U;
+        std::array<fsb::Real, Rows * Cols * Count> mat = {};
+        std::array<fsb::Real, Rows * Count> b_vec = {};
+        for (size_t prob = 0U; prob < Count; ++prob)
+        {
+            for (size_t col = 0U; col < Cols; ++col)
+            {
+                for (size_t row = 0U; row < Rows; ++row)
+                {
+                    mat[(Rows * col + row) * Count + prob]
+                        = 0.1 * static_cast<fsb::Real>(((row + prob + 2U) * (col + 3U)) % 7U) + ((row == col) ? 1.0 : 0.0);
+                }
+            }
+            for (size_t row = 0U; row < Rows; ++row)
+            {
+                b_vec[row * Count + prob] = static_cast<fsb::Real>((row * (prob + 1U)) % 4U) - 1.0;
+            }
+        }
+
+        std::array<fsb::Real, Cols * Count> x_vec = {};
+        REQUIRE(fsb::linalg_batch_leastsquares_solve<Rows, Cols>(Count, mat.data(), b_vec.data(), x_vec.data(), nullptr) == EFSB_LAPACK_ERROR_NONE);
+        for (size_t prob = 0U; prob < Count; ++prob)
+        {
+            std::array<double_t, Rows * Cols> mat_prob = {};
+            std::array<double_t, Rows> b_prob = {};
+            std::array<double_t, Cols> x_expected = {};
+            for (size_t ind = 0U; ind < (Rows * Cols); ++ind)
+            {
+                mat_prob[ind] = mat[ind * Count + prob];
+            }
+            for (size_t ind = 0U; ind < Rows; ++ind)
+            {
+                b_prob[ind] = b_vec[ind * Count + prob];
+            }
+            std::array<double_t, 512U> work = {};
+            REQUIRE(fsb_linalg_leastsquares_solve(mat_prob.data(), Rows, Cols, b_prob.data(), 1U, 512U, work.data(), x_expected.data()) == EFSB_LAPACK_ERROR_NONE);
+            for (size_t ind = 0U; ind < Cols; ++ind)
+            {
+                REQUIRE(x_vec[ind * Count + prob] == FsbApprox(x_expected[ind], 1.0e-10));
+            }
+        }
+    }
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,214 @@
+#include <doctest/doctest.h>
+#include <array>
+#include "fsb_test_macros.h"
+#include "fsb_linalg.h"
+#include "fsb_linalg_fixed.h"
+#include "fsb_types.h"
+
+TEST_SUITE_BEGIN("linalg_fixed");
+
+TEST_CASE("Fixed size Cholesky solve symmetric positive definite matrix" * doctest::description("[fsb_linalg_fixed][fsb::linalg_fixed_posdef_solve]"))
+{
+    // lower triangle of matrix
+    std::array<fsb::Real, 9U> a_mat = {
+        4.0, 12.0, -16.0,
+        0.0, 37.0, -43.0,
+        0.0, 0.0, 98.0
+    };
+    std::array<fsb::Real, 3U> x_vec = {1.0, 2.0, 3.0};
+    const std::array<fsb::Real, 3U> x_vec_expected = {28.583333333333265, -7.666666666666648, 1.333333333333330};
+    const std::array<fsb::Real, 9U> chol_expected = {
+        2.0, 6.0, -8.0,
+        0.0, 1.0, 5.0,
+        0.0, 0.0, 3.0
+    };
+
+    REQUIRE(fsb::linalg_fixed_posdef_solve(3U, a_mat.data(), x_vec.data()) == EFSB_LAPACK_ERROR_NONE);
+    for (size_t k = 0U; k < x_vec.size(); ++k)
+    {
+        REQUIRE(x_vec[k] == FsbApprox(x_vec_expected[k]));
+    }
+    for (size_t k = 0U; k < a_mat.size(); ++k)
+    {
+        REQUIRE(a_mat[k] == FsbApprox(chol_expected[k]));
+    }
+}
+
+TEST_CASE("Fixed size Cholesky solve not positive definite matrix" * doctest::description("[fsb_linalg_fixed][fsb::linalg_fixed_posdef_solve]"))
+{
+    std::array<fsb::Real, 9U> a_mat = {
+        -4.0, 12.0, -16.0,
+        0.0, 37.0, -43.0,
+        0.0, 0.0, 98.0
+    };
+    std::array<fsb::Real, 3U> x_vec = {1.0, 2.0, 3.0};
+    REQUIRE(fsb::linalg_fixed_posdef_solve(3U, a_mat.data(), x_vec.data()) == EFSB_LAPACK_NOT_POSITIVE_DEFINITE);
+    REQUIRE(fsb::linalg_fixed_posdef_solve(0U, a_mat.data(), x_vec.data()) == EFSB_LAPACK_ERROR_INPUT);
+    REQUIRE(fsb::linalg_fixed_posdef_solve(fsb::kLinalgFixedMaxDim + 1U, a_mat.data(), x_vec.data()) == EFSB_LAPACK_ERROR_INPUT);
+}
+
+TEST_CASE("Fixed size Cholesky solve matches LAPACK" * doctest::description("[fsb_linalg_fixed][fsb::linalg_fixed_posdef_solve]"))
+{
+    constexpr size_t MaxDim = fsb::kLinalgFixedMaxDim;
+    for (size_t dim = 1U; dim <= MaxDim; ++dim)
+    {
+        // symmetric positive definite matrix A = B^T B + I
+        std::array<fsb::Real, MaxDim * MaxDim> b_mat = {};
+        for (size_t k = 0U; k < (dim * dim); ++k)
+        {
+            b_mat[k] = 0.1 * static_cast<fsb::Real>((k * 7U) % 11U) - 0.45;
+        }
+        std::array<fsb::Real, MaxDim * MaxDim> a_mat = {};
+        for (size_t col = 0U; col < dim; ++col)
+        {
+            for (size_t row = 0U; row < dim; ++row)
+            {
+                fsb::Real value = (row == col) ? 1.0 : 0.0;
+                for (size_t k = 0U; k < dim; ++k)
+                {
+                    value += b_mat[dim * row + k] * b_mat[dim * col + k];
+                }
+                a_mat[dim * col + row] = value;
+            }
+        }
+        std::array<fsb::Real, MaxDim> b_vec = {};
+        for (size_t k = 0U; k < dim; ++k)
+        {
+            b_vec[k] = 1.0 - 0.25 * static_cast<fsb::Real>(k);
+        }
+
+        std::array<double_t, MaxDim * MaxDim> work = {};
+        std::array<double_t, MaxDim> x_vec_expected = {};
+        REQUIRE(fsb_linalg_cholesky_solve(
+            a_mat.data(), b_vec.data(), 1U, dim, work.size(), work.data(), x_vec_expected.data()) == EFSB_LAPACK_ERROR_NONE);
+
+        std::array<fsb::Real, MaxDim> x_vec = b_vec;
+        REQUIRE(fsb::linalg_fixed_posdef_solve(dim, a_mat.data(), x_vec.data()) == EFSB_LAPACK_ERROR_NONE);
+        for (size_t k = 0U; k < dim; ++k)
+        {
+            REQUIRE(x_vec[k] == FsbApprox(x_vec_expected[k]));
+        }
+    }
+}
+
+TEST_CASE("Fixed size least squares matches LAPACK" * doctest::description("[fsb_linalg_fixed][fsb::linalg_fixed_leastsquares_solve]"))
+{
+    constexpr size_t Rows = 6U;
+    constexpr size_t MaxCols = fsb::kLinalgFixedMaxDim;
+    for (size_t cols = 1U; cols <= MaxCols; ++cols)
+    {
+        std::array<fsb::Real, Rows * MaxCols> a_mat = {};
+        for (size_t k = 0U; k < (Rows * cols); ++k)
+        {
+            a_mat[k] = 0.1 * static_cast<fsb::Real>((k * 7U) % 11U) - 0.45 + ((k % (Rows + 1U)) == 0U ? 1.0 : 0.0);
+        }
+        const std::array<fsb::Real, Rows> b_vec = {1.0, -0.5, 0.25, 2.0, -1.0, 0.75};
+
+        std::array<double_t, 512U> work = {};
+        std::array<double_t, MaxCols> x_vec_expected = {};
+        REQUIRE(fsb_linalg_leastsquares_solve(
+            a_mat.data(), Rows, cols, b_vec.data(), 1U, work.size(), work.data(), x_vec_expected.data()) == EFSB_LAPACK_ERROR_NONE);
+
+        std::array<fsb::Real, MaxCols> x_vec = {};
+        REQUIRE(fsb::linalg_fixed_leastsquares_solve<Rows>(cols, a_mat.data(), b_vec.data(), x_vec.data()) == EFSB_LAPACK_ERROR_NONE);
+        for (size_t k = 0U; k < cols; ++k)
+        {
+            REQUIRE(x_vec[k] == FsbApprox(x_vec_expected[k], 1.0e-9));
+        }
+    }
+
+    // rank deficient matrix
+    std::array<fsb::Real, Rows * 3U> rank_mat = {};
+    rank_mat[0U] = 1.0;
+    rank_mat[Rows + 1U] = 1.0;
+    const std::array<fsb::Real, Rows> b_vec = {1.0, 1.0, 1.0, 1.0, 1.0, 1.0};
+    std::array<fsb::Real, 3U> x_vec = {};
+    REQUIRE(fsb::linalg_fixed_leastsquares_solve<Rows, 3U>(rank_mat.data(), b_vec.data(), x_vec.data()) == EFSB_LAPACK_ERROR_NOT_FULL_RANK);
+    REQUIRE(fsb::linalg_fixed_leastsquares_solve<Rows>(0U, rank_mat.data(), b_vec.data(), x_vec.data()) == EFSB_LAPACK_ERROR_INPUT);
+}
+
+TEST_CASE("Fixed size Jacobi SVD matches LAPACK" * doctest::description("[fsb_linalg_fixed][fsb::linalg_fixed_svd]"))
+{
+    constexpr size_t Rows = 6U;
+    constexpr size_t Cols = 7U;
+    std::array<fsb::Real, Rows * Cols> a_mat = {};
+    for (size_t col = 0U; col < Cols; ++col)
+    {
+        for (size_t row = 0U; row < Rows; ++row)
+        {
+            a_mat[Rows * col + row] = 0.1 * static_cast<fsb::Real>(((row + 2U) * (col + 3U)) % 11U) - 0.5
+                                      + ((row == col) ? 1.0 : 0.0);
+        }
+    }
+
+    std::array<double_t, 512U> work = {};
+    std::array<double_t, Rows * Rows> u_expected = {};
+    std::array<double_t, Rows> s_expected = {};
+    std::array<double_t, Rows * Cols> vt_expected = {};
+    REQUIRE(fsb_linalg_svd(a_mat.data(), Rows, Cols, false, false, 512U, work.data(), u_expected.data(), s_expected.data(), vt_expected.data()) == EFSB_LAPACK_ERROR_NONE);
+
+    std::array<fsb::Real, Cols> sing_val = {};
+    std::array<fsb::Real, Rows * Cols> vec_u = {};
+    std::array<fsb::Real, Cols * Cols> vec_v = {};
+    REQUIRE(fsb::linalg_fixed_svd<Rows, Cols>(a_mat.data(), nullptr, sing_val.data(), vec_u.data(), vec_v.data()) == EFSB_LAPACK_ERROR_NONE);
+    for (size_t ind = 0U; ind < Rows; ++ind)
+    {
+        REQUIRE(sing_val[ind] == FsbApprox(s_expected[ind], 1.0e-10));
+    }
+    REQUIRE(sing_val[Rows] == FsbApprox(0.0, 1.0e-10));
+
+    // A = U S V^T and V orthogonal
+    for (size_t col = 0U; col < Cols; ++col)
+    {
+        for (size_t row = 0U; row < Rows; ++row)
+        {
+            fsb::Real value = 0.0;
+            for (size_t ind = 0U; ind < Cols; ++ind)
+            {
+                value += vec_u[Rows * ind + row] * sing_val[ind] * vec_v[Cols * ind + col];
+            }
+            REQUIRE(value == FsbApprox(a_mat[Rows * col + row], 1.0e-10));
+        }
+        for (size_t other = 0U; other < Cols; ++other)
+        {
+            fsb::Real value = 0.0;
+            for (size_t ind = 0U; ind < Cols; ++ind)
+            {
+                value += vec_v[Cols * col + ind] * vec_v[Cols * other + ind];
+            }
+            REQUIRE(value == FsbApprox((col == other) ? 1.0 : 0.0, 1.0e-10));
+        }
+    }
+
+    // warm start from previous right singular vectors after small change
+    std::array<fsb::Real, Rows * Cols> b_mat = a_mat;
+    for (size_t ind = 0U; ind < (Rows * Cols); ++ind)
+    {
+        b_mat[ind] += 1.0e-3 * static_cast<fsb::Real>(ind % 5U);
+    }
+    size_t cold_sweeps = 0U;
+    size_t warm_sweeps = 0U;
+    std::array<fsb::Real, Cols> sing_val_cold = {};
+    std::array<fsb::Real, Cols> sing_val_warm = {};
+    REQUIRE(fsb::linalg_fixed_svd<Rows, Cols>(b_mat.data(), nullptr, sing_val_cold.data(), nullptr, nullptr, &cold_sweeps) == EFSB_LAPACK_ERROR_NONE);
+    REQUIRE(fsb::linalg_fixed_svd<Rows, Cols>(b_mat.data(), vec_v.data(), sing_val_warm.data(), nullptr, nullptr, &warm_sweeps) == EFSB_LAPACK_ERROR_NONE);
+    REQUIRE(warm_sweeps <= 3U);
+    REQUIRE(warm_sweeps < cold_sweeps);
+    for (size_t ind = 0U; ind < Cols; ++ind)
+    {
+        REQUIRE(sing_val_warm[ind] == FsbApprox(sing_val_cold[ind], 1.0e-10));
+    }
+
+    // rank deficient tall matrix with runtime dispatch
+    std::array<fsb::Real, Rows * 3U> rank_mat = {};
+    rank_mat[0U] = 2.0;
+    rank_mat[Rows + 1U] = 1.0;
+    std::array<fsb::Real, 3U> rank_val = {};
+    REQUIRE(fsb::linalg_fixed_svd<Rows>(3U, rank_mat.data(), nullptr, rank_val.data(), nullptr, nullptr) == EFSB_LAPACK_ERROR_NONE);
+    REQUIRE(rank_val[0U] == FsbApprox(2.0));
+    REQUIRE(rank_val[1U] == FsbApprox(1.0));
+    REQUIRE(rank_val[2U] == FsbApprox(0.0));
+    REQUIRE(fsb::linalg_fixed_svd<Rows>(0U, rank_mat.data(), nullptr, rank_val.data(), nullptr, nullptr) == EFSB_LAPACK_ERROR_INPUT);
+}
+
+TEST_SUITE_END();
@@ -423,4 +423,110 @@ TEST_CASE("Least squares solution overdetermined system" * doctest::description(
     }
 }
 
+TEST_CASE("Least squares solution with workspace plan" * doctest::description("[fsb_linalg][fsb_linalg_leastsquares_plan]"))
+{
+    // Inputs - same overdetermined system as direct solve
+    const size_t rows = 4U;
+    const size_t columns = 2U;
+    const size_t nrhs = 1U;
+    const double_t a_mat[rows * columns] = {
+        1.0, 1.2, 2.0, 2.5,
+        1.5, 2.0, 3.0, 3.5
+    };
+    const double_t b_vec[rows * nrhs] = {
+        3.0,
+        4.0,
+        5.0,
+        8.0
+    };
+    const double_t x_expected[columns * nrhs] = {
+        3.8394793926247286,
+        -0.5856832971800433
+    };
+
+    // Process
+    FsbLinalgLeastSquaresPlan plan = {};
+    REQUIRE(fsb_linalg_leastsquares_plan(rows, columns, nrhs, &plan) == EFSB_LAPACK_ERROR_NONE);
+    REQUIRE(plan.lwork > 0U);
+    REQUIRE(plan.work_len == (rows * columns) + (rows * nrhs) + plan.lwork);
+
+    // repeated execution with same plan
+    fsb::WorkArray<double_t, 256U> work;
+    for (size_t iter = 0U; iter < 3U; ++iter)
+    {
+        double_t x_actual[columns * nrhs] = {};
+        REQUIRE(fsb_linalg_leastsquares_execute_work(plan, a_mat, b_vec, work, x_actual) == EFSB_LAPACK_ERROR_NONE);
+        REQUIRE(work.get_used() == 0U);
+        for (size_t idx = 0U; idx < columns; ++idx)
+        {
+            REQUIRE(x_actual[idx] == FsbApprox(x_expected[idx]));
+        }
+    }
+
+    // not enough work space
+    double_t x_actual[columns * nrhs] = {};
+    double_t small_work[4U] = {};
+    REQUIRE(fsb_linalg_leastsquares_execute(&plan, a_mat, b_vec, 4U, small_work, x_actual) == EFSB_LAPACK_ERROR_MEMORY);
+    fsb::WorkArray<double_t, 4U> small_array;
+    REQUIRE(fsb_linalg_leastsquares_execute_work(plan, a_mat, b_vec, small_array, x_actual) == EFSB_LAPACK_ERROR_MEMORY);
+
+    // invalid plans
+    const FsbLinalgLeastSquaresPlan empty_plan = {};
+    REQUIRE(fsb_linalg_leastsquares_execute(&empty_plan, a_mat, b_vec, 256U, small_work, x_actual) == EFSB_LAPACK_ERROR_INPUT);
+    REQUIRE(fsb_linalg_leastsquares_execute(nullptr, a_mat, b_vec, 256U, small_work, x_actual) == EFSB_LAPACK_ERROR_INPUT);
+    REQUIRE(fsb_linalg_leastsquares_plan(0U, columns, nrhs, &plan) == EFSB_LAPACK_ERROR_INPUT);
+}
+
+TEST_CASE("Pseudoinverse and SVD with workspace plan" * doctest::description("[fsb_linalg][fsb_linalg_pseudoinverse_plan]"))
+{
+    // Inputs
+    const size_t rows = 3U;
+    const size_t cols = 4U;
+    const double_t a_mat[rows * cols] = {
+        0.957166948242946, 0.485375648722841, 0.800280468888800,
+        0.141886338627215, 0.421761282626275, 0.915735525189067,
+        0.792207329559554, 0.959492426392903, 0.655740699156587,
+        0.0357116785741896, 0.849129305868777, 0.933993247757551
+    };
+    constexpr size_t work_len = 256U;
+
+    // SVD plan matches direct SVD
+    FsbLinalgSvdPlan svd_plan = {};
+    REQUIRE(fsb_linalg_svd_plan(rows, cols, false, false, &svd_plan) == EFSB_LAPACK_ERROR_NONE);
+    REQUIRE(svd_plan.work_len == (rows * cols) + svd_plan.lwork);
+    double_t work[work_len] = {};
+    double_t u_expected[rows * rows] = {};
+    double_t s_expected[rows] = {};
+    double_t vt_expected[rows * cols] = {};
+    REQUIRE(fsb_linalg_svd(a_mat, rows, cols, false, false, work_len, work, u_expected, s_expected, vt_expected) == EFSB_LAPACK_ERROR_NONE);
+    fsb::WorkArray<double_t, work_len> work_array;
+    double_t u_actual[rows * rows] = {};
+    double_t s_actual[rows] = {};
+    double_t vt_actual[rows * cols] = {};
+    REQUIRE(fsb_linalg_svd_execute_work(svd_plan, a_mat, work_array, u_actual, s_actual, vt_actual) == EFSB_LAPACK_ERROR_NONE);
+    for (size_t k = 0U; k < rows; ++k)
+    {
+        REQUIRE(s_actual[k] == FsbApprox(s_expected[k]));
+    }
+    for (size_t k = 0U; k < (rows * cols); ++k)
+    {
+        REQUIRE(vt_actual[k] == FsbApprox(vt_expected[k]));
+    }
+
+    // pseudoinverse plan matches direct pseudoinverse
+    FsbLinalgPseudoinversePlan pinv_plan = {};
+    REQUIRE(fsb_linalg_pseudoinverse_plan(rows, cols, &pinv_plan) == EFSB_LAPACK_ERROR_NONE);
+    double_t inv_expected[cols * rows] = {};
+    REQUIRE(fsb_linalg_pseudoinverse(a_mat, rows, cols, work_len, work, inv_expected) == EFSB_LAPACK_ERROR_NONE);
+    double_t inv_actual[cols * rows] = {};
+    REQUIRE(fsb_linalg_pseudoinverse_execute_work(pinv_plan, a_mat, work_array, inv_actual) == EFSB_LAPACK_ERROR_NONE);
+    REQUIRE(work_array.get_used() == 0U);
+    for (size_t k = 0U; k < (rows * cols); ++k)
+    {
+        REQUIRE(inv_actual[k] == FsbApprox(inv_expected[k]));
+    }
+    REQUIRE(fsb_linalg_pseudoinverse_execute(&pinv_plan, a_mat, pinv_plan.work_len - 1U, work, inv_actual) == EFSB_LAPACK_ERROR_MEMORY);
+    REQUIRE(fsb_linalg_svd_execute(nullptr, a_mat, work_len, work, u_actual, s_actual, vt_actual) == EFSB_LAPACK_ERROR_INPUT);
+}
+
 TEST_SUITE_END();
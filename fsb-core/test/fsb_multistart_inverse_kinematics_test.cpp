@@ -0,0 +1,169 @@
+#include <doctest/doctest.h>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include "fsb_test_macros.h"
+#include "fsb_multistart_inverse_kinematics.h"
+#include "fsb_inverse_kinematics.h"
+#include "fsb_kinematics.h"
+#include "fsb_body_tree_sample.h"
+
+TEST_SUITE_BEGIN("multistart_inverse_kinematics");
+
+TEST_CASE("Multi-start inverse kinematics Panda 7 DoF" * doctest::description("[fsb_multistart_inverse_kinematics][fsb::MultiStartInverseKinematics]"))
+{
+    size_t              ee_index = 0U;
+    const fsb::BodyTree panda_tree = create_panda_body_tree(ee_index);
+    const fsb::JointSpacePosition initial_config = {{1.0, -0.32, 0.08, -2.15, 0.04, -2.0, 0.78}};
+    const fsb::Transform target_pose = {
+        {0.9218430590013226, -0.3843272787743501, 0.04613060152655873, -0.019232393605190336},
+        {0.47372404011176217, 0.07, 0.5155132061520504}};
+    fsb::OptimParameters optim_params = {};
+    optim_params.max_iterations = 50U;
+    fsb::MultiStartParameters multistart_params = {};
+    multistart_params.num_workers = 4U;
+    multistart_params.stop_on_success = false;
+
+    static fsb::MultiStartInverseKinematics solver;
+    fsb::MultiStartSeeds seeds = {};
+    REQUIRE(solver.solve(target_pose, seeds).result.info == fsb::InverseKinematicsInfo::INVALID_INPUT);
+    REQUIRE(solver.initialize(panda_tree, panda_tree.get_num_bodies(), optim_params, multistart_params) == fsb::InverseKinematicsInfo::INVALID_INPUT);
+    REQUIRE(solver.get_num_workers() == 0U);
+    REQUIRE(solver.initialize(panda_tree, ee_index, optim_params, multistart_params) == fsb::InverseKinematicsInfo::SUCCESS);
+    REQUIRE(solver.get_num_workers() == 4U);
+    REQUIRE(solver.solve(target_pose, seeds).result.info == fsb::InverseKinematicsInfo::INVALID_INPUT);
+
+    // generated seeds start from initial configuration
+    solver.generate_seeds(initial_config, 12U, seeds);
+    REQUIRE(seeds.num_seeds == 12U);
+    for (size_t coord = 0U; coord < panda_tree.get_num_coordinates(); ++coord)
+    {
+        REQUIRE(seeds.seed[0U].q[coord] == FsbApprox(initial_config.q[coord]));
+        REQUIRE(seeds.seed[1U].q[coord] != FsbApprox(initial_config.q[coord]));
+        REQUIRE(seeds.seed[1U].q[coord] >= -M_PI);
+        REQUIRE(seeds.seed[1U].q[coord] <= M_PI);
+    }
+
+    // best solution by distance to reference matches serial evaluation of all seeds
+    const fsb::JointSpacePosition reference = {{0.9, -0.3, 0.1, -2.2, 0.0, -2.0, 0.8}};
+    const fsb::MultiStartResult& result = solver.solve(
+        target_pose, seeds, fsb::multistart_cost_joint_distance, &reference);
+    REQUIRE(result.num_solved == seeds.num_seeds);
+    REQUIRE(result.num_converged > 0U);
+    REQUIRE(result.result.info == fsb::InverseKinematicsInfo::SUCCESS);
+    REQUIRE(fsb::vector_norm(result.result.error_pose.linear) == FsbApprox(0.0, 1.0e-5));
+    REQUIRE(fsb::vector_norm(result.result.error_pose.angular) == FsbApprox(0.0, 1.0e-5));
+
+    size_t    num_converged = 0U;
+    size_t    best_index = seeds.num_seeds;
+    fsb::Real best_cost = 0.0;
+    for (size_t index = 0U; index < seeds.num_seeds; ++index)
+    {
+        const fsb::InverseKinematicsResult expected = fsb::compute_inverse_kinematics(
+            panda_tree, optim_params, seeds.seed[index], ee_index, target_pose);
+        if (expected.info == fsb::InverseKinematicsInfo::SUCCESS)
+        {
+            num_converged += 1U;
+            const fsb::Real cost = fsb::multistart_cost_joint_distance(expected, &reference);
+            if ((best_index == seeds.num_seeds) || (cost < best_cost))
+            {
+                best_index = index;
+                best_cost = cost;
+            }
+        }
+    }
+    REQUIRE(result.num_converged == num_converged);
+    REQUIRE(result.seed_index == best_index);
+    REQUIRE(result.cost == FsbApprox(best_cost));
+
+    // worker threads are reused by later calls
+    for (size_t repeat = 0U; repeat < 3U; ++repeat)
+    {
+        const fsb::MultiStartResult& repeat_result = solver.solve(
+            target_pose, seeds, fsb::multistart_cost_joint_distance, &reference);
+        REQUIRE(repeat_result.num_solved == seeds.num_seeds);
+        REQUIRE(repeat_result.seed_index == best_index);
+    }
+
+    // stop on first success
+    multistart_params.stop_on_success = true;
+    REQUIRE(solver.initialize(panda_tree, ee_index, optim_params, multistart_params) == fsb::InverseKinematicsInfo::SUCCESS);
+    const fsb::MultiStartResult& first_result = solver.solve(target_pose, seeds);
+    REQUIRE(first_result.result.info == fsb::InverseKinematicsInfo::SUCCESS);
+    REQUIRE(first_result.num_converged >= 1U);
+    REQUIRE(first_result.num_solved <= seeds.num_seeds);
+    REQUIRE(fsb::vector_norm(first_result.result.error_pose.linear) == FsbApprox(0.0, 1.0e-5));
+}
+
+TEST_CASE("Multi-start inverse kinematics re-initialized" * doctest::description("[fsb_multistart_inverse_kinematics][fsb::MultiStartInverseKinematics]"))
+{
+    size_t              ee_index = 0U;
+    const fsb::BodyTree panda_tree = create_panda_body_tree(ee_index);
+    const fsb::JointSpacePosition initial_config = {{1.0, -0.32, 0.08, -2.15, 0.04, -2.0, 0.78}};
+    const fsb::Transform target_pose = {
+        {0.9218430590013226, -0.3843272787743501, 0.04613060152655873, -0.019232393605190336},
+        {0.47372404011176217, 0.07, 0.5155132061520504}};
+    fsb::OptimParameters optim_params = {};
+    optim_params.max_iterations = 50U;
+    fsb::MultiStartParameters multistart_params = {};
+    multistart_params.num_workers = 4U;
+    multistart_params.stop_on_success = false;
+
+    static fsb::MultiStartInverseKinematics solver;
+    // seeds and target of each solve are released before the solver is initialized again, new pool
+    // threads must not replay the job of the previous pool
+    for (size_t repeat = 0U; repeat < 4U; ++repeat)
+    {
+        REQUIRE(solver.initialize(panda_tree, ee_index, optim_params, multistart_params) == fsb::InverseKinematicsInfo::SUCCESS);
+        REQUIRE(solver.get_num_workers() == 4U);
+        // pool threads are waiting before the next job is released
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        const auto seeds = std::make_unique<fsb::MultiStartSeeds>();
+        const auto target = std::make_unique<fsb::Transform>(target_pose);
+        solver.generate_seeds(initial_config, 8U, *seeds);
+        const fsb::MultiStartResult& result = solver.solve(*target, *seeds);
+        REQUIRE(result.num_solved == seeds->num_seeds);
+        REQUIRE(result.num_converged > 0U);
+    }
+}
+
+TEST_CASE("Multi-start inverse kinematics unreachable target" * doctest::description("[fsb_multistart_inverse_kinematics][fsb::MultiStartInverseKinematics]"))
+{
+    size_t              ee_index = 0U;
+    const fsb::BodyTree panda_tree = create_panda_body_tree(ee_index);
+    const fsb::JointSpacePosition initial_config = {{1.0, -0.32, 0.08, -2.15, 0.04, -2.0, 0.78}};
+    const fsb::Transform target_pose = {{1.0, 0.0, 0.0, 0.0}, {2.0, 0.0, 0.5}};
+    fsb::OptimParameters optim_params = {};
+    optim_params.max_iterations = 1000U;
+    fsb::MultiStartParameters multistart_params = {};
+    multistart_params.num_workers = 2U;
+
+    static fsb::MultiStartInverseKinematics solver;
+    REQUIRE(solver.initialize(panda_tree, ee_index, optim_params, multistart_params) == fsb::InverseKinematicsInfo::SUCCESS);
+    fsb::MultiStartSeeds seeds = {};
+    solver.generate_seeds(initial_config, 6U, seeds);
+
+    // stalled solutions are not converged and are ranked by pose error, not by user cost
+    const fsb::JointSpacePosition reference = initial_config;
+    const fsb::MultiStartResult& result = solver.solve(
+        target_pose, seeds, fsb::multistart_cost_joint_distance, &reference);
+    REQUIRE(result.num_solved == seeds.num_seeds);
+    REQUIRE(result.num_converged == 0U);
+    REQUIRE(result.result.info != fsb::InverseKinematicsInfo::SUCCESS);
+    fsb::Real min_cost = 0.0;
+    for (size_t index = 0U; index < seeds.num_seeds; ++index)
+    {
+        const fsb::InverseKinematicsResult expected = fsb::compute_inverse_kinematics(
+            panda_tree, optim_params, seeds.seed[index], ee_index, target_pose);
+        REQUIRE(expected.info != fsb::InverseKinematicsInfo::SUCCESS);
+        const fsb::Real cost = fsb::vector_dot(expected.error_pose.angular, expected.error_pose.angular)
+                               + fsb::vector_dot(expected.error_pose.linear, expected.error_pose.linear);
+        if ((index == 0U) || (cost < min_cost))
+        {
+            min_cost = cost;
+        }
+    }
+    REQUIRE(result.cost == FsbApprox(min_cost));
+}
+
+TEST_SUITE_END();
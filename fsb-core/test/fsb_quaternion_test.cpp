@@ -200,6 +200,18 @@ TEST_CASE("Quaternion logarithm" * doctest::description("[fsb_quaternion][fsb::q
     REQUIRE(p_actual.z == FsbApprox(p_expected.z));
 }
 
+TEST_CASE("Quaternion logarithm with rounding error" * doctest::description("[fsb_quaternion][fsb::quat_log]"))
+{
+    // Inputs: scalar part rounded above one
+    const fsb::Quaternion q_a = {1.0000000000000002, 1.0e-8, 0.0, 0.0};
+    // Process
+    const fsb::Vec3 p_actual = fsb::quat_log(q_a);
+
+    REQUIRE(p_actual.x == FsbApprox(1.0e-8));
+    REQUIRE(p_actual.y == FsbApprox(0.0));
+    REQUIRE(p_actual.z == FsbApprox(0.0));
+}
+
 TEST_CASE("Quaternion exponential" * doctest::description("[fsb_quaternion][fsb::quat_exp]"))
 {
     // Inputs
@@ -105,4 +105,34 @@ TEST_CASE("lifo_and_marker_restore" * doctest::description("[fsb::WorkArray]"))
     REQUIRE(8U == work.get_remaining());
 }
 
+TEST_CASE("high_water_mark" * doctest::description("[fsb::WorkArray]"))
+{
+    fsb::WorkArray<int, 8U> work;
+    REQUIRE(0U == work.get_peak());
+
+    {
+        fsb::WorkFrame<int, 8U> frame(work);
+        fsb::WorkBlock<int> a;
+        fsb::WorkBlock<int> b;
+        REQUIRE(fsb::WorkArrayStatus::SUCCESS == frame.allocate(3U, a));
+        REQUIRE(fsb::WorkArrayStatus::SUCCESS == frame.allocate(2U, b));
+        REQUIRE(5U == work.get_peak());
+    }
+
+    // Peak kept after frame released allocations
+    REQUIRE(0U == work.get_used());
+    REQUIRE(5U == work.get_peak());
+
+    // Failed allocation does not change peak
+    fsb::WorkBlock<int> c;
+    REQUIRE(fsb::WorkArrayStatus::INVALID_ARGUMENT == work.allocate(9U, c));
+    REQUIRE(5U == work.get_peak());
+
+    REQUIRE(fsb::WorkArrayStatus::SUCCESS == work.allocate(1U, c));
+    work.reset();
+    REQUIRE(5U == work.get_peak());
+    work.reset_peak();
+    REQUIRE(0U == work.get_peak());
+}
+
 TEST_SUITE_END();